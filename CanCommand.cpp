@@ -0,0 +1,305 @@
+#include "Globals.h"
+#include "CanCommand.h"
+#include "Trace.h"
+
+#include <stddef.h>
+
+/**
+ * @file CanCommand.cpp
+ * @brief 모듈 명령 전달 확인(seq + ACK)과 재전송의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 명령별 효과 (ACK를 받았을 때 g_state에 반영할 필드)
+//------------------------------------------------------------------------------
+
+enum CanCmdEffect : uint8_t {
+  CE_NONE,   // 1회 동작 (상태는 모듈이 상태 프레임으로 알려 줌)
+  CE_BOOL,   // param != 0 → bool
+  CE_U8,     // param → uint8_t
+};
+
+struct CanCmdDef {
+  uint8_t  moduleId;
+  uint8_t  cmd;
+  uint8_t  effect;
+  uint16_t offset;   // SystemState 안의 대상 필드
+  uint32_t changeBit; // 적용 시 알릴 상태 변경 비트 (STATE_CHG_*)
+};
+
+#define CC_AT(member) (uint16_t)offsetof(SystemState, member)
+
+const CanCmdDef kCmdDefs[] = {
+  { MODULE_TANK,   TANK_CMD_SET_PUMP,           CE_BOOL, CC_AT(tank.pumpOn),        STATE_CHG_TANK },
+  { MODULE_TANK,   TANK_CMD_SET_LIGHT,          CE_BOOL, CC_AT(tank.lightOn),       STATE_CHG_TANK },
+  { MODULE_GROW,   GROW_CMD_SET_LED_BRIGHTNESS, CE_U8,   CC_AT(grow.ledBrightness), STATE_CHG_GROW },
+  { MODULE_FEEDER, FEEDER_CMD_FEED_ONCE,        CE_NONE, 0,                         0              },
+};
+
+const size_t  kDefCount = sizeof(kCmdDefs) / sizeof(kCmdDefs[0]);
+const uint8_t kOtherDef = (uint8_t)kDefCount;   // 표에 없는 명령의 통계 묶음
+
+uint8_t findDef(uint8_t moduleId, uint8_t cmd) {
+  for (size_t i = 0; i < kDefCount; ++i) {
+    if (kCmdDefs[i].moduleId == moduleId && kCmdDefs[i].cmd == cmd) return (uint8_t)i;
+  }
+  return kOtherDef;
+}
+
+bool isSetCommand(uint8_t def) {
+  return def != kOtherDef && kCmdDefs[def].effect != CE_NONE;
+}
+
+
+//------------------------------------------------------------------------------
+// 대기 표 (ACK를 기다리는 명령)
+//------------------------------------------------------------------------------
+
+struct InFlight {
+  bool      used;
+  uint8_t   seq;
+  uint8_t   moduleId;
+  uint8_t   cmd;
+  uint8_t   def;
+  uint8_t   retries;
+  int32_t   param;
+  uint32_t  firstUs;     // 처음 송신 시각 (왕복 시간 기준)
+  uint32_t  deadlineUs;  // 이 시각까지 ACK가 없으면 재전송
+  CanTxItem item;
+};
+
+const uint32_t kAckTimeoutUs = CAN_CMD_ACK_TIMEOUT_MS * 1000u;
+
+portMUX_TYPE s_cmdMux = portMUX_INITIALIZER_UNLOCKED;
+
+InFlight    s_inFlight[CAN_CMD_INFLIGHT];
+uint8_t     s_inFlightCount = 0;
+uint8_t     s_nextSeq       = 0;
+CanCmdStats s_stats[kDefCount + 1];
+uint32_t    s_unmatchedAcks = 0;
+uint32_t    s_lastRttUs     = 0;
+
+// 아래 함수들은 모두 s_cmdMux를 잡은 상태에서 호출합니다.
+
+inline bool timeReached(uint32_t nowUs, uint32_t atUs) {
+  return (int32_t)(nowUs - atUs) >= 0;
+}
+
+void release(InFlight &f) {
+  f.used = false;
+  s_inFlightCount--;
+}
+
+void recordRtt(CanCmdStats &s, uint32_t rttUs) {
+  if (s.acked + s.rejected == 0 || rttUs < s.rttMinUs) s.rttMinUs = rttUs;
+  if (rttUs > s.rttMaxUs) s.rttMaxUs = rttUs;
+  s.rttLastUs = rttUs;
+  s.rttSumUs += rttUs;
+  s_lastRttUs = rttUs;
+}
+
+void applyEffect(SystemState &st, const CanCmdDef &d, int32_t param) {
+  uint8_t *dst = (uint8_t *)&st + d.offset;
+  switch (d.effect) {
+    case CE_BOOL: *(bool *)dst = (param != 0);   break;
+    case CE_U8:   *dst         = (uint8_t)param; break;
+    default: break;
+  }
+}
+
+} // namespace
+
+static_assert(CAN_CMD_SAFETY_RESERVE < CAN_CMD_INFLIGHT, "routine commands need at least one in-flight entry");
+
+bool canCmdHasRoom(bool safety) {
+  size_t limit = safety ? CAN_CMD_INFLIGHT : CAN_CMD_INFLIGHT - CAN_CMD_SAFETY_RESERVE;
+  portENTER_CRITICAL(&s_cmdMux);
+  bool room = s_inFlightCount < limit;
+  portEXIT_CRITICAL(&s_cmdMux);
+  return room;
+}
+
+void canCmdTrack(CanTxItem &item, uint32_t nowUs) {
+  uint8_t moduleId = (uint8_t)(item.canId - CAN_ID_CMD_BASE);
+  uint8_t cmd      = item.data[0];
+  int32_t param    = (int32_t)(((uint32_t)item.data[1] << 24) | ((uint32_t)item.data[2] << 16) |
+                               ((uint32_t)item.data[3] <<  8) |  (uint32_t)item.data[4]);
+  uint8_t def = findDef(moduleId, cmd);
+
+  portENTER_CRITICAL(&s_cmdMux);
+  // 같은 설정 명령이 ACK 대기 중이면 새 값으로 대체 (이전 seq의 ACK는 무시됨)
+  if (isSetCommand(def)) {
+    for (size_t i = 0; i < CAN_CMD_INFLIGHT; ++i) {
+      InFlight &f = s_inFlight[i];
+      if (f.used && f.def == def) {
+        release(f);
+        s_stats[def].superseded++;
+      }
+    }
+  }
+
+  item.data[5] = s_nextSeq++;
+
+  for (size_t i = 0; i < CAN_CMD_INFLIGHT; ++i) {
+    InFlight &f = s_inFlight[i];
+    if (f.used) continue;
+    f.used       = true;
+    f.seq        = item.data[5];
+    f.moduleId   = moduleId;
+    f.cmd        = cmd;
+    f.def        = def;
+    f.retries    = 0;
+    f.param      = param;
+    f.firstUs    = nowUs;
+    f.deadlineUs = nowUs + kAckTimeoutUs;
+    f.item       = item;
+    s_inFlightCount++;
+    break;
+  }
+  s_stats[def].sent++;
+  portEXIT_CRITICAL(&s_cmdMux);
+}
+
+bool canCmdNextRetransmit(uint32_t nowUs, CanTxItem &out) {
+  bool got = false;
+
+  portENTER_CRITICAL(&s_cmdMux);
+  for (size_t i = 0; i < CAN_CMD_INFLIGHT && !got; ++i) {
+    InFlight &f = s_inFlight[i];
+    if (!f.used || !timeReached(nowUs, f.deadlineUs)) continue;
+
+    if (f.retries >= CAN_CMD_MAX_RETRIES) {
+      s_stats[f.def].timeouts++;
+      release(f);
+      continue;
+    }
+    out = f.item;
+    got = true;
+  }
+  portEXIT_CRITICAL(&s_cmdMux);
+
+  return got;
+}
+
+void canCmdRetransmitDone(const CanTxItem &item, bool sent, uint32_t nowUs) {
+  uint8_t moduleId = (uint8_t)(item.canId - CAN_ID_CMD_BASE);
+  bool counted = false;
+
+  portENTER_CRITICAL(&s_cmdMux);
+  for (size_t i = 0; i < CAN_CMD_INFLIGHT; ++i) {
+    InFlight &f = s_inFlight[i];
+    if (!f.used || f.seq != item.data[5] || f.moduleId != moduleId || f.cmd != item.data[0]) continue;
+    if (sent) {
+      f.retries++;
+      f.deadlineUs = nowUs + kAckTimeoutUs;
+      s_stats[f.def].retransmits++;
+      counted = true;
+    } else {
+      f.deadlineUs = nowUs + 1000u;
+    }
+    break;
+  }
+  portEXIT_CRITICAL(&s_cmdMux);
+
+  if (counted) traceFlag(item.traceId, TRACE_FLAG_RETRANSMIT);
+}
+
+uint32_t canCmdMsUntilDeadline(uint32_t nowUs, uint32_t maxMs) {
+  uint32_t waitMs = maxMs;
+
+  portENTER_CRITICAL(&s_cmdMux);
+  for (size_t i = 0; i < CAN_CMD_INFLIGHT; ++i) {
+    const InFlight &f = s_inFlight[i];
+    if (!f.used) continue;
+    if (timeReached(nowUs, f.deadlineUs)) {
+      waitMs = 0;
+      break;
+    }
+    uint32_t ms = (f.deadlineUs - nowUs + 999u) / 1000u;
+    if (ms < waitMs) waitMs = ms;
+  }
+  portEXIT_CRITICAL(&s_cmdMux);
+
+  return waitMs;
+}
+
+bool canCmdIsAck(const twai_message_t &msg) {
+  return !msg.extd && (msg.identifier & ~0x7Fu) == CAN_ID_ACK_BASE;
+}
+
+void canCmdHandleAck(SystemState &st, const twai_message_t &msg, uint32_t nowUs,
+                     uint32_t *changed) {
+  uint8_t moduleId = (uint8_t)(msg.identifier - CAN_ID_ACK_BASE);
+  if (msg.data_length_code < 3) return;
+  uint8_t cmd    = msg.data[0];
+  uint8_t seq    = msg.data[1];
+  uint8_t result = msg.data[2];
+
+  uint16_t traceId = 0;
+
+  portENTER_CRITICAL(&s_cmdMux);
+  InFlight *match = nullptr;
+  for (size_t i = 0; i < CAN_CMD_INFLIGHT; ++i) {
+    InFlight &f = s_inFlight[i];
+    if (f.used && f.seq == seq && f.moduleId == moduleId && f.cmd == cmd) {
+      match = &f;
+      break;
+    }
+  }
+
+  if (!match) {
+    s_unmatchedAcks++;
+  } else {
+    CanCmdStats &s = s_stats[match->def];
+    recordRtt(s, nowUs - match->firstUs);
+    if (result == CAN_ACK_OK) {
+      s.acked++;
+      if (match->def != kOtherDef) {
+        applyEffect(st, kCmdDefs[match->def], match->param);
+        if (changed) *changed |= kCmdDefs[match->def].changeBit;
+      }
+    } else {
+      s.rejected++;
+    }
+    traceId = match->item.traceId;
+    release(*match);
+  }
+  portEXIT_CRITICAL(&s_cmdMux);
+
+  traceStamp(traceId, TRACE_STAGE_ACK);
+}
+
+bool getCanCmdKindStats(size_t index, uint8_t &moduleId, uint8_t &cmd, CanCmdStats &out) {
+  if (index > kDefCount) return false;
+  moduleId = index < kDefCount ? kCmdDefs[index].moduleId : 0xFF;
+  cmd      = index < kDefCount ? kCmdDefs[index].cmd : 0xFF;
+  portENTER_CRITICAL(&s_cmdMux);
+  out = s_stats[index];
+  portEXIT_CRITICAL(&s_cmdMux);
+  return true;
+}
+
+void getCanCmdTotals(CanCmdStats &out) {
+  out = CanCmdStats{};
+
+  portENTER_CRITICAL(&s_cmdMux);
+  for (size_t i = 0; i <= kDefCount; ++i) {
+    const CanCmdStats &s = s_stats[i];
+    if (s.acked + s.rejected > 0) {
+      if (out.acked + out.rejected == 0 || s.rttMinUs < out.rttMinUs) out.rttMinUs = s.rttMinUs;
+      if (s.rttMaxUs > out.rttMaxUs) out.rttMaxUs = s.rttMaxUs;
+    }
+    out.sent        += s.sent;
+    out.acked       += s.acked;
+    out.rejected    += s.rejected;
+    out.retransmits += s.retransmits;
+    out.timeouts    += s.timeouts;
+    out.superseded  += s.superseded;
+    out.rttSumUs    += s.rttSumUs;
+  }
+  out.unmatchedAcks = s_unmatchedAcks;
+  out.rttLastUs     = s_lastRttUs;
+  portEXIT_CRITICAL(&s_cmdMux);
+}
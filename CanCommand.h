@@ -0,0 +1,98 @@
+#ifndef CAN_COMMAND_H
+#define CAN_COMMAND_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+// twai.h는 C 라이브러리이므로 extern "C"로 감싸야 합니다.
+extern "C" {
+  #include "driver/twai.h"
+}
+
+/**
+ * @file CanCommand.h
+ * @brief 모듈 명령의 전달 확인(seq + ACK), 재전송, 왕복 시간 통계를 선언합니다.
+ *
+ * taskCan이 송신 스케줄러에서 명령을 꺼낼 때 seq를 붙여 대기 표(in-flight)에 올리고,
+ * 모듈이 같은 seq로 ACK를 보내면 그때 명령의 효과(펌프/조명/LED 상태)를 g_state에 반영합니다.
+ * CAN_CMD_ACK_TIMEOUT_MS 안에 ACK가 없으면 같은 seq로 다시 보내므로 모듈은 seq로
+ * 중복을 걸러야 하며, CAN_CMD_MAX_RETRIES번을 넘기면 전달 실패로 집계하고 버립니다.
+ *
+ * 대기 표와 통계는 내부 스핀락으로 보호되지만, 송신/재전송 함수는 taskCan 전용입니다.
+ */
+
+/**
+ * @brief 대기 표에 새 명령을 올릴 자리가 있는지 확인합니다.
+ *
+ * 일반 명령에는 CAN_CMD_SAFETY_RESERVE개를 남겨 두므로, 응답 없는 모듈로 간 명령이 표를 채워도
+ * 우선 레인의 안전 명령(펌프 OFF)은 ACK나 시간 초과를 기다리지 않고 나갑니다.
+ * 자리가 없으면 taskCan은 그 레인에서 꺼내지 않습니다.
+ * @param safety 안전 명령용 자리(남겨 둔 자리 포함)를 보면 true
+ */
+bool canCmdHasRoom(bool safety);
+
+/**
+ * @brief 송신 스케줄러에서 꺼낸 명령에 seq를 붙이고 대기 표에 올립니다.
+ *
+ * 같은 설정 명령(예: 펌프)이 아직 ACK를 기다리고 있으면 이전 것은 대체(superseded)되어
+ * 늦게 온 ACK가 새 값 위에 이전 값을 덮어쓰지 않습니다.
+ * @param item 보낼 명령 (data[5]에 seq를 기록)
+ * @param nowUs 현재 시각 (micros())
+ */
+void canCmdTrack(CanTxItem &item, uint32_t nowUs);
+
+/**
+ * @brief ACK 시간이 지난 명령을 하나 찾습니다. (같은 seq로 다시 보낼 프레임)
+ *
+ * 재전송 횟수를 다 쓴 명령은 여기서 포기(timeouts)하고 다음 것을 찾습니다.
+ * 재전송 횟수는 canCmdRetransmitDone()이 실제로 넘긴 뒤에만 셉니다.
+ * @return 다시 보낼 명령이 있으면 true
+ */
+bool canCmdNextRetransmit(uint32_t nowUs, CanTxItem &out);
+
+/**
+ * @brief canCmdNextRetransmit()로 찾은 명령을 컨트롤러 TX 큐에 넘긴 결과를 기록합니다.
+ *
+ * 넘겼으면 재전송 한 번을 세고 다음 제한 시간을 잡습니다. 큐가 가득 차 못 넘겼으면
+ * 횟수는 그대로 두고 1ms 뒤(또는 TX 완료 알림 때) 다시 시도하게 합니다.
+ * @param item canCmdNextRetransmit()가 돌려준 명령
+ * @param sent twai_transmit() 성공 여부
+ */
+void canCmdRetransmitDone(const CanTxItem &item, bool sent, uint32_t nowUs);
+
+/**
+ * @brief 가장 이른 재전송 시각까지 남은 시간 (ms, 올림)을 돌려줍니다.
+ * @param maxMs 대기 중인 명령이 없거나 더 멀면 이 값
+ */
+uint32_t canCmdMsUntilDeadline(uint32_t nowUs, uint32_t maxMs);
+
+/**
+ * @brief 모듈이 보낸 명령 ACK 프레임인지 확인합니다.
+ */
+bool canCmdIsAck(const twai_message_t &msg);
+
+/**
+ * @brief ACK를 대기 중인 명령과 맞춰 보고, CAN_ACK_OK이면 명령의 효과를 st에 반영합니다.
+ *
+ * g_state에 쓸 때는 호출자가 쓰기 구간(stateWriteBegin/End)을 잡고 있어야 합니다.
+ * @param changed 효과를 반영했으면 해당 STATE_CHG_* 비트를 OR합니다. (nullptr 가능)
+ */
+void canCmdHandleAck(SystemState &st, const twai_message_t &msg, uint32_t nowUs,
+                     uint32_t *changed = nullptr);
+
+/**
+ * @brief 명령 종류별 전달 통계를 번호 순서로 복사합니다. (내보내기용)
+ *
+ * 효과 표의 명령 다음, 마지막 번호는 표에 없는 명령(서버가 직접 보낸 기타 명령)의 묶음이며
+ * 이때 moduleId/cmd는 0xFF입니다.
+ * @return 번호가 범위 밖이면 false
+ */
+bool getCanCmdKindStats(size_t index, uint8_t &moduleId, uint8_t &cmd, CanCmdStats &out);
+
+/**
+ * @brief 모든 명령을 합친 전달 통계를 복사합니다.
+ */
+void getCanCmdTotals(CanCmdStats &out);
+
+
+#endif // CAN_COMMAND_H
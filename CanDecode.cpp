@@ -0,0 +1,255 @@
+#include "Globals.h"
+#include "CanDecode.h"
+
+#include <stddef.h>
+
+/**
+ * @file CanDecode.cpp
+ * @brief 표 기반 CAN 상태 프레임 디코더의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 필드 / 메시지 기술자
+//------------------------------------------------------------------------------
+
+enum CanFieldType : uint8_t {
+  CF_U8_F32,    // data[byte] (uint8) * scale → float
+  CF_U16_F32,   // data[byte..byte+1] (uint16 LE) * scale → float
+  CF_I16_F32,   // data[byte..byte+1] (int16 LE) * scale → float
+  CF_U8_U8,     // data[byte] (uint8) → uint8_t
+  CF_U32_U32,   // data[byte..byte+3] (uint32 LE) → uint32_t
+  CF_BIT_BOOL,  // data[byte]의 bit번째 비트 → bool
+};
+
+/**
+ * @brief 페이로드 필드 하나: data[byte]부터 읽어 SystemState의 offset 위치에 씁니다.
+ */
+struct CanFieldDesc {
+  uint16_t offset;
+  uint8_t  type;
+  uint8_t  byte;
+  uint8_t  bit;
+  float    scale;
+};
+
+/**
+ * @brief CAN ID 하나의 페이로드 형식: kCanFields[first] ~ [first + count - 1]
+ *  - statusOffset / updateOffset : 수신 시 MODULE_OK / now로 갱신할 모듈 필드
+ *  - changeBit : 값이 실제로 바뀌었을 때 알릴 상태 변경 비트 (STATE_CHG_*)
+ */
+struct CanMsgDesc {
+  uint32_t canId;
+  uint8_t  minDlc;
+  uint16_t statusOffset;
+  uint16_t updateOffset;
+  uint8_t  first;
+  uint8_t  count;
+  uint32_t changeBit;
+};
+
+#define CD_AT(member) (uint16_t)offsetof(SystemState, member)
+
+constexpr CanFieldDesc kCanFields[] = {
+  // [0] 0x010 수조 v1: temp(0), level(1), pH(2)/10, TDS(3)*10, turbidity(4), DO(5)/10
+  { CD_AT(tank.tempC),                 CF_U8_F32,   0, 0, 1.0f   },
+  { CD_AT(tank.levelPercent),          CF_U8_F32,   1, 0, 1.0f   },
+  { CD_AT(tank.pH),                    CF_U8_F32,   2, 0, 0.1f   },
+  { CD_AT(tank.tds),                   CF_U8_F32,   3, 0, 10.0f  },
+  { CD_AT(tank.turbidity),             CF_U8_F32,   4, 0, 1.0f   },
+  { CD_AT(tank.do_mgL),                CF_U8_F32,   5, 0, 0.1f   },
+
+  // [6] 0x011 수조 v2 (고해상도): temp(0-1)/100, pH(2-3)/100, TDS(4-5), level(6)/2, DO(7)/10
+  { CD_AT(tank.tempC),                 CF_I16_F32,  0, 0, 0.01f  },
+  { CD_AT(tank.pH),                    CF_U16_F32,  2, 0, 0.01f  },
+  { CD_AT(tank.tds),                   CF_U16_F32,  4, 0, 1.0f   },
+  { CD_AT(tank.levelPercent),          CF_U8_F32,   6, 0, 0.5f   },
+  { CD_AT(tank.do_mgL),                CF_U8_F32,   7, 0, 0.1f   },
+
+  // [11] 0x020 재배기: temp(0), humidity(1), leak 비트(2: bit0~3)
+  { CD_AT(grow.tempC),                 CF_U8_F32,   0, 0, 1.0f   },
+  { CD_AT(grow.humidity),              CF_U8_F32,   1, 0, 1.0f   },
+  { CD_AT(grow.leak[0]),               CF_BIT_BOOL, 2, 0, 1.0f   },
+  { CD_AT(grow.leak[1]),               CF_BIT_BOOL, 2, 1, 1.0f   },
+  { CD_AT(grow.leak[2]),               CF_BIT_BOOL, 2, 2, 1.0f   },
+  { CD_AT(grow.leak[3]),               CF_BIT_BOOL, 2, 3, 1.0f   },
+
+  // [17] 0x030 양액기: 채널 비율(0~3) %, 모터 비트(4: bit0~3), 잔량(5) %
+  { CD_AT(nutrient.channelRatio[0]),   CF_U8_F32,   0, 0, 1.0f   },
+  { CD_AT(nutrient.channelRatio[1]),   CF_U8_F32,   1, 0, 1.0f   },
+  { CD_AT(nutrient.channelRatio[2]),   CF_U8_F32,   2, 0, 1.0f   },
+  { CD_AT(nutrient.channelRatio[3]),   CF_U8_F32,   3, 0, 1.0f   },
+  { CD_AT(nutrient.channelMotorOn[0]), CF_BIT_BOOL, 4, 0, 1.0f   },
+  { CD_AT(nutrient.channelMotorOn[1]), CF_BIT_BOOL, 4, 1, 1.0f   },
+  { CD_AT(nutrient.channelMotorOn[2]), CF_BIT_BOOL, 4, 2, 1.0f   },
+  { CD_AT(nutrient.channelMotorOn[3]), CF_BIT_BOOL, 4, 3, 1.0f   },
+  { CD_AT(nutrient.levelPercent),      CF_U8_F32,   5, 0, 1.0f   },
+
+  // [26] 0x040 급여기: 잔량(0) %, 급여 중(1: bit0), 마지막 급여 시각(2-5, LE)
+  { CD_AT(feeder.feedLevelPercent),    CF_U8_F32,   0, 0, 1.0f   },
+  { CD_AT(feeder.feedingNow),          CF_BIT_BOOL, 1, 0, 1.0f   },
+  { CD_AT(feeder.lastFeedTime),        CF_U32_U32,  2, 0, 1.0f   },
+};
+
+constexpr CanMsgDesc kCanMessages[] = {
+  { 0x010, 6, CD_AT(tank.status),     CD_AT(tank.lastUpdateMs),      0, 6, STATE_CHG_TANK     },
+  { 0x011, 8, CD_AT(tank.status),     CD_AT(tank.lastUpdateMs),      6, 5, STATE_CHG_TANK     },
+  { 0x020, 3, CD_AT(grow.status),     CD_AT(grow.lastUpdateMs),     11, 6, STATE_CHG_GROW     },
+  { 0x030, 6, CD_AT(nutrient.status), CD_AT(nutrient.lastUpdateMs), 17, 9, STATE_CHG_NUTRIENT },
+  { 0x040, 6, CD_AT(feeder.status),   CD_AT(feeder.lastUpdateMs),   26, 3, STATE_CHG_FEEDER   },
+};
+
+constexpr size_t kCanFieldCount   = sizeof(kCanFields) / sizeof(kCanFields[0]);
+constexpr size_t kCanMessageCount = sizeof(kCanMessages) / sizeof(kCanMessages[0]);
+
+
+//------------------------------------------------------------------------------
+// 컴파일 타임 검증 / 직접 인덱스 표
+//------------------------------------------------------------------------------
+
+// 상태 프레임 ID의 하위 8비트로 바로 인덱싱합니다. (ID 0x000~0x0FF)
+constexpr uint32_t kCanSlotCount = 256;
+constexpr uint8_t  kNoSlot       = 0xFF;
+
+constexpr size_t fieldWidth(uint8_t type) {
+  return type == CF_U16_F32 || type == CF_I16_F32 ? 2 :
+         type == CF_U32_U32                       ? 4 : 1;
+}
+
+// 메시지 m의 필드가 모두 minDlc 안에 들어가는지 (i: 검사할 필드 순번)
+constexpr bool fieldsFit(const CanMsgDesc &m, size_t i = 0) {
+  return i == m.count ||
+         (kCanFields[m.first + i].byte + fieldWidth(kCanFields[m.first + i].type) <= m.minDlc &&
+          fieldsFit(m, i + 1));
+}
+
+constexpr bool messagesValid(size_t i = 0) {
+  return i == kCanMessageCount ||
+         (kCanMessages[i].canId < kCanSlotCount &&
+          kCanMessages[i].minDlc <= TWAI_FRAME_MAX_DLC &&
+          kCanMessages[i].first + kCanMessages[i].count <= kCanFieldCount &&
+          fieldsFit(kCanMessages[i]) &&
+          messagesValid(i + 1));
+}
+
+constexpr bool idsUnique(size_t i = 0, size_t j = 1) {
+  return i + 1 >= kCanMessageCount ? true :
+         j == kCanMessageCount     ? idsUnique(i + 1, i + 2) :
+         kCanMessages[i].canId != kCanMessages[j].canId && idsUnique(i, j + 1);
+}
+
+static_assert(kCanMessageCount < kNoSlot, "too many CAN status messages");
+static_assert(messagesValid(), "CAN decode table: ID out of range or field beyond minDlc");
+static_assert(idsUnique(), "CAN decode table: duplicate CAN ID");
+
+constexpr uint8_t findSlot(uint32_t id, size_t i = 0) {
+  return i == kCanMessageCount          ? kNoSlot :
+         kCanMessages[i].canId == id    ? (uint8_t)i :
+                                          findSlot(id, i + 1);
+}
+
+template <size_t... I> struct IndexSeq {};
+template <size_t N, size_t... I> struct MakeIndexSeq : MakeIndexSeq<N - 1, N - 1, I...> {};
+template <size_t... I> struct MakeIndexSeq<0, I...> { typedef IndexSeq<I...> type; };
+
+struct CanSlotTable {
+  uint8_t slot[kCanSlotCount];
+};
+
+template <size_t... I>
+constexpr CanSlotTable buildSlotTable(IndexSeq<I...>) {
+  return CanSlotTable{ { findSlot(I)... } };
+}
+
+constexpr CanSlotTable kCanSlots = buildSlotTable(MakeIndexSeq<kCanSlotCount>::type());
+
+
+//------------------------------------------------------------------------------
+// 디코딩
+//------------------------------------------------------------------------------
+// 표는 constexpr이므로 메시지마다 디코더 함수를 템플릿으로 찍어내면 필드 형식/위치/배율이
+// 모두 상수로 접혀, 손으로 쓴 switch와 같은 코드가 됩니다. (표 항목만 추가하면 됨)
+
+inline uint16_t readU16(const uint8_t *d) { return (uint16_t)(d[0] | (d[1] << 8)); }
+inline uint32_t readU32(const uint8_t *d) {
+  return (uint32_t)d[0] | ((uint32_t)d[1] << 8) | ((uint32_t)d[2] << 16) | ((uint32_t)d[3] << 24);
+}
+
+// 값이 바뀐 경우에만 쓰고 true를 돌려줍니다. (화면 갱신 알림 판단용)
+template <typename T>
+inline bool store(uint8_t *dst, T v) {
+  if (*(T *)dst == v) return false;
+  *(T *)dst = v;
+  return true;
+}
+
+template <size_t F>
+inline bool applyField(uint8_t *base, const uint8_t *data) {
+  const uint8_t *d = data + kCanFields[F].byte;
+  uint8_t *dst = base + kCanFields[F].offset;
+  const float scale = kCanFields[F].scale;
+
+  switch (kCanFields[F].type) {
+    case CF_U8_F32:   return store<float>(dst, d[0] * scale);
+    case CF_U16_F32:  return store<float>(dst, readU16(d) * scale);
+    case CF_I16_F32:  return store<float>(dst, (int16_t)readU16(d) * scale);
+    case CF_U8_U8:    return store<uint8_t>(dst, d[0]);
+    case CF_U32_U32:  return store<uint32_t>(dst, readU32(d));
+    case CF_BIT_BOOL: return store<bool>(dst, (d[0] >> kCanFields[F].bit) & 0x01);
+  }
+  return false;
+}
+
+template <size_t F, size_t N>
+struct FieldRun {
+  static inline bool apply(uint8_t *base, const uint8_t *data) {
+    bool changed = applyField<F>(base, data);
+    return FieldRun<F + 1, N - 1>::apply(base, data) | changed;
+  }
+};
+
+template <size_t F>
+struct FieldRun<F, 0> {
+  static inline bool apply(uint8_t *, const uint8_t *) { return false; }
+};
+
+template <size_t M>
+bool decodeMessage(uint8_t *base, const uint8_t *data) {
+  return FieldRun<kCanMessages[M].first, kCanMessages[M].count>::apply(base, data);
+}
+
+typedef bool (*CanMsgDecoder)(uint8_t *base, const uint8_t *data);
+
+struct CanDecoderTable {
+  CanMsgDecoder fn[kCanMessageCount];
+};
+
+template <size_t... I>
+constexpr CanDecoderTable buildDecoderTable(IndexSeq<I...>) {
+  return CanDecoderTable{ { &decodeMessage<I>... } };
+}
+
+constexpr CanDecoderTable kCanDecoders = buildDecoderTable(MakeIndexSeq<kCanMessageCount>::type());
+
+} // namespace
+
+CanDecodeResult canDecodeFrame(SystemState &st, const twai_message_t &msg, uint32_t now,
+                               uint32_t *changed) {
+  uint32_t id = msg.identifier;
+  if (id >= kCanSlotCount || msg.extd) return CAN_DECODE_UNKNOWN_ID;
+
+  uint8_t slot = kCanSlots.slot[id];
+  if (slot == kNoSlot) return CAN_DECODE_UNKNOWN_ID;
+
+  const CanMsgDesc &m = kCanMessages[slot];
+  if (msg.data_length_code < m.minDlc) return CAN_DECODE_SHORT_FRAME;
+
+  uint8_t *base = (uint8_t *)&st;
+  bool dirty = kCanDecoders.fn[slot](base, msg.data);
+  dirty |= store<ModuleStatus>(base + m.statusOffset, MODULE_OK);
+  *(uint32_t *)(base + m.updateOffset) = now;
+
+  if (dirty && changed) *changed |= m.changeBit;
+  return CAN_DECODE_OK;
+}
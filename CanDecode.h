@@ -0,0 +1,42 @@
+#ifndef CAN_DECODE_H
+#define CAN_DECODE_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+// twai.h는 C 라이브러리이므로 extern "C"로 감싸야 합니다.
+extern "C" {
+  #include "driver/twai.h"
+}
+
+/**
+ * @file CanDecode.h
+ * @brief 모듈 상태 CAN 프레임을 SystemState로 옮기는 표 기반 디코더를 선언합니다.
+ *
+ * CAN ID별 페이로드 형식(바이트 위치, 폭, 배율, 대상 필드)은 CanDecode.cpp의
+ * constexpr 표에 있습니다. 새 모듈이나 새 페이로드 버전은 표에 항목을 추가하면 되며,
+ * 조회는 ID 하위 비트로 바로 인덱싱하므로 항목 수와 무관하게 일정한 비용입니다.
+ */
+
+/**
+ * @brief 프레임 하나를 디코딩한 결과
+ */
+enum CanDecodeResult : uint8_t {
+  CAN_DECODE_OK          = 0,  // 상태에 반영함
+  CAN_DECODE_UNKNOWN_ID  = 1,  // 표에 없는 ID (무시)
+  CAN_DECODE_SHORT_FRAME = 2,  // DLC가 형식보다 짧음 (무시)
+};
+
+/**
+ * @brief 수신 프레임을 표에 따라 st에 반영합니다.
+ *
+ * 대상 모듈의 status를 MODULE_OK로, lastUpdateMs를 now로 갱신합니다.
+ * g_state에 쓸 때는 호출자가 쓰기 구간(stateWriteBegin/End)을 잡고 있어야 합니다.
+ * @param changed 표시되는 값(lastUpdateMs 제외)이 실제로 바뀌었으면 해당 모듈의
+ *                STATE_CHG_* 비트를 OR합니다. (nullptr 가능)
+ */
+CanDecodeResult canDecodeFrame(SystemState &st, const twai_message_t &msg, uint32_t now,
+                               uint32_t *changed = nullptr);
+
+
+#endif // CAN_DECODE_H
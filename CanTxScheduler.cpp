@@ -0,0 +1,194 @@
+#include "Globals.h"
+#include "CanTxScheduler.h"
+#include "Trace.h"
+
+/**
+ * @file CanTxScheduler.cpp
+ * @brief CAN 명령 송신 스케줄러(합치기 + 우선 레인)의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 명령별 송신 정책
+//------------------------------------------------------------------------------
+
+enum CanCmdPolicyFlag : uint8_t {
+  TXP_COALESCE        = 0x01,  // 설정형: 대기 중인 같은 명령은 최신 값으로 덮어씀
+  TXP_SAFETY          = 0x02,  // 항상 우선 레인
+  TXP_SAFETY_WHEN_OFF = 0x04,  // 파라미터가 0(OFF)일 때만 우선 레인
+};
+
+struct CanCmdPolicy {
+  uint8_t moduleId;
+  uint8_t cmd;
+  uint8_t flags;
+};
+
+// 표에 없는 명령은 합치지 않고 일반 레인으로 보냅니다. (예: FEEDER_CMD_FEED_ONCE)
+const CanCmdPolicy kCmdPolicies[] = {
+  { MODULE_TANK, TANK_CMD_SET_PUMP,           TXP_COALESCE | TXP_SAFETY_WHEN_OFF },
+  { MODULE_TANK, TANK_CMD_SET_LIGHT,          TXP_COALESCE },
+  { MODULE_GROW, GROW_CMD_SET_LED_BRIGHTNESS, TXP_COALESCE },
+};
+
+const size_t kPolicyCount = sizeof(kCmdPolicies) / sizeof(kCmdPolicies[0]);
+
+int findPolicy(uint8_t moduleId, uint8_t cmd) {
+  for (size_t i = 0; i < kPolicyCount; ++i) {
+    if (kCmdPolicies[i].moduleId == moduleId && kCmdPolicies[i].cmd == cmd) return (int)i;
+  }
+  return -1;
+}
+
+
+//------------------------------------------------------------------------------
+// 대기열: 고정 슬롯 풀 + 레인별 단방향 연결 리스트
+//------------------------------------------------------------------------------
+
+enum CanTxLane : uint8_t {
+  LANE_SAFETY  = 0,
+  LANE_ROUTINE = 1,
+  LANE_COUNT   = 2,
+};
+
+const int8_t kNone = -1;
+
+struct TxSlot {
+  CanTxItem item;
+  int8_t    policy;   // 합치기 키 (kCmdPolicies 인덱스, 합치지 않으면 kNone)
+  uint8_t   lane;
+  int8_t    next;
+};
+
+struct TxLaneList {
+  int8_t  head;
+  int8_t  tail;
+  uint8_t count;
+};
+
+static_assert(CAN_TX_SLOTS < 127, "slot index must fit in int8_t");
+static_assert(CAN_TX_SAFETY_RESERVE < CAN_TX_SLOTS, "routine lane needs at least one slot");
+
+portMUX_TYPE s_txMux = portMUX_INITIALIZER_UNLOCKED;
+
+TxSlot     s_slots[CAN_TX_SLOTS];
+TxLaneList s_lanes[LANE_COUNT] = { { kNone, kNone, 0 }, { kNone, kNone, 0 } };
+int8_t     s_freeHead   = kNone;
+bool       s_poolReady  = false;
+int8_t     s_pendingByPolicy[kPolicyCount];  // 합치기 키 → 대기 중인 슬롯
+CanTxStats s_txStats = {};
+
+// 아래 함수들은 모두 s_txMux를 잡은 상태에서 호출합니다.
+
+void initPool() {
+  for (size_t i = 0; i < CAN_TX_SLOTS; ++i) {
+    s_slots[i].next = (i + 1 < CAN_TX_SLOTS) ? (int8_t)(i + 1) : kNone;
+  }
+  s_freeHead = 0;
+  for (size_t i = 0; i < kPolicyCount; ++i) s_pendingByPolicy[i] = kNone;
+  s_poolReady = true;
+}
+
+void laneAppend(uint8_t lane, int8_t idx) {
+  TxLaneList &l = s_lanes[lane];
+  s_slots[idx].lane = lane;
+  s_slots[idx].next = kNone;
+  if (l.tail == kNone) l.head = idx;
+  else s_slots[l.tail].next = idx;
+  l.tail = idx;
+  l.count++;
+}
+
+void laneRemove(uint8_t lane, int8_t idx) {
+  TxLaneList &l = s_lanes[lane];
+  int8_t prev = kNone;
+  for (int8_t cur = l.head; cur != kNone; prev = cur, cur = s_slots[cur].next) {
+    if (cur != idx) continue;
+    if (prev == kNone) l.head = s_slots[cur].next;
+    else s_slots[prev].next = s_slots[cur].next;
+    if (l.tail == cur) l.tail = prev;
+    l.count--;
+    return;
+  }
+}
+
+} // namespace
+
+CanTxSubmitResult canTxSubmit(uint8_t moduleId, uint8_t cmd, int32_t param, const CanTxItem &item) {
+  int policy = findPolicy(moduleId, cmd);
+  uint8_t flags = policy >= 0 ? kCmdPolicies[policy].flags : 0;
+  bool safety = (flags & TXP_SAFETY) || ((flags & TXP_SAFETY_WHEN_OFF) && param == 0);
+  bool coalesce = (flags & TXP_COALESCE) != 0;
+
+  CanTxSubmitResult result;
+  uint16_t replacedTrace = 0;
+
+  portENTER_CRITICAL(&s_txMux);
+  if (!s_poolReady) initPool();
+  s_txStats.submitted++;
+  if (safety) s_txStats.safety++;
+
+  int8_t pending = coalesce ? s_pendingByPolicy[policy] : kNone;
+  if (pending != kNone) {
+    // 아직 나가지 않은 같은 설정 명령: 자리는 그대로 두고 값만 최신으로
+    replacedTrace = s_slots[pending].item.traceId;
+    s_slots[pending].item = item;
+    // 레인은 덮어쓴 최신 값 기준 (펌프 OFF 위에 ON이 오면 일반 레인 뒤로)
+    uint8_t lane = safety ? LANE_SAFETY : LANE_ROUTINE;
+    if (s_slots[pending].lane != lane) {
+      laneRemove(s_slots[pending].lane, pending);
+      laneAppend(lane, pending);
+    }
+    s_txStats.coalesced++;
+    result = CAN_TX_COALESCED;
+  } else if (s_freeHead == kNone ||
+             (!safety && s_lanes[LANE_ROUTINE].count >= CAN_TX_SLOTS - CAN_TX_SAFETY_RESERVE)) {
+    s_txStats.dropped++;
+    result = CAN_TX_FULL;
+  } else {
+    int8_t idx = s_freeHead;
+    s_freeHead = s_slots[idx].next;
+    s_slots[idx].item = item;
+    s_slots[idx].policy = coalesce ? (int8_t)policy : kNone;
+    laneAppend(safety ? LANE_SAFETY : LANE_ROUTINE, idx);
+    if (coalesce) s_pendingByPolicy[policy] = idx;
+
+    uint32_t depth = s_lanes[LANE_SAFETY].count + s_lanes[LANE_ROUTINE].count;
+    if (depth > s_txStats.highWater) s_txStats.highWater = depth;
+    result = CAN_TX_QUEUED;
+  }
+  portEXIT_CRITICAL(&s_txMux);
+
+  traceFlag(replacedTrace, TRACE_FLAG_COALESCED);
+  return result;
+}
+
+bool canTxTake(CanTxItem &out, bool includeRoutine) {
+  bool got = false;
+  uint8_t lanes = includeRoutine ? LANE_COUNT : LANE_SAFETY + 1;
+
+  portENTER_CRITICAL(&s_txMux);
+  for (uint8_t lane = 0; lane < lanes && !got; ++lane) {
+    int8_t idx = s_lanes[lane].head;
+    if (idx == kNone) continue;
+
+    laneRemove(lane, idx);
+    out = s_slots[idx].item;
+    // 꺼낸 뒤 들어오는 같은 명령은 새 항목이 되어 이 프레임 뒤에 나갑니다.
+    if (s_slots[idx].policy != kNone) s_pendingByPolicy[s_slots[idx].policy] = kNone;
+    s_slots[idx].next = s_freeHead;
+    s_freeHead = idx;
+    s_txStats.taken++;
+    got = true;
+  }
+  portEXIT_CRITICAL(&s_txMux);
+
+  return got;
+}
+
+void getCanTxStats(CanTxStats &out) {
+  portENTER_CRITICAL(&s_txMux);
+  out = s_txStats;
+  portEXIT_CRITICAL(&s_txMux);
+}
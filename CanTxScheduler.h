@@ -0,0 +1,51 @@
+#ifndef CAN_TX_SCHEDULER_H
+#define CAN_TX_SCHEDULER_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file CanTxScheduler.h
+ * @brief 모듈로 보내는 CAN 명령의 송신 대기열(스케줄러)을 선언합니다.
+ *
+ * - 합치기: 설정형 명령(예: LED 밝기)은 같은 (모듈, 명령)이 아직 대기 중이면
+ *   새 항목을 만들지 않고 값만 최신으로 바꿉니다. 1회 동작 명령(급여)은 합치지 않습니다.
+ * - 우선 레인: 안전 명령(예: 펌프 OFF)은 일반 명령보다 먼저 나가며,
+ *   일반 명령으로 대기열이 가득 차도 CAN_TX_SAFETY_RESERVE개의 자리는 남아 있습니다.
+ *   합쳐진 항목의 레인은 마지막 값으로 정합니다. (대기 중인 펌프 OFF가 ON으로 바뀌면 일반 레인으로)
+ *
+ * 생산자(UI/UART/로직 태스크)는 여럿이고 소비자는 taskCan 하나입니다.
+ */
+
+/**
+ * @brief canTxSubmit() 결과
+ */
+enum CanTxSubmitResult : uint8_t {
+  CAN_TX_QUEUED    = 0,  // 새 항목으로 대기열에 들어감
+  CAN_TX_COALESCED = 1,  // 대기 중인 같은 명령의 값을 덮어씀
+  CAN_TX_FULL      = 2,  // 자리가 없어 버림
+};
+
+/**
+ * @brief 명령을 송신 대기열에 넣습니다.
+ * @param moduleId 대상 모듈 ID (합치기/우선순위 판단용)
+ * @param cmd 명령 코드
+ * @param param 파라미터
+ * @param item 실제로 보낼 CAN 프레임
+ */
+CanTxSubmitResult canTxSubmit(uint8_t moduleId, uint8_t cmd, int32_t param, const CanTxItem &item);
+
+/**
+ * @brief 다음에 보낼 명령을 꺼냅니다. 우선 레인이 먼저입니다. (taskCan 전용)
+ * @param includeRoutine false면 우선 레인만 봅니다 (ACK 대기 표에 남겨 둔 자리만 있을 때)
+ * @return 꺼냈으면 true, 볼 레인이 비었으면 false
+ */
+bool canTxTake(CanTxItem &out, bool includeRoutine);
+
+/**
+ * @brief 송신 스케줄러 통계를 복사합니다.
+ */
+void getCanTxStats(CanTxStats &out);
+
+
+#endif // CAN_TX_SCHEDULER_H
@@ -1,5 +1,20 @@
 #include "Globals.h"
 #include "Communication.h"
+#include "Telemetry.h"
+#include "Protocol.h"
+#include "StateStore.h"
+#include "CanDecode.h"
+#include "CanTxScheduler.h"
+#include "CanCommand.h"
+#include "EventLog.h"
+#include "FlashLog.h"
+#include "History.h"
+#include "Schedule.h"
+#include "Rules.h"
+#include "Profile.h"
+#include "Trace.h"
+
+#include <atomic>
 
 /**
  * @file Communication.cpp
@@ -12,62 +27,154 @@
 //==============================================================================
 
 void enqueueCanCommand(uint8_t moduleId, uint8_t cmd, int32_t param) {
+  enqueueCanCommand(moduleId, cmd, param, 0);
+}
+
+void enqueueCanCommand(uint8_t moduleId, uint8_t cmd, int32_t param, uint16_t traceId) {
   CanTxItem item;
-  // 예시 CAN ID: 0x100 | moduleId
-  item.canId = 0x100 | moduleId;
+  item.canId = CAN_ID_CMD_BASE | moduleId;
   item.dlc   = 8;
   item.data[0] = cmd;
   item.data[1] = (param >> 24) & 0xFF;
   item.data[2] = (param >> 16) & 0xFF;
   item.data[3] = (param >>  8) & 0xFF;
   item.data[4] = (param      ) & 0xFF;
-  item.data[5] = 0;
+  item.data[5] = 0;  // seq: taskCan이 실제로 보낼 때 붙임 (canCmdTrack)
   item.data[6] = 0;
   item.data[7] = 0;
+  item.traceId = traceId;
+
+  if (canTxSubmit(moduleId, cmd, param, item) == CAN_TX_FULL) {
+    traceFlag(traceId, TRACE_FLAG_DROPPED);
+    return;
+  }
+  traceStamp(traceId, TRACE_STAGE_CAN_QUEUED);
+  if (g_taskCanHandle) {
+    xTaskNotify(g_taskCanHandle, CAN_NOTIFY_TX_QUEUED, eSetBits);
+  }
+}
+
+namespace {
+
+// 디코딩할 수 없어 버린 프레임 수 (쓰기 구간 안에서만 증가)
+std::atomic<uint32_t> s_canRxUnknownId{0};
+std::atomic<uint32_t> s_canRxShortFrame{0};
 
-  if (g_canTxQueue) {
-    xQueueSend(g_canTxQueue, &item, 0);
+// 수신 프레임 하나를 g_state에 반영합니다. 호출자가 쓰기 구간을 잡고 있어야 합니다.
+// 값이 바뀐 부분은 changed에 STATE_CHG_* 비트로 모읍니다.
+void applyCanFrame(const twai_message_t &msg, uint32_t now, uint32_t &changed) {
+  if (canCmdIsAck(msg)) {
+    canCmdHandleAck(g_state, msg, micros(), &changed);
+    return;
+  }
+
+  switch (canDecodeFrame(g_state, msg, now, &changed)) {
+    case CAN_DECODE_UNKNOWN_ID:
+      s_canRxUnknownId.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case CAN_DECODE_SHORT_FRAME:
+      s_canRxShortFrame.fetch_add(1, std::memory_order_relaxed);
+      break;
+    default:
+      break;
   }
 }
 
+//------------------------------------------------------------------------------
+// CAN 수신 스테이징 링 (단일 생산자 / 단일 소비자, 락 없음)
+//------------------------------------------------------------------------------
+static_assert((CAN_RX_RING_SIZE & (CAN_RX_RING_SIZE - 1)) == 0,
+              "CAN_RX_RING_SIZE must be a power of two");
+
+twai_message_t        s_canRxRing[CAN_RX_RING_SIZE];
+std::atomic<uint32_t> s_canRxHead{0};  // 생산자만 증가 (다음에 쓸 위치)
+std::atomic<uint32_t> s_canRxTail{0};  // 소비자만 증가 (다음에 읽을 위치)
+
+// 통계: 각 카운터는 한 쪽(생산자 또는 소비자)만 갱신합니다.
+std::atomic<uint32_t> s_canRxOverflow{0};
+std::atomic<uint32_t> s_canRxHighWater{0};
+std::atomic<uint32_t> s_canRxApplied{0};
+std::atomic<uint32_t> s_canRxBatches{0};
+std::atomic<uint32_t> s_canRxDriverMissed{0};
+
+} // namespace
+
 void handleCanFrame(const twai_message_t &msg) {
-  uint32_t id = msg.identifier;
-
-  if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-    uint32_t now = millis();
-
-    switch (id) {
-      case 0x010: { // 예: 수조 모듈 상태
-        g_state.tank.status = MODULE_OK;
-        // payload 예시: temp(0), level(1), pH(2), TDS(3), turbidity(4), DO(5)
-        // 실제 포맷에 맞게 디코딩 필요
-        g_state.tank.tempC        = msg.data[0];
-        g_state.tank.levelPercent = msg.data[1];
-        g_state.tank.pH           = msg.data[2] / 10.0;
-        g_state.tank.tds          = msg.data[3] * 10;
-        g_state.tank.turbidity    = msg.data[4];
-        g_state.tank.do_mgL       = msg.data[5] / 10.0;
-        g_state.tank.lastUpdateMs = now;
-        break;
-      }
-      case 0x020: { // 재배기 모듈 상태
-        g_state.grow.status     = MODULE_OK;
-        g_state.grow.tempC      = msg.data[0];
-        g_state.grow.humidity   = msg.data[1];
-        g_state.grow.leak[0]    = msg.data[2] & 0x01;
-        g_state.grow.leak[1]    = msg.data[2] & 0x02;
-        g_state.grow.leak[2]    = msg.data[2] & 0x04;
-        g_state.grow.leak[3]    = msg.data[2] & 0x08;
-        g_state.grow.lastUpdateMs = now;
-        break;
-      }
-      // TODO: 양액기(0x030), 급여기(0x040) 등 실제 CAN ID에 맞게 구현
-      default:
-        break;
-    }
+  uint32_t now = millis();
+
+  // 필드 대입만 하는 짧은 구간이므로 읽는 쪽(UI/UART)을 기다리지 않습니다.
+  uint32_t changed = 0;
+  stateWriteBegin();
+  applyCanFrame(msg, now, changed);
+  stateWriteEnd();
+  statePublishChanges(changed);
+}
+
+bool canRxPush(const twai_message_t &msg) {
+  uint32_t head = s_canRxHead.load(std::memory_order_relaxed);
+  uint32_t tail = s_canRxTail.load(std::memory_order_acquire);
+  uint32_t depth = head - tail;
 
-    xSemaphoreGive(g_stateMutex);
+  if (depth >= CAN_RX_RING_SIZE) {
+    s_canRxOverflow.fetch_add(1, std::memory_order_relaxed);
+    return false;
   }
+
+  s_canRxRing[head & (CAN_RX_RING_SIZE - 1)] = msg;
+  s_canRxHead.store(head + 1, std::memory_order_release);
+
+  if (depth + 1 > s_canRxHighWater.load(std::memory_order_relaxed)) {
+    s_canRxHighWater.store(depth + 1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+size_t canRxApplyPending(size_t maxFrames) {
+  if (maxFrames > CAN_RX_APPLY_BATCH) maxFrames = CAN_RX_APPLY_BATCH;
+
+  uint32_t tail = s_canRxTail.load(std::memory_order_relaxed);
+  uint32_t head = s_canRxHead.load(std::memory_order_acquire);
+  size_t n = head - tail;
+  if (n == 0) return 0;
+  if (n > maxFrames) n = maxFrames;
+
+  // 링 슬롯은 복사 후 바로 돌려주고, 쓰기 구간에서는 필드 대입만 합니다.
+  twai_message_t batch[CAN_RX_APPLY_BATCH];
+  for (size_t i = 0; i < n; ++i) {
+    batch[i] = s_canRxRing[(tail + i) & (CAN_RX_RING_SIZE - 1)];
+  }
+  s_canRxTail.store(tail + (uint32_t)n, std::memory_order_release);
+
+  uint32_t now = millis();
+  uint32_t changed = 0;
+  stateWriteBegin();
+  for (size_t i = 0; i < n; ++i) {
+    applyCanFrame(batch[i], now, changed);
+  }
+  stateWriteEnd();
+  statePublishChanges(changed);
+
+  s_canRxApplied.fetch_add((uint32_t)n, std::memory_order_relaxed);
+  s_canRxBatches.fetch_add(1, std::memory_order_relaxed);
+  return n;
+}
+
+void canRxPollDriverStats() {
+  twai_status_info_t info;
+  if (twai_get_status_info(&info) != ESP_OK) return;
+  s_canRxDriverMissed.store(info.rx_missed_count + info.rx_overrun_count,
+                            std::memory_order_relaxed);
+}
+
+void getCanRxStats(CanRxStats &out) {
+  out.received      = s_canRxHead.load(std::memory_order_relaxed);
+  out.applied       = s_canRxApplied.load(std::memory_order_relaxed);
+  out.batches       = s_canRxBatches.load(std::memory_order_relaxed);
+  out.overflowDrops = s_canRxOverflow.load(std::memory_order_relaxed);
+  out.driverMissed  = s_canRxDriverMissed.load(std::memory_order_relaxed);
+  out.highWater     = s_canRxHighWater.load(std::memory_order_relaxed);
+  out.unknownId     = s_canRxUnknownId.load(std::memory_order_relaxed);
+  out.shortFrame    = s_canRxShortFrame.load(std::memory_order_relaxed);
 }
 
 
@@ -75,26 +182,28 @@ void handleCanFrame(const twai_message_t &msg) {
 // 모듈 제어 요청 헬퍼 함수 구현
 //==============================================================================
 
+// 아래 요청은 명령을 보내기만 하며, 해당 상태(pumpOn 등)는 모듈의 ACK를 받았을 때 바뀝니다.
+
 void requestTankPump(bool on) {
   enqueueCanCommand(MODULE_TANK, TANK_CMD_SET_PUMP, on ? 1 : 0);
-  logEvent(on ? "Tank pump ON requested" : "Tank pump OFF requested");
+  logEvent(LOG_TANK_PUMP_REQ, on);
 }
 
 void requestTankLight(bool on) {
   enqueueCanCommand(MODULE_TANK, TANK_CMD_SET_LIGHT, on ? 1 : 0);
-  logEvent(on ? "Tank light ON requested" : "Tank light OFF requested");
+  logEvent(LOG_TANK_LIGHT_REQ, on);
 }
 
 void requestGrowLedBrightness(uint8_t brightness) {
   if (brightness > 100) brightness = 100;
   enqueueCanCommand(MODULE_GROW, GROW_CMD_SET_LED_BRIGHTNESS, (int32_t)brightness);
-  logEvent(("Grow LED brightness set to " + String(brightness) + "%" ).c_str());
+  logEvent(LOG_GROW_LED_SET, brightness);
 }
 
 void requestFeederOnce(uint8_t amountPercent) {
   if (amountPercent > 100) amountPercent = 100;
   enqueueCanCommand(MODULE_FEEDER, FEEDER_CMD_FEED_ONCE, (int32_t)amountPercent);
-  logEvent(("Feeder once, amount " + String(amountPercent) + "% requested" ).c_str());
+  logEvent(LOG_FEEDER_ONCE_REQ, amountPercent);
 }
 
 
@@ -102,8 +211,665 @@ void requestFeederOnce(uint8_t amountPercent) {
 // UART (서버) 통신 관련 함수 구현
 //==============================================================================
 
-String buildStatusJson() {
-  String s = "{";
+namespace {
+
+uint8_t s_txSeq = 0;  // 송신 프레임 시퀀스 번호 (taskUart 전용)
+
+// 텔레메트리 전송 상태 (모두 taskUart 전용)
+TelemetryMode s_telemetryMode      = TELEMETRY_MODE_FULL;
+uint32_t      s_keyframeIntervalMs = TELEMETRY_KEYFRAME_MS;
+bool          s_keyframeRequested  = true;
+uint32_t      s_lastTelemetryMs    = 0;
+uint32_t      s_lastKeyframeMs     = 0;
+SystemState   s_lastSent;          // 필드별 마지막 전송값 (델타 비교 기준)
+
+// 로그 내보내기 위치 (taskUart 전용): [s_logExportSeq, s_logExportEnd)
+uint32_t      s_logExportSeq = 0;
+uint32_t      s_logExportEnd = 0;
+
+// 플래시 보관 로그 내보내기 위치 (taskUart 전용): [s_flashExportPos, s_flashExportEnd)
+uint32_t      s_flashExportPos = 0;
+uint32_t      s_flashExportEnd = 0;
+bool          s_flashExporting = false;  // 끝 표시를 아직 안 보냄
+
+// 센서 이력 내보내기 (taskUart 전용): 칸 시작 시각 [s_histExportT, s_histExportEnd]
+HistoryChannel s_histExportCh   = HIST_TANK_TEMP;
+HistoryTier    s_histExportTier = HIST_TIER_RAW;
+uint32_t       s_histExportT    = 0;
+uint32_t       s_histExportEnd  = 0;
+bool           s_histExporting  = false;  // 끝 표시를 아직 안 보냄
+bool           s_histExportDone = false;  // 남은 칸 없음 → 다음 호출에서 끝 표시
+
+// 태스크 프로파일 내보내기 (taskUart 전용): 명령 시점의 복사본을 태스크 순서대로
+TaskProfile    s_profExport[PROF_TASK_COUNT];
+uint8_t        s_profExportNext = 0;
+bool           s_profExporting  = false;  // 끝 표시를 아직 안 보냄
+
+// 명령 추적 내보내기 (taskUart 전용): 명령 시점의 단계 요약, 그 뒤 [s_traceExportId, s_traceExportEnd) 레코드
+TraceStageStats s_traceExport[TRACE_STAGE_COUNT];
+uint8_t         s_traceExportStage = 0;
+uint16_t        s_traceExportId    = 0;
+uint16_t        s_traceExportEnd   = 0;
+bool            s_traceExporting   = false;  // 끝 표시를 아직 안 보냄
+
+// 모듈 명령 통계 내보내기 (taskUart 전용): 종류 번호 순서로, 보낼 때의 값
+size_t          s_canCmdExportNext = 0;
+bool            s_canCmdExporting  = false;  // 끝 표시를 아직 안 보냄
+
+// 서버로부터 유효한 메시지를 받았음을 기록합니다. (Fail-safe 판단 기준)
+void markServerRx() {
+  uint32_t now = millis();
+  stateWriteBegin();
+  bool reconnected = !g_state.serverConnected;
+  g_state.serverConnected = true;
+  g_state.lastServerRxMs  = now;
+  stateWriteEnd();
+  if (reconnected) statePublishChanges(STATE_CHG_SYSTEM);
+}
+
+void sendServerAck(uint8_t seq, uint8_t status) {
+  uint8_t payload[ACK_RECORD_LEN] = { seq, status };
+  uint8_t out[FRAME_HEADER_LEN + ACK_RECORD_LEN + FRAME_CRC_LEN + 2];
+  size_t n = buildFrame(FRAME_ACK, s_txSeq++, payload, sizeof(payload), out, sizeof(out));
+  if (n > 0) Serial2.write(out, n);
+}
+
+// 메인 컨트롤러 자체 명령 처리 (CAN으로 보내지 않음)
+void handleSystemCommand(const ServerCommand &cmd) {
+  switch (cmd.command) {
+    case SYS_CMD_PING:
+      break;
+    case SYS_CMD_SET_LINK_MODE:
+      setLinkMode(cmd.param == LINK_MODE_BINARY ? LINK_MODE_BINARY : LINK_MODE_TEXT);
+      break;
+    case SYS_CMD_SET_TELEMETRY_MODE:
+      setTelemetryMode(cmd.param == TELEMETRY_MODE_DELTA ? TELEMETRY_MODE_DELTA
+                                                         : TELEMETRY_MODE_FULL);
+      break;
+    case SYS_CMD_REQUEST_KEYFRAME:
+      requestTelemetryKeyframe();
+      break;
+    case SYS_CMD_SET_KEYFRAME_INTERVAL:
+      setTelemetryKeyframeInterval(cmd.param > 0 ? (uint32_t)cmd.param : 0);
+      break;
+    case SYS_CMD_EXPORT_LOG: {
+      // 요청 시점까지 기록된 것만 내보냄 (0: 남아 있는 전부)
+      s_logExportEnd = logNextSeq();
+      uint32_t count = s_logExportEnd - logFirstSeq();
+      if (cmd.param > 0 && (uint32_t)cmd.param < count) count = (uint32_t)cmd.param;
+      s_logExportSeq = s_logExportEnd - count;
+      break;
+    }
+    case SYS_CMD_EXPORT_FLASH_LOG: {
+      s_flashExportEnd = flashLogEndPos();
+      uint32_t count = s_flashExportEnd - flashLogStartPos();
+      if (cmd.param > 0 && (uint32_t)cmd.param < count) count = (uint32_t)cmd.param;
+      s_flashExportPos = s_flashExportEnd - count;
+      s_flashExporting = true;
+      break;
+    }
+    case SYS_CMD_EXPORT_HISTORY: {
+      uint32_t p     = (uint32_t)cmd.param;
+      uint8_t  ch    = (uint8_t)(p >> 24);
+      uint8_t  tier  = (uint8_t)(p >> 16);
+      uint32_t count = p & 0xFFFF;
+      uint32_t oldest, newest;
+      if (ch >= HIST_CHANNEL_COUNT || tier >= HIST_TIER_COUNT) {
+        logEvent(LOG_UNKNOWN_SYS_CMD, cmd.command);
+        break;
+      }
+      s_histExportCh   = (HistoryChannel)ch;
+      s_histExportTier = (HistoryTier)tier;
+      s_histExporting  = true;
+      s_histExportDone = !historyNewest(s_histExportTier, newest) ||
+                         !historyOldest(s_histExportTier, oldest);
+      if (s_histExportDone) break;
+      // 요청 시점까지의 칸만 내보냄 (0: 남아 있는 전부)
+      uint32_t period = historyPeriod(s_histExportTier);
+      s_histExportEnd = newest;
+      s_histExportT   = oldest;
+      if (count > 0 && (newest - oldest) / period + 1 > count) {
+        s_histExportT = newest - (count - 1) * period;
+      }
+      break;
+    }
+    case SYS_CMD_SET_TIME:
+      scheduleSetTime((uint32_t)cmd.param);
+      break;
+    case SYS_CMD_SCHEDULE_SET:
+    case SYS_CMD_SCHEDULE_ACTION:
+    case SYS_CMD_SCHEDULE_CLEAR:
+      if (!scheduleHandleCommand(cmd.command, (uint32_t)cmd.param)) {
+        logEvent(LOG_UNKNOWN_SYS_CMD, cmd.command);
+      }
+      break;
+    case SYS_CMD_EXPORT_PROFILE:
+      // 복사본을 떠서 내보내는 사이 바뀌지 않게 하고, 1이면 그 뒤 누적값을 초기화
+      for (uint8_t t = 0; t < PROF_TASK_COUNT; ++t) getTaskProfile((ProfileTask)t, s_profExport[t]);
+      s_profExportNext = 0;
+      s_profExporting  = true;
+      if (cmd.param == 1) profileReset();
+      break;
+    case SYS_CMD_EXPORT_TRACE: {
+      // 요약은 지금 계산해 두고, 레코드는 요청 시점까지의 최근 N개 (이 명령 자신은 제외)
+      for (uint8_t st = TRACE_STAGE_QUEUED; st < TRACE_STAGE_COUNT; ++st) {
+        traceStageStats((TraceStage)st, s_traceExport[st]);
+      }
+      uint32_t count = cmd.param > 0 ? (uint32_t)cmd.param : 0;
+      if (count > TRACE_RING_SIZE - 1) count = TRACE_RING_SIZE - 1;
+      s_traceExportEnd   = cmd.traceId;
+      s_traceExportId    = (uint16_t)(cmd.traceId - count);
+      s_traceExportStage = TRACE_STAGE_QUEUED;
+      s_traceExporting   = true;
+      break;
+    }
+    case SYS_CMD_EXPORT_CAN_CMD_STATS:
+      s_canCmdExportNext = 0;
+      s_canCmdExporting  = true;
+      break;
+    case SYS_CMD_RULE_CONDITION:
+    case SYS_CMD_RULE_HYSTERESIS:
+    case SYS_CMD_RULE_ACTION:
+    case SYS_CMD_RULE_CLEAR:
+      if (!rulesHandleCommand(cmd.command, (uint32_t)cmd.param)) {
+        logEvent(LOG_UNKNOWN_SYS_CMD, cmd.command);
+      }
+      break;
+    default:
+      logEvent(LOG_UNKNOWN_SYS_CMD, cmd.command);
+      break;
+  }
+}
+
+} // namespace
+
+size_t buildStatusJson(char *buf, size_t bufSize) {
+  SystemState snap;
+  if (!snapshotState(snap)) return 0;
+  return encodeStatusJson(snap, buf, bufSize);
+}
+
+size_t buildStatusFrame(uint8_t *buf, size_t bufSize) {
+  SystemState snap;
+  if (!snapshotState(snap)) return 0;
+
+  uint8_t record[TELEMETRY_RECORD_LEN];
+  size_t len = encodeStatusRecord(snap, millis(), record, sizeof(record));
+  if (len == 0) return 0;
+  return buildFrame(FRAME_TELEMETRY, s_txSeq++, record, len, buf, bufSize);
+}
+
+namespace {
+
+// 텍스트 모드 한 줄 끝에 줄바꿈을 붙입니다. 자리가 없으면 0
+size_t terminateLine(uint8_t *buf, size_t len, size_t bufSize) {
+  if (len == 0 || len + 2 > bufSize) return 0;
+  buf[len++] = '\r';
+  buf[len++] = '\n';
+  return len;
+}
+
+// 내보내기 끝 표시: 진행 표시를 내리고 빈 프레임(바이너리) / "<tag>,END" 한 줄(텍스트)을 기록합니다.
+size_t buildExportEnd(bool &active, FrameType type, const char *tag, uint8_t *buf, size_t bufSize) {
+  active = false;
+  if (g_linkMode == LINK_MODE_BINARY) return buildFrame(type, s_txSeq++, nullptr, 0, buf, bufSize);
+  size_t len = (size_t)snprintf((char *)buf, bufSize, "%s,END", tag);
+  return terminateLine(buf, len < bufSize ? len : 0, bufSize);
+}
+
+uint8_t *putLe16(uint8_t *p, uint16_t v) {
+  *p++ = (uint8_t)v;
+  *p++ = (uint8_t)(v >> 8);
+  return p;
+}
+
+uint8_t *putLe32(uint8_t *p, uint32_t v) {
+  for (int i = 0; i < 4; ++i) *p++ = (uint8_t)(v >> (8 * i));
+  return p;
+}
+
+// 로그 레코드를 FRAME_LOG payload(LOG_WIRE_RECORD_LEN, LE)로 기록합니다.
+uint8_t *putLogRecord(uint8_t *p, const LogRecord &rec) {
+  for (int i = 0; i < 4; ++i) *p++ = (uint8_t)(rec.seq >> (8 * i));
+  for (int i = 0; i < 4; ++i) *p++ = (uint8_t)(rec.ms >> (8 * i));
+  *p++ = (uint8_t)rec.code;
+  *p++ = (uint8_t)(rec.code >> 8);
+  for (size_t a = 0; a < LOG_RECORD_ARGS; ++a) {
+    for (int i = 0; i < 4; ++i) *p++ = (uint8_t)((uint32_t)rec.args[a] >> (8 * i));
+  }
+  return p;
+}
+
+// 델타 모드 한 번 분량을 현재 링크 형식으로 인코딩합니다.
+size_t encodeTelemetryDelta(const SystemState &snap, uint32_t mask, bool keyframe,
+                            uint32_t now, uint8_t *buf, size_t bufSize) {
+  if (g_linkMode == LINK_MODE_BINARY) {
+    uint8_t record[FRAME_MAX_PAYLOAD];
+    size_t len;
+    uint8_t type;
+    if (keyframe) {
+      len  = encodeStatusRecord(snap, now, record, sizeof(record));
+      type = FRAME_TELEMETRY;
+    } else {
+      len  = encodeStatusDeltaRecord(snap, mask, now, record, sizeof(record));
+      type = FRAME_TELEMETRY_DELTA;
+    }
+    if (len == 0) return 0;
+    return buildFrame(type, s_txSeq++, record, len, buf, bufSize);
+  }
+
+  size_t len = encodeStatusDeltaJson(snap, mask, keyframe, (char *)buf, bufSize);
+  return terminateLine(buf, len, bufSize);
+}
+
+} // namespace
+
+size_t buildTelemetryUpdate(uint8_t *buf, size_t bufSize, uint32_t now) {
+  if (s_telemetryMode == TELEMETRY_MODE_FULL) {
+    if (now - s_lastTelemetryMs < PERIOD_UART_TX_MS) return 0;
+    s_lastTelemetryMs = now;
+    if (g_linkMode == LINK_MODE_BINARY) return buildStatusFrame(buf, bufSize);
+    size_t len = buildStatusJson((char *)buf, bufSize);
+    return terminateLine(buf, len, bufSize);
+  }
+
+  if (now - s_lastTelemetryMs < TELEMETRY_DELTA_MIN_GAP_MS) return 0;
+
+  SystemState snap;
+  if (!snapshotState(snap)) return 0;
+
+  bool keyframe = s_keyframeRequested ||
+                  (s_keyframeIntervalMs > 0 && now - s_lastKeyframeMs >= s_keyframeIntervalMs);
+  uint32_t mask = keyframe ? TF_ALL_MASK : telemetryChangedFields(snap, s_lastSent);
+  if (mask == 0) return 0;
+
+  size_t len = encodeTelemetryDelta(snap, mask, keyframe, now, buf, bufSize);
+  if (len == 0 && !keyframe) {
+    // 델타가 한 프레임에 들어가지 않으면 키프레임으로 대신 보냄
+    keyframe = true;
+    mask = TF_ALL_MASK;
+    len = encodeTelemetryDelta(snap, mask, keyframe, now, buf, bufSize);
+  }
+  if (len == 0) return 0;
+
+  telemetryMarkSent(s_lastSent, snap, mask);
+  if (keyframe) {
+    s_keyframeRequested = false;
+    s_lastKeyframeMs = now;
+  }
+  s_lastTelemetryMs = now;
+  return len;
+}
+
+size_t buildLogExport(uint8_t *buf, size_t bufSize) {
+  while ((int32_t)(s_logExportEnd - s_logExportSeq) > 0) {
+    uint32_t first = logFirstSeq();
+    if ((int32_t)(s_logExportSeq - first) < 0) {
+      s_logExportSeq = first;  // 내보내는 사이 덮어써진 구간은 건너뜀
+      continue;
+    }
+
+    LogRecord rec;
+    if (!logRead(s_logExportSeq++, rec)) continue;
+
+    if (g_linkMode == LINK_MODE_BINARY) {
+      uint8_t record[LOG_WIRE_RECORD_LEN];
+      putLogRecord(record, rec);
+      return buildFrame(FRAME_LOG, s_txSeq++, record, sizeof(record), buf, bufSize);
+    }
+
+    int n = snprintf((char *)buf, bufSize, "LOG,%lu,%lu,",
+                     (unsigned long)rec.seq, (unsigned long)rec.ms);
+    if (n < 0 || (size_t)n >= bufSize) return 0;
+    size_t len = (size_t)n + logFormat(rec, (char *)buf + n, bufSize - (size_t)n, false);
+    return terminateLine(buf, len, bufSize);
+  }
+  return 0;
+}
+
+size_t buildFlashLogExport(uint8_t *buf, size_t bufSize) {
+  if (!s_flashExporting) return 0;
+  bool binary = (g_linkMode == LINK_MODE_BINARY);
+
+  while ((int32_t)(s_flashExportEnd - s_flashExportPos) > 0) {
+    uint32_t start = flashLogStartPos();
+    if ((int32_t)(s_flashExportPos - start) < 0) {
+      s_flashExportPos = start;  // 내보내는 사이 지워진 세그먼트는 건너뜀
+      continue;
+    }
+
+    FlashLogEntry e;
+    if (!flashLogRead(s_flashExportPos++, e)) continue;
+
+    if (binary) {
+      uint8_t record[LOG_ARCHIVE_WIRE_RECORD_LEN];
+      uint8_t *p = record;
+      for (int i = 0; i < 4; ++i) *p++ = (uint8_t)(e.boot >> (8 * i));
+      putLogRecord(p, e.rec);
+      return buildFrame(FRAME_LOG_ARCHIVE, s_txSeq++, record, sizeof(record), buf, bufSize);
+    }
+
+    int n = snprintf((char *)buf, bufSize, "LOGF,%lu,%lu,%lu,", (unsigned long)e.boot,
+                     (unsigned long)e.rec.seq, (unsigned long)e.rec.ms);
+    if (n < 0 || (size_t)n >= bufSize) return 0;
+    size_t len = (size_t)n + logFormat(e.rec, (char *)buf + n, bufSize - (size_t)n, false);
+    return terminateLine(buf, len, bufSize);
+  }
+
+  return buildExportEnd(s_flashExporting, FRAME_LOG_ARCHIVE, "LOGF", buf, bufSize);
+}
+
+size_t buildHistoryExport(uint8_t *buf, size_t bufSize) {
+  if (!s_histExporting) return 0;
+  bool binary = (g_linkMode == LINK_MODE_BINARY);
+  int tierNo  = (int)s_histExportTier;
+  int chNo    = (int)s_histExportCh;
+
+  if (!s_histExportDone) {
+    // 내보내는 사이 덮어써진 앞부분은 조회에서 건너뜀 (결과의 첫 시각이 뒤로 밀림)
+    HistoryPoint pts[HISTORY_WIRE_MAX_POINTS];
+    size_t n = historyQuery(s_histExportCh, s_histExportTier, s_histExportT, s_histExportEnd,
+                            pts, binary ? HISTORY_WIRE_MAX_POINTS : 1);
+    if (n > 0) {
+      uint32_t period = historyPeriod(s_histExportTier);
+      if (pts[n - 1].t >= s_histExportEnd) s_histExportDone = true;
+      s_histExportT = pts[n - 1].t + period;
+
+      if (binary) {
+        uint16_t scale = historyScale(s_histExportCh);
+        uint8_t record[HISTORY_WIRE_HEADER_LEN + HISTORY_WIRE_MAX_POINTS * HISTORY_WIRE_POINT_LEN];
+        uint8_t *p = record;
+        *p++ = (uint8_t)chNo;
+        *p++ = (uint8_t)tierNo;
+        *p++ = (uint8_t)period;
+        *p++ = (uint8_t)(period >> 8);
+        for (int i = 0; i < 4; ++i) *p++ = (uint8_t)(pts[0].t >> (8 * i));
+        *p++ = (uint8_t)scale;
+        *p++ = (uint8_t)(scale >> 8);
+        *p++ = (uint8_t)n;
+        for (size_t i = 0; i < n; ++i) {
+          int16_t v[3] = { INT16_MIN, INT16_MIN, INT16_MIN };
+          if (pts[i].valid) {
+            v[0] = (int16_t)lroundf(pts[i].min * scale);
+            v[1] = (int16_t)lroundf(pts[i].max * scale);
+            v[2] = (int16_t)lroundf(pts[i].avg * scale);
+          }
+          for (int k = 0; k < 3; ++k) {
+            *p++ = (uint8_t)((uint16_t)v[k]);
+            *p++ = (uint8_t)((uint16_t)v[k] >> 8);
+          }
+        }
+        return buildFrame(FRAME_HISTORY, s_txSeq++, record, (size_t)(p - record), buf, bufSize);
+      }
+
+      const HistoryPoint &pt = pts[0];
+      int len = pt.valid
+        ? snprintf((char *)buf, bufSize, "HIST,%d,%d,%lu,%.3f,%.3f,%.3f", chNo, tierNo,
+                   (unsigned long)pt.t, pt.min, pt.max, pt.avg)
+        : snprintf((char *)buf, bufSize, "HIST,%d,%d,%lu,,,", chNo, tierNo, (unsigned long)pt.t);
+      if (len < 0 || (size_t)len >= bufSize) return 0;
+      return terminateLine(buf, (size_t)len, bufSize);
+    }
+  }
+
+  return buildExportEnd(s_histExporting, FRAME_HISTORY, "HIST", buf, bufSize);
+}
+
+static_assert(5 + 6 * 4 + PROFILE_HIST_BUCKETS * 4 == PROFILE_WIRE_RECORD_LEN &&
+              PROFILE_WIRE_RECORD_LEN <= FRAME_MAX_PAYLOAD,
+              "FRAME_PROFILE record layout must match PROFILE_WIRE_RECORD_LEN");
+
+size_t buildProfileExport(uint8_t *buf, size_t bufSize) {
+  if (!s_profExporting) return 0;
+  bool binary = (g_linkMode == LINK_MODE_BINARY);
+
+  if (s_profExportNext < PROF_TASK_COUNT) {
+    uint8_t t = s_profExportNext++;
+    const TaskProfile &p = s_profExport[t];
+
+    if (binary) {
+      uint8_t record[PROFILE_WIRE_RECORD_LEN];
+      uint8_t *w = record;
+      *w++ = t;
+      w = putLe16(w, p.cpuPermille);
+      w = putLe16(w, p.stackFree);
+      w = putLe32(w, p.loops);
+      w = putLe32(w, p.busyUs);
+      w = putLe32(w, p.maxUs);
+      w = putLe32(w, p.lockWaits);
+      w = putLe32(w, p.lockWaitUs);
+      w = putLe32(w, p.lockMaxUs);
+      for (size_t b = 0; b < PROFILE_HIST_BUCKETS; ++b) w = putLe32(w, p.hist[b]);
+      return buildFrame(FRAME_PROFILE, s_txSeq++, record, (size_t)(w - record), buf, bufSize);
+    }
+
+    int n = snprintf((char *)buf, bufSize, "PROF,%s,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu",
+                     profileTaskName((ProfileTask)t), (unsigned)p.cpuPermille, (unsigned)p.stackFree,
+                     (unsigned long)p.loops, (unsigned long)p.busyUs, (unsigned long)p.maxUs,
+                     (unsigned long)p.lockWaits, (unsigned long)p.lockWaitUs, (unsigned long)p.lockMaxUs);
+    for (size_t b = 0; b < PROFILE_HIST_BUCKETS && n > 0 && (size_t)n < bufSize; ++b) {
+      n += snprintf((char *)buf + n, bufSize - (size_t)n, ",%lu", (unsigned long)p.hist[b]);
+    }
+    if (n < 0 || (size_t)n >= bufSize) return 0;
+    return terminateLine(buf, (size_t)n, bufSize);
+  }
+
+  return buildExportEnd(s_profExporting, FRAME_PROFILE, "PROF", buf, bufSize);
+}
+
+static_assert(10 + (TRACE_STAGE_COUNT - 1) * 4 == TRACE_WIRE_RECORD_LEN &&
+              6 + 6 * 4 == TRACE_WIRE_SUMMARY_LEN &&
+              TRACE_WIRE_RECORD_LEN <= FRAME_MAX_PAYLOAD,
+              "FRAME_TRACE layouts must match TRACE_WIRE_*_LEN");
+
+size_t buildTraceExport(uint8_t *buf, size_t bufSize) {
+  if (!s_traceExporting) return 0;
+  bool binary = (g_linkMode == LINK_MODE_BINARY);
+
+  if (s_traceExportStage < TRACE_STAGE_COUNT) {
+    uint8_t st = s_traceExportStage++;
+    const TraceStageStats &s = s_traceExport[st];
+
+    if (binary) {
+      uint8_t record[TRACE_WIRE_SUMMARY_LEN];
+      uint8_t *w = record;
+      *w++ = TRACE_WIRE_SUMMARY;
+      *w++ = st;
+      w = putLe16(w, s.count);
+      w = putLe16(w, s.overSla);
+      w = putLe32(w, s.hopP50Us);
+      w = putLe32(w, s.hopP99Us);
+      w = putLe32(w, s.hopMaxUs);
+      w = putLe32(w, s.cumP50Us);
+      w = putLe32(w, s.cumP99Us);
+      w = putLe32(w, s.cumMaxUs);
+      return buildFrame(FRAME_TRACE, s_txSeq++, record, (size_t)(w - record), buf, bufSize);
+    }
+
+    int n = snprintf((char *)buf, bufSize, "TRACE,S,%s,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu",
+                     traceStageName((TraceStage)st), (unsigned)s.count, (unsigned)s.overSla,
+                     (unsigned long)s.hopP50Us, (unsigned long)s.hopP99Us, (unsigned long)s.hopMaxUs,
+                     (unsigned long)s.cumP50Us, (unsigned long)s.cumP99Us, (unsigned long)s.cumMaxUs);
+    if (n < 0 || (size_t)n >= bufSize) return 0;
+    return terminateLine(buf, (size_t)n, bufSize);
+  }
+
+  // 그 사이 덮어쓰인 레코드는 건너뜀
+  TraceRecord r;
+  bool found = false;
+  while (s_traceExportId != s_traceExportEnd && !found) {
+    found = traceRead(s_traceExportId++, r);
+  }
+
+  if (found) {
+    if (binary) {
+      uint8_t record[TRACE_WIRE_RECORD_LEN];
+      uint8_t *w = record;
+      *w++ = TRACE_WIRE_RECORD;
+      w = putLe16(w, r.id);
+      *w++ = r.module;
+      *w++ = r.cmd;
+      *w++ = r.flags;
+      w = putLe32(w, r.t[TRACE_STAGE_RX]);
+      for (uint8_t st = TRACE_STAGE_QUEUED; st < TRACE_STAGE_COUNT; ++st) {
+        w = putLe32(w, (r.reached & (1u << st)) ? r.t[st] - r.t[TRACE_STAGE_RX] : UINT32_MAX);
+      }
+      return buildFrame(FRAME_TRACE, s_txSeq++, record, (size_t)(w - record), buf, bufSize);
+    }
+
+    int n = snprintf((char *)buf, bufSize, "TRACE,R,%u,%u,%u,%u", (unsigned)r.id,
+                     (unsigned)r.module, (unsigned)r.cmd, (unsigned)r.flags);
+    for (uint8_t st = TRACE_STAGE_QUEUED; st < TRACE_STAGE_COUNT && n > 0 && (size_t)n < bufSize; ++st) {
+      if (r.reached & (1u << st)) {
+        n += snprintf((char *)buf + n, bufSize - (size_t)n, ",%lu",
+                      (unsigned long)(r.t[st] - r.t[TRACE_STAGE_RX]));
+      } else {
+        n += snprintf((char *)buf + n, bufSize - (size_t)n, ",-");
+      }
+    }
+    if (n < 0 || (size_t)n >= bufSize) return 0;
+    return terminateLine(buf, (size_t)n, bufSize);
+  }
+
+  return buildExportEnd(s_traceExporting, FRAME_TRACE, "TRACE", buf, bufSize);
+}
+
+static_assert(2 + 10 * 4 == CAN_CMD_WIRE_RECORD_LEN && CAN_CMD_WIRE_RECORD_LEN <= FRAME_MAX_PAYLOAD,
+              "FRAME_CAN_CMD_STATS record layout must match CAN_CMD_WIRE_RECORD_LEN");
+
+size_t buildCanCmdStatsExport(uint8_t *buf, size_t bufSize) {
+  if (!s_canCmdExporting) return 0;
+  bool binary = (g_linkMode == LINK_MODE_BINARY);
+
+  uint8_t module, cmd;
+  CanCmdStats s;
+  if (getCanCmdKindStats(s_canCmdExportNext, module, cmd, s)) {
+    s_canCmdExportNext++;
+    uint32_t samples = s.acked + s.rejected;
+    uint32_t avg = samples ? (uint32_t)(s.rttSumUs / samples) : 0;
+
+    if (binary) {
+      uint8_t record[CAN_CMD_WIRE_RECORD_LEN];
+      uint8_t *w = record;
+      *w++ = module;
+      *w++ = cmd;
+      w = putLe32(w, s.sent);
+      w = putLe32(w, s.acked);
+      w = putLe32(w, s.rejected);
+      w = putLe32(w, s.retransmits);
+      w = putLe32(w, s.timeouts);
+      w = putLe32(w, s.superseded);
+      w = putLe32(w, s.rttLastUs);
+      w = putLe32(w, s.rttMinUs);
+      w = putLe32(w, s.rttMaxUs);
+      w = putLe32(w, avg);
+      return buildFrame(FRAME_CAN_CMD_STATS, s_txSeq++, record, (size_t)(w - record), buf, bufSize);
+    }
+
+    char kind[12];
+    if (module == CAN_CMD_WIRE_OTHER) {
+      snprintf(kind, sizeof(kind), "*,*");
+    } else {
+      snprintf(kind, sizeof(kind), "%u,%u", (unsigned)module, (unsigned)cmd);
+    }
+    int n = snprintf((char *)buf, bufSize, "CANCMD,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu", kind,
+                     (unsigned long)s.sent, (unsigned long)s.acked, (unsigned long)s.rejected,
+                     (unsigned long)s.retransmits, (unsigned long)s.timeouts, (unsigned long)s.superseded,
+                     (unsigned long)s.rttLastUs, (unsigned long)s.rttMinUs, (unsigned long)s.rttMaxUs,
+                     (unsigned long)avg);
+    if (n < 0 || (size_t)n >= bufSize) return 0;
+    return terminateLine(buf, (size_t)n, bufSize);
+  }
+
+  return buildExportEnd(s_canCmdExporting, FRAME_CAN_CMD_STATS, "CANCMD", buf, bufSize);
+}
+
+void setTelemetryMode(TelemetryMode mode) {
+  if (s_telemetryMode == mode) return;
+  s_telemetryMode = mode;
+  s_keyframeRequested = true;
+  logEvent(mode == TELEMETRY_MODE_DELTA ? LOG_TELEMETRY_DELTA : LOG_TELEMETRY_FULL);
+}
+
+void setTelemetryKeyframeInterval(uint32_t intervalMs) {
+  s_keyframeIntervalMs = intervalMs;
+}
 
-  if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-    s += "\"tank\":{\"st\":
\ No newline at end of file
+void requestTelemetryKeyframe() {
+  s_keyframeRequested = true;
+}
+
+// 서버 → 메인 컨트롤러 명령 예시 포맷 (아주 단순화)
+// "CMD,<moduleId>,<command>,<param>\n"
+void parseServerLine(const String &line) {
+  if (!line.startsWith("CMD")) return;
+
+  ServerCommand cmd{};
+  int idx1 = line.indexOf(',');
+  int idx2 = line.indexOf(',', idx1 + 1);
+  int idx3 = line.indexOf(',', idx2 + 1);
+
+  if (idx1 < 0 || idx2 < 0 || idx3 < 0) return;
+
+  cmd.targetModule = (uint8_t) line.substring(idx1 + 1, idx2).toInt();
+  cmd.command      = (uint8_t) line.substring(idx2 + 1, idx3).toInt();
+  cmd.param        = (int32_t) line.substring(idx3 + 1).toInt();
+  cmd.traceId      = traceBegin(cmd.targetModule, cmd.command);
+
+  if (g_serverCmdQueue && xQueueSend(g_serverCmdQueue, &cmd, 0) == pdTRUE) {
+    traceStamp(cmd.traceId, TRACE_STAGE_QUEUED);
+  } else {
+    traceFlag(cmd.traceId, TRACE_FLAG_DROPPED);
+  }
+
+  markServerRx();
+}
+
+void handleServerFrame(const Frame &frame) {
+  markServerRx();
+
+  if (frame.type != FRAME_COMMAND) return;
+
+  if (frame.len != COMMAND_RECORD_LEN) {
+    sendServerAck(frame.seq, FRAME_ACK_MALFORMED);
+    return;
+  }
+
+  ServerCommand cmd{};
+  cmd.targetModule = frame.payload[0];
+  cmd.command      = frame.payload[1];
+  cmd.param        = (int32_t)((uint32_t)frame.payload[2]         |
+                               ((uint32_t)frame.payload[3] << 8)  |
+                               ((uint32_t)frame.payload[4] << 16) |
+                               ((uint32_t)frame.payload[5] << 24));
+  cmd.traceId      = traceBegin(cmd.targetModule, cmd.command);
+
+  bool queued = g_serverCmdQueue && xQueueSend(g_serverCmdQueue, &cmd, 0) == pdTRUE;
+  if (queued) {
+    traceStamp(cmd.traceId, TRACE_STAGE_QUEUED);
+  } else {
+    traceFlag(cmd.traceId, TRACE_FLAG_DROPPED);
+  }
+  sendServerAck(frame.seq, queued ? FRAME_ACK_OK : FRAME_ACK_BUSY);
+}
+
+void setLinkMode(LinkMode mode) {
+  if (g_linkMode == mode) return;
+  g_linkMode = mode;
+  requestTelemetryKeyframe();  // 새 형식으로 전체 상태부터 다시 보냄
+  logEvent(mode == LINK_MODE_BINARY ? LOG_LINK_BINARY : LOG_LINK_TEXT);
+}
+
+// 서버 명령 처리 → CAN 라우팅
+void handleServerCommand(const ServerCommand &cmd) {
+  if (cmd.targetModule == MODULE_SYSTEM) {
+    handleSystemCommand(cmd);
+    return;
+  }
+
+  // FR-006 명령 라우팅
+  enqueueCanCommand(cmd.targetModule, cmd.command, cmd.param, cmd.traceId);
+
+  // 예시: UI 클릭 피드백
+  playClickBuzzer();
+}
@@ -2,6 +2,7 @@
 #define COMMUNICATION_H
 
 #include <Arduino.h>
+#include "DataTypes.h"
 
 // twai.h는 C 라이브러리이므로 extern "C"로 감싸야 합니다.
 extern "C" {
@@ -19,7 +20,17 @@ extern "C" {
 //==============================================================================
 
 /**
- * @brief CAN 버스로 전송할 명령을 생성하여 큐에 추가합니다.
+ * @brief taskCanAlert가 기다리는 TWAI 경고 (initCan의 alerts_enabled와 동일하게 유지)
+ */
+const uint32_t CAN_ALERTS_ENABLED = TWAI_ALERT_RX_DATA | TWAI_ALERT_RX_QUEUE_FULL |
+                                    TWAI_ALERT_RX_FIFO_OVERRUN |
+                                    TWAI_ALERT_TX_SUCCESS | TWAI_ALERT_TX_IDLE |
+                                    TWAI_ALERT_TX_FAILED;
+
+/**
+ * @brief CAN 버스로 전송할 명령을 생성하여 송신 스케줄러(CanTxScheduler.h)에 넣고 taskCan을 깨웁니다.
+ *
+ * 대기 중인 같은 설정 명령은 최신 값으로 합쳐지고, 펌프 OFF 같은 안전 명령은 먼저 나갑니다.
  * @param moduleId 대상 모듈 ID
  * @param cmd 명령 코드
  * @param param 파라미터
@@ -27,15 +38,51 @@ extern "C" {
 void enqueueCanCommand(uint8_t moduleId, uint8_t cmd, int32_t param);
 
 /**
- * @brief CAN 버스에서 수신된 메시지를 처리합니다.
+ * @brief 서버 명령을 추적 ID와 함께 CAN 송신 스케줄러에 넣습니다. (Trace.h의 CAN_QUEUED 단계)
+ * @param traceId ServerCommand의 추적 ID (0이면 추적하지 않음)
+ */
+void enqueueCanCommand(uint8_t moduleId, uint8_t cmd, int32_t param, uint16_t traceId);
+
+/**
+ * @brief CAN 버스에서 수신된 메시지 하나를 곧바로 상태에 반영합니다.
+ *
+ * 모듈 상태 프레임은 CanDecode 표로, 명령 ACK는 CanCommand의 대기 표로 처리합니다.
  * @param msg 수신된 a twai_message_t 메시지
  */
 void handleCanFrame(const twai_message_t &msg);
 
+/**
+ * @brief 수신 프레임을 스테이징 링에 넣습니다. (생산자 한 곳 전용)
+ *
+ * 상태를 건드리지 않으므로 상태 쓰기/읽기와 무관하게 항상 즉시 끝납니다.
+ * 링이 가득 찬 경우에만 새 프레임을 버리고 overflowDrops를 올립니다.
+ * @return 링에 넣었으면 true
+ */
+bool canRxPush(const twai_message_t &msg);
+
+/**
+ * @brief 링에 쌓인 프레임을 수신 순서대로 최대 maxFrames개 꺼내
+ * 쓰기 구간 한 번으로 상태에 반영합니다. (소비자 한 곳 전용)
+ * @return 반영한 프레임 수 (0이면 링이 비어 있음)
+ */
+size_t canRxApplyPending(size_t maxFrames);
+
+/**
+ * @brief 드라이버 수준 유실 카운터를 읽어 통계에 반영합니다. (taskCan 주기 처리용)
+ */
+void canRxPollDriverStats();
+
+/**
+ * @brief CAN 수신 링 통계를 복사합니다.
+ */
+void getCanRxStats(CanRxStats &out);
+
 
 //==============================================================================
 // 모듈 제어 요청 헬퍼 함수 (CAN 명령 전송)
 //==============================================================================
+// 요청 시점에는 g_state를 바꾸지 않습니다. 모듈이 ACK로 적용을 확인하면
+// 그때 pumpOn/lightOn/ledBrightness가 바뀝니다. (CanCommand.h)
 
 void requestTankPump(bool on);
 void requestTankLight(bool on);
@@ -48,10 +95,111 @@ void requestFeederOnce(uint8_t amountPercent);
 //==============================================================================
 
 /**
- * @brief 현재 시스템 상태를 JSON 형식의 문자열로 만들어 반환합니다.
- * @return String JSON 형식의 상태 정보
+ * @brief 현재 시스템 상태를 JSON 형식으로 buf에 기록합니다.
+ *
+ * 상태는 락 없는 스냅샷(snapshotState)으로 복사하고, 포맷팅은 복사본으로
+ * 고정 버퍼에 수행하므로 CAN 쓰기를 막지 않으며 힙 할당이 없습니다.
+ * @param buf 출력 버퍼 (STATUS_JSON_MAX_LEN 이상 권장)
+ * @param bufSize 출력 버퍼 크기
+ * @return 기록한 바이트 수 (NUL 제외). 버퍼 부족 시 0
+ */
+size_t buildStatusJson(char *buf, size_t bufSize);
+
+/**
+ * @brief 현재 시스템 상태를 바이너리 텔레메트리 프레임(FRAME_TELEMETRY)으로 buf에 기록합니다.
+ * @param buf 출력 버퍼 (FRAME_MAX_ENCODED 이상 권장)
+ * @param bufSize 출력 버퍼 크기
+ * @return 전송할 바이트 수 (구분자 포함). 버퍼 부족 시 0
+ */
+size_t buildStatusFrame(uint8_t *buf, size_t bufSize);
+
+/**
+ * @brief 지금 서버로 보낼 텔레메트리가 있으면 buf에 기록합니다.
+ *
+ * taskUart 루프마다 호출합니다. 현재 링크 모드(텍스트/바이너리)와
+ * 텔레메트리 모드(전체/델타)에 따라 전송 시점과 형식을 결정합니다.
+ *  - 전체 모드: PERIOD_UART_TX_MS마다 전체 상태
+ *  - 델타 모드: 데드밴드를 넘은 필드만 (최소 TELEMETRY_DELTA_MIN_GAP_MS 간격),
+ *               키프레임은 주기마다 또는 서버/모드 전환 요청 시
+ * @param buf 출력 버퍼 (STATUS_JSON_MAX_LEN 이상 권장)
+ * @param bufSize 출력 버퍼 크기
+ * @param now 현재 시각 (millis())
+ * @return 그대로 Serial2로 보낼 바이트 수 (텍스트는 줄바꿈 포함). 보낼 것이 없으면 0
  */
-String buildStatusJson();
+size_t buildTelemetryUpdate(uint8_t *buf, size_t bufSize, uint32_t now);
+
+/**
+ * @brief 서버가 SYS_CMD_EXPORT_LOG로 요청한 로그 레코드를 하나씩 buf에 기록합니다.
+ *
+ * taskUart 루프마다 보낼 것이 없을 때까지(최대 LOG_EXPORT_BATCH번) 호출합니다.
+ * 바이너리 모드는 FRAME_LOG 프레임(레코드 그대로), 텍스트 모드는 "LOG,<seq>,<ms>,<문구>"
+ * 한 줄이며, 문구는 이때 처음 만듭니다. 내보내는 사이 덮어써진 레코드는 건너뜁니다.
+ * @return 그대로 Serial2로 보낼 바이트 수. 내보낼 레코드가 없으면 0
+ */
+size_t buildLogExport(uint8_t *buf, size_t bufSize);
+
+/**
+ * @brief 서버가 SYS_CMD_EXPORT_FLASH_LOG로 요청한 플래시 보관 로그를 하나씩 buf에 기록합니다.
+ *
+ * taskUart 루프마다 FLASH_LOG_EXPORT_BATCH번까지 호출해 텔레메트리와 링크를 나눠 씁니다.
+ * 바이너리 모드는 FRAME_LOG_ARCHIVE 프레임, 텍스트 모드는 "LOGF,<부팅>,<seq>,<ms>,<문구>" 한 줄이며,
+ * 다 보내면 끝 표시(빈 FRAME_LOG_ARCHIVE / "LOGF,END")를 한 번 보냅니다.
+ * @return 그대로 Serial2로 보낼 바이트 수. 내보낼 것이 없으면 0
+ */
+size_t buildFlashLogExport(uint8_t *buf, size_t bufSize);
+
+/**
+ * @brief 서버가 SYS_CMD_EXPORT_HISTORY로 요청한 센서 이력을 buf에 기록합니다.
+ *
+ * taskUart 루프마다 HISTORY_EXPORT_BATCH번까지 호출합니다. 바이너리 모드는 FRAME_HISTORY
+ * 프레임 하나에 칸 HISTORY_WIRE_MAX_POINTS개까지, 텍스트 모드는 한 칸에 "HIST,..." 한 줄이며,
+ * 다 보내면 끝 표시(빈 FRAME_HISTORY / "HIST,END")를 한 번 보냅니다.
+ * @return 그대로 Serial2로 보낼 바이트 수. 내보낼 것이 없으면 0
+ */
+size_t buildHistoryExport(uint8_t *buf, size_t bufSize);
+
+/**
+ * @brief 서버가 SYS_CMD_EXPORT_PROFILE로 요청한 태스크 프로파일을 하나씩 buf에 기록합니다.
+ *
+ * taskUart 루프마다 PROFILE_EXPORT_BATCH번까지 호출합니다. 명령을 받은 시점의 복사본을
+ * 태스크마다 FRAME_PROFILE 프레임 하나 / "PROF,..." 한 줄로 보내고, 끝 표시를 한 번 보냅니다.
+ * @return 그대로 Serial2로 보낼 바이트 수. 내보낼 것이 없으면 0
+ */
+size_t buildProfileExport(uint8_t *buf, size_t bufSize);
+
+/**
+ * @brief 서버가 SYS_CMD_EXPORT_TRACE로 요청한 명령 추적을 하나씩 buf에 기록합니다.
+ *
+ * taskUart 루프마다 TRACE_EXPORT_BATCH번까지 호출합니다. 명령을 받은 시점에 계산한 단계 요약을
+ * 먼저 보내고, 요청한 최근 레코드를 오래된 것부터 FRAME_TRACE 프레임 하나 / "TRACE,..." 한 줄씩
+ * 보낸 뒤 끝 표시를 한 번 보냅니다.
+ * @return 그대로 Serial2로 보낼 바이트 수. 내보낼 것이 없으면 0
+ */
+size_t buildTraceExport(uint8_t *buf, size_t bufSize);
+
+/**
+ * @brief 서버가 SYS_CMD_EXPORT_CAN_CMD_STATS로 요청한 모듈 명령 종류별 통계를 하나씩 buf에 기록합니다.
+ *
+ * taskUart 루프마다 CAN_CMD_EXPORT_BATCH번까지 호출합니다. 종류마다 FRAME_CAN_CMD_STATS 프레임
+ * 하나 / "CANCMD,..." 한 줄(송신/ACK/재전송 수와 왕복 시간)로 보내고, 끝 표시를 한 번 보냅니다.
+ * @return 그대로 Serial2로 보낼 바이트 수. 내보낼 것이 없으면 0
+ */
+size_t buildCanCmdStatsExport(uint8_t *buf, size_t bufSize);
+
+/**
+ * @brief 텔레메트리 전송 방식을 바꿉니다. 델타로 바꾸면 키프레임부터 보냅니다.
+ */
+void setTelemetryMode(TelemetryMode mode);
+
+/**
+ * @brief 델타 모드의 키프레임 주기를 바꿉니다. (0: 요청 시에만)
+ */
+void setTelemetryKeyframeInterval(uint32_t intervalMs);
+
+/**
+ * @brief 다음 텔레메트리 전송을 키프레임으로 만듭니다.
+ */
+void requestTelemetryKeyframe();
 
 /**
  * @brief 서버로부터 수신된 한 줄의 명령 문자열을 파싱합니다.
@@ -59,6 +207,21 @@ String buildStatusJson();
  */
 void parseServerLine(const String &line);
 
+/**
+ * @brief 서버로부터 수신된 바이너리 프레임을 처리합니다.
+ *
+ * FRAME_COMMAND는 명령 큐에 넣고 같은 seq로 FRAME_ACK를 즉시 회신합니다.
+ * taskUart에서만 호출해야 합니다. (Serial2 송신을 태스크 하나로 제한)
+ * @param frame 디코딩이 끝난 프레임
+ */
+void handleServerFrame(const struct Frame &frame);
+
+/**
+ * @brief 서버 링크 모드를 전환합니다. taskUart에서만 호출해야 합니다.
+ * @param mode 새 링크 모드
+ */
+void setLinkMode(LinkMode mode);
+
 /**
  * @brief 파싱된 서버 명령을 실제 CAN 명령으로 변환하여 전송 큐에 넣습니다.
  * @param cmd 파싱된 ServerCommand 구조체
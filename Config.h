@@ -32,15 +32,148 @@ const int CAN_RX_PIN     = 4;   // CAN 통신 RX
 //==============================================================================
 const uint32_t PERIOD_CAN_COLLECT_MS  = 100;  // CAN 데이터 수집 주기
 const uint32_t PERIOD_UART_TX_MS      = 200;  // UART 데이터 전송 주기
-const uint32_t PERIOD_UI_UPDATE_MS    = 5000; // UI 화면 자동 갱신 주기
+const uint32_t PERIOD_UI_UPDATE_MS    = 5000; // UI 화면 안전 갱신 주기 (평소에는 상태 변경 알림으로 갱신)
+const uint32_t UI_MIN_FRAME_MS        = 50;   // 화면 갱신 최소 간격 (최대 20 fps)
 const uint32_t BOOT_READY_MS          = 3000; // 부팅 후 초기 동작 허용 시간
 const uint32_t SERVER_TIMEOUT_MS      = 5000; // 서버로부터 응답이 없을 때 타임아웃으로 간주하는 시간
+const uint32_t TELEMETRY_KEYFRAME_MS      = 10000; // 델타 모드에서 전체 상태(키프레임)를 보내는 기본 주기
+const uint32_t TELEMETRY_DELTA_MIN_GAP_MS = 50;    // 델타 모드에서 연속 전송 사이의 최소 간격
 
 
 //==============================================================================
 // 기타 설정
 //==============================================================================
-const int LOG_BUFFER_SIZE = 64; // 로그 메시지를 저장할 버퍼의 크기
+const size_t LOG_BUFFER_SIZE = 64;  // 로그 레코드 링 크기 (2의 거듭제곱)
+const size_t LOG_RECORD_ARGS = 3;   // 로그 레코드 하나에 담는 정수 인자 수
+const size_t LOG_CONSOLE_BATCH = 16; // taskLogic 한 주기(100ms)에 시리얼 콘솔로 출력할 최대 로그 수
+const size_t LOG_EXPORT_BATCH  = 4;  // taskUart 한 바퀴에 서버로 내보낼 최대 로그 수
+const size_t STATUS_JSON_MAX_LEN = 384; // 상태 JSON 한 줄의 최대 길이 (NUL 포함)
+const size_t CAN_RX_RING_SIZE   = 64;   // CAN 수신 스테이징 링 크기 (2의 거듭제곱)
+const size_t CAN_RX_APPLY_BATCH = 16;   // 쓰기 구간 한 번에 상태로 반영할 최대 프레임 수
+const size_t CAN_TX_SLOTS          = 16; // CAN 송신 대기 명령 최대 개수
+const size_t CAN_TX_SAFETY_RESERVE = 4;  // 그중 안전 명령 전용으로 남겨 두는 개수
+const size_t   CAN_CMD_INFLIGHT       = 8;  // 모듈 ACK를 기다리는 명령 최대 개수
+const size_t   CAN_CMD_SAFETY_RESERVE = 2;  // 그중 안전 명령 전용으로 남겨 두는 개수
+const uint32_t CAN_CMD_ACK_TIMEOUT_MS = 50; // ACK가 이 시간 안에 없으면 같은 seq로 재전송
+const uint8_t  CAN_CMD_MAX_RETRIES    = 3;  // 재전송 최대 횟수 (넘으면 전달 실패로 처리)
+const size_t   CAN_CMD_EXPORT_BATCH   = 1;  // taskUart 한 바퀴에 내보낼 명령 종류별 통계 레코드(또는 줄) 수
+const size_t   INPUT_EVENT_RING_SIZE  = 32; // 엔코더/버튼 ISR 이벤트 링 크기 (2의 거듭제곱)
+const size_t   RENDER_QUEUE_LEN        = 32;        // 렌더 태스크 명령 큐 길이
+const size_t   RENDER_STRIP_COUNT      = 2;         // DMA 조각 버퍼 수 (하나 전송 중에 다음 것 준비)
+const size_t   RENDER_STRIP_MAX_PIXELS = 320 * 16;  // 조각 버퍼 크기: 화면 폭 x 글자 한 줄 (10 KB)
+
+
+//==============================================================================
+// 플래시 이벤트 로그 (partitions.csv의 evlog 파티션)
+//==============================================================================
+const char     FLASH_LOG_PARTITION[]   = "evlog"; // 파티션 이름
+const uint32_t FLASH_LOG_SEGMENT_SIZE  = 4096;    // 세그먼트 = 플래시 지우기 단위 (섹터)
+const uint32_t FLASH_LOG_FLUSH_MS      = 2000;    // 새 레코드를 모아 두는 최대 시간
+const size_t   FLASH_LOG_KICK_RECORDS  = 16;      // 이만큼 쌓이면 기다리지 않고 씀 (2의 거듭제곱, RAM 링보다 작게)
+const size_t   FLASH_LOG_WRITE_RECORDS = 16;      // 플래시 쓰기 한 번에 담는 최대 레코드 수
+const size_t   FLASH_LOG_EXPORT_BATCH  = 1;       // taskUart 한 바퀴(10ms)에 내보낼 보관 로그 수 (약 50바이트, 115200bps의 절반)
+
+
+//==============================================================================
+// 센서 이력 (History.h, 부팅 후 시간 기준, RAM 고정 크기)
+//==============================================================================
+const uint32_t HISTORY_RAW_PERIOD_S     = 1;    // 원본 샘플 간격 (taskLogic 1초 시계)
+const size_t   HISTORY_RAW_POINTS       = 600;  // 원본 10분
+const uint32_t HISTORY_MINUTE_PERIOD_S  = 60;   // 1분 최소/최대/평균
+const size_t   HISTORY_MINUTE_POINTS    = 1440; // 24시간
+const uint32_t HISTORY_QUARTER_PERIOD_S = 900;  // 15분 최소/최대/평균
+const size_t   HISTORY_QUARTER_POINTS   = 672;  // 7일
+const size_t   HISTORY_RAM_BUDGET       = 96 * 1024; // 채널 전체 저장소 상한 (static_assert로 확인)
+const size_t   HISTORY_EXPORT_BATCH     = 1;    // taskUart 한 바퀴에 내보낼 이력 프레임(또는 줄) 수
+
+
+//==============================================================================
+// 설정 저장 (Settings.h, NVS 블롭 하나)
+//==============================================================================
+const char     SETTINGS_NVS_KEY[]      = "cfg";  // 설정 블롭 키 (예전 필드별 키는 부팅 때 옮기고 지움)
+const uint8_t  SETTINGS_BLOB_VERSION   = 2;      // 블롭 형식 버전 (1 = 예전 필드별 키)
+const uint32_t SETTINGS_SAVE_DELAY_MS  = 1000;   // 마지막 변경 후 이만큼 조용하면 저장 (실제 쓰기는 taskFlashLog가 깰 때)
+
+
+//==============================================================================
+// 예약 실행 (Schedule.h, 분 단위 타이머 휠)
+//==============================================================================
+const size_t   SCHEDULE_MAX_ENTRIES     = 32;      // 예약 칸 수 (0번은 설정 화면의 Fail-safe 급여)
+const uint32_t SCHEDULE_CATCHUP_MAX_MIN = 10;      // 시각이 이만큼 이내로 앞으로 뛰면 건너뛴 분도 실행 (넘으면 건너뜀)
+const char     SCHEDULE_NVS_KEY[]       = "sched"; // 예약 항목 블롭 키
+const uint8_t  SCHEDULE_BLOB_VERSION    = 1;
+const uint32_t SCHEDULE_SAVE_DELAY_MS   = 1000;    // 마지막 변경 후 이만큼 조용하면 저장 (taskFlashLog)
+
+
+//==============================================================================
+// 자동 규칙 (Rules.h, 센서 임계값 → 모듈 명령)
+//==============================================================================
+const size_t   RULES_MAX             = 128;     // 규칙 칸 수
+const char     RULES_NVS_KEY[]       = "rules"; // 규칙 블롭 키
+const uint8_t  RULES_BLOB_VERSION    = 1;
+const uint32_t RULES_SAVE_DELAY_MS   = 1000;    // 마지막 변경 후 이만큼 조용하면 저장 (taskFlashLog)
+
+
+//==============================================================================
+// 태스크 프로파일 (Profile.h)
+//==============================================================================
+const uint32_t PROFILE_LOCK_CONTENDED_US = 2;   // g_state 락을 이만큼 이상 기다렸으면 경합으로 셈
+const size_t   PROFILE_EXPORT_BATCH      = 1;   // taskUart 한 바퀴에 내보낼 태스크 레코드(또는 줄) 수
+
+
+//==============================================================================
+// 서버 명령 추적 (Trace.h)
+//==============================================================================
+const size_t   TRACE_RING_SIZE    = 128;  // 최근 명령 레코드 수 (2의 거듭제곱)
+const uint32_t TRACE_SLA_US       = 50000; // 수신 → 각 단계가 이보다 늦으면 요약의 초과 수에 셈 (펌프 OFF 목표)
+const size_t   TRACE_EXPORT_BATCH = 2;    // taskUart 한 바퀴에 내보낼 요약/레코드(또는 줄) 수
+
+
+//==============================================================================
+// 로터리 엔코더 / 버튼
+//==============================================================================
+const int8_t   ENCODER_TRANSITIONS_PER_STEP = 4;   // 한 클릭(디텐트)당 A/B 상태 전이 수
+const uint32_t ENCODER_VELOCITY_IDLE_MS     = 250; // 이 시간 동안 스텝이 없으면 회전 속도 0
+const int32_t  ENCODER_FAST_STEPS_PER_S     = 8;   // 값 입력: 이보다 빨리 돌리면 한 스텝에 ENCODER_FAST_INCREMENT
+const int32_t  ENCODER_FASTER_STEPS_PER_S   = 20;  // 값 입력: 이보다 빨리 돌리면 한 스텝에 ENCODER_FASTER_INCREMENT
+const uint8_t  ENCODER_FAST_INCREMENT       = 5;
+const uint8_t  ENCODER_FASTER_INCREMENT     = 10;
+const uint32_t BUTTON_DEBOUNCE_MS           = 5;   // 이보다 짧게 눌린 것은 채터링으로 무시
+const uint32_t BUTTON_LONG_CLICK_MS         = 700; // 이 이상 눌렀다 떼면 긴 클릭
+
+
+//==============================================================================
+// taskCan 알림 비트 (xTaskNotify eSetBits)
+//==============================================================================
+const uint32_t CAN_NOTIFY_RX        = 0x01; // 드라이버 RX 큐에 프레임 도착 (TWAI 경고)
+const uint32_t CAN_NOTIFY_TX_QUEUED = 0x02; // 송신 스케줄러에 명령 추가
+const uint32_t CAN_NOTIFY_TX_DONE   = 0x04; // 컨트롤러 TX 큐에 자리가 생김 (TWAI 경고)
+
+
+//==============================================================================
+// 상태 변경 비트 (statePublishChanges → taskUi 알림(eSetBits) + taskLogic이 stateTakeChanges()로 가져감)
+//==============================================================================
+const uint32_t STATE_CHG_TANK     = 0x01; // g_state.tank
+const uint32_t STATE_CHG_GROW     = 0x02; // g_state.grow
+const uint32_t STATE_CHG_NUTRIENT = 0x04; // g_state.nutrient
+const uint32_t STATE_CHG_FEEDER   = 0x08; // g_state.feeder
+const uint32_t STATE_CHG_SYSTEM   = 0x10; // 서버 연결, 경고/오류 플래그
+const uint32_t STATE_CHG_SETTINGS = 0x20; // g_settings
+const uint32_t STATE_CHG_LOG      = 0x40; // 로그 버퍼
+const uint32_t STATE_CHG_HISTORY  = 0x80; // 센서 이력 (1초마다 새 샘플)
+const uint32_t STATE_CHG_PROFILE  = 0x100; // 태스크 프로파일 (1초마다 CPU 점유/스택 갱신)
+const uint32_t STATE_CHG_ALL      = 0x1FF;
+const uint32_t UI_NOTIFY_INPUT    = 0x200; // 상태 변경이 아닌 입력 이벤트 (엔코더/버튼 ISR)
+const uint32_t UI_NOTIFY_RENDER   = 0x400; // 렌더 조각 버퍼가 비었음 (기다리던 그리기 이어서)
+
+
+//==============================================================================
+// 모듈 명령 CAN ID
+//==============================================================================
+// 명령: CAN_ID_CMD_BASE | moduleId, [0]=명령, [1..4]=파라미터(BE), [5]=seq
+// ACK : CAN_ID_ACK_BASE | moduleId, [0]=명령, [1]=seq, [2]=CanAckResult
+const uint32_t CAN_ID_CMD_BASE = 0x100;
+const uint32_t CAN_ID_ACK_BASE = 0x180;
 
 
 //==============================================================================
@@ -50,6 +183,7 @@ const int LOG_BUFFER_SIZE = 64; // 로그 메시지를 저장할 버퍼의 크
  * @brief CAN 통신에 사용될 각 기능 모듈의 고유 ID
  */
 enum ModuleId : uint8_t {
+  MODULE_SYSTEM    = 0, // 메인 컨트롤러 자신 (서버 → 컨트롤러 시스템 명령 전용, CAN 미전송)
   MODULE_TANK      = 1, // 수조
   MODULE_GROW      = 2, // 재배기
   MODULE_NUTRIENT  = 3, // 양액기
@@ -70,6 +204,39 @@ enum ModuleStatus : uint8_t {
 //==============================================================================
 // 모듈별 제어 명령 코드 정의
 //==============================================================================
+/**
+ * @brief 모듈이 명령 ACK에 담아 보내는 처리 결과
+ */
+enum CanAckResult : uint8_t {
+  CAN_ACK_OK       = 0,  // 적용함
+  CAN_ACK_REJECTED = 1   // 거부함 (범위 밖 파라미터, 인터록 등)
+};
+
+/**
+ * @brief 메인 컨트롤러(MODULE_SYSTEM) 자체 명령
+ */
+enum SystemCommand : uint8_t {
+  SYS_CMD_PING          = 0,  // 링크 유지 (동작 없음)
+  SYS_CMD_SET_LINK_MODE = 1,  // 서버 링크 모드 전환 (파라미터: LinkMode)
+  SYS_CMD_SET_TELEMETRY_MODE    = 2,  // 텔레메트리 전송 방식 (파라미터: TelemetryMode)
+  SYS_CMD_REQUEST_KEYFRAME      = 3,  // 다음 전송에 전체 상태(키프레임) 요청
+  SYS_CMD_SET_KEYFRAME_INTERVAL = 4,  // 키프레임 주기 (파라미터: ms, 0=요청 시에만)
+  SYS_CMD_EXPORT_LOG            = 5,  // 로그 레코드 내보내기 (파라미터: 최근 N개, 0=남아 있는 전부)
+  SYS_CMD_EXPORT_FLASH_LOG      = 6,  // 플래시에 보관된 로그 내보내기 (파라미터: 최근 N개, 0=전부)
+  SYS_CMD_EXPORT_HISTORY        = 7,  // 센서 이력 내보내기 (파라미터: 채널<<24 | 단계<<16 | 최근 N개, N=0이면 전부)
+  SYS_CMD_SET_TIME              = 8,  // 현지 시각 맞춤 (파라미터: 1970-01-01 00:00부터의 현지 초, uint32)
+  SYS_CMD_SCHEDULE_SET          = 9,  // 예약 항목 시각 (파라미터: Schedule.h의 시각 워드, 칸 번호 포함)
+  SYS_CMD_SCHEDULE_ACTION       = 10, // 예약 항목 동작 (파라미터: 칸<<24 | 모듈<<16 | 명령<<8 | 값)
+  SYS_CMD_SCHEDULE_CLEAR        = 11, // 서버가 넣은 예약 항목 모두 지움
+  SYS_CMD_RULE_CONDITION        = 12, // 자동 규칙 조건 (파라미터: Rules.h의 조건 워드, 칸 번호 포함)
+  SYS_CMD_RULE_HYSTERESIS       = 13, // 자동 규칙 히스테리시스 (파라미터: 칸<<24 | 폭, 채널 배율 단위)
+  SYS_CMD_RULE_ACTION           = 14, // 자동 규칙 동작 (파라미터: Rules.h의 동작 워드)
+  SYS_CMD_RULE_CLEAR            = 15, // 자동 규칙 모두 지움
+  SYS_CMD_EXPORT_PROFILE        = 16, // 태스크 프로파일 내보내기 (파라미터: 1이면 내보낸 뒤 누적값 초기화)
+  SYS_CMD_EXPORT_TRACE          = 17, // 명령 추적 내보내기 (파라미터: 단계 요약 뒤에 보낼 최근 레코드 수, 0=요약만)
+  SYS_CMD_EXPORT_CAN_CMD_STATS  = 18  // 모듈 명령 종류별 전달/왕복 시간 통계 내보내기
+};
+
 /**
  * @brief 수조(Tank) 모듈 제어용 명령
  */
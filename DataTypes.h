@@ -114,12 +114,86 @@ struct SystemSettings {
 //==============================================================================
 
 /**
- * @brief CAN 버스로 전송할 명령을 큐에 담기 위한 구조체
+ * @brief CAN 버스로 전송할 명령을 송신 대기열에 담기 위한 구조체
  */
 struct CanTxItem {
   uint32_t canId; // CAN ID
   uint8_t  dlc;   // Data Length Code (0-8)
   uint8_t  data[8]; // 데이터 페이로드
+  uint16_t traceId; // 서버 명령 추적 ID (Trace.h, 0이면 추적하지 않음)
+};
+
+/**
+ * @brief CAN 송신 스케줄러 통계 (누적값)
+ */
+struct CanTxStats {
+  uint32_t submitted;  // enqueueCanCommand() 호출 수
+  uint32_t coalesced;  // 대기 중인 같은 (모듈, 명령)에 값만 덮어쓴 수
+  uint32_t safety;     // 우선 레인으로 들어간 수
+  uint32_t dropped;    // 자리가 없어 버린 수
+  uint32_t taken;      // taskCan이 꺼내 간 수
+  uint32_t highWater;  // 동시에 대기했던 최대 명령 수
+};
+
+/**
+ * @brief 모듈 명령 전달(ACK) 통계 (누적값, 명령 종류별 또는 전체)
+ *
+ * 왕복 시간은 처음 송신한 시점부터 ACK를 받은 시점까지이며 재전송 시간을 포함합니다.
+ */
+struct CanCmdStats {
+  uint32_t sent;          // 처음 송신한 명령 수
+  uint32_t acked;         // CAN_ACK_OK로 확인된 수 (이때만 상태에 반영)
+  uint32_t rejected;      // 모듈이 거부한 수
+  uint32_t retransmits;   // ACK 시간 초과로 다시 보낸 횟수
+  uint32_t timeouts;      // 재전송을 다 써도 ACK가 없어 포기한 수
+  uint32_t superseded;    // ACK 전에 같은 설정 명령이 새로 나가 대체된 수
+  uint32_t unmatchedAcks; // 대기 중인 명령이 없는 ACK (중복/늦은 ACK)
+  uint32_t rttLastUs;     // 마지막 왕복 시간
+  uint32_t rttMinUs;
+  uint32_t rttMaxUs;
+  uint64_t rttSumUs;      // 평균 = rttSumUs / (acked + rejected)
+};
+
+/**
+ * @brief CAN 수신 스테이징 링 통계 (누적값)
+ */
+struct CanRxStats {
+  uint32_t received;      // 링에 들어간 프레임 수
+  uint32_t applied;       // 상태에 반영된 프레임 수
+  uint32_t batches;       // 상태 반영 배치(쓰기 구간) 수
+  uint32_t overflowDrops; // 링이 가득 차서 버린 프레임 수
+  uint32_t driverMissed;  // 드라이버 RX 큐/하드웨어 FIFO에서 이미 유실된 프레임 수
+  uint32_t highWater;     // 링에 동시에 쌓였던 최대 프레임 수
+  uint32_t unknownId;     // 디코드 표에 없는 ID라 무시한 프레임 수
+  uint32_t shortFrame;    // DLC가 형식보다 짧아 무시한 프레임 수
+};
+
+/**
+ * @brief 로터리 엔코더/버튼 입력 통계 (누적값)
+ */
+struct InputStats {
+  uint32_t steps;          // 디텐트 단위 회전 스텝 수 (방향 무관)
+  uint32_t invalidStates;  // A/B가 동시에 바뀐 전이 (놓친 에지, 무시)
+  uint32_t buttonEdges;    // 버튼 누름/뗌 에지 수
+  uint32_t bounceRejects;  // BUTTON_DEBOUNCE_MS보다 짧아 버린 누름
+  uint32_t overflowDrops;  // 이벤트 링이 가득 차서 버린 이벤트
+  uint32_t highWater;      // 링에 동시에 쌓였던 최대 이벤트 수
+};
+
+/**
+ * @brief 서버(UART) 링크의 송수신 형식
+ */
+enum LinkMode : uint8_t {
+  LINK_MODE_TEXT   = 0,  // JSON 송신 / "CMD,..." 텍스트 수신 (디버그용 기본값)
+  LINK_MODE_BINARY = 1   // COBS+CRC16 바이너리 프레임 (Protocol.h)
+};
+
+/**
+ * @brief 서버로 상태를 보내는 방식
+ */
+enum TelemetryMode : uint8_t {
+  TELEMETRY_MODE_FULL  = 0,  // PERIOD_UART_TX_MS마다 전체 상태
+  TELEMETRY_MODE_DELTA = 1   // 데드밴드를 넘은 필드만 즉시 + 주기/요청 시 키프레임
 };
 
 /**
@@ -129,6 +203,99 @@ struct ServerCommand {
   uint8_t targetModule; // 명령 대상 모듈 ID
   uint8_t command;      // 명령 코드
   int32_t param;        // 파라미터
+  uint16_t traceId;     // 추적 ID (Trace.h, 0이면 추적하지 않음)
+};
+
+
+//==============================================================================
+// 이벤트 로그
+//==============================================================================
+
+/**
+ * @brief 로그 이벤트 코드
+ *
+ * 문구와 인자 형식은 EventLog.cpp의 kLogFormats 표에 있으며, 레코드에는 코드와 인자만
+ * 저장합니다. 서버가 바이너리 레코드를 해석하므로 기존 값은 바꾸지 말고 뒤에 추가합니다.
+ */
+enum LogCode : uint16_t {
+  LOG_LOG_CLEARED        = 0,
+  LOG_TANK_PUMP_REQ      = 1,   // [0] on
+  LOG_TANK_LIGHT_REQ     = 2,   // [0] on
+  LOG_GROW_LED_SET       = 3,   // [0] 밝기 %
+  LOG_FEEDER_ONCE_REQ    = 4,   // [0] 급여량 %
+  LOG_UNKNOWN_SYS_CMD    = 5,   // [0] 명령 코드
+  LOG_TELEMETRY_DELTA    = 6,
+  LOG_TELEMETRY_FULL     = 7,
+  LOG_LINK_BINARY        = 8,
+  LOG_LINK_TEXT          = 9,
+  LOG_CAN_TX_DROPPED     = 10,  // [0] 새로 버린 수
+  LOG_CAN_CMD_FAILED     = 11,  // [0] 새로 실패한 수 [1] 누적 무응답 [2] 누적 거부
+  LOG_CAN_RX_LOST        = 12,  // [0] 새로 잃은 수 [1] 누적 링 유실 [2] 누적 드라이버 유실
+  LOG_BUTTON_NO_ACTION   = 13,
+  LOG_FAILSAFE_FEED      = 14,
+  LOG_GROW_LEAKS_RESET   = 15,
+  LOG_LOG_SCREEN_CLICK   = 16,
+  LOG_SET_DISPLAY_OFF    = 17,  // [0] 분
+  LOG_SET_FACTORY_INIT   = 18,  // [0] 플래그
+  LOG_BOOT               = 19,  // [0] 부팅 번호 [1] esp_reset_reason_t [2] 마운트 때 건너뛴 손상 레코드 수
+  LOG_FLASH_LOG_LOST     = 20,  // [0] 플래시에 쓰기 전에 RAM 링에서 덮어써진 수
+  LOG_FLASH_LOG_ERROR    = 21,  // [0] esp_err_t
+  LOG_SETTINGS_MIGRATED  = 22,  // [0] 이전 형식 버전 [1] 새 블롭 버전
+  LOG_SETTINGS_RESET     = 23,  // [0] SettingsLoadResult (손상 사유)
+  LOG_TIME_SYNC          = 24,  // [0] 보정량 (초, 새 시각 - 이전 시각) [1] 첫 맞춤이면 1
+  LOG_SCHEDULE_FIRED     = 25,  // [0] 칸 [1] 모듈 [2] 값
+  LOG_SCHEDULE_RESET     = 26,  // [0] SettingsLoadResult (저장된 예약 블롭 손상 사유)
+  LOG_RULE_FIRED         = 27,  // [0] 규칙 칸 [1] 1=조건 충족, 0=해제 [2] 채널 값 (배율 단위)
+  LOG_RULES_RESET        = 28,  // [0] SettingsLoadResult (저장된 규칙 블롭 손상 사유)
+  LOG_CODE_COUNT
+};
+
+/**
+ * @brief 로그 레코드 (고정 크기). 문자열은 읽는 쪽에서 logFormat()으로 만듭니다.
+ */
+struct LogRecord {
+  uint32_t seq;                    // 기록 순번 (부팅 후 0부터 계속 증가)
+  uint32_t ms;                     // 기록 시각 (millis())
+  uint16_t code;                   // LogCode
+  int32_t  args[LOG_RECORD_ARGS];  // 코드별 인자 (안 쓰는 칸은 0)
+};
+
+//==============================================================================
+// 센서 이력
+//==============================================================================
+
+/**
+ * @brief 이력을 남기는 센서 채널 (History.cpp의 채널 표와 순서가 같아야 합니다)
+ */
+enum HistoryChannel : uint8_t {
+  HIST_TANK_TEMP = 0,   // 수온 (섭씨)
+  HIST_TANK_PH,         // pH
+  HIST_TANK_DO,         // 용존 산소량 (mg/L)
+  HIST_TANK_LEVEL,      // 수위 (%)
+  HIST_GROW_TEMP,       // 재배기 온도 (섭씨)
+  HIST_GROW_HUMIDITY,   // 재배기 습도 (%)
+  HIST_CHANNEL_COUNT
+};
+
+/**
+ * @brief 이력 해상도 단계 (간격이 짧은 것부터)
+ */
+enum HistoryTier : uint8_t {
+  HIST_TIER_RAW = 0,    // HISTORY_RAW_PERIOD_S 원본
+  HIST_TIER_MINUTE,     // HISTORY_MINUTE_PERIOD_S 최소/최대/평균
+  HIST_TIER_QUARTER,    // HISTORY_QUARTER_PERIOD_S 최소/최대/평균
+  HIST_TIER_COUNT
+};
+
+/**
+ * @brief 이력 조회 결과 한 칸 (원본 단계는 min = max = avg)
+ */
+struct HistoryPoint {
+  uint32_t t;      // 칸 시작 시각 (부팅 후 초)
+  float    min;
+  float    max;
+  float    avg;
+  bool     valid;  // false: 그 구간에 샘플 없음 (모듈 오프라인 등)
 };
 
 
@@ -142,11 +309,15 @@ struct ServerCommand {
 enum ScreenId : uint8_t {
   SCREEN_DASHBOARD = 0, // 대시보드
   SCREEN_TANK,          // 수조 상세
+  SCREEN_TREND_TEMP,    // 수온 추이 그래프
+  SCREEN_TREND_PH,      // pH 추이 그래프
+  SCREEN_TREND_DO,      // 용존 산소 추이 그래프
   SCREEN_GROW,          // 재배기 상세
   SCREEN_NUTRIENT,      // 양액기 상세
   SCREEN_FEEDER,        // 급여기 상세
   SCREEN_LOG,           // 로그
   SCREEN_SETTINGS,      // 설정
+  SCREEN_DIAG,          // 태스크 진단 (CPU 점유, 루프 시간, 스택)
   SCREEN_COUNT          // 전체 화면 개수 (UI 로직에 사용)
 };
 
@@ -159,5 +330,44 @@ enum AlarmLevel : uint8_t {
   ALARM_ERROR        // 오류
 };
 
+/**
+ * @brief 부저/LED 패턴 (단계 표와 우선순위는 Indicator.cpp의 kPatterns)
+ */
+enum IndicatorPattern : uint8_t {
+  IND_PATTERN_BOOT = 0,      // 부팅: 200ms 울림 + LED 흰색, 200ms 쉼, 2회
+  IND_PATTERN_CLICK,         // UI 클릭: 50ms 울림 1회
+  IND_PATTERN_ALARM_WARNING, // 경고: 500ms 울림, 500ms 쉼 반복
+  IND_PATTERN_ALARM_ERROR,   // 오류/누수: 1000ms 울림, 500ms 쉼 반복
+  IND_PATTERN_COUNT
+};
+
+/**
+ * @brief 실행 시간을 재는 태스크 (이름과 핸들은 Profile.cpp의 표)
+ */
+enum ProfileTask : uint8_t {
+  PROF_TASK_CAN = 0,
+  PROF_TASK_UART,
+  PROF_TASK_UI,
+  PROF_TASK_LOGIC,
+  PROF_TASK_ALARM,
+  PROF_TASK_RENDER,
+  PROF_TASK_FLASH_LOG,
+  PROF_TASK_COUNT
+};
+
+/**
+ * @brief 서버 명령이 지나가는 단계 (Trace.h, 순서대로 지나감)
+ */
+enum TraceStage : uint8_t {
+  TRACE_STAGE_RX = 0,       // 줄/프레임을 해석함 (parseServerLine / handleServerFrame)
+  TRACE_STAGE_QUEUED,       // g_serverCmdQueue에 들어감
+  TRACE_STAGE_DISPATCH,     // taskUart가 큐에서 꺼냄 (handleServerCommand 직전)
+  TRACE_STAGE_CAN_QUEUED,   // CAN 송신 스케줄러에 들어감 (enqueueCanCommand)
+  TRACE_STAGE_CAN_TAKEN,    // taskCan이 스케줄러에서 꺼냄
+  TRACE_STAGE_CAN_TX,       // 컨트롤러 TX 큐에 넘김 (twai_transmit 성공)
+  TRACE_STAGE_ACK,          // 모듈 ACK 수신
+  TRACE_STAGE_COUNT
+};
+
 
 #endif // DATA_TYPES_H
@@ -0,0 +1,248 @@
+#include "Globals.h"
+#include "EventLog.h"
+#include "StateStore.h"
+
+#include <atomic>
+
+/**
+ * @file EventLog.cpp
+ * @brief 이벤트 로그 링과 포맷팅의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 코드별 문구 (LogCode 순서와 같아야 합니다)
+//------------------------------------------------------------------------------
+// 인자 자리: %d 부호 있는 정수, %u 부호 없는 정수, %b ON/OFF, %% 퍼센트 기호.
+// 자리는 args[0]부터 차례로 채웁니다.
+
+const char *const kLogFormats[] = {
+  "Log buffer cleared",
+  "Tank pump %b requested",
+  "Tank light %b requested",
+  "Grow LED brightness set to %u%%",
+  "Feeder once, amount %u%% requested",
+  "Unknown system command %u",
+  "Telemetry: delta streaming",
+  "Telemetry: full state",
+  "Server link: binary frames",
+  "Server link: text",
+  "CAN tx queue full, dropped %u",
+  "CAN cmd not applied %u (no ack %u, rejected %u)",
+  "CAN rx lost %u (ring %u, driver %u)",
+  "Button clicked (no special action)",
+  "Fail-safe feeder schedule triggered",
+  "Grow leaks reset (long click)",
+  "Log screen short click",
+  "Settings: displayOffMinutes = %u",
+  "Settings: factoryInitialized = %u",
+  "Boot #%u, reset reason %u, torn %u",
+  "Flash log missed %u records",
+  "Flash log write error %d",
+  "Settings migrated v%u -> v%u",
+  "Settings blob invalid (%u), defaults restored",
+  "Clock set, corrected by %d s (first %u)",
+  "Schedule entry %u fired: module %u, value %u",
+  "Schedule blob invalid (%u), entries cleared",
+  "Rule %u %b at value %d",
+  "Rules blob invalid (%u), rules cleared",
+};
+
+static_assert(sizeof(kLogFormats) / sizeof(kLogFormats[0]) == LOG_CODE_COUNT,
+              "kLogFormats must have one entry per LogCode");
+
+
+//------------------------------------------------------------------------------
+// 레코드 링 (여러 생산자, 락 없음)
+//------------------------------------------------------------------------------
+// 생산자는 다음 순번 seq의 칸(seq % 크기) stamp를 CAS로 "seq 쓰는 중"으로 바꿔 칸과 순번을
+// 함께 차지한 뒤 s_nextSeq를 올리고, 내용을 쓰고 완료 값을 기록합니다. 다른 생산자가 칸만
+// 차지하고 순번을 아직 올리지 못했으면 대신 올려 주므로(helping) 누구도 기다리지 않습니다.
+// 따라서 seq < s_nextSeq인 레코드는 항상 쓰는 중이거나 완료 상태이고 순번에 빈 곳이 없습니다.
+// 한 바퀴 전 생산자가 아직 같은 칸을 쓰는 중이면 새 레코드는 순번을 받지 않고 버립니다.
+// 읽는 쪽은 seqlock처럼 stamp를 앞뒤로 확인해 그 사이에 덮어써졌으면 버립니다.
+
+static_assert((LOG_BUFFER_SIZE & (LOG_BUFFER_SIZE - 1)) == 0,
+              "LOG_BUFFER_SIZE must be a power of two");
+
+struct LogSlot {
+  std::atomic<uint32_t> stamp;  // 0: 빈 칸, 2*seq+1: 쓰는 중, 2*seq+2: seq 기록 완료
+  uint32_t ms;
+  uint16_t code;
+  int32_t  args[LOG_RECORD_ARGS];
+};
+
+LogSlot               s_slots[LOG_BUFFER_SIZE];
+std::atomic<uint32_t> s_nextSeq{0};
+std::atomic<uint32_t> s_firstSeq{0};    // clearLogs() 시점의 순번 (이전 레코드는 보이지 않음)
+std::atomic<uint32_t> s_busyDrops{0};
+
+// 콘솔 출력 위치와 통계 (taskLogic 전용)
+uint32_t s_consoleSeq  = 0;
+uint32_t s_consoleLost = 0;
+
+inline uint32_t writingStamp(uint32_t seq) { return 2u * seq + 1u; }
+inline uint32_t doneStamp(uint32_t seq)    { return 2u * seq + 2u; }
+
+// 순번 하나와 그 칸을 차지합니다. 한 바퀴 전 레코드를 아직 쓰는 중이면 false
+bool claimSlot(uint32_t &seqOut) {
+  for (;;) {
+    uint32_t seq = s_nextSeq.load(std::memory_order_acquire);
+    LogSlot &slot = s_slots[seq & (LOG_BUFFER_SIZE - 1)];
+    uint32_t cur = slot.stamp.load(std::memory_order_acquire);
+
+    if (cur == writingStamp(seq) || cur == doneStamp(seq)) {
+      // 다른 생산자가 차지만 하고 순번을 아직 못 올림 → 대신 올리고 다시
+      s_nextSeq.compare_exchange_weak(seq, seq + 1, std::memory_order_acq_rel);
+      continue;
+    }
+    if ((int32_t)(cur - writingStamp(seq)) > 0) continue;  // 읽은 seq가 이미 지난 값
+    if (cur & 1u) return false;                               // 한 바퀴 전 생산자가 쓰는 중
+
+    if (slot.stamp.compare_exchange_weak(cur, writingStamp(seq), std::memory_order_acq_rel)) {
+      s_nextSeq.compare_exchange_strong(seq, seq + 1, std::memory_order_acq_rel);
+      seqOut = seq;
+      return true;
+    }
+  }
+}
+
+// buf[n]부터 s를 이어 붙입니다. (NUL 자리는 남김)
+void appendText(char *buf, size_t bufSize, size_t &n, const char *s) {
+  while (*s && n + 1 < bufSize) buf[n++] = *s++;
+}
+
+} // namespace
+
+void logEvent(LogCode code, int32_t a0, int32_t a1, int32_t a2) {
+  uint32_t seq;
+  if (!claimSlot(seq)) {
+    s_busyDrops.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  LogSlot &slot = s_slots[seq & (LOG_BUFFER_SIZE - 1)];
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.ms      = millis();
+  slot.code    = (uint16_t)code;
+  slot.args[0] = a0;
+  slot.args[1] = a1;
+  slot.args[2] = a2;
+  slot.stamp.store(doneStamp(seq), std::memory_order_release);
+
+  statePublishChanges(STATE_CHG_LOG);
+
+  // 플래시 보관: 일정 개수마다 taskFlashLog를 깨움 (그 외에는 FLASH_LOG_FLUSH_MS마다 스스로 깸)
+  if (((seq + 1) & (FLASH_LOG_KICK_RECORDS - 1)) == 0 && g_taskFlashLogHandle) {
+    xTaskNotifyGive(g_taskFlashLogHandle);
+  }
+}
+
+void clearLogs() {
+  s_firstSeq.store(s_nextSeq.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  // clear 후 한 줄 남겨두기
+  logEvent(LOG_LOG_CLEARED);
+}
+
+uint32_t logNextSeq() {
+  return s_nextSeq.load(std::memory_order_acquire);
+}
+
+uint32_t logFirstSeq() {
+  uint32_t next  = s_nextSeq.load(std::memory_order_acquire);
+  uint32_t first = s_firstSeq.load(std::memory_order_relaxed);
+  uint32_t ring  = next > LOG_BUFFER_SIZE ? next - (uint32_t)LOG_BUFFER_SIZE : 0;
+  return first > ring ? first : ring;
+}
+
+bool logRead(uint32_t seq, LogRecord &out, bool includeCleared) {
+  if (!includeCleared && (int32_t)(seq - s_firstSeq.load(std::memory_order_relaxed)) < 0) return false;
+
+  const LogSlot &slot = s_slots[seq & (LOG_BUFFER_SIZE - 1)];
+  uint32_t before = slot.stamp.load(std::memory_order_acquire);
+  if (before != doneStamp(seq)) return false;
+
+  out.seq  = seq;
+  out.ms   = slot.ms;
+  out.code = slot.code;
+  for (size_t i = 0; i < LOG_RECORD_ARGS; ++i) out.args[i] = slot.args[i];
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.stamp.load(std::memory_order_relaxed) == before;
+}
+
+size_t logFormat(const LogRecord &rec, char *buf, size_t bufSize, bool withTime) {
+  if (bufSize == 0) return 0;
+  size_t n = 0;
+  char num[12];
+
+  if (withTime) {
+    snprintf(num, sizeof(num), "%lu", (unsigned long)rec.ms);
+    appendText(buf, bufSize, n, num);
+    appendText(buf, bufSize, n, ": ");
+  }
+
+  if (rec.code >= LOG_CODE_COUNT) {
+    snprintf(num, sizeof(num), "%u", (unsigned)rec.code);
+    appendText(buf, bufSize, n, "Event #");
+    appendText(buf, bufSize, n, num);
+    buf[n] = '\0';
+    return n;
+  }
+
+  size_t arg = 0;
+  for (const char *p = kLogFormats[rec.code]; *p && n + 1 < bufSize; ++p) {
+    if (*p != '%' || p[1] == '\0') {
+      buf[n++] = *p;
+      continue;
+    }
+    char spec = *++p;
+    if (spec == '%') {
+      buf[n++] = '%';
+      continue;
+    }
+    int32_t v = arg < LOG_RECORD_ARGS ? rec.args[arg++] : 0;
+    switch (spec) {
+      case 'd': snprintf(num, sizeof(num), "%ld", (long)v); break;
+      case 'u': snprintf(num, sizeof(num), "%lu", (unsigned long)(uint32_t)v); break;
+      case 'b': snprintf(num, sizeof(num), "%s", v ? "ON" : "OFF"); break;
+      default:  num[0] = '\0'; break;
+    }
+    appendText(buf, bufSize, n, num);
+  }
+  buf[n] = '\0';
+  return n;
+}
+
+void logConsolePump(size_t maxRecords) {
+  uint32_t next  = logNextSeq();
+  uint32_t first = logFirstSeq();
+  if ((int32_t)(s_consoleSeq - first) < 0) {
+    // 지웠거나 출력하기 전에 덮어써진 구간은 건너뜀 (지운 것은 유실로 세지 않음)
+    uint32_t ringFirst = next > LOG_BUFFER_SIZE ? next - (uint32_t)LOG_BUFFER_SIZE : 0;
+    if ((int32_t)(ringFirst - s_consoleSeq) > 0) s_consoleLost += ringFirst - s_consoleSeq;
+    s_consoleSeq = first;
+  }
+
+  char line[96];
+  for (size_t i = 0; i < maxRecords && s_consoleSeq != next; ++i) {
+    LogRecord rec;
+    if (!logRead(s_consoleSeq, rec)) {
+      // 아직 쓰는 중이면 다음 호출에서 다시, 그 사이 덮어써졌으면 건너뜀
+      const LogSlot &slot = s_slots[s_consoleSeq & (LOG_BUFFER_SIZE - 1)];
+      if (slot.stamp.load(std::memory_order_relaxed) == writingStamp(s_consoleSeq)) break;
+      if ((int32_t)(s_consoleSeq - s_firstSeq.load(std::memory_order_relaxed)) >= 0) s_consoleLost++;
+      s_consoleSeq++;
+      continue;
+    }
+    logFormat(rec, line, sizeof(line), true);
+    Serial.println(line);
+    s_consoleSeq++;
+  }
+}
+
+void getLogStats(LogStats &out) {
+  out.written     = s_nextSeq.load(std::memory_order_relaxed);
+  out.busyDrops   = s_busyDrops.load(std::memory_order_relaxed);
+  out.consoleLost = s_consoleLost;
+}
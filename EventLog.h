@@ -0,0 +1,70 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file EventLog.h
+ * @brief 이벤트 로그 링(고정 크기 바이너리 레코드)과 지연 포맷팅을 선언합니다.
+ *
+ * logEvent(code, 인자...)는 문자열을 만들지 않고 LogRecord 하나를 링에 기록만 하므로
+ * 힙 할당과 Serial 출력이 없습니다. 어느 태스크에서 동시에 불러도 되며(락 없음),
+ * 링이 가득 차면 가장 오래된 레코드를 덮어씁니다.
+ *
+ * 문자열은 읽는 쪽이 필요할 때만 만듭니다.
+ *  - 로그 화면: 보이는 줄만 logFormat()
+ *  - 시리얼 콘솔: taskLogic이 logConsolePump()로 새 레코드를 모아 출력
+ *  - 서버: SYS_CMD_EXPORT_LOG 요청 시 taskUart가 레코드(바이너리) 또는 한 줄(텍스트)로 전송
+ *  - 플래시: taskFlashLog가 레코드 그대로 모아 씀 (FlashLog.h)
+ *
+ * 읽는 쪽은 각자 순번(seq)으로 위치를 기억하며, 레코드를 소비하지 않습니다.
+ * logEvent()/clearLogs()의 선언은 Globals.h에 있습니다.
+ */
+
+/**
+ * @brief 로그 링 통계 (누적값)
+ */
+struct LogStats {
+  uint32_t written;      // 기록한 레코드 수
+  uint32_t busyDrops;    // 링을 한 바퀴 돌아온 칸을 다른 태스크가 아직 쓰는 중이라 버린 수
+  uint32_t consoleLost;  // 콘솔로 출력하기 전에 덮어써진 수
+};
+
+/**
+ * @brief 다음에 기록될 순번을 돌려줍니다. (가장 최근 레코드 = 반환값 - 1)
+ */
+uint32_t logNextSeq();
+
+/**
+ * @brief 링에 남아 있는 가장 오래된 순번을 돌려줍니다. (clearLogs() 이전 것은 제외)
+ */
+uint32_t logFirstSeq();
+
+/**
+ * @brief 순번 seq의 레코드를 복사합니다.
+ * @param includeCleared true면 clearLogs()로 화면에서 지운 레코드도 읽음 (플래시 보관용)
+ * @return 아직 기록 중이거나, 이미 덮어써졌거나, 지운 레코드면 false
+ */
+bool logRead(uint32_t seq, LogRecord &out, bool includeCleared = false);
+
+/**
+ * @brief 레코드를 사람이 읽는 문구로 만듭니다.
+ * @param withTime true면 앞에 "<ms>: "를 붙임
+ * @return 기록한 길이 (NUL 제외, 버퍼가 작으면 잘림)
+ */
+size_t logFormat(const LogRecord &rec, char *buf, size_t bufSize, bool withTime);
+
+/**
+ * @brief 마지막 호출 이후 새로 기록된 레코드를 포맷해 Serial로 출력합니다. (taskLogic 전용)
+ * @param maxRecords 한 번에 출력할 최대 레코드 수 (남은 것은 다음 호출에서)
+ */
+void logConsolePump(size_t maxRecords);
+
+/**
+ * @brief 로그 링 통계를 복사합니다.
+ */
+void getLogStats(LogStats &out);
+
+
+#endif // EVENT_LOG_H
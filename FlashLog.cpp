@@ -0,0 +1,318 @@
+#include "Globals.h"
+#include "FlashLog.h"
+#include "EventLog.h"
+#include "Protocol.h"
+
+#include <atomic>
+#include <stddef.h>
+#include <esp_partition.h>
+#include <esp_system.h>
+
+/**
+ * @file FlashLog.cpp
+ * @brief 플래시 보관 로그(세그먼트 기록, 마운트, 모아 쓰기, 읽기)의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 플래시 배치
+//------------------------------------------------------------------------------
+// 세그먼트(섹터) = [머리 32바이트][레코드 32바이트 x kSlotsPerSegment]
+// 세그먼트 일련번호 n은 항상 n % 세그먼트 수 자리에 있으므로, 지운 뒤 머리를 쓰기 전에
+// 전원이 끊겨도 남은 세그먼트들의 일련번호로 순서를 복원할 수 있습니다.
+// 레코드는 지운 상태(0xFF)인 칸에 한 번만 쓰며, 다 0xFF인 칸이 세그먼트의 끝입니다.
+
+const uint32_t kSegMagic = 0x31474C45;  // "ELG1"
+
+struct FlashSegHeader {
+  uint32_t magic;
+  uint32_t segSeq;
+  uint16_t recordSize;
+  uint16_t crc;          // 앞 10바이트의 crc16Ccitt
+  uint8_t  reserved[20]; // 0xFF로 남김
+};
+
+struct FlashRecord {
+  uint32_t seq;
+  uint32_t ms;
+  uint32_t boot;
+  int32_t  args[LOG_RECORD_ARGS];
+  uint16_t code;
+  uint16_t crc;          // 앞 26바이트의 crc16Ccitt
+  uint8_t  reserved[4];  // 0xFF로 남김
+};
+
+static_assert(sizeof(FlashSegHeader) == 32, "segment header must fill one record slot");
+static_assert(sizeof(FlashRecord) == 32, "flash record layout changed");
+static_assert(FLASH_LOG_SEGMENT_SIZE % SPI_FLASH_SEC_SIZE == 0,
+              "segments must be whole erase sectors");
+static_assert((FLASH_LOG_KICK_RECORDS & (FLASH_LOG_KICK_RECORDS - 1)) == 0,
+              "FLASH_LOG_KICK_RECORDS must be a power of two");
+static_assert(FLASH_LOG_KICK_RECORDS < LOG_BUFFER_SIZE,
+              "the flusher must be woken before the RAM ring laps");
+
+const uint32_t kSlotsPerSegment = FLASH_LOG_SEGMENT_SIZE / sizeof(FlashRecord) - 1;
+const size_t   kHeaderCrcLen    = offsetof(FlashSegHeader, crc);
+const size_t   kRecordCrcLen    = offsetof(FlashRecord, crc);
+
+const esp_partition_t *s_part = nullptr;
+uint32_t s_segCount = 0;
+uint32_t s_boot     = 0;
+
+// taskFlashLog(또는 태스크 전 호출자)만 사용
+uint32_t s_headSegSeq = UINT32_MAX;       // 쓰고 있는 세그먼트 (UINT32_MAX: 아직 없음)
+uint32_t s_writeSlot  = kSlotsPerSegment; // 다음에 쓸 칸 (= kSlotsPerSegment면 새 세그먼트 필요)
+uint32_t s_flushSeq   = 0;                // 다음에 플래시로 옮길 RAM 로그 순번
+FlashRecord s_batch[FLASH_LOG_WRITE_RECORDS];
+
+std::atomic<uint32_t> s_startPos{0};
+std::atomic<uint32_t> s_endPos{0};
+
+FlashLogStats s_stats = {};
+
+inline uint32_t segOffset(uint32_t segSeq) {
+  return (segSeq % s_segCount) * FLASH_LOG_SEGMENT_SIZE;
+}
+
+inline uint32_t slotOffset(uint32_t segSeq, uint32_t slot) {
+  return segOffset(segSeq) + (slot + 1) * (uint32_t)sizeof(FlashRecord);
+}
+
+bool isErased(const void *p, size_t len) {
+  const uint8_t *b = (const uint8_t *)p;
+  for (size_t i = 0; i < len; ++i) {
+    if (b[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+bool recordValid(const FlashRecord &r) {
+  return crc16Ccitt((const uint8_t *)&r, kRecordCrcLen) == r.crc;
+}
+
+// 자리 idx의 머리를 읽습니다. 손상됐거나 다른 자리의 일련번호면 false
+bool readHeader(uint32_t idx, FlashSegHeader &h) {
+  if (esp_partition_read(s_part, idx * FLASH_LOG_SEGMENT_SIZE, &h, sizeof(h)) != ESP_OK) return false;
+  return h.magic == kSegMagic && h.recordSize == sizeof(FlashRecord) &&
+         crc16Ccitt((const uint8_t *)&h, kHeaderCrcLen) == h.crc &&
+         h.segSeq % s_segCount == idx;
+}
+
+void noteError(esp_err_t err) {
+  s_stats.errors++;
+  logEvent(LOG_FLASH_LOG_ERROR, err);
+}
+
+// 가장 오래된 세그먼트를 지우고 다음 일련번호의 세그먼트를 엽니다.
+bool openNextSegment() {
+  uint32_t segSeq = s_headSegSeq + 1;
+
+  // 지우기 전에 읽는 쪽이 볼 범위에서 먼저 뺌
+  if (segSeq >= s_segCount) {
+    s_startPos.store((segSeq - s_segCount + 1) * kSlotsPerSegment, std::memory_order_release);
+  }
+
+  esp_err_t err = esp_partition_erase_range(s_part, segOffset(segSeq), FLASH_LOG_SEGMENT_SIZE);
+  if (err != ESP_OK) {
+    noteError(err);
+    return false;
+  }
+  s_stats.segmentErases++;
+
+  FlashSegHeader h;
+  memset(&h, 0xFF, sizeof(h));
+  h.magic      = kSegMagic;
+  h.segSeq     = segSeq;
+  h.recordSize = sizeof(FlashRecord);
+  h.crc        = crc16Ccitt((const uint8_t *)&h, kHeaderCrcLen);
+  err = esp_partition_write(s_part, segOffset(segSeq), &h, sizeof(h));
+  if (err != ESP_OK) {
+    noteError(err);
+    return false;
+  }
+
+  s_headSegSeq = segSeq;
+  s_writeSlot  = 0;
+  return true;
+}
+
+// 가장 최근 세그먼트와 그 안의 쓸 칸을 찾습니다.
+void mount() {
+  bool found = false;
+  for (uint32_t i = 0; i < s_segCount; ++i) {
+    FlashSegHeader h;
+    if (!readHeader(i, h)) continue;
+    if (!found || (int32_t)(h.segSeq - s_headSegSeq) > 0) s_headSegSeq = h.segSeq;
+    found = true;
+  }
+
+  if (!found) {
+    // 빈 파티션: 첫 쓰기에서 일련번호 0 세그먼트를 엶
+    s_headSegSeq = UINT32_MAX;
+    s_writeSlot  = kSlotsPerSegment;
+    s_startPos.store(0);
+    s_endPos.store(0);
+    return;
+  }
+
+  // 칸은 앞에서부터 차례로 쓰므로 처음 나오는 빈 칸이 끝. 끝 바로 앞 칸의 CRC가 맞지 않으면
+  // 지난번에 쓰다 전원이 끊긴 레코드 (그 칸은 건너뛰고 다음 칸부터 씀)
+  const size_t kChunk = 8;
+  FlashRecord chunk[kChunk];
+  bool lastValid = true;
+  s_writeSlot = kSlotsPerSegment;
+  for (uint32_t slot = 0; slot < kSlotsPerSegment && s_writeSlot == kSlotsPerSegment; slot += kChunk) {
+    size_t n = kSlotsPerSegment - slot < kChunk ? kSlotsPerSegment - slot : kChunk;
+    if (esp_partition_read(s_part, slotOffset(s_headSegSeq, slot), chunk, n * sizeof(FlashRecord)) != ESP_OK) break;
+    for (size_t i = 0; i < n; ++i) {
+      if (isErased(&chunk[i], sizeof(FlashRecord))) {
+        s_writeSlot = slot + (uint32_t)i;
+        break;
+      }
+      lastValid = recordValid(chunk[i]);
+    }
+  }
+  if (!lastValid) s_stats.tornSkipped++;
+
+  uint32_t oldest = s_headSegSeq >= s_segCount - 1 ? s_headSegSeq - (s_segCount - 1) : 0;
+  s_startPos.store(oldest * kSlotsPerSegment);
+  s_endPos.store(s_headSegSeq * kSlotsPerSegment + s_writeSlot);
+}
+
+} // namespace
+
+bool flashLogInit() {
+  s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                    FLASH_LOG_PARTITION);
+  if (!s_part || s_part->size < 2 * FLASH_LOG_SEGMENT_SIZE) {
+    s_part = nullptr;
+    Serial.println("[FlashLog] evlog partition not found");
+    return false;
+  }
+  s_segCount = s_part->size / FLASH_LOG_SEGMENT_SIZE;
+  s_stats = {};
+  s_stats.segments = s_segCount;
+  mount();
+
+  // 부팅 번호: 남아 있는 가장 최근 레코드의 다음
+  s_boot = 1;
+  uint32_t start = s_startPos.load();
+  for (uint32_t pos = s_endPos.load(); pos != start; --pos) {
+    FlashLogEntry e;
+    if (flashLogRead(pos - 1, e)) {
+      s_boot = e.boot + 1;
+      break;
+    }
+  }
+
+  // 이번 부팅 이전 RAM 레코드(setup 중 기록분)도 함께 옮기고, 부팅 레코드는 바로 씀
+  s_flushSeq = logFirstSeq();
+  logEvent(LOG_BOOT, (int32_t)s_boot, (int32_t)esp_reset_reason(), (int32_t)s_stats.tornSkipped);
+  flashLogFlush();
+  return true;
+}
+
+void flashLogFlush() {
+  if (!s_part) return;
+
+  uint32_t lostBefore = s_stats.lost;
+  uint32_t next = logNextSeq();
+
+  while (s_flushSeq != next) {
+    // RAM 링을 한 바퀴 넘게 밀렸으면 덮어써진 것은 건너뜀
+    uint32_t ringFirst = next > LOG_BUFFER_SIZE ? next - (uint32_t)LOG_BUFFER_SIZE : 0;
+    if ((int32_t)(ringFirst - s_flushSeq) > 0) {
+      s_stats.lost += ringFirst - s_flushSeq;
+      s_flushSeq = ringFirst;
+      continue;
+    }
+
+    if (s_writeSlot >= kSlotsPerSegment && !openNextSegment()) break;
+
+    // 세그먼트 끝을 넘지 않는 만큼 모아서 한 번에 씀
+    size_t room = kSlotsPerSegment - s_writeSlot;
+    if (room > FLASH_LOG_WRITE_RECORDS) room = FLASH_LOG_WRITE_RECORDS;
+    size_t n = 0;
+    bool pending = false;
+    while (n < room && s_flushSeq != next) {
+      LogRecord rec;
+      if (!logRead(s_flushSeq, rec, true)) {
+        // 링 안에 있는데 못 읽으면 아직 쓰는 중 → 다음에. 그 사이 덮어써졌으면 유실
+        uint32_t now = logNextSeq();
+        if ((int32_t)(s_flushSeq - (now > LOG_BUFFER_SIZE ? now - (uint32_t)LOG_BUFFER_SIZE : 0)) >= 0) {
+          pending = true;
+          break;
+        }
+        s_stats.lost++;
+        s_flushSeq++;
+        continue;
+      }
+      FlashRecord &r = s_batch[n++];
+      memset(&r, 0xFF, sizeof(r));
+      r.seq  = rec.seq;
+      r.ms   = rec.ms;
+      r.boot = s_boot;
+      for (size_t i = 0; i < LOG_RECORD_ARGS; ++i) r.args[i] = rec.args[i];
+      r.code = rec.code;
+      r.crc  = crc16Ccitt((const uint8_t *)&r, kRecordCrcLen);
+      s_flushSeq++;
+    }
+
+    if (n > 0) {
+      esp_err_t err = esp_partition_write(s_part, slotOffset(s_headSegSeq, s_writeSlot),
+                                          s_batch, n * sizeof(FlashRecord));
+      if (err != ESP_OK) {
+        noteError(err);
+        break;
+      }
+      s_writeSlot += (uint32_t)n;
+      s_endPos.store(s_headSegSeq * kSlotsPerSegment + s_writeSlot, std::memory_order_release);
+      s_stats.flushes++;
+      s_stats.recordsWritten += (uint32_t)n;
+    }
+    if (pending) break;
+  }
+
+  if (s_stats.lost != lostBefore) logEvent(LOG_FLASH_LOG_LOST, (int32_t)(s_stats.lost - lostBefore));
+}
+
+uint32_t flashLogBoot() {
+  return s_boot;
+}
+
+uint32_t flashLogStartPos() {
+  return s_startPos.load(std::memory_order_acquire);
+}
+
+uint32_t flashLogEndPos() {
+  return s_endPos.load(std::memory_order_acquire);
+}
+
+bool flashLogRead(uint32_t pos, FlashLogEntry &out) {
+  if (!s_part) return false;
+  if ((int32_t)(pos - flashLogStartPos()) < 0 || (int32_t)(pos - flashLogEndPos()) >= 0) return false;
+
+  uint32_t segSeq = pos / kSlotsPerSegment;
+  uint32_t idx    = segSeq % s_segCount;
+  FlashSegHeader h;
+  if (!readHeader(idx, h) || h.segSeq != segSeq) return false;
+
+  FlashRecord r;
+  if (esp_partition_read(s_part, slotOffset(segSeq, pos % kSlotsPerSegment), &r, sizeof(r)) != ESP_OK) return false;
+  if (!recordValid(r)) return false;
+
+  // 읽는 사이 세그먼트가 지워지고 다시 쓰였으면 버림
+  if (!readHeader(idx, h) || h.segSeq != segSeq) return false;
+
+  out.boot     = r.boot;
+  out.rec.seq  = r.seq;
+  out.rec.ms   = r.ms;
+  out.rec.code = r.code;
+  for (size_t i = 0; i < LOG_RECORD_ARGS; ++i) out.rec.args[i] = r.args[i];
+  return true;
+}
+
+void getFlashLogStats(FlashLogStats &out) {
+  out = s_stats;
+}
@@ -0,0 +1,87 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file FlashLog.h
+ * @brief 이벤트 로그를 플래시에 남기는 추가 전용(append-only) 보관 로그를 선언합니다.
+ *
+ * RAM 로그 링(EventLog.h)은 재부팅하면 사라지므로, taskFlashLog가 새 레코드를 모아
+ * evlog 파티션(partitions.csv)에 한 번에 씁니다. logEvent()는 플래시를 건드리지 않고,
+ * FLASH_LOG_KICK_RECORDS개마다 taskFlashLog를 깨우기만 합니다.
+ *
+ * 파티션은 지우기 단위(FLASH_LOG_SEGMENT_SIZE)의 세그먼트로 나눠 차례로 채우고, 끝에 닿으면
+ * 처음으로 돌아가 가장 오래된 세그먼트를 지운 뒤 씁니다. 모든 세그먼트가 번갈아 같은 횟수만큼
+ * 지워지므로 마모가 한곳에 몰리지 않습니다. 세그먼트 머리에는 일련번호를, 레코드마다 CRC를 두어
+ * 부팅 때 가장 최근 세그먼트를 찾고, 전원이 끊겨 쓰다 만 레코드는 건너뜁니다.
+ *
+ * 레코드 위치(pos)는 "세그먼트 일련번호 x 세그먼트당 레코드 수 + 칸 번호"이며 재부팅해도 이어서
+ * 증가합니다. 읽기는 어느 태스크에서나 할 수 있고, 읽는 사이 지워진 위치는 실패로 돌려줍니다.
+ */
+
+/**
+ * @brief 플래시에서 읽은 로그 레코드
+ */
+struct FlashLogEntry {
+  uint32_t  boot;  // 기록한 부팅 번호 (1부터)
+  LogRecord rec;   // seq/ms는 그 부팅 기준
+};
+
+/**
+ * @brief 플래시 로그 통계 (이번 부팅의 누적값)
+ */
+struct FlashLogStats {
+  uint32_t segments;        // 파티션의 세그먼트 수 (0이면 파티션 없음)
+  uint32_t flushes;         // 플래시 쓰기 횟수 (모아 쓴 묶음 수)
+  uint32_t recordsWritten;
+  uint32_t segmentErases;
+  uint32_t lost;            // 플래시에 쓰기 전에 RAM 링에서 덮어써진 수
+  uint32_t tornSkipped;     // 마운트 때 발견한, 지난 부팅에서 쓰다 만 레코드 (0 또는 1)
+  uint32_t errors;          // 지우기/쓰기 실패
+};
+
+/**
+ * @brief evlog 파티션을 찾아 가장 최근 세그먼트와 쓸 위치를 복원하고, LOG_BOOT를 기록합니다.
+ *
+ * setup()에서 태스크를 만들기 전에 한 번 호출합니다. 부팅 레코드는 바로 플래시에 씁니다.
+ * @return 파티션이 없으면 false (이후 보관 로그 기능은 아무 일도 하지 않음)
+ */
+bool flashLogInit();
+
+/**
+ * @brief RAM 링에서 아직 플래시에 쓰지 않은 레코드를 지금 모두 씁니다.
+ *
+ * taskFlashLog, 또는 taskFlashLog가 없을 때(setup(), 호스트 벤치)만 호출합니다.
+ */
+void flashLogFlush();
+
+/**
+ * @brief 이번 부팅 번호 (flashLogInit() 전이나 파티션이 없으면 0)
+ */
+uint32_t flashLogBoot();
+
+/**
+ * @brief 플래시에 남아 있는 가장 오래된 위치
+ */
+uint32_t flashLogStartPos();
+
+/**
+ * @brief 다음에 쓸 위치 (가장 최근 레코드 = 반환값 - 1)
+ */
+uint32_t flashLogEndPos();
+
+/**
+ * @brief 위치 pos의 레코드를 읽습니다.
+ * @return 범위 밖, 지워짐, 쓰다 만 레코드(CRC 불일치)면 false
+ */
+bool flashLogRead(uint32_t pos, FlashLogEntry &out);
+
+/**
+ * @brief 플래시 로그 통계를 복사합니다.
+ */
+void getFlashLogStats(FlashLogStats &out);
+
+
+#endif // FLASH_LOG_H
@@ -9,6 +9,11 @@
 #include <freertos/semphr.h>
 #include "DataTypes.h"
 
+// handleCanFrame() 프로토타입이 twai_message_t를 사용하므로 함께 포함합니다.
+extern "C" {
+  #include "driver/twai.h"
+}
+
 /**
  * @file Globals.h
  * @brief 다른 소스 파일에서 공통으로 참조하는 전역 변수들을 'extern'으로 선언합니다.
@@ -25,21 +30,28 @@ extern Preferences prefs; // 비휘발성 저장소(NVS) 라이브러리 객체
 //==============================================================================
 // 시스템 상태 및 설정
 //==============================================================================
-extern SystemState g_state;       // 시스템의 현재 상태를 담는 전역 변수
+extern SystemState g_state;       // 시스템의 현재 상태를 담는 전역 변수 (StateStore.h 규칙으로 접근)
 extern SystemSettings g_settings; // 시스템의 설정값을 담는 전역 변수
 
 
 //==============================================================================
 // FreeRTOS 관련 핸들 및 동기화 객체
 //==============================================================================
-extern SemaphoreHandle_t g_stateMutex;     // g_state 보호를 위한 뮤텍스
-extern QueueHandle_t g_canTxQueue;         // CAN 전송 명령 큐
 extern QueueHandle_t g_serverCmdQueue;     // 서버 수신 명령 큐
 extern TaskHandle_t g_taskCanHandle;       // CAN 통신 태스크 핸들
+extern TaskHandle_t g_taskCanAlertHandle;  // CAN 경고 전달 태스크 핸들
 extern TaskHandle_t g_taskUartHandle;      // UART 통신 태스크 핸들
 extern TaskHandle_t g_taskUiHandle;        // UI 처리 태스크 핸들
+extern TaskHandle_t g_taskRenderHandle;    // 패널 전송(렌더) 태스크 핸들
 extern TaskHandle_t g_taskLogicHandle;     // 로직 처리 태스크 핸들
 extern TaskHandle_t g_taskAlarmHandle;     // 알람 처리 태스크 핸들
+extern TaskHandle_t g_taskFlashLogHandle;  // 플래시 로그 기록 태스크 핸들
+
+
+//==============================================================================
+// 서버 링크
+//==============================================================================
+extern volatile LinkMode g_linkMode;       // 현재 서버 링크 모드 (taskUart만 변경)
 
 
 //==============================================================================
@@ -51,14 +63,11 @@ extern volatile ScreenId g_currentScreen;  // 현재 표시 중인 화면 ID
 extern int16_t g_encoderPos;
 extern int16_t g_lastEncoderPos;
 extern int16_t g_lastScreenEncPos;
-extern int8_t  g_lastEncA;
-extern int8_t  g_lastEncB;
 
 // 로터리 엔코더 버튼 관련 변수
 extern bool    g_lastButton;
 extern volatile bool g_buttonClicked;
 extern volatile bool g_buttonLongClicked;
-extern uint32_t g_buttonPressStartMs;
 
 
 //==============================================================================
@@ -68,18 +77,13 @@ extern uint32_t g_uptimeSeconds;
 extern uint32_t g_lastClockUpdateMs;
 extern uint8_t  g_timeHour;
 extern uint8_t  g_timeMinute;
-extern int16_t  g_lastFeederScheduleMinute;
 
 
 //==============================================================================
 // 알람 및 로깅
 //==============================================================================
 extern volatile AlarmLevel g_alarmLevel; // 현재 알람 레벨
-
-// 간단 로그 버퍼
-extern String g_logBuffer[];
-extern int g_logHead;
-extern int g_logCount;
+// 로그 레코드 링은 EventLog.h 참고
 
 
 //==============================================================================
@@ -91,27 +95,46 @@ void initTft();
 void initCan();
 void initUart();
 void loadSettings();
-void saveSettings();
+void saveSettings();      // Settings.h: 바뀜만 표시, 저장은 taskFlashLog가 모아서
 void resetSystemState();
 
 // 유틸리티
 void playBootBuzzer();
-void playClickBuzzer();
-void logEvent(const char *msg);
+void playClickBuzzer();   // Indicator.h 패턴 시작만 하고 바로 돌아옴
+void logEvent(LogCode code, int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0);  // EventLog.h
 void clearLogs();
 
 // 입력 처리
-void updateRotary();
+void initRotaryInput();
+uint32_t updateRotary();
+void getInputStats(InputStats &out);
 bool fetchButtonClicked();
 bool fetchShortClick();
 bool fetchLongClick();
 
 // 통신
-String buildStatusJson();
+size_t buildStatusJson(char *buf, size_t bufSize);
+size_t buildStatusFrame(uint8_t *buf, size_t bufSize);
+size_t buildTelemetryUpdate(uint8_t *buf, size_t bufSize, uint32_t now);
+void setTelemetryMode(TelemetryMode mode);
+void setTelemetryKeyframeInterval(uint32_t intervalMs);
+void requestTelemetryKeyframe();
+size_t buildLogExport(uint8_t *buf, size_t bufSize);
+size_t buildFlashLogExport(uint8_t *buf, size_t bufSize);
+size_t buildHistoryExport(uint8_t *buf, size_t bufSize);
 void parseServerLine(const String &line);
+void handleServerFrame(const struct Frame &frame);
 void handleServerCommand(const ServerCommand &cmd);
+void setLinkMode(LinkMode mode);
 void handleCanFrame(const twai_message_t &msg);
+bool canRxPush(const twai_message_t &msg);
+size_t canRxApplyPending(size_t maxFrames);
+void canRxPollDriverStats();
+void getCanRxStats(CanRxStats &out);
 void enqueueCanCommand(uint8_t moduleId, uint8_t cmd, int32_t param);
+bool canTxTake(CanTxItem &out, bool includeRoutine);
+void getCanTxStats(CanTxStats &out);
+void getCanCmdTotals(CanCmdStats &out);
 void requestTankPump(bool on);
 void requestTankLight(bool on);
 void requestGrowLedBrightness(uint8_t brightness);
@@ -119,24 +142,25 @@ void requestFeederOnce(uint8_t amountPercent);
 
 // UI
 void drawCurrentScreen();
-void drawDashboard();
-void drawTankScreen();
-void drawGrowScreen();
-void drawNutrientScreen();
-void drawFeederScreen();
-void drawLogScreen();
-void drawSettingsScreen();
+bool uiRefresh(uint32_t changed, uint32_t inputUs);
+bool uiFlush();
+void uiInvalidate();
 void handleTankClick(bool shortClick, bool longClick);
 void handleGrowClick(bool shortClick, bool longClick);
 void handleSettingsClick(bool shortClick, bool longClick);
 void handleLogClick(bool shortClick, bool longClick);
+void handleTrendClick(bool shortClick, bool longClick);
+void handleDiagClick(bool shortClick, bool longClick);
 
 // FreeRTOS 태스크
 void taskCan(void *pvParameters);
+void taskCanAlert(void *pvParameters);
 void taskUart(void *pvParameters);
 void taskUi(void *pvParameters);
+void taskRender(void *pvParameters);
 void taskLogic(void *pvParameters);
 void taskAlarm(void *pvParameters);
+void taskFlashLog(void *pvParameters);
 
 
 #endif // GLOBALS_H
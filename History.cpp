@@ -0,0 +1,314 @@
+#include "Globals.h"
+#include "History.h"
+#include "StateStore.h"
+
+#include <atomic>
+
+/**
+ * @file History.cpp
+ * @brief 센서 이력 링(단계별)과 요약 누적, 시퀀스 락 조회의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 채널 표 (HistoryChannel 순서와 같아야 합니다)
+//------------------------------------------------------------------------------
+
+struct HistoryChannelDef {
+  uint16_t valueOffset;   // SystemState 안의 float 필드
+  uint16_t statusOffset;  // 그 모듈의 ModuleStatus
+  uint16_t scale;         // 보관값 = 값 x scale (int16 범위 안에 들어가야 함)
+};
+
+#define HIST_CH(module, field, scale) \
+  { (uint16_t)offsetof(SystemState, module.field), (uint16_t)offsetof(SystemState, module.status), scale }
+
+const HistoryChannelDef kChannels[] = {
+  HIST_CH(tank, tempC,        100),   // -327.67 ~ 327.67 °C
+  HIST_CH(tank, pH,           1000),  // 0.000 ~ 14.000
+  HIST_CH(tank, do_mgL,       100),
+  HIST_CH(tank, levelPercent, 100),
+  HIST_CH(grow, tempC,        100),
+  HIST_CH(grow, humidity,     100),
+};
+
+#undef HIST_CH
+
+static_assert(sizeof(kChannels) / sizeof(kChannels[0]) == HIST_CHANNEL_COUNT,
+              "kChannels must have one entry per HistoryChannel");
+
+
+//------------------------------------------------------------------------------
+// 저장소
+//------------------------------------------------------------------------------
+// 단계마다 칸 번호 b = 시각 / 간격, 링 위치 = b % 칸 수. s_head는 가장 최근 칸 번호이며,
+// 요약 단계에서는 아직 누적 중인 칸(링에는 칸이 넘어갈 때 기록)입니다.
+
+const int16_t kEmpty = INT16_MIN;  // 샘플 없는 칸
+
+struct HistoryAgg {
+  int16_t min;
+  int16_t max;
+  int16_t avg;
+};
+
+struct HistoryAccum {
+  int32_t  sum;
+  int16_t  min;
+  int16_t  max;
+  uint16_t n;
+};
+
+const size_t kAggTiers = HIST_TIER_COUNT - 1;  // HIST_TIER_RAW 제외
+
+struct ChannelStore {
+  int16_t      raw[HISTORY_RAW_POINTS];
+  HistoryAgg   minute[HISTORY_MINUTE_POINTS];
+  HistoryAgg   quarter[HISTORY_QUARTER_POINTS];
+  HistoryAccum acc[kAggTiers];
+};
+
+static_assert(sizeof(ChannelStore) * HIST_CHANNEL_COUNT <= HISTORY_RAM_BUDGET,
+              "history store exceeds HISTORY_RAM_BUDGET");
+
+const uint32_t kPeriod[HIST_TIER_COUNT] = {
+  HISTORY_RAW_PERIOD_S, HISTORY_MINUTE_PERIOD_S, HISTORY_QUARTER_PERIOD_S
+};
+const uint32_t kPoints[HIST_TIER_COUNT] = {
+  (uint32_t)HISTORY_RAW_POINTS, (uint32_t)HISTORY_MINUTE_POINTS, (uint32_t)HISTORY_QUARTER_POINTS
+};
+
+ChannelStore s_store[HIST_CHANNEL_COUNT];
+bool         s_started = false;
+uint32_t     s_head[HIST_TIER_COUNT];   // 가장 최근 칸 번호
+uint32_t     s_first[HIST_TIER_COUNT];  // 첫 샘플의 칸 번호 (그 앞은 없음)
+
+// 짝수: 안정 상태, 홀수: 쓰기 진행 중 (StateStore와 같은 규칙)
+portMUX_TYPE          s_historyMux = portMUX_INITIALIZER_UNLOCKED;
+std::atomic<uint32_t> s_historySeq{0};
+
+inline HistoryAgg *aggRing(ChannelStore &c, size_t tier) {
+  return tier == HIST_TIER_MINUTE ? c.minute : c.quarter;
+}
+
+int16_t encodeValue(const SystemState &st, const HistoryChannelDef &def) {
+  const uint8_t *base = (const uint8_t *)&st;
+  ModuleStatus status;
+  float v;
+  memcpy(&status, base + def.statusOffset, sizeof(status));
+  memcpy(&v, base + def.valueOffset, sizeof(v));
+  if (status == MODULE_OFFLINE || isnan(v) || isinf(v)) return kEmpty;
+
+  float scaled = v * def.scale;
+  if (scaled >  32767.0f) return  32767;
+  if (scaled < -32767.0f) return -32767;
+  return (int16_t)lroundf(scaled);
+}
+
+void resetAccum(HistoryAccum &a) {
+  a.sum = 0;
+  a.min = INT16_MAX;
+  a.max = INT16_MIN;
+  a.n   = 0;
+}
+
+HistoryAgg accumValue(const HistoryAccum &a) {
+  if (a.n == 0) return { kEmpty, kEmpty, kEmpty };
+  return { a.min, a.max, (int16_t)lroundf((float)a.sum / a.n) };
+}
+
+// 칸 번호 (from, to)를 빈 칸으로 (링 한 바퀴를 넘는 부분은 어차피 덮어쓰므로 생략)
+void clearBuckets(size_t tier, uint32_t from, uint32_t to) {
+  if (to - from <= 1) return;
+  uint32_t count = to - from - 1;
+  if (count > kPoints[tier]) count = kPoints[tier];
+  for (uint32_t b = to - count; b != to; ++b) {
+    uint32_t slot = b % kPoints[tier];
+    for (size_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) {
+      if (tier == HIST_TIER_RAW) s_store[ch].raw[slot] = kEmpty;
+      else aggRing(s_store[ch], tier)[slot] = { kEmpty, kEmpty, kEmpty };
+    }
+  }
+}
+
+// 남아 있는 칸 번호 범위 [lo, hi] (쓰기 구간 밖에서는 시퀀스 락 안에서 호출)
+void bucketRange(size_t tier, uint32_t &lo, uint32_t &hi) {
+  hi = s_head[tier];
+  // 원본은 head 칸까지 링에 있고, 요약 단계의 head 칸은 누적값이므로 링에 한 칸 더 남음
+  uint32_t span = tier == HIST_TIER_RAW ? kPoints[tier] - 1 : kPoints[tier];
+  lo = hi - s_first[tier] > span ? hi - span : s_first[tier];
+}
+
+HistoryAgg readBucket(size_t ch, size_t tier, uint32_t b) {
+  ChannelStore &c = s_store[ch];
+  if (tier == HIST_TIER_RAW) {
+    int16_t v = c.raw[b % kPoints[tier]];
+    return { v, v, v };
+  }
+  if (b == s_head[tier]) return accumValue(c.acc[tier - 1]);
+  return aggRing(c, tier)[b % kPoints[tier]];
+}
+
+inline float decodeValue(int16_t v, uint16_t scale) {
+  return (float)v / scale;
+}
+
+} // namespace
+
+void historyInit() {
+  portENTER_CRITICAL(&s_historyMux);
+  s_historySeq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s_started = false;
+  for (size_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) {
+    ChannelStore &c = s_store[ch];
+    for (size_t i = 0; i < HISTORY_RAW_POINTS; ++i)     c.raw[i] = kEmpty;
+    for (size_t i = 0; i < HISTORY_MINUTE_POINTS; ++i)  c.minute[i] = { kEmpty, kEmpty, kEmpty };
+    for (size_t i = 0; i < HISTORY_QUARTER_POINTS; ++i) c.quarter[i] = { kEmpty, kEmpty, kEmpty };
+    for (size_t t = 0; t < kAggTiers; ++t) resetAccum(c.acc[t]);
+  }
+  s_historySeq.fetch_add(1, std::memory_order_release);
+  portEXIT_CRITICAL(&s_historyMux);
+}
+
+void historySample(uint32_t nowS, const SystemState &st) {
+  int16_t v[HIST_CHANNEL_COUNT];
+  for (size_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) v[ch] = encodeValue(st, kChannels[ch]);
+
+  portENTER_CRITICAL(&s_historyMux);
+  if (s_started && nowS / kPeriod[HIST_TIER_RAW] <= s_head[HIST_TIER_RAW]) {
+    portEXIT_CRITICAL(&s_historyMux);
+    return;
+  }
+  s_historySeq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (size_t tier = 0; tier < HIST_TIER_COUNT; ++tier) {
+    uint32_t b = nowS / kPeriod[tier];
+    if (!s_started) {
+      s_first[tier] = b;
+      s_head[tier]  = b;
+    } else if (b != s_head[tier]) {
+      if (tier != HIST_TIER_RAW) {
+        // 누적 중이던 칸을 링에 기록하고 새 칸을 시작
+        uint32_t slot = s_head[tier] % kPoints[tier];
+        for (size_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) {
+          HistoryAccum &a = s_store[ch].acc[tier - 1];
+          aggRing(s_store[ch], tier)[slot] = accumValue(a);
+          resetAccum(a);
+        }
+      }
+      clearBuckets(tier, s_head[tier], b);
+      s_head[tier] = b;
+    }
+
+    if (tier == HIST_TIER_RAW) {
+      uint32_t slot = b % kPoints[tier];
+      for (size_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) s_store[ch].raw[slot] = v[ch];
+      continue;
+    }
+    for (size_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) {
+      if (v[ch] == kEmpty) continue;
+      HistoryAccum &a = s_store[ch].acc[tier - 1];
+      a.sum += v[ch];
+      if (v[ch] < a.min) a.min = v[ch];
+      if (v[ch] > a.max) a.max = v[ch];
+      a.n++;
+    }
+  }
+  s_started = true;
+
+  s_historySeq.fetch_add(1, std::memory_order_release);
+  portEXIT_CRITICAL(&s_historyMux);
+
+  statePublishChanges(STATE_CHG_HISTORY);
+}
+
+uint32_t historyPeriod(HistoryTier tier) {
+  return tier < HIST_TIER_COUNT ? kPeriod[tier] : 0;
+}
+
+uint16_t historyScale(HistoryChannel ch) {
+  return ch < HIST_CHANNEL_COUNT ? kChannels[ch].scale : 1;
+}
+
+int16_t historyEncode(HistoryChannel ch, const SystemState &st) {
+  return ch < HIST_CHANNEL_COUNT ? encodeValue(st, kChannels[ch]) : kEmpty;
+}
+
+HistoryTier historyTierFor(uint32_t spanS) {
+  for (size_t tier = 0; tier < HIST_TIER_COUNT; ++tier) {
+    if (spanS <= kPeriod[tier] * kPoints[tier]) return (HistoryTier)tier;
+  }
+  return (HistoryTier)(HIST_TIER_COUNT - 1);
+}
+
+bool historyNewest(HistoryTier tier, uint32_t &tOut) {
+  if (tier >= HIST_TIER_COUNT) return false;
+  for (;;) {
+    uint32_t before = s_historySeq.load(std::memory_order_acquire);
+    if (before & 1) { taskYIELD(); continue; }
+    bool started = s_started;
+    uint32_t head = s_head[tier];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_historySeq.load(std::memory_order_relaxed) != before) continue;
+    if (!started) return false;
+    tOut = head * kPeriod[tier];
+    return true;
+  }
+}
+
+bool historyOldest(HistoryTier tier, uint32_t &tOut) {
+  if (tier >= HIST_TIER_COUNT) return false;
+  for (;;) {
+    uint32_t before = s_historySeq.load(std::memory_order_acquire);
+    if (before & 1) { taskYIELD(); continue; }
+    bool started = s_started;
+    uint32_t lo, hi;
+    bucketRange(tier, lo, hi);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_historySeq.load(std::memory_order_relaxed) != before) continue;
+    if (!started) return false;
+    tOut = lo * kPeriod[tier];
+    return true;
+  }
+}
+
+size_t historyQuery(HistoryChannel ch, HistoryTier tier, uint32_t fromS, uint32_t toS,
+                    HistoryPoint *out, size_t maxPoints) {
+  if (ch >= HIST_CHANNEL_COUNT || tier >= HIST_TIER_COUNT || maxPoints == 0 || fromS > toS) return 0;
+  const uint32_t period = kPeriod[tier];
+  const uint16_t scale  = kChannels[ch].scale;
+
+  for (;;) {
+    uint32_t before = s_historySeq.load(std::memory_order_acquire);
+    if (before & 1) {
+      // 쓰는 쪽이 다른 코어에서 구간을 끝낼 때까지 양보
+      taskYIELD();
+      continue;
+    }
+
+    size_t n = 0;
+    if (s_started) {
+      uint32_t lo, hi;
+      bucketRange(tier, lo, hi);
+      uint32_t from = fromS / period;
+      uint32_t to   = toS / period;
+      if (from < lo) from = lo;
+      if (to > hi) to = hi;
+      for (uint32_t b = from; b <= to && n < maxPoints; ++b, ++n) {
+        HistoryAgg a = readBucket(ch, tier, b);
+        HistoryPoint &p = out[n];
+        p.t     = b * period;
+        p.valid = a.avg != kEmpty;
+        p.min   = p.valid ? decodeValue(a.min, scale) : 0.0f;
+        p.max   = p.valid ? decodeValue(a.max, scale) : 0.0f;
+        p.avg   = p.valid ? decodeValue(a.avg, scale) : 0.0f;
+      }
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_historySeq.load(std::memory_order_relaxed) == before) return n;
+  }
+}
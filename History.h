@@ -0,0 +1,85 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file History.h
+ * @brief 센서 채널별 다단계 이력 저장소(원본 + 최소/최대/평균 요약)를 선언합니다.
+ *
+ * taskLogic이 1초 시계가 넘어갈 때마다 historySample()로 채널마다 값 하나를 넣으면,
+ * 같은 값이 세 단계에 동시에 들어갑니다.
+ *  - 원본: HISTORY_RAW_POINTS개 (1초 x 10분)
+ *  - 1분: 그 1분 동안의 최소/최대/평균 HISTORY_MINUTE_POINTS개 (24시간)
+ *  - 15분: 같은 방식으로 HISTORY_QUARTER_POINTS개 (7일)
+ *
+ * 각 단계는 "시각 / 간격"을 칸 번호로 쓰는 고정 크기 링이라 샘플 하나를 넣는 비용은
+ * 단계 수에 비례하는 상수이고, 오래된 칸은 덮어쓰기만 합니다. 요약 단계는 진행 중인 칸의
+ * 최소/최대/합계를 누적해 두었다가 칸이 넘어갈 때 한 번 기록합니다. 값은 채널 배율을 곱한
+ * int16으로 보관하며, 모듈이 오프라인이었던 칸은 빈 칸으로 남습니다.
+ *
+ * 쓰는 쪽은 taskLogic 하나뿐이고, 읽는 쪽(UI 그래프, 서버 내보내기)은 g_state와 같은
+ * 시퀀스 락으로 복사 중 쓰기가 끼어들었는지 확인해 다시 읽으므로 서로 막지 않습니다.
+ */
+
+/**
+ * @brief 저장소를 모두 빈 칸으로 되돌립니다. setup()에서 태스크를 만들기 전에 호출합니다.
+ */
+void historyInit();
+
+/**
+ * @brief 시각 nowS의 채널 값들을 넣습니다. (taskLogic 전용, 1초에 한 번)
+ *
+ * 이전 샘플 이후 건너뛴 칸은 빈 칸으로 채웁니다. 이전 샘플보다 이른 시각은 무시합니다.
+ * @param nowS 부팅 후 초 (g_uptimeSeconds)
+ * @param st   이번 주기의 상태 복사본 (오프라인 모듈의 채널은 빈 값)
+ */
+void historySample(uint32_t nowS, const SystemState &st);
+
+/**
+ * @brief 단계의 칸 간격(초)
+ */
+uint32_t historyPeriod(HistoryTier tier);
+
+/**
+ * @brief 채널 값의 보관 배율 (보관값 = 값 x 배율, 서버 내보내기에서 사용)
+ */
+uint16_t historyScale(HistoryChannel ch);
+
+/**
+ * @brief 상태 복사본에서 채널 값을 보관 형식(값 x 배율, 반올림)으로 꺼냅니다.
+ * @return 모듈이 오프라인이거나 값이 없으면 INT16_MIN
+ */
+int16_t historyEncode(HistoryChannel ch, const SystemState &st);
+
+/**
+ * @brief spanS초 구간을 담을 수 있는 가장 촘촘한 단계를 고릅니다. (넘으면 가장 긴 단계)
+ */
+HistoryTier historyTierFor(uint32_t spanS);
+
+/**
+ * @brief 단계에서 가장 최근 칸의 시작 시각을 돌려줍니다. 요약 단계는 진행 중인 칸입니다.
+ * @return 아직 샘플이 없으면 false
+ */
+bool historyNewest(HistoryTier tier, uint32_t &tOut);
+
+/**
+ * @brief 단계에 남아 있는 가장 오래된 칸의 시작 시각을 돌려줍니다.
+ * @return 아직 샘플이 없으면 false
+ */
+bool historyOldest(HistoryTier tier, uint32_t &tOut);
+
+/**
+ * @brief 채널의 [fromS, toS] 구간에 걸친 칸들을 오래된 것부터 복사합니다.
+ *
+ * 남아 있지 않은 앞부분은 건너뛰고, 빈 칸도 valid = false로 자리를 채워 돌려주므로
+ * 결과의 시각은 간격만큼씩 이어집니다. 요약 단계의 진행 중인 칸은 지금까지의 값입니다.
+ * @param maxPoints out 크기 (넘는 뒷부분은 잘림)
+ * @return 복사한 칸 수
+ */
+size_t historyQuery(HistoryChannel ch, HistoryTier tier, uint32_t fromS, uint32_t toS,
+                    HistoryPoint *out, size_t maxPoints);
+
+
+#endif // HISTORY_H
@@ -0,0 +1,226 @@
+#include "Globals.h"
+#include "Indicator.h"
+
+#include <esp_timer.h>
+
+/**
+ * @file Indicator.cpp
+ * @brief 부저/LED 패턴 표와 esp_timer로 단계를 넘기는 시퀀서 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 패턴 표
+//------------------------------------------------------------------------------
+
+// 우선순위: 높을수록 같은 출력을 먼저 차지 (칸마다 패턴 하나)
+enum IndicatorPriority : uint8_t {
+  IND_PRIO_UI = 0,
+  IND_PRIO_BOOT,
+  IND_PRIO_ALARM,
+  IND_PRIO_COUNT
+};
+
+struct IndStep {
+  uint16_t ms;   // 유지 시간 (0 불가)
+  uint8_t  out;  // 이 단계의 출력 비트 (마스크 밖 비트는 무시)
+};
+
+struct IndPattern {
+  const IndStep *steps;
+  uint8_t        count;
+  uint8_t        mask;   // 이 패턴이 차지하는 출력
+  uint8_t        prio;   // IndicatorPriority
+  bool           loop;   // 끝나면 처음부터 (indicatorStop까지)
+};
+
+constexpr IndStep kBootSteps[] = {
+  { 200, IND_OUT_BUZZER | IND_OUT_LEDS }, { 200, 0 },
+  { 200, IND_OUT_BUZZER | IND_OUT_LEDS }, { 200, 0 },
+};
+constexpr IndStep kClickSteps[]   = { { 50, IND_OUT_BUZZER } };
+constexpr IndStep kWarningSteps[] = { { 500, IND_OUT_BUZZER }, { 500, 0 } };
+constexpr IndStep kErrorSteps[]   = { { 1000, IND_OUT_BUZZER }, { 500, 0 } };
+
+#define IND_PATTERN(steps, mask, prio, loop) \
+  { steps, (uint8_t)(sizeof(steps) / sizeof(steps[0])), (uint8_t)(mask), prio, loop }
+
+// IndicatorPattern 순서
+constexpr IndPattern kPatterns[] = {
+  IND_PATTERN(kBootSteps,    IND_OUT_BUZZER | IND_OUT_LEDS, IND_PRIO_BOOT,  false),
+  IND_PATTERN(kClickSteps,   IND_OUT_BUZZER,                IND_PRIO_UI,    false),
+  IND_PATTERN(kWarningSteps, IND_OUT_BUZZER,                IND_PRIO_ALARM, true),
+  IND_PATTERN(kErrorSteps,   IND_OUT_BUZZER,                IND_PRIO_ALARM, true),
+};
+
+static_assert(sizeof(kPatterns) / sizeof(kPatterns[0]) == IND_PATTERN_COUNT,
+              "kPatterns must have one entry per IndicatorPattern");
+
+constexpr bool patternValid(const IndPattern &p) {
+  if (p.count == 0 || p.prio >= IND_PRIO_COUNT) return false;
+  for (uint8_t i = 0; i < p.count; ++i) {
+    if (p.steps[i].ms == 0) return false;
+  }
+  return true;
+}
+
+constexpr bool patternsValid() {
+  for (const IndPattern &p : kPatterns) {
+    if (!patternValid(p)) return false;
+  }
+  return true;
+}
+
+static_assert(patternsValid(), "indicator pattern needs steps, each with a non-zero duration");
+
+// 출력 비트 → 핀
+struct IndPin {
+  uint8_t bit;
+  int     pin;
+};
+
+constexpr IndPin kPins[] = {
+  { IND_OUT_BUZZER, PIN_BUZZER },
+  { IND_OUT_RED,    PIN_LED_RED },
+  { IND_OUT_GREEN,  PIN_LED_GREEN },
+  { IND_OUT_BLUE,   PIN_LED_BLUE },
+};
+
+
+//------------------------------------------------------------------------------
+// 재생 상태 (s_indMux 안에서만 접근)
+//------------------------------------------------------------------------------
+
+struct IndSlot {
+  const IndPattern *pat;     // nullptr이면 빈 칸
+  uint8_t           step;
+  int64_t           stepEndUs;
+};
+
+portMUX_TYPE       s_indMux = portMUX_INITIALIZER_UNLOCKED;
+esp_timer_handle_t s_indTimer = nullptr;
+IndSlot            s_slots[IND_PRIO_COUNT];
+uint8_t            s_base = 0;
+uint8_t            s_out  = 0;   // 지금 핀에 나가 있는 출력
+IndicatorStats     s_stats = {};
+
+// 끝난 단계를 넘깁니다. 타이머가 늦었으면 밀린 단계를 한꺼번에 넘김 (시각은 누적)
+void advance(int64_t nowUs) {
+  for (IndSlot &s : s_slots) {
+    while (s.pat && nowUs >= s.stepEndUs) {
+      if (++s.step >= s.pat->count) {
+        if (!s.pat->loop) {
+          s.pat = nullptr;
+          break;
+        }
+        s.step = 0;
+      }
+      s.stepEndUs += (int64_t)s.pat->steps[s.step].ms * 1000;
+    }
+  }
+}
+
+// 우선순위가 높은 칸부터 출력을 차지하고, 남은 출력은 평상 상태
+uint8_t compose() {
+  uint8_t out = 0;
+  uint8_t claimed = 0;
+  for (int p = IND_PRIO_COUNT - 1; p >= 0; --p) {
+    const IndSlot &s = s_slots[p];
+    if (!s.pat) continue;
+    out |= s.pat->steps[s.step].out & s.pat->mask & ~claimed;
+    claimed |= s.pat->mask;
+  }
+  return out | (s_base & ~claimed);
+}
+
+// 바뀐 출력 핀만 씁니다.
+void writeOutputs() {
+  uint8_t out = compose();
+  uint8_t diff = out ^ s_out;
+  for (const IndPin &p : kPins) {
+    if (diff & p.bit) {
+      digitalWrite(p.pin, (out & p.bit) ? HIGH : LOW);
+      s_stats.pinWrites++;
+    }
+  }
+  s_out = out;
+}
+
+// 출력을 반영하고 다음 단계 경계에 타이머를 겁니다. (s_indMux 안에서)
+void applyAndArm(int64_t nowUs) {
+  writeOutputs();
+
+  int64_t next = INT64_MAX;
+  for (const IndSlot &s : s_slots) {
+    if (s.pat && s.stepEndUs < next) next = s.stepEndUs;
+  }
+  if (!s_indTimer) return;
+  esp_timer_stop(s_indTimer);
+  if (next != INT64_MAX) {
+    esp_timer_start_once(s_indTimer, next > nowUs ? (uint64_t)(next - nowUs) : 1);
+  }
+}
+
+void onStepTimer(void *) {
+  portENTER_CRITICAL(&s_indMux);
+  int64_t now = esp_timer_get_time();
+  s_stats.timerFires++;
+  advance(now);
+  applyAndArm(now);
+  portEXIT_CRITICAL(&s_indMux);
+}
+
+} // namespace
+
+void indicatorInit() {
+  esp_timer_create_args_t args = {};
+  args.callback = onStepTimer;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "indicator";
+  esp_timer_create(&args, &s_indTimer);
+}
+
+void indicatorPlay(IndicatorPattern p) {
+  if (p >= IND_PATTERN_COUNT) return;
+  const IndPattern &pat = kPatterns[p];
+  portENTER_CRITICAL(&s_indMux);
+  int64_t now = esp_timer_get_time();
+  s_stats.plays++;
+  advance(now);
+  IndSlot &s = s_slots[pat.prio];
+  s.pat = &pat;
+  s.step = 0;
+  s.stepEndUs = now + (int64_t)pat.steps[0].ms * 1000;
+  applyAndArm(now);
+  portEXIT_CRITICAL(&s_indMux);
+}
+
+void indicatorStop(IndicatorPattern p) {
+  if (p >= IND_PATTERN_COUNT) return;
+  const IndPattern &pat = kPatterns[p];
+  portENTER_CRITICAL(&s_indMux);
+  IndSlot &s = s_slots[pat.prio];
+  if (s.pat == &pat) {
+    int64_t now = esp_timer_get_time();
+    s.pat = nullptr;
+    advance(now);
+    applyAndArm(now);
+  }
+  portEXIT_CRITICAL(&s_indMux);
+}
+
+void indicatorSetBase(uint8_t outputs) {
+  portENTER_CRITICAL(&s_indMux);
+  if (outputs != s_base) {
+    s_base = outputs;
+    writeOutputs();  // 단계 경계는 그대로이므로 타이머는 다시 걸지 않음
+  }
+  portEXIT_CRITICAL(&s_indMux);
+}
+
+void getIndicatorStats(IndicatorStats &out) {
+  portENTER_CRITICAL(&s_indMux);
+  out = s_stats;
+  portEXIT_CRITICAL(&s_indMux);
+}
@@ -0,0 +1,67 @@
+#ifndef INDICATOR_H
+#define INDICATOR_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file Indicator.h
+ * @brief 부저와 RGB 상태 LED를 단계 표(켬/끔 + 시간)대로 울리는 패턴 시퀀서를 선언합니다.
+ *
+ * 패턴은 Indicator.cpp의 constexpr 표에 "출력 비트, 유지 시간" 단계들로 적혀 있고,
+ * 단계 경계마다 esp_timer 콜백 하나가 출력을 바꾼 뒤 다음 경계에 타이머를 다시 겁니다.
+ * 패턴을 시작한 태스크는 기다리지 않고, 울리는 동안 어느 태스크도 주기적으로 깨지 않습니다.
+ *
+ * 패턴마다 우선순위와 차지하는 출력(마스크)이 있어, 같은 출력은 우선순위가 높은 패턴이
+ * 씁니다. 경보가 울리는 동안의 클릭음은 들리지 않고, 클릭음 도중 경보가 오면 바로 경보로
+ * 바뀝니다. 높은 패턴이 끝나면 아래 패턴이 하던 단계에서 이어 울립니다.
+ * 어느 패턴도 차지하지 않은 출력은 indicatorSetBase()로 정한 평상 상태를 따릅니다.
+ */
+
+// 출력 비트
+const uint8_t IND_OUT_BUZZER = 0x01;
+const uint8_t IND_OUT_RED    = 0x02;
+const uint8_t IND_OUT_GREEN  = 0x04;
+const uint8_t IND_OUT_BLUE   = 0x08;
+const uint8_t IND_OUT_LEDS   = IND_OUT_RED | IND_OUT_GREEN | IND_OUT_BLUE;
+
+/**
+ * @brief 시퀀서 통계 (누적값)
+ */
+struct IndicatorStats {
+  uint32_t plays;       // indicatorPlay() 호출 수
+  uint32_t timerFires;  // 단계 경계 타이머 콜백 수 (= 울리는 동안 깨어난 횟수)
+  uint32_t pinWrites;   // 실제로 바뀐 출력 핀 쓰기 수
+};
+
+/**
+ * @brief 단계 타이머를 만듭니다. initPins() 뒤, 첫 indicatorPlay() 전에 호출합니다.
+ */
+void indicatorInit();
+
+/**
+ * @brief 패턴을 처음 단계부터 시작합니다. (같은 우선순위에서 울리던 패턴은 대체)
+ *
+ * 출력만 바꾸고 타이머를 걸어 두므로 바로 돌아옵니다.
+ */
+void indicatorPlay(IndicatorPattern p);
+
+/**
+ * @brief 울리고 있는 패턴 p를 멈춥니다. (반복 패턴 끄기, 다른 패턴이면 무시)
+ */
+void indicatorStop(IndicatorPattern p);
+
+/**
+ * @brief 패턴이 차지하지 않은 출력의 평상 상태를 정합니다. (IND_OUT_* 비트)
+ *
+ * 값이 같으면 아무것도 하지 않으므로 매 주기 불러도 됩니다.
+ */
+void indicatorSetBase(uint8_t outputs);
+
+/**
+ * @brief 시퀀서 통계를 복사합니다.
+ */
+void getIndicatorStats(IndicatorStats &out);
+
+
+#endif // INDICATOR_H
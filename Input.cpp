@@ -1,55 +1,207 @@
 #include "Globals.h"
 #include "Input.h"
 
+#include <atomic>
+
 /**
  * @file Input.cpp
  * @brief 로터리 엔코더 입력 처리 함수의 실제 구현을 포함합니다.
  */
 
-void updateRotary() {
-  // ===== 로터리 인코더 (A falling edge 기준으로 1 step) =====
-  static uint32_t lastStepTime = 0;
-
-  int a = digitalRead(PIN_ROTARY_A);
-  int b = digitalRead(PIN_ROTARY_B);
-
-  // 이전에 HIGH였다가 지금 LOW가 되면(A falling edge) 한 스텝으로 간주
-  if (g_lastEncA == HIGH && a == LOW) {
-    uint32_t now = millis();
-    // 간단한 디바운스 (2ms 이상 간격)
-    if (now - lastStepTime > 2) {
-      if (b == HIGH) {
-        g_encoderPos++;   // 한 방향
-      } else {
-        g_encoderPos--;   // 반대 방향
-      }
-      lastStepTime = now;
-    }
+namespace {
+
+//------------------------------------------------------------------------------
+// 입력 이벤트 링 (ISR 생산자 / taskUi 소비자, 락 없음)
+//------------------------------------------------------------------------------
+// 엔코더와 버튼 ISR은 모두 같은 코어의 GPIO 인터럽트 디스패처에서 차례로 실행되므로
+// 생산자는 하나로 볼 수 있습니다.
+static_assert((INPUT_EVENT_RING_SIZE & (INPUT_EVENT_RING_SIZE - 1)) == 0,
+              "INPUT_EVENT_RING_SIZE must be a power of two");
+
+enum InputEventType : uint8_t {
+  INPUT_EV_STEP   = 0,  // value: +1 / -1 (디텐트 한 칸)
+  INPUT_EV_BUTTON = 1,  // value: 1 눌림 / 0 뗌
+};
+
+struct InputEvent {
+  uint8_t  type;
+  int8_t   value;
+  uint32_t us;    // ISR에서 찍은 micros()
+};
+
+InputEvent            s_eventRing[INPUT_EVENT_RING_SIZE];
+std::atomic<uint32_t> s_eventHead{0};  // ISR만 증가
+std::atomic<uint32_t> s_eventTail{0};  // updateRotary()만 증가
+
+// ISR 쪽 상태와 통계
+uint8_t  s_encState = 0;   // 직전 (A << 1) | B
+int8_t   s_encAccum = 0;   // 디텐트에 도달하기 전까지 누적한 전이
+bool     s_swLevelLow = false;
+std::atomic<uint32_t> s_invalidStates{0};
+std::atomic<uint32_t> s_overflowDrops{0};
+std::atomic<uint32_t> s_highWater{0};
+
+// 소비자 쪽 상태와 통계
+uint32_t s_steps         = 0;
+uint32_t s_buttonEdges   = 0;
+uint32_t s_bounceRejects = 0;
+uint32_t s_pressStartUs  = 0;
+uint32_t s_lastStepUs    = 0;
+int32_t  s_velocity      = 0;   // 스텝/초 (부호 = 방향)
+std::atomic<int32_t>  s_velocityOut{0};
+std::atomic<uint32_t> s_lastStepOutUs{0};
+
+// [직전 상태 * 4 + 현재 상태] → 전이 방향. 0은 변화 없음 또는 두 상이 동시에 바뀐 경우.
+// A 하강 에지에서 B가 HIGH이면 +1 (3 → 1 → 0 → 2 → 3)
+const int8_t kQuadTable[16] = {
+   0, -1, +1,  0,
+  +1,  0,  0, -1,
+  -1,  0,  0, +1,
+   0, +1, -1,  0,
+};
+
+inline uint8_t readEncoderState() {
+  return (uint8_t)((digitalRead(PIN_ROTARY_A) ? 2 : 0) | (digitalRead(PIN_ROTARY_B) ? 1 : 0));
+}
+
+void IRAM_ATTR pushEvent(uint8_t type, int8_t value) {
+  uint32_t head = s_eventHead.load(std::memory_order_relaxed);
+  uint32_t tail = s_eventTail.load(std::memory_order_acquire);
+  uint32_t depth = head - tail;
+
+  if (depth >= INPUT_EVENT_RING_SIZE) {
+    s_overflowDrops.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  InputEvent &ev = s_eventRing[head & (INPUT_EVENT_RING_SIZE - 1)];
+  ev.type  = type;
+  ev.value = value;
+  ev.us    = micros();
+  s_eventHead.store(head + 1, std::memory_order_release);
+
+  if (depth + 1 > s_highWater.load(std::memory_order_relaxed)) {
+    s_highWater.store(depth + 1, std::memory_order_relaxed);
+  }
+
+  if (g_taskUiHandle) {
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(g_taskUiHandle, UI_NOTIFY_INPUT, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+// A/B 두 핀의 CHANGE 인터럽트
+void IRAM_ATTR encoderIsr() {
+  uint8_t cur = readEncoderState();
+  uint8_t prev = s_encState;
+  if (cur == prev) return;
+  s_encState = cur;
+
+  int8_t dir = kQuadTable[(prev << 2) | cur];
+  if (dir == 0) {
+    s_invalidStates.fetch_add(1, std::memory_order_relaxed);
+    return;
   }
 
-  g_lastEncA = a;
-  g_lastEncB = b;
+  // 접점 채터링은 +1/-1이 번갈아 나와 상쇄되고, 한 디텐트를 다 돌아야 스텝이 됩니다.
+  s_encAccum += dir;
+  if (s_encAccum >= ENCODER_TRANSITIONS_PER_STEP) {
+    s_encAccum = 0;
+    pushEvent(INPUT_EV_STEP, +1);
+  } else if (s_encAccum <= -ENCODER_TRANSITIONS_PER_STEP) {
+    s_encAccum = 0;
+    pushEvent(INPUT_EV_STEP, -1);
+  }
+}
+
+// 스위치 핀의 CHANGE 인터럽트 (디바운스는 소비자가 시간 간격으로 처리)
+void IRAM_ATTR buttonIsr() {
+  bool low = (digitalRead(PIN_ROTARY_SW) == LOW);
+  if (low == s_swLevelLow) return;
+  s_swLevelLow = low;
+  pushEvent(INPUT_EV_BUTTON, low ? 1 : 0);
+}
+
+void handleStep(const InputEvent &ev) {
+  g_encoderPos += ev.value;
+  s_steps++;
 
-  // ===== 로터리 버튼 (짧은 클릭 / 긴 클릭) =====
-  bool btnPressed = (digitalRead(PIN_ROTARY_SW) == LOW); // LOW면 눌림
-  uint32_t nowMs = millis();
+  // 직전 스텝과의 간격으로 순간 속도를 구하고 지수 평균 (방향이 바뀌면 새로 시작)
+  uint32_t dt = ev.us - s_lastStepUs;
+  bool fresh = s_steps == 1 || dt >= ENCODER_VELOCITY_IDLE_MS * 1000u ||
+               (s_velocity > 0) != (ev.value > 0);
+  int32_t inst = (int32_t)(1000000u / (dt ? dt : 1)) * ev.value;
+  s_velocity = fresh ? ev.value : (s_velocity * 3 + inst) / 4;
+  s_lastStepUs = ev.us;
 
-  if (btnPressed && !g_lastButton) {
+  s_velocityOut.store(s_velocity, std::memory_order_relaxed);
+  s_lastStepOutUs.store(ev.us, std::memory_order_relaxed);
+}
+
+void handleButton(const InputEvent &ev) {
+  bool pressed = ev.value != 0;
+  if (pressed == g_lastButton) return;
+  g_lastButton = pressed;
+  s_buttonEdges++;
+
+  if (pressed) {
     // 버튼이 막 눌리기 시작한 시점
-    g_buttonPressStartMs = nowMs;
-  } else if (!btnPressed && g_lastButton) {
-    // 버튼에서 손을 뗀 시점 → 눌려 있던 시간 계산
-    uint32_t pressDuration = nowMs - g_buttonPressStartMs;
-    if (pressDuration >= 700) {
-      // 700ms 이상: 긴 클릭으로 간주
-      g_buttonLongClicked = true;
-    } else {
-      // 700ms 미만: 짧은 클릭으로 간주
-      g_buttonClicked = true;
-    }
+    s_pressStartUs = ev.us;
+    return;
   }
 
-  g_lastButton = btnPressed;
+  // 버튼에서 손을 뗀 시점 → 눌려 있던 시간 계산
+  uint32_t pressMs = (ev.us - s_pressStartUs) / 1000u;
+  if (pressMs < BUTTON_DEBOUNCE_MS) {
+    s_bounceRejects++;
+  } else if (pressMs >= BUTTON_LONG_CLICK_MS) {
+    g_buttonLongClicked = true;
+  } else {
+    g_buttonClicked = true;
+  }
+}
+
+} // namespace
+
+void initRotaryInput() {
+  s_encState   = readEncoderState();
+  s_encAccum   = 0;
+  s_swLevelLow = (digitalRead(PIN_ROTARY_SW) == LOW);
+
+  attachInterrupt(digitalPinToInterrupt(PIN_ROTARY_A),  encoderIsr, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(PIN_ROTARY_B),  encoderIsr, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(PIN_ROTARY_SW), buttonIsr,  CHANGE);
+}
+
+uint32_t updateRotary() {
+  uint32_t tail = s_eventTail.load(std::memory_order_relaxed);
+  uint32_t head = s_eventHead.load(std::memory_order_acquire);
+  uint32_t firstUs = 0;
+
+  if (tail != head) firstUs = s_eventRing[tail & (INPUT_EVENT_RING_SIZE - 1)].us;
+  for (; tail != head; ++tail) {
+    const InputEvent &ev = s_eventRing[tail & (INPUT_EVENT_RING_SIZE - 1)];
+    if (ev.type == INPUT_EV_STEP) handleStep(ev);
+    else handleButton(ev);
+  }
+  s_eventTail.store(tail, std::memory_order_release);
+  return firstUs;
+}
+
+int32_t getEncoderVelocity() {
+  uint32_t lastUs = s_lastStepOutUs.load(std::memory_order_relaxed);
+  if (micros() - lastUs >= ENCODER_VELOCITY_IDLE_MS * 1000u) return 0;
+  return s_velocityOut.load(std::memory_order_relaxed);
+}
+
+void getInputStats(InputStats &out) {
+  out.steps         = s_steps;
+  out.invalidStates = s_invalidStates.load(std::memory_order_relaxed);
+  out.buttonEdges   = s_buttonEdges;
+  out.bounceRejects = s_bounceRejects;
+  out.overflowDrops = s_overflowDrops.load(std::memory_order_relaxed);
+  out.highWater     = s_highWater.load(std::memory_order_relaxed);
 }
 
 bool fetchShortClick() {
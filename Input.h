@@ -1,16 +1,40 @@
 #ifndef INPUT_H
 #define INPUT_H
 
+#include <Arduino.h>
+#include "DataTypes.h"
+
 /**
  * @file Input.h
  * @brief 로터리 엔코더 입력 처리에 관련된 함수 선언을 포함합니다.
+ *
+ * A/B/SW 핀의 GPIO 인터럽트가 에지마다 상태 표로 회전 방향을 판정하고, 디텐트 단위 스텝과
+ * 버튼 에지를 시각과 함께 이벤트 링에 넣은 뒤 taskUi를 UI_NOTIFY_INPUT 비트로 깨웁니다.
+ * 화면을 그리는 동안에도 에지를 놓치지 않으며, updateRotary()는 쌓인 이벤트를 꺼내 반영합니다.
+ */
+
+/**
+ * @brief 엔코더/버튼 핀에 인터럽트를 등록합니다. initPins()에서 핀 설정 후 한 번 호출합니다.
+ */
+void initRotaryInput();
+
+/**
+ * @brief ISR이 쌓은 회전/버튼 이벤트를 꺼내 g_encoderPos와 클릭 상태에 반영합니다.
+ * UI 태스크에서만 호출해야 합니다. (이벤트 링의 유일한 소비자)
+ * @return 꺼낸 이벤트 중 가장 이른 것의 ISR 시각 (micros()), 이벤트가 없으면 0
+ */
+uint32_t updateRotary();
+
+/**
+ * @brief 최근 회전 속도를 돌려줍니다. (값 입력 가속용)
+ * @return 스텝/초, 부호는 방향. ENCODER_VELOCITY_IDLE_MS 동안 스텝이 없으면 0
  */
+int32_t getEncoderVelocity();
 
 /**
- * @brief 로터리 엔코더의 회전과 버튼 상태를 읽고 내부 상태를 업데이트합니다.
- * 이 함수는 UI 태스크에서 주기적으로 호출되어야 합니다.
+ * @brief 입력 통계를 복사합니다. 소비자 쪽 값은 taskUi에서 갱신되므로 근사값입니다.
  */
-void updateRotary();
+void getInputStats(InputStats &out);
 
 /**
  * @brief 짧은 클릭 이벤트가 발생했는지 확인하고 상태를 초기화합니다.
@@ -0,0 +1,150 @@
+#include "Globals.h"
+#include "Profile.h"
+#include "StateStore.h"
+
+/**
+ * @file Profile.cpp
+ * @brief 태스크 프로파일 표와 루프/락 계측, 1초 창 CPU 점유 계산의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+// ProfileTask 순서
+TaskHandle_t *const kHandles[] = {
+  &g_taskCanHandle, &g_taskUartHandle, &g_taskUiHandle, &g_taskLogicHandle,
+  &g_taskAlarmHandle, &g_taskRenderHandle, &g_taskFlashLogHandle,
+};
+
+const char *const kNames[] = {
+  "CAN", "UART", "UI", "Logic", "Alarm", "Render", "Flash",
+};
+
+static_assert(sizeof(kHandles) / sizeof(kHandles[0]) == PROF_TASK_COUNT,
+              "kHandles must have one entry per ProfileTask");
+static_assert(sizeof(kNames) / sizeof(kNames[0]) == PROF_TASK_COUNT,
+              "kNames must have one entry per ProfileTask");
+
+portMUX_TYPE s_profMux = portMUX_INITIALIZER_UNLOCKED;
+TaskProfile  s_prof[PROF_TASK_COUNT];          // s_profMux 안에서만 접근
+uint32_t     s_loopStartUs[PROF_TASK_COUNT];   // 태스크마다 자기 칸만 씀
+uint32_t     s_windowBusyUs[PROF_TASK_COUNT];  // 창 시작 때의 busyUs (s_profMux 안에서만)
+uint32_t     s_windowStartUs = 0;
+
+// 16us부터 4배 간격
+inline uint8_t bucketOf(uint32_t us) {
+  if (us < 16) return 0;
+  uint8_t b = (uint8_t)((31 - __builtin_clz(us)) / 2 - 1);
+  return b < PROFILE_HIST_BUCKETS ? b : (uint8_t)(PROFILE_HIST_BUCKETS - 1);
+}
+
+int currentTask() {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  for (size_t t = 0; t < PROF_TASK_COUNT; ++t) {
+    if (*kHandles[t] == self) return (int)t;
+  }
+  return -1;
+}
+
+} // namespace
+
+void profileLoopBegin(ProfileTask task) {
+  s_loopStartUs[task] = micros();
+}
+
+void profileLoopEnd(ProfileTask task) {
+  uint32_t us = micros() - s_loopStartUs[task];
+  uint8_t b = bucketOf(us);
+
+  portENTER_CRITICAL(&s_profMux);
+  TaskProfile &p = s_prof[task];
+  p.loops++;
+  p.busyUs += us;
+  if (us > p.maxUs) p.maxUs = us;
+  p.hist[b]++;
+  portEXIT_CRITICAL(&s_profMux);
+}
+
+void profileLockWait(uint32_t waitUs) {
+  if (waitUs < PROFILE_LOCK_CONTENDED_US) return;
+  int t = currentTask();
+  if (t < 0) return;
+
+  portENTER_CRITICAL(&s_profMux);
+  TaskProfile &p = s_prof[t];
+  p.lockWaits++;
+  p.lockWaitUs += waitUs;
+  if (waitUs > p.lockMaxUs) p.lockMaxUs = waitUs;
+  portEXIT_CRITICAL(&s_profMux);
+}
+
+void profileService() {
+  // 스택 여유는 다른 태스크의 것도 읽을 수 있음 (구간 밖에서)
+  uint16_t stack[PROF_TASK_COUNT];
+  for (size_t t = 0; t < PROF_TASK_COUNT; ++t) {
+    TaskHandle_t h = *kHandles[t];
+    stack[t] = h ? (uint16_t)uxTaskGetStackHighWaterMark(h) : 0;
+  }
+
+  uint32_t now = micros();
+  uint32_t elapsed = now - s_windowStartUs;
+  bool first = (s_windowStartUs == 0);
+  s_windowStartUs = now;
+
+  portENTER_CRITICAL(&s_profMux);
+  for (size_t t = 0; t < PROF_TASK_COUNT; ++t) {
+    TaskProfile &p = s_prof[t];
+    uint32_t busy = p.busyUs - s_windowBusyUs[t];
+    s_windowBusyUs[t] = p.busyUs;
+    if (!first && elapsed > 0) {
+      uint64_t permille = (uint64_t)busy * 1000 / elapsed;
+      p.cpuPermille = (uint16_t)(permille > 1000 ? 1000 : permille);
+    }
+    p.stackFree = stack[t];
+  }
+  portEXIT_CRITICAL(&s_profMux);
+
+  statePublishChanges(STATE_CHG_PROFILE);
+}
+
+void profileReset() {
+  portENTER_CRITICAL(&s_profMux);
+  for (size_t t = 0; t < PROF_TASK_COUNT; ++t) {
+    TaskProfile &p = s_prof[t];
+    uint16_t cpu = p.cpuPermille;
+    uint16_t stack = p.stackFree;
+    s_windowBusyUs[t] -= p.busyUs;  // 진행 중인 창의 차이는 그대로 (부호 없는 뺄셈)
+    p = {};
+    p.cpuPermille = cpu;
+    p.stackFree = stack;
+  }
+  portEXIT_CRITICAL(&s_profMux);
+}
+
+void getTaskProfile(ProfileTask task, TaskProfile &out) {
+  if (task >= PROF_TASK_COUNT) {
+    out = {};
+    return;
+  }
+  portENTER_CRITICAL(&s_profMux);
+  out = s_prof[task];
+  portEXIT_CRITICAL(&s_profMux);
+}
+
+const char *profileTaskName(ProfileTask task) {
+  return task < PROF_TASK_COUNT ? kNames[task] : "?";
+}
+
+uint32_t profileBucketLimitUs(uint8_t bucket) {
+  return (size_t)bucket + 1 < PROFILE_HIST_BUCKETS ? 16u << (2 * bucket) : UINT32_MAX;
+}
+
+uint8_t profilePercentileBucket(const TaskProfile &p, uint16_t permille) {
+  if (p.loops == 0) return 0;
+  uint64_t target = ((uint64_t)p.loops * permille + 999) / 1000;
+  uint64_t seen = 0;
+  for (uint8_t b = 0; b < PROFILE_HIST_BUCKETS; ++b) {
+    seen += p.hist[b];
+    if (seen >= target) return b;
+  }
+  return (uint8_t)(PROFILE_HIST_BUCKETS - 1);
+}
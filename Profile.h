@@ -0,0 +1,87 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file Profile.h
+ * @brief 태스크별 루프 실행 시간 분포, g_state 락 대기, CPU 점유, 스택 여유를 재는 프로파일러를 선언합니다.
+ *
+ * 각 태스크는 깨어난 직후 profileLoopBegin(), 다시 잠들기(대기/지연) 직전 profileLoopEnd()를
+ * 부릅니다. 그 사이 시간이 루프 한 번의 실행 시간이며, 4배 간격 구간 8칸의 분포에 쌓입니다.
+ *  [0] < 16us  [1] < 64us  [2] < 256us  [3] < 1ms  [4] < 4ms  [5] < 16ms  [6] < 65ms  [7] 그 이상
+ * 실행 시간에는 같은 코어의 더 높은 우선순위 태스크/인터럽트에 선점된 시간도 들어갑니다.
+ *
+ * CPU 점유는 taskLogic이 1초마다 profileService()로 지난 1초 동안의 실행 시간 합을 나눈 값(‰)이고,
+ * 두 코어를 합치면 최대 2000‰입니다. 스택 여유는 같은 때 uxTaskGetStackHighWaterMark()로 읽습니다.
+ * 락 대기는 g_state 시퀀스 락(StateStore)에서 쓰기 구간을 얻기까지 / 스냅샷을 다시 뜬 시간이며,
+ * PROFILE_LOCK_CONTENDED_US 이상인 것만 부른 태스크에 셉니다.
+ *
+ * 값은 서버 명령 SYS_CMD_EXPORT_PROFILE(FRAME_PROFILE / "PROF,...")과 진단 화면에서 봅니다.
+ */
+
+const size_t PROFILE_HIST_BUCKETS = 8;
+
+/**
+ * @brief 태스크 하나의 프로파일 (누적값은 profileReset()까지)
+ */
+struct TaskProfile {
+  uint32_t loops;        // 루프 수
+  uint32_t busyUs;       // 루프 실행 시간 합
+  uint32_t maxUs;        // 가장 긴 루프
+  uint32_t hist[PROFILE_HIST_BUCKETS];  // 루프 시간 분포
+  uint32_t lockWaits;    // 락 경합 수
+  uint32_t lockWaitUs;   // 락 대기 시간 합
+  uint32_t lockMaxUs;    // 가장 긴 락 대기
+  uint16_t cpuPermille;  // 지난 1초의 CPU 점유 (‰)
+  uint16_t stackFree;    // 지금까지 가장 적게 남은 스택 (바이트, 태스크가 없으면 0)
+};
+
+/**
+ * @brief 태스크 루프 한 번의 시작 (깨어난 직후, 그 태스크에서만 호출)
+ */
+void profileLoopBegin(ProfileTask task);
+
+/**
+ * @brief 태스크 루프 한 번의 끝 (다시 잠들기 직전, 그 태스크에서만 호출)
+ */
+void profileLoopEnd(ProfileTask task);
+
+/**
+ * @brief 지금 태스크가 락을 waitUs만큼 기다렸음을 기록합니다. (프로파일 대상이 아닌 태스크는 무시)
+ */
+void profileLockWait(uint32_t waitUs);
+
+/**
+ * @brief CPU 점유와 스택 여유를 갱신하고 화면에 알립니다. (taskLogic, 1초마다)
+ */
+void profileService();
+
+/**
+ * @brief 누적값(루프, 분포, 최대, 락 대기)을 0으로 되돌립니다. CPU 점유/스택 여유는 그대로
+ */
+void profileReset();
+
+/**
+ * @brief 태스크 하나의 프로파일을 복사합니다.
+ */
+void getTaskProfile(ProfileTask task, TaskProfile &out);
+
+/**
+ * @brief 태스크 이름 (내보내기/화면 표시용)
+ */
+const char *profileTaskName(ProfileTask task);
+
+/**
+ * @brief 분포 칸의 위쪽 경계(us, 미만). 마지막 칸은 UINT32_MAX
+ */
+uint32_t profileBucketLimitUs(uint8_t bucket);
+
+/**
+ * @brief 루프의 permille(‰)가 들어가는 분포 칸 번호 (예: 500 → 중앙값 칸). 루프가 없으면 0
+ */
+uint8_t profilePercentileBucket(const TaskProfile &p, uint16_t permille);
+
+
+#endif // PROFILE_H
@@ -0,0 +1,215 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <Arduino.h>
+
+/**
+ * @file Protocol.h
+ * @brief 서버(Raspberry Pi) UART 링크의 바이너리 프레임 규격과 코덱을 선언합니다.
+ *
+ * 프레임 구조 (COBS 인코딩 전):
+ *
+ *   +------+-----+-------------+-----------+
+ *   | type | seq | payload (N) | crc16(LE) |
+ *   +------+-----+-------------+-----------+
+ *
+ *  - crc16 : CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), type~payload 대상
+ *  - 전송 시 전체를 COBS로 인코딩하고 0x00 한 바이트로 프레임을 구분합니다.
+ *    따라서 수신 측은 0x00만 찾으면 언제든 프레임 경계를 다시 잡을 수 있습니다.
+ *
+ * 링크는 텍스트 모드(JSON 송신 / "CMD,..." 수신)로 시작합니다. 서버가
+ * "CMD,0,1,1"(SYS_CMD_SET_LINK_MODE=바이너리)을 보내면 이후 송수신이 모두
+ * 바이너리 프레임으로 바뀌고, 바이너리 명령 SYS_CMD_SET_LINK_MODE=0 또는
+ * 서버 타임아웃 시 텍스트 모드(디버그용)로 돌아옵니다.
+ */
+
+
+//==============================================================================
+// 프레임 규격
+//==============================================================================
+
+/**
+ * @brief 프레임 종류 (type 바이트)
+ */
+enum FrameType : uint8_t {
+  FRAME_TELEMETRY = 0x01, // 컨트롤러 → 서버 : 상태 텔레메트리 레코드
+  FRAME_COMMAND   = 0x02, // 서버 → 컨트롤러 : 명령 레코드
+  FRAME_ACK       = 0x03, // 컨트롤러 → 서버 : 명령 수신 확인
+  FRAME_TELEMETRY_DELTA = 0x04, // 컨트롤러 → 서버 : 바뀐 필드만 담은 델타 레코드
+  FRAME_LOG       = 0x05, // 컨트롤러 → 서버 : 로그 레코드 (SYS_CMD_EXPORT_LOG 응답)
+  FRAME_LOG_ARCHIVE = 0x06, // 컨트롤러 → 서버 : 플래시 보관 로그 레코드 (SYS_CMD_EXPORT_FLASH_LOG 응답)
+  FRAME_HISTORY   = 0x07, // 컨트롤러 → 서버 : 센서 이력 묶음 (SYS_CMD_EXPORT_HISTORY 응답)
+  FRAME_PROFILE   = 0x08, // 컨트롤러 → 서버 : 태스크 프로파일 (SYS_CMD_EXPORT_PROFILE 응답)
+  FRAME_TRACE     = 0x09, // 컨트롤러 → 서버 : 명령 추적 요약/레코드 (SYS_CMD_EXPORT_TRACE 응답)
+  FRAME_CAN_CMD_STATS = 0x0A, // 컨트롤러 → 서버 : 모듈 명령 종류별 통계 (SYS_CMD_EXPORT_CAN_CMD_STATS 응답)
+};
+
+/**
+ * @brief FRAME_ACK의 결과 코드
+ */
+enum FrameAckStatus : uint8_t {
+  FRAME_ACK_OK        = 0, // 명령 큐에 들어감
+  FRAME_ACK_BUSY      = 1, // 명령 큐가 가득 참
+  FRAME_ACK_MALFORMED = 2, // 레코드 길이/형식 오류
+};
+
+const size_t FRAME_HEADER_LEN   = 2;   // type + seq
+const size_t FRAME_CRC_LEN      = 2;
+const size_t FRAME_MAX_PAYLOAD  = 64;
+const size_t FRAME_MAX_RAW      = FRAME_HEADER_LEN + FRAME_MAX_PAYLOAD + FRAME_CRC_LEN;
+// COBS 오버헤드(254바이트마다 1바이트) + 선두 코드 1바이트 + 구분자 1바이트
+const size_t FRAME_MAX_ENCODED  = FRAME_MAX_RAW + FRAME_MAX_RAW / 254 + 2;
+
+/**
+ * @brief 명령 레코드 (FRAME_COMMAND payload, 6바이트)
+ *  [0] targetModule  [1] command  [2..5] param (int32, LE)
+ */
+const size_t COMMAND_RECORD_LEN = 6;
+
+/**
+ * @brief 수신 확인 레코드 (FRAME_ACK payload, 2바이트)
+ *  [0] 확인 대상 명령 프레임의 seq  [1] FrameAckStatus
+ */
+const size_t ACK_RECORD_LEN = 2;
+
+/**
+ * @brief 로그 레코드 (FRAME_LOG payload, 22바이트, 모두 LE)
+ *  [0..3] seq  [4..7] ms  [8..9] LogCode  [10..21] 인자 3개 (int32)
+ *
+ * 문구는 보내지 않으므로 서버가 LogCode 표로 포맷합니다.
+ * 텍스트 모드에서는 "LOG,<seq>,<ms>,<문구>" 한 줄로 보냅니다.
+ */
+const size_t LOG_WIRE_RECORD_LEN = 22;
+
+/**
+ * @brief 플래시 보관 로그 레코드 (FRAME_LOG_ARCHIVE payload, 26바이트, 모두 LE)
+ *  [0..3] 부팅 번호  [4..25] FRAME_LOG 레코드와 같음 (seq/ms는 그 부팅 기준)
+ *
+ * payload가 빈 FRAME_LOG_ARCHIVE는 내보내기 끝을 뜻합니다.
+ * 텍스트 모드에서는 "LOGF,<부팅>,<seq>,<ms>,<문구>" 줄들 뒤에 "LOGF,END"를 보냅니다.
+ */
+const size_t LOG_ARCHIVE_WIRE_RECORD_LEN = 26;
+
+/**
+ * @brief 센서 이력 묶음 (FRAME_HISTORY payload, 11 + 6 x n바이트, 모두 LE)
+ *  [0] HistoryChannel  [1] HistoryTier  [2..3] 칸 간격(초)  [4..7] 첫 칸 시작 시각(부팅 후 초)
+ *  [8..9] 배율  [10] 칸 수 n  [11..] 칸마다 min, max, avg (int16, 값 x 배율)
+ *
+ * 칸은 간격만큼씩 이어지며, avg가 -32768이면 샘플이 없는 칸입니다.
+ * payload가 빈 FRAME_HISTORY는 내보내기 끝을 뜻합니다.
+ * 텍스트 모드에서는 "HIST,<채널>,<단계>,<시각>,<min>,<max>,<avg>" 줄들(빈 칸은 값 자리가 빔)
+ * 뒤에 "HIST,END"를 보냅니다.
+ */
+const size_t HISTORY_WIRE_HEADER_LEN = 11;
+const size_t HISTORY_WIRE_POINT_LEN  = 6;
+const size_t HISTORY_WIRE_MAX_POINTS = (FRAME_MAX_PAYLOAD - HISTORY_WIRE_HEADER_LEN) / HISTORY_WIRE_POINT_LEN;
+
+/**
+ * @brief 태스크 프로파일 레코드 (FRAME_PROFILE payload, 61바이트, 모두 LE)
+ *  [0] ProfileTask  [1..2] CPU 점유(‰, 지난 1초)  [3..4] 최소 남은 스택(바이트)
+ *  [5..8] 루프 수  [9..12] 루프 실행 시간 합(us)  [13..16] 최대 루프 시간(us)
+ *  [17..20] 락 경합 수  [21..24] 락 대기 합(us)  [25..28] 최대 락 대기(us)
+ *  [29..60] 루프 시간 분포 8칸 (uint32, Profile.h의 구간)
+ *
+ * 태스크마다 한 레코드를 보내고, payload가 빈 FRAME_PROFILE은 내보내기 끝을 뜻합니다.
+ * 텍스트 모드에서는 "PROF,<이름>,<CPU‰>,<스택>,<루프 수>,<실행 합>,<최대>,<경합>,<대기 합>,
+ * <최대 대기>,<분포 8칸>" 줄들 뒤에 "PROF,END"를 보냅니다.
+ */
+const size_t PROFILE_WIRE_RECORD_LEN = 61;
+
+/**
+ * @brief 명령 추적 (FRAME_TRACE payload, 모두 LE, [0]이 종류)
+ *
+ * 단계 요약 (30바이트): 수신 이후 단계(TRACE_STAGE_QUEUED..ACK)마다 하나
+ *  [0] TRACE_WIRE_SUMMARY  [1] TraceStage  [2..3] 표본 수  [4..5] TRACE_SLA_US 초과 수
+ *  [6..17] 직전 단계부터 걸린 시간 p50/p99/최대(us)  [18..29] 수신부터 걸린 시간 p50/p99/최대(us)
+ *
+ * 명령 레코드 (34바이트): 요청한 최근 N개, 오래된 것부터
+ *  [0] TRACE_WIRE_RECORD  [1..2] 추적 ID  [3] 모듈  [4] 명령  [5] TraceFlag 비트
+ *  [6..9] 수신 시각(micros)  [10..33] 단계 QUEUED..ACK의 수신 후 경과(us, 지나지 않았으면 0xFFFFFFFF)
+ *
+ * payload가 빈 FRAME_TRACE는 내보내기 끝을 뜻합니다. 텍스트 모드에서는
+ * "TRACE,S,<단계>,<수>,<초과>,<구간 p50>,<구간 p99>,<구간 최대>,<누적 p50>,<누적 p99>,<누적 최대>",
+ * "TRACE,R,<ID>,<모듈>,<명령>,<플래그>,<경과 6개, 지나지 않았으면 ->" 줄들 뒤에 "TRACE,END"를 보냅니다.
+ */
+const uint8_t TRACE_WIRE_SUMMARY     = 0;
+const uint8_t TRACE_WIRE_RECORD      = 1;
+const size_t  TRACE_WIRE_SUMMARY_LEN = 30;
+const size_t  TRACE_WIRE_RECORD_LEN  = 34;
+
+/**
+ * @brief 모듈 명령 종류별 통계 레코드 (FRAME_CAN_CMD_STATS payload, 42바이트, 모두 LE)
+ *  [0] 모듈  [1] 명령 (효과 표에 없는 명령 묶음은 둘 다 0xFF)
+ *  [2..5] 송신  [6..9] ACK  [10..13] 거부  [14..17] 재전송  [18..21] 시간 초과  [22..25] 대체
+ *  [26..29] 마지막 왕복(us)  [30..33] 최소  [34..37] 최대  [38..41] 평균 (ACK/거부가 없으면 0)
+ *
+ * 종류마다 한 레코드를 보내고, payload가 빈 FRAME_CAN_CMD_STATS는 내보내기 끝을 뜻합니다.
+ * 텍스트 모드에서는 "CANCMD,<모듈>,<명령>,<송신>,<ACK>,<거부>,<재전송>,<시간 초과>,<대체>,
+ * <마지막>,<최소>,<최대>,<평균>" 줄들(묶음은 모듈/명령이 "*") 뒤에 "CANCMD,END"를 보냅니다.
+ */
+const size_t  CAN_CMD_WIRE_RECORD_LEN = 42;
+const uint8_t CAN_CMD_WIRE_OTHER      = 0xFF;
+
+
+//==============================================================================
+// 코덱
+//==============================================================================
+
+/**
+ * @brief CRC-16/CCITT-FALSE를 계산합니다.
+ */
+uint16_t crc16Ccitt(const uint8_t *data, size_t len, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief COBS 인코딩 (구분자 0x00은 붙이지 않음)
+ * @return 인코딩된 길이. 출력 버퍼가 부족하면 0
+ */
+size_t cobsEncode(const uint8_t *src, size_t len, uint8_t *dst, size_t dstSize);
+
+/**
+ * @brief COBS 디코딩 (구분자 0x00은 포함하지 않은 입력)
+ * @return 디코딩된 길이. 형식 오류 또는 출력 버퍼 부족이면 0
+ */
+size_t cobsDecode(const uint8_t *src, size_t len, uint8_t *dst, size_t dstSize);
+
+/**
+ * @brief 헤더/CRC를 붙이고 COBS 인코딩한 뒤 0x00 구분자까지 기록합니다.
+ * @return 전송할 전체 바이트 수. 버퍼 부족 또는 payload 초과 시 0
+ */
+size_t buildFrame(uint8_t type, uint8_t seq, const uint8_t *payload, size_t payloadLen,
+                  uint8_t *out, size_t outSize);
+
+/**
+ * @brief 디코딩이 끝난 프레임 (payload는 디코더 내부 버퍼를 가리킴)
+ */
+struct Frame {
+  uint8_t        type;
+  uint8_t        seq;
+  const uint8_t *payload;
+  size_t         len;
+};
+
+/**
+ * @brief 바이트 단위로 먹여 넣는 스트리밍 프레임 디코더
+ */
+struct FrameDecoder {
+  uint8_t  raw[FRAME_MAX_ENCODED];  // 구분자 전까지 받은 COBS 바이트
+  size_t   rawLen;
+  bool     overflow;                // 현재 프레임이 버퍼를 넘침 → 구분자까지 버림
+  uint8_t  decoded[FRAME_MAX_RAW];
+
+  uint32_t frames;                  // 정상 프레임 수
+  uint32_t crcErrors;               // CRC 불일치
+  uint32_t framingErrors;           // COBS 오류, 길이 부족, 버퍼 초과
+};
+
+void frameDecoderInit(FrameDecoder &d);
+
+/**
+ * @brief 수신 바이트 하나를 처리합니다.
+ * @return 1: out에 정상 프레임 완성, 0: 계속 수신 중, -1: 손상된 프레임을 버림
+ */
+int frameDecoderPush(FrameDecoder &d, uint8_t byte, Frame &out);
+
+
+#endif // PROTOCOL_H
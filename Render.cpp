@@ -0,0 +1,232 @@
+#include "Globals.h"
+#include "Render.h"
+#include "Profile.h"
+
+/**
+ * @file Render.cpp
+ * @brief 렌더 큐, DMA 조각 버퍼, 렌더 태스크 처리의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+enum RenderCmdType : uint8_t {
+  RC_STRIP,      // 조각 버퍼 → pushImageDMA
+  RC_FILL,       // 단색 채우기 (채우기 버퍼 → pushImageDMA)
+  RC_FRAME_END,  // 앞선 전송이 모두 끝나면 프레임 완료
+};
+
+struct RenderCmd {
+  uint8_t  type;
+  uint8_t  strip;    // RC_STRIP: 조각 버퍼 번호
+  uint16_t color;    // RC_FILL
+  int16_t  x, y, w, h;
+  uint32_t inputUs;  // RC_FRAME_END
+};
+
+static_assert(RENDER_STRIP_COUNT >= 2, "need two strips to compose while one is on the bus");
+
+const int16_t  kFillStrip  = RENDER_STRIP_COUNT;          // s_inFlight에서 채우기 버퍼를 나타냄
+const uint32_t kFillPixels = RENDER_STRIP_MAX_PIXELS / 4;  // 단색이므로 작게 두고 나눠 보냄
+
+// DMA가 읽는 버퍼이므로 내부 RAM(정적 배열)에 둡니다.
+uint16_t      s_strips[RENDER_STRIP_COUNT][RENDER_STRIP_MAX_PIXELS];
+uint16_t      s_fillStrip[kFillPixels];
+QueueHandle_t s_cmdQueue  = nullptr;
+QueueHandle_t s_freeQueue = nullptr;  // 비어 있는 조각 번호
+volatile bool s_stripWanted = false;  // taskUi가 버퍼를 못 얻고 돌아감 → 비면 알림
+
+// 렌더 태스크(또는 태스크 시작 전의 호출자)만 사용
+int16_t  s_inFlight    = -1;  // DMA 전송 중인 버퍼 번호
+uint16_t s_fillColor   = 0;   // s_fillStrip에 채워 둔 색 (바이트를 바꾼 값)
+uint32_t s_fillPixels  = 0;   // s_fillStrip 앞쪽에서 s_fillColor로 채워 둔 픽셀 수
+uint32_t s_startUs     = 0;
+uint32_t s_waitUs      = 0;   // 명령 처리 중 DMA 완료를 기다린 시간
+
+portMUX_TYPE s_statsMux = portMUX_INITIALIZER_UNLOCKED;
+RenderStats  s_stats = {};
+
+inline uint32_t windowBytes(int32_t w, int32_t h) {
+  return 11u + (uint32_t)(w * h) * 2u;
+}
+
+inline bool taskRunning() {
+  return g_taskRenderHandle != nullptr;
+}
+
+// 진행 중인 DMA가 끝나기를 기다리고 그 조각 버퍼를 돌려줍니다.
+void finishTransfer() {
+  if (s_inFlight < 0) return;
+  uint32_t t0 = micros();
+  tft.dmaWait();
+  s_waitUs += micros() - t0;
+
+  int16_t done = s_inFlight;
+  s_inFlight = -1;
+  if (done == kFillStrip) return;
+
+  uint8_t idx = (uint8_t)done;
+  xQueueSend(s_freeQueue, &idx, 0);
+  if (s_stripWanted && g_taskUiHandle) {
+    s_stripWanted = false;
+    xTaskNotify(g_taskUiHandle, UI_NOTIFY_RENDER, eSetBits);
+  }
+}
+
+// 사각형을 채우기 버퍼에서 DMA로 보냅니다. 버퍼보다 크면 줄 단위로 나눕니다.
+void fillRectDma(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (w <= 0 || h <= 0 || (uint32_t)w > kFillPixels) return;
+  int16_t rowsPerChunk = (int16_t)(kFillPixels / (uint32_t)w);
+  // 스프라이트 조각과 같은 경로로 나가므로 버퍼에는 바이트를 바꾼 값으로 담음
+  uint16_t swapped = (uint16_t)((color >> 8) | (color << 8));
+
+  for (int16_t row = 0; row < h; row += rowsPerChunk) {
+    int16_t rows = (h - row < rowsPerChunk) ? h - row : rowsPerChunk;
+    uint32_t pixels = (uint32_t)w * rows;
+    finishTransfer();  // 채우기 버퍼를 다시 쓰기 전에 이전 전송 완료
+    if (swapped != s_fillColor || pixels > s_fillPixels) {
+      for (uint32_t i = 0; i < pixels; ++i) s_fillStrip[i] = swapped;
+      s_fillColor  = swapped;
+      s_fillPixels = pixels;
+    }
+    tft.pushImageDMA(x, y + row, w, rows, s_fillStrip);
+    s_inFlight = kFillStrip;
+  }
+}
+
+void execute(const RenderCmd &c) {
+  switch (c.type) {
+    case RC_STRIP: {
+      finishTransfer();  // 버스는 하나: 앞 조각이 끝나야 다음 조각을 시작
+      tft.pushImageDMA(c.x, c.y, c.w, c.h, s_strips[c.strip]);
+      s_inFlight = c.strip;
+      portENTER_CRITICAL(&s_statsMux);
+      s_stats.strips++;
+      s_stats.spiBytes += windowBytes(c.w, c.h);
+      portEXIT_CRITICAL(&s_statsMux);
+      break;
+    }
+    case RC_FILL:
+      fillRectDma(c.x, c.y, c.w, c.h, c.color);
+      portENTER_CRITICAL(&s_statsMux);
+      s_stats.fills++;
+      s_stats.spiBytes += windowBytes(c.w, c.h);
+      portEXIT_CRITICAL(&s_statsMux);
+      break;
+    case RC_FRAME_END: {
+      finishTransfer();
+      uint32_t photonUs = c.inputUs ? micros() - c.inputUs : 0;
+      portENTER_CRITICAL(&s_statsMux);
+      s_stats.frames++;
+      if (c.inputUs) {
+        s_stats.photonCount++;
+        s_stats.photonLastUs = photonUs;
+        if (photonUs > s_stats.photonMaxUs) s_stats.photonMaxUs = photonUs;
+        s_stats.photonSumUs += photonUs;
+      }
+      portEXIT_CRITICAL(&s_statsMux);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void submit(const RenderCmd &c) {
+  if (!taskRunning()) {
+    // 렌더 태스크 전: 호출한 쪽에서 바로 보내고 끝날 때까지 기다림
+    execute(c);
+    finishTransfer();
+    return;
+  }
+
+  xQueueSend(s_cmdQueue, &c, portMAX_DELAY);
+  uint32_t depth = (uint32_t)uxQueueMessagesWaiting(s_cmdQueue);
+  portENTER_CRITICAL(&s_statsMux);
+  if (depth > s_stats.queueHighWater) s_stats.queueHighWater = depth;
+  portEXIT_CRITICAL(&s_statsMux);
+}
+
+} // namespace
+
+void renderInit() {
+  if (s_cmdQueue) return;
+  s_cmdQueue  = xQueueCreate(RENDER_QUEUE_LEN, sizeof(RenderCmd));
+  s_freeQueue = xQueueCreate(RENDER_STRIP_COUNT, sizeof(uint8_t));
+  for (uint8_t i = 0; i < RENDER_STRIP_COUNT; ++i) {
+    xQueueSend(s_freeQueue, &i, 0);
+  }
+  tft.initDMA();
+  tft.startWrite();  // DMA 전송 동안 CS를 잡아 둠 (이후 패널은 렌더 경로로만 그림)
+}
+
+uint16_t *renderAcquireStrip(bool wait) {
+  uint8_t idx;
+  if (xQueueReceive(s_freeQueue, &idx, 0) == pdTRUE) return s_strips[idx];
+
+  portENTER_CRITICAL(&s_statsMux);
+  s_stats.stripWaits++;
+  portEXIT_CRITICAL(&s_statsMux);
+  if (!wait) {
+    // 알림 요청 후 한 번 더 확인: 그 사이에 비었으면 알림을 놓치지 않도록 바로 가져감
+    s_stripWanted = true;
+    if (xQueueReceive(s_freeQueue, &idx, 0) != pdTRUE) return nullptr;
+    s_stripWanted = false;
+    return s_strips[idx];
+  }
+  xQueueReceive(s_freeQueue, &idx, portMAX_DELAY);
+  return s_strips[idx];
+}
+
+void renderSubmitStrip(uint16_t *strip, int16_t x, int16_t y, int16_t w, int16_t h) {
+  RenderCmd c = {};
+  c.type  = RC_STRIP;
+  c.strip = (uint8_t)((strip - s_strips[0]) / RENDER_STRIP_MAX_PIXELS);
+  c.x = x; c.y = y; c.w = w; c.h = h;
+  submit(c);
+}
+
+void renderSubmitFill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  RenderCmd c = {};
+  c.type  = RC_FILL;
+  c.color = color;
+  c.x = x; c.y = y; c.w = w; c.h = h;
+  submit(c);
+}
+
+void renderEndFrame(uint32_t inputUs) {
+  RenderCmd c = {};
+  c.type    = RC_FRAME_END;
+  c.inputUs = inputUs;
+  submit(c);
+}
+
+void renderService() {
+  if (s_startUs == 0) s_startUs = micros();
+
+  // DMA 전송 중이면 큐를 기다리지 않고, 다음 명령이 없을 때 전송 완료를 처리합니다.
+  RenderCmd c;
+  TickType_t wait = s_inFlight >= 0 ? 0 : portMAX_DELAY;
+  if (xQueueReceive(s_cmdQueue, &c, wait) != pdTRUE) {
+    finishTransfer();
+    s_waitUs = 0;
+    return;
+  }
+
+  profileLoopBegin(PROF_TASK_RENDER);
+  uint32_t t0 = micros();
+  s_waitUs = 0;
+  execute(c);
+  uint32_t busy = micros() - t0 - s_waitUs;
+  profileLoopEnd(PROF_TASK_RENDER);
+
+  portENTER_CRITICAL(&s_statsMux);
+  s_stats.busyUs += busy;
+  portEXIT_CRITICAL(&s_statsMux);
+}
+
+void getRenderStats(RenderStats &out) {
+  portENTER_CRITICAL(&s_statsMux);
+  out = s_stats;
+  portEXIT_CRITICAL(&s_statsMux);
+  out.runUs = s_startUs ? micros() - s_startUs : 0;
+}
@@ -0,0 +1,86 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <Arduino.h>
+
+/**
+ * @file Render.h
+ * @brief TFT 패널 전송(렌더 태스크 + DMA 조각 버퍼)을 선언합니다.
+ *
+ * UI는 화면 내용을 오프스크린 스프라이트에 그린 뒤, 바뀐 영역을 조각 버퍼
+ * (RENDER_STRIP_COUNT개, 번갈아 사용)에 담아 렌더 큐에 넣기만 합니다.
+ * 렌더 태스크가 큐를 꺼내 pushImageDMA로 패널에 보내는 동안 UI는 다음 조각을 준비합니다.
+ * 조각 버퍼가 모두 전송 중이면 UI는 기다리지 않고 돌아가 입력을 처리하며, 버퍼가 비면
+ * 렌더 태스크가 taskUi에 UI_NOTIFY_RENDER를 보내 나머지를 이어 그리게 합니다.
+ * 단색 채우기도 렌더 태스크의 채우기 버퍼에서 DMA로 보내므로 CPU를 점유하지 않습니다.
+ *
+ * 렌더 태스크가 생성되기 전(setup()의 부팅 화면, 태스크 없이 도는 호스트 벤치)에는
+ * 제출한 쪽에서 바로 전송하고 끝날 때까지 기다립니다.
+ */
+
+/**
+ * @brief 렌더 파이프라인 통계 (누적값). 진단 화면의 "Lat ... Rnd" 줄에 지연과 CPU 점유가 보입니다.
+ *
+ * 렌더 태스크 CPU 점유율 = busyUs / runUs. 입력→패널 지연은 입력 이벤트(ISR 시각)부터
+ * 그 입력 뒤에 그린 프레임의 마지막 조각이 패널에 다 나간 시점까지입니다.
+ */
+struct RenderStats {
+  uint32_t frames;          // 패널에 다 나간 프레임 수
+  uint32_t strips;          // DMA로 보낸 이미지 조각 수
+  uint32_t fills;           // 단색 채우기 수
+  uint32_t stripWaits;      // 조각 버퍼가 모두 전송 중이라 UI가 미루거나 기다린 횟수
+  uint32_t queueHighWater;  // 렌더 큐에 동시에 쌓였던 최대 명령 수
+  uint64_t spiBytes;        // 패널로 보낸 바이트 (주소창 설정 포함)
+  uint64_t busyUs;          // 렌더 태스크가 CPU를 쓴 시간 (큐/DMA 대기 제외)
+  uint32_t runUs;           // 렌더 태스크가 시작한 뒤 지난 시간
+  uint32_t photonCount;     // 입력→패널 지연 측정 수
+  uint32_t photonLastUs;
+  uint32_t photonMaxUs;
+  uint64_t photonSumUs;
+};
+
+/**
+ * @brief 렌더 큐와 조각 버퍼를 만들고 DMA를 켭니다. initTft()에서 한 번 호출합니다.
+ */
+void renderInit();
+
+/**
+ * @brief 비어 있는 조각 버퍼(최대 RENDER_STRIP_MAX_PIXELS 픽셀)를 하나 얻습니다.
+ *
+ * 얻은 버퍼는 반드시 renderSubmitStrip()으로 돌려줘야 합니다.
+ * @param wait true면 버퍼가 빌 때까지 기다림. false면 바로 nullptr을 돌려주고,
+ *             버퍼가 비는 즉시 taskUi에 UI_NOTIFY_RENDER를 보냅니다.
+ */
+uint16_t *renderAcquireStrip(bool wait);
+
+/**
+ * @brief 조각 버퍼의 w x h 픽셀(행 간격 w)을 패널 (x, y)에 보내도록 제출합니다.
+ */
+void renderSubmitStrip(uint16_t *strip, int16_t x, int16_t y, int16_t w, int16_t h);
+
+/**
+ * @brief 패널의 사각형 영역을 단색으로 채우도록 제출합니다. (버퍼 불필요)
+ * @param color TFT_* 와 같은 RGB565 값 (조각 버퍼처럼 바이트를 바꿔 둘 필요 없음)
+ */
+void renderSubmitFill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+/**
+ * @brief 프레임의 끝을 제출합니다. 앞서 제출한 조각이 모두 나가면 프레임 수를 셉니다.
+ * @param inputUs 이 프레임에 반영된 가장 이른 입력 이벤트 시각 (micros(), 없으면 0)
+ */
+void renderEndFrame(uint32_t inputUs);
+
+/**
+ * @brief 렌더 명령 하나를 처리합니다. (taskRender 전용)
+ *
+ * 큐가 비어 있으면 명령이 올 때까지, 진행 중인 DMA가 있으면 그 전송이 끝날 때까지 기다립니다.
+ */
+void renderService();
+
+/**
+ * @brief 렌더 통계를 복사합니다.
+ */
+void getRenderStats(RenderStats &out);
+
+
+#endif // RENDER_H
@@ -0,0 +1,359 @@
+#include "Globals.h"
+#include "Rules.h"
+#include "History.h"
+#include "Settings.h"
+#include "Protocol.h"
+
+#include <atomic>
+
+/**
+ * @file Rules.cpp
+ * @brief 규칙 표, 채널별 명령열 번역/실행, 규칙 블롭 저장의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 규칙 표와 명령열
+//------------------------------------------------------------------------------
+
+struct RuleDef {
+  uint32_t cond;    // 조건 워드 하위 24비트 (0이면 빈 칸)
+  uint32_t action;  // 동작 워드 하위 24비트 (모듈 0이면 동작 없음)
+  uint16_t hyst;    // 히스테리시스 폭 (채널 배율 단위)
+};
+
+// 명령 하나: [연산 RuleCompare] [규칙 칸] [충족 임계값 int16 LE] [해제 임계값 int16 LE]
+const size_t kInstrLen = 6;
+const size_t kWords    = (RULES_MAX + 31) / 32;
+
+static_assert(RULES_MAX <= 256, "rule index must fit in one bytecode byte");
+
+// 채널 → 그 값을 바꾸는 모듈의 STATE_CHG 비트 (HistoryChannel 순서)
+const uint32_t kChannelChg[] = {
+  STATE_CHG_TANK, STATE_CHG_TANK, STATE_CHG_TANK, STATE_CHG_TANK,
+  STATE_CHG_GROW, STATE_CHG_GROW,
+};
+
+static_assert(sizeof(kChannelChg) / sizeof(kChannelChg[0]) == HIST_CHANNEL_COUNT,
+              "kChannelChg must have one entry per HistoryChannel");
+
+// 아래는 모두 s_rulesMux 안에서만 접근
+portMUX_TYPE s_rulesMux = portMUX_INITIALIZER_UNLOCKED;
+RuleDef      s_defs[RULES_MAX];
+uint8_t      s_code[RULES_MAX * kInstrLen];
+uint16_t     s_segStart[HIST_CHANNEL_COUNT];
+uint16_t     s_segEnd[HIST_CHANNEL_COUNT];
+uint32_t     s_active[kWords];      // 규칙별 충족 여부
+uint32_t     s_pendingOn[kWords];   // 보내야 할 충족 동작
+uint32_t     s_pendingOff[kWords];  // 보내야 할 해제 동작
+int16_t      s_last[HIST_CHANNEL_COUNT];
+uint32_t     s_dirtyChannels = 0;   // 값이 같아도 다시 평가할 채널 (규칙이 바뀜)
+bool         s_lastConnected = true;
+RulesStats   s_stats = {};
+
+// 저장 상태: 변경 순번은 명령 처리(taskUart)가 올리고, 저장한 순번은 taskFlashLog만 씀
+const size_t kRecordLen = 9;  // 칸 1 + 조건 3 + 동작 3 + 폭 2
+const size_t kBlobMax   = 2 + RULES_MAX * kRecordLen + 2;
+uint8_t               s_blob[kBlobMax];  // taskFlashLog/rulesInit 전용 (스택 대신)
+std::atomic<uint32_t> s_changeSeq{0};
+std::atomic<uint32_t> s_lastChangeMs{0};
+uint32_t              s_savedSeq = 0;
+
+inline bool testBit(const uint32_t *bits, size_t i) { return (bits[i / 32] >> (i % 32)) & 1u; }
+inline void setBit(uint32_t *bits, size_t i)        { bits[i / 32] |= 1u << (i % 32); }
+inline void clearBit(uint32_t *bits, size_t i)      { bits[i / 32] &= ~(1u << (i % 32)); }
+
+uint8_t ruleChannel(uint32_t cond) { return (uint8_t)((cond >> RULE_CHANNEL_SHIFT) & 0x0F); }
+uint8_t ruleCompare(uint32_t cond) { return (uint8_t)((cond >> RULE_CMP_SHIFT) & 0x03); }
+uint8_t ruleModule(uint32_t action) { return (uint8_t)((action >> RULE_MODULE_SHIFT) & 0x0F); }
+
+int16_t clamp16(int32_t v) {
+  if (v > INT16_MAX) return INT16_MAX;
+  if (v < INT16_MIN + 1) return INT16_MIN + 1;
+  return (int16_t)v;
+}
+
+void putI16(uint8_t *p, int16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)((uint16_t)v >> 8);
+}
+
+int16_t getI16(const uint8_t *p) {
+  return (int16_t)(uint16_t)(p[0] | (p[1] << 8));
+}
+
+// 규칙 표를 채널별 명령열로 다시 만듭니다. 조건과 동작이 모두 있는 규칙만 들어갑니다.
+void compile() {
+  size_t pos = 0;
+  uint32_t count = 0;
+  for (uint8_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) {
+    s_segStart[ch] = (uint16_t)pos;
+    for (size_t i = 0; i < RULES_MAX; ++i) {
+      const RuleDef &d = s_defs[i];
+      if (d.cond == 0 || ruleModule(d.action) == MODULE_SYSTEM || ruleChannel(d.cond) != ch) continue;
+      uint8_t cmp = ruleCompare(d.cond);
+      int32_t thr = (int16_t)(d.cond & 0xFFFF);
+      int32_t off = cmp == RULE_CMP_ABOVE ? thr - d.hyst : thr + d.hyst;
+      s_code[pos]     = cmp;
+      s_code[pos + 1] = (uint8_t)i;
+      putI16(&s_code[pos + 2], (int16_t)thr);
+      putI16(&s_code[pos + 4], clamp16(off));
+      pos += kInstrLen;
+      count++;
+    }
+    s_segEnd[ch] = (uint16_t)pos;
+  }
+  s_stats.rules = count;
+  s_stats.codeBytes = (uint32_t)pos;
+  s_stats.compiles++;
+}
+
+// 채널 하나의 명령열을 값 v로 실행합니다. 충족/해제가 바뀐 규칙은 보낼 목록에 올림
+void runSegment(uint8_t ch, int16_t v) {
+  const uint8_t *pc  = s_code + s_segStart[ch];
+  const uint8_t *end = s_code + s_segEnd[ch];
+  s_stats.evaluations++;
+  s_stats.steps += (uint32_t)(end - pc) / kInstrLen;
+  for (; pc < end; pc += kInstrLen) {
+    uint8_t idx = pc[1];
+    int16_t on  = getI16(pc + 2);
+    int16_t off = getI16(pc + 4);
+    bool active = testBit(s_active, idx);
+    bool above  = pc[0] == RULE_CMP_ABOVE;
+    if (!active && (above ? v > on : v < on)) {
+      setBit(s_active, idx);
+      setBit(s_pendingOn, idx);
+      clearBit(s_pendingOff, idx);
+    } else if (active && (above ? v <= off : v >= off)) {
+      clearBit(s_active, idx);
+      setBit(s_pendingOff, idx);
+      clearBit(s_pendingOn, idx);
+    }
+  }
+}
+
+// 규칙 칸 하나를 비우거나 바꾸기 전에: 충족 상태/보낼 동작을 지우고 채널을 다시 평가하게 함
+void resetSlot(uint8_t slot) {
+  clearBit(s_active, slot);
+  clearBit(s_pendingOn, slot);
+  clearBit(s_pendingOff, slot);
+  if (s_defs[slot].cond != 0) s_dirtyChannels |= 1u << ruleChannel(s_defs[slot].cond);
+}
+
+void sendAction(uint8_t slot, bool on, bool serverConnected) {
+  portENTER_CRITICAL(&s_rulesMux);
+  RuleDef d = s_defs[slot];
+  int16_t v = d.cond ? s_last[ruleChannel(d.cond)] : 0;
+  portEXIT_CRITICAL(&s_rulesMux);
+
+  uint8_t value = on ? (uint8_t)(d.action >> 8) : (uint8_t)d.action;
+  if (value == RULE_NO_VALUE || ruleModule(d.action) == MODULE_SYSTEM) return;
+  if ((d.cond & RULE_FAILSAFE_ONLY) && serverConnected) return;
+
+  enqueueCanCommand(ruleModule(d.action), (uint8_t)((d.action >> RULE_COMMAND_SHIFT) & 0x0F), value);
+  logEvent(LOG_RULE_FIRED, slot, on ? 1 : 0, v);
+  portENTER_CRITICAL(&s_rulesMux);
+  s_stats.fired++;
+  portEXIT_CRITICAL(&s_rulesMux);
+}
+
+void markChanged() {
+  s_lastChangeMs.store(millis(), std::memory_order_relaxed);
+  s_changeSeq.fetch_add(1, std::memory_order_release);
+  if (g_taskFlashLogHandle) xTaskNotifyGive(g_taskFlashLogHandle);
+}
+
+
+//------------------------------------------------------------------------------
+// 규칙 블롭: [0] 버전 [1] 규칙 수 [칸, 조건 24비트 LE, 동작 24비트 LE, 폭 LE] x 수 [CRC-16 LE]
+//------------------------------------------------------------------------------
+
+void putLe24(uint8_t *p, uint32_t v) {
+  for (int k = 0; k < 3; ++k) p[k] = (uint8_t)(v >> (8 * k));
+}
+
+uint32_t getLe24(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+}
+
+size_t encodeBlob(uint8_t *b) {
+  size_t n = 2;
+  uint8_t count = 0;
+  portENTER_CRITICAL(&s_rulesMux);
+  for (size_t i = 0; i < RULES_MAX; ++i) {
+    const RuleDef &d = s_defs[i];
+    if (d.cond == 0 && d.action == 0) continue;
+    b[n] = (uint8_t)i;
+    putLe24(b + n + 1, d.cond);
+    putLe24(b + n + 4, d.action);
+    b[n + 7] = (uint8_t)d.hyst;
+    b[n + 8] = (uint8_t)(d.hyst >> 8);
+    n += kRecordLen;
+    count++;
+  }
+  portEXIT_CRITICAL(&s_rulesMux);
+  b[0] = RULES_BLOB_VERSION;
+  b[1] = count;
+  uint16_t crc = crc16Ccitt(b, n);
+  b[n]     = (uint8_t)crc;
+  b[n + 1] = (uint8_t)(crc >> 8);
+  return n + 2;
+}
+
+uint8_t loadBlob() {
+  uint8_t *b = s_blob;
+  size_t len = prefs.getBytesLength(RULES_NVS_KEY);
+  if (len == 0) return SETTINGS_LOAD_DEFAULTS;
+  if (len < 4 || len > kBlobMax || prefs.getBytes(RULES_NVS_KEY, b, len) != len ||
+      len != 2 + (size_t)b[1] * kRecordLen + 2) {
+    return SETTINGS_LOAD_BAD_LENGTH;
+  }
+  if (crc16Ccitt(b, len - 2) != (uint16_t)(b[len - 2] | (b[len - 1] << 8))) {
+    return SETTINGS_LOAD_BAD_CRC;
+  }
+  if (b[0] != RULES_BLOB_VERSION) return SETTINGS_LOAD_BAD_VERSION;
+
+  for (size_t n = 2; n + 2 < len; n += kRecordLen) {
+    uint8_t  slot = b[n];
+    uint32_t cond = getLe24(b + n + 1);
+    if (slot >= RULES_MAX) continue;
+    if (cond != 0 && (ruleChannel(cond) >= HIST_CHANNEL_COUNT || ruleCompare(cond) > RULE_CMP_BELOW)) continue;
+    s_defs[slot].cond   = cond;
+    s_defs[slot].action = getLe24(b + n + 4);
+    s_defs[slot].hyst   = (uint16_t)(b[n + 7] | (b[n + 8] << 8));
+  }
+  return SETTINGS_LOAD_OK;
+}
+
+} // namespace
+
+void rulesInit() {
+  uint8_t result = loadBlob();
+  if (result >= SETTINGS_LOAD_BAD_LENGTH) {
+    logEvent(LOG_RULES_RESET, result);
+    prefs.remove(RULES_NVS_KEY);
+  }
+  portENTER_CRITICAL(&s_rulesMux);
+  for (size_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) s_last[ch] = INT16_MIN;
+  s_dirtyChannels = (1u << HIST_CHANNEL_COUNT) - 1;
+  s_stats.loadResult = result;
+  compile();
+  portEXIT_CRITICAL(&s_rulesMux);
+  s_savedSeq = s_changeSeq.load(std::memory_order_relaxed);
+}
+
+void rulesEvaluate(const SystemState &st, uint32_t changed) {
+  uint32_t on[kWords];
+  uint32_t off[kWords];
+  bool any = false;
+
+  portENTER_CRITICAL(&s_rulesMux);
+  if (st.serverConnected != s_lastConnected) {
+    s_lastConnected = st.serverConnected;
+    // 서버가 끊긴 순간: 연결 중에 상태만 따라간 Fail-safe 규칙의 충족 동작을 보냄
+    if (!st.serverConnected) {
+      for (size_t i = 0; i < RULES_MAX; ++i) {
+        if (testBit(s_active, i) && (s_defs[i].cond & RULE_FAILSAFE_ONLY)) setBit(s_pendingOn, i);
+      }
+    }
+  }
+  for (uint8_t ch = 0; ch < HIST_CHANNEL_COUNT; ++ch) {
+    bool dirty = (s_dirtyChannels >> ch) & 1u;
+    if (!dirty && !(changed & kChannelChg[ch])) continue;
+    int16_t v = historyEncode((HistoryChannel)ch, st);
+    if (v == s_last[ch] && !dirty) continue;
+    s_last[ch] = v;
+    s_dirtyChannels &= ~(1u << ch);
+    if (v == INT16_MIN) continue;  // 오프라인: 상태 유지
+    if (s_segStart[ch] != s_segEnd[ch]) runSegment(ch, v);
+  }
+  for (size_t w = 0; w < kWords; ++w) {
+    on[w] = s_pendingOn[w];
+    off[w] = s_pendingOff[w];
+    s_pendingOn[w] = s_pendingOff[w] = 0;
+    any |= (on[w] | off[w]) != 0;
+  }
+  portEXIT_CRITICAL(&s_rulesMux);
+  if (!any) return;
+
+  // CAN 요청/로그는 구간 밖에서
+  for (size_t w = 0; w < kWords; ++w) {
+    for (uint32_t bits = off[w]; bits; bits &= bits - 1) {
+      sendAction((uint8_t)(w * 32 + __builtin_ctz(bits)), false, st.serverConnected);
+    }
+    for (uint32_t bits = on[w]; bits; bits &= bits - 1) {
+      sendAction((uint8_t)(w * 32 + __builtin_ctz(bits)), true, st.serverConnected);
+    }
+  }
+}
+
+bool rulesHandleCommand(uint8_t command, uint32_t param) {
+  uint8_t slot = (uint8_t)(param >> RULE_SLOT_SHIFT);
+  if (command != SYS_CMD_RULE_CLEAR && slot >= RULES_MAX) return false;
+
+  switch (command) {
+    case SYS_CMD_RULE_CONDITION: {
+      uint32_t cond = param & 0xFFFFFF;
+      uint8_t cmp = ruleCompare(cond);
+      if (cmp > RULE_CMP_BELOW || (cmp != RULE_CMP_NONE && ruleChannel(cond) >= HIST_CHANNEL_COUNT)) return false;
+      portENTER_CRITICAL(&s_rulesMux);
+      resetSlot(slot);
+      if (cmp == RULE_CMP_NONE) {
+        s_defs[slot] = { 0, 0, 0 };
+      } else {
+        s_defs[slot].cond = cond;
+        s_dirtyChannels |= 1u << ruleChannel(cond);
+      }
+      compile();
+      portEXIT_CRITICAL(&s_rulesMux);
+      break;
+    }
+    case SYS_CMD_RULE_HYSTERESIS: {
+      uint32_t hyst = param & 0xFFFF;
+      if (hyst > INT16_MAX) return false;
+      portENTER_CRITICAL(&s_rulesMux);
+      s_defs[slot].hyst = (uint16_t)hyst;
+      compile();
+      portEXIT_CRITICAL(&s_rulesMux);
+      break;
+    }
+    case SYS_CMD_RULE_ACTION: {
+      uint32_t action = param & 0xFFFFFF;
+      if (ruleModule(action) > MODULE_FEEDER) return false;
+      portENTER_CRITICAL(&s_rulesMux);
+      resetSlot(slot);
+      s_defs[slot].action = action;
+      compile();
+      portEXIT_CRITICAL(&s_rulesMux);
+      break;
+    }
+    case SYS_CMD_RULE_CLEAR:
+      portENTER_CRITICAL(&s_rulesMux);
+      for (size_t i = 0; i < RULES_MAX; ++i) s_defs[i] = { 0, 0, 0 };
+      for (size_t w = 0; w < kWords; ++w) s_active[w] = s_pendingOn[w] = s_pendingOff[w] = 0;
+      compile();
+      portEXIT_CRITICAL(&s_rulesMux);
+      break;
+    default:
+      return false;
+  }
+  markChanged();
+  return true;
+}
+
+void rulesService() {
+  uint32_t seq = s_changeSeq.load(std::memory_order_acquire);
+  if (seq == s_savedSeq) return;
+  if (millis() - s_lastChangeMs.load(std::memory_order_relaxed) < RULES_SAVE_DELAY_MS) return;
+
+  size_t len = encodeBlob(s_blob);
+  if (prefs.putBytes(RULES_NVS_KEY, s_blob, len) != len) return;  // 다음 차례에 다시 시도
+  s_savedSeq = seq;
+}
+
+void getRulesStats(RulesStats &out) {
+  portENTER_CRITICAL(&s_rulesMux);
+  out = s_stats;
+  portEXIT_CRITICAL(&s_rulesMux);
+}
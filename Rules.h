@@ -0,0 +1,91 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file Rules.h
+ * @brief 서버가 넣은 센서 임계값 규칙을 바이트코드로 바꿔 컨트롤러에서 바로 실행하는 규칙 엔진을 선언합니다.
+ *
+ * 규칙 하나는 "채널 값이 임계값을 넘으면(또는 밑돌면) 동작, 히스테리시스만큼 되돌아오면 해제
+ * 동작"입니다. 예) 용존산소 < 5.00 → 폭기 펌프 ON, 5.50 이상 → OFF.
+ * 값과 임계값은 센서 이력과 같은 채널/배율(History.h의 historyScale)을 씁니다.
+ *
+ * 규칙이 바뀔 때마다 채널별 명령열(6바이트: 연산, 규칙 번호, 충족 임계값, 해제 임계값)로
+ * 다시 번역해 두고, taskLogic은 상태가 바뀐 모듈의 채널 중 값이 실제로 바뀐 채널의 명령열만
+ * 실행합니다. 규칙마다 충족 여부를 비트 하나로 기억하므로 바뀐 순간에만 동작을 보냅니다.
+ * 오프라인 채널은 평가하지 않고 상태를 그대로 둡니다.
+ *
+ * 서버 왕복 없이 바로 반응하고, Fail-safe 전용 규칙은 서버가 끊겼을 때만 동작을 보냅니다.
+ * (연결 중에는 상태만 따라가다가 끊기는 순간 충족 중인 규칙의 동작을 한 번 보냄)
+ * 규칙은 NVS 블롭 하나(RULES_NVS_KEY, 버전 + CRC)에 보관되어 재부팅 후에도 남습니다.
+ *
+ * 조건 워드 (SYS_CMD_RULE_CONDITION 파라미터)
+ *  [31..24] 칸  [23..20] 채널 (HistoryChannel)  [18] 1=Fail-safe 전용
+ *  [17..16] 비교 (RuleCompare, 0이면 칸 지움)  [15..0] 임계값 (int16, 채널 배율 단위)
+ * 동작 워드 (SYS_CMD_RULE_ACTION 파라미터)
+ *  [31..24] 칸  [23..20] 모듈 (ModuleId)  [19..16] 명령  [15..8] 충족 값  [7..0] 해제 값 (0xFF: 보내지 않음)
+ * 히스테리시스 (SYS_CMD_RULE_HYSTERESIS 파라미터): [31..24] 칸  [15..0] 폭 (기본 0)
+ */
+
+/**
+ * @brief 조건 비교 방식
+ */
+enum RuleCompare : uint8_t {
+  RULE_CMP_NONE  = 0,  // 칸 비어 있음
+  RULE_CMP_ABOVE = 1,  // 값 > 임계값이면 충족, 값 <= 임계값 - 폭이면 해제
+  RULE_CMP_BELOW = 2,  // 값 < 임계값이면 충족, 값 >= 임계값 + 폭이면 해제
+};
+
+// 조건/동작 워드 필드
+const uint32_t RULE_SLOT_SHIFT     = 24;
+const uint32_t RULE_CHANNEL_SHIFT  = 20;
+const uint32_t RULE_FAILSAFE_ONLY  = 1u << 18;
+const uint32_t RULE_CMP_SHIFT      = 16;
+const uint32_t RULE_MODULE_SHIFT   = 20;
+const uint32_t RULE_COMMAND_SHIFT  = 16;
+const uint8_t  RULE_NO_VALUE       = 0xFF;
+
+/**
+ * @brief 규칙 엔진 통계 (누적값)
+ */
+struct RulesStats {
+  uint32_t rules;        // 번역된(조건과 동작이 모두 있는) 규칙 수
+  uint32_t codeBytes;    // 명령열 길이
+  uint32_t evaluations;  // 명령열을 실행한 채널 수
+  uint32_t steps;        // 실행한 명령 수
+  uint32_t fired;        // 보낸 동작 수
+  uint32_t compiles;     // 다시 번역한 횟수
+  uint8_t  loadResult;   // 부팅 때 블롭 읽은 결과 (SettingsLoadResult)
+};
+
+/**
+ * @brief 저장된 규칙을 읽어 번역합니다. setup()에서 태스크를 만들기 전에 호출합니다.
+ */
+void rulesInit();
+
+/**
+ * @brief 바뀐 채널의 규칙을 평가하고, 충족/해제가 바뀐 규칙의 동작을 보냅니다. (taskLogic 전용)
+ * @param st      이번 주기의 상태 복사본
+ * @param changed 이번 주기에 바뀐 STATE_CHG_* 비트 (관계없는 모듈의 채널은 건너뜀)
+ */
+void rulesEvaluate(const SystemState &st, uint32_t changed);
+
+/**
+ * @brief 서버 규칙 명령(SYS_CMD_RULE_*)을 처리합니다. 잘못된 칸/값이면 false
+ */
+bool rulesHandleCommand(uint8_t command, uint32_t param);
+
+/**
+ * @brief 바뀐 규칙을 NVS에 저장합니다. (taskFlashLog 전용)
+ */
+void rulesService();
+
+/**
+ * @brief 규칙 엔진 통계를 복사합니다.
+ */
+void getRulesStats(RulesStats &out);
+
+
+#endif // RULES_H
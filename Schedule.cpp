@@ -0,0 +1,436 @@
+#include "Globals.h"
+#include "Schedule.h"
+#include "Settings.h"
+#include "Protocol.h"
+
+#include <atomic>
+
+/**
+ * @file Schedule.cpp
+ * @brief 현지 시계, 예약 항목 표, 3단계 타이머 휠, 예약 블롭 저장의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+//------------------------------------------------------------------------------
+// 휠 구조
+//------------------------------------------------------------------------------
+
+const uint32_t kMinPerHour = 60;
+const uint32_t kMinPerDay  = 1440;
+const uint8_t  kNone       = 0xFF;
+
+enum WheelLevel : uint8_t {
+  WHEEL_MINUTE = 0,  // 남은 시간 1시간 미만: 분 칸
+  WHEEL_HOUR,        // 하루 미만: 시 칸 (정시에 분 단계로)
+  WHEEL_DAY,         // 그 이상 (매일 항목은 최대 7일 뒤): 일 칸 (자정에 시/분 단계로)
+  WHEEL_LEVEL_COUNT
+};
+
+const uint8_t kBuckets[WHEEL_LEVEL_COUNT]    = { 60, 24, 8 };
+const uint8_t kHeadOffset[WHEEL_LEVEL_COUNT] = { 0, 60, 84 };
+const size_t  kHeadCount = 60 + 24 + 8;
+
+static_assert(SCHEDULE_MAX_ENTRIES < kNone, "entry index must fit in a uint8_t link");
+
+struct SchedEntry {
+  uint32_t when;     // 시각 워드 (0이면 비어 있음)
+  uint32_t action;   // 동작 워드 (모듈 0이면 없음)
+  uint32_t nextMin;  // 다음 실행 현지 분
+  uint8_t  next;     // 같은 칸 목록 (kNone: 끝)
+  uint8_t  prev;
+  uint8_t  head;     // 매달린 칸 (kNone: 휠 밖)
+};
+
+// 휠과 항목 표 (s_schedMux 안에서만 접근)
+portMUX_TYPE  s_schedMux = portMUX_INITIALIZER_UNLOCKED;
+SchedEntry    s_entries[SCHEDULE_MAX_ENTRIES];
+uint8_t       s_heads[kHeadCount];
+uint32_t      s_curMin = 0;  // 마지막으로 처리한 현지 분
+ScheduleStats s_stats = {};
+
+// 현지 시계: 현지 초 = g_uptimeSeconds + s_offset (서버가 맞춤)
+std::atomic<uint32_t> s_offset{0};
+std::atomic<bool>     s_synced{false};
+
+// 설정 화면 Fail-safe 급여 (0번 칸)를 마지막으로 건 값
+uint8_t s_feedHour   = kNone;
+uint8_t s_feedMinute = kNone;
+uint8_t s_feedAmount = kNone;
+
+// 저장 상태: 변경 순번은 명령 처리(taskUart)가 올리고, 저장한 순번은 taskFlashLog만 씀
+const size_t kRecordLen = 9;  // 칸 1 + 시각 워드 4 + 동작 워드 4
+const size_t kBlobMax   = 2 + (SCHEDULE_MAX_ENTRIES - 1) * kRecordLen + 2;
+std::atomic<uint32_t> s_changeSeq{0};
+std::atomic<uint32_t> s_lastChangeMs{0};
+uint32_t              s_savedSeq = 0;
+
+uint8_t  actionModule(uint32_t a) { return (uint8_t)(a >> 16); }
+uint8_t  actionCommand(uint32_t a) { return (uint8_t)(a >> 8); }
+uint8_t  actionValue(uint32_t a)  { return (uint8_t)a; }
+
+bool armed(const SchedEntry &e) {
+  return e.when != 0 && actionModule(e.action) != MODULE_SYSTEM;
+}
+
+// 1970-01-01은 목요일 (0 = 일요일)
+uint8_t dayOfWeek(uint32_t day) {
+  return (uint8_t)((day + 4) % 7);
+}
+
+// afterMin보다 뒤의 첫 실행 분
+uint32_t nextFire(uint32_t when, uint32_t afterMin) {
+  uint32_t start = afterMin + 1;
+  uint32_t day   = start / kMinPerDay;
+  uint32_t md    = start % kMinPerDay;
+  uint32_t phase = when & SCHED_MINUTE_MASK;
+
+  if (when & SCHED_INTERVAL) {
+    uint32_t period = (when >> SCHED_PERIOD_SHIFT) & SCHED_MINUTE_MASK;
+    uint32_t t = phase;
+    if (md > phase) t = phase + (md - phase + period - 1) / period * period;
+    if (t >= kMinPerDay) {
+      day++;
+      t = phase;
+    }
+    return day * kMinPerDay + t;
+  }
+
+  uint32_t dow = (when >> SCHED_DOW_SHIFT) & SCHED_DOW_ALL;
+  if (md > phase) day++;
+  for (int d = 0; d < 7; ++d, ++day) {
+    if (dow & (1u << dayOfWeek(day))) break;
+  }
+  return day * kMinPerDay + phase;
+}
+
+void unlink(uint8_t i) {
+  SchedEntry &e = s_entries[i];
+  if (e.head == kNone) return;
+  if (e.prev != kNone) s_entries[e.prev].next = e.next;
+  else                 s_heads[e.head] = e.next;
+  if (e.next != kNone) s_entries[e.next].prev = e.prev;
+  e.head = kNone;
+  s_stats.entries--;
+}
+
+// 다음 실행까지 남은 시간에 맞는 단계의 칸 맨 앞에 매답니다.
+void place(uint8_t i) {
+  SchedEntry &e = s_entries[i];
+  uint32_t delta = e.nextMin - s_curMin;
+  uint8_t head;
+  if (delta < kMinPerHour) {
+    head = kHeadOffset[WHEEL_MINUTE] + e.nextMin % kBuckets[WHEEL_MINUTE];
+  } else if (delta < kMinPerDay) {
+    head = kHeadOffset[WHEEL_HOUR] + (e.nextMin / kMinPerHour) % kBuckets[WHEEL_HOUR];
+  } else {
+    head = kHeadOffset[WHEEL_DAY] + (e.nextMin / kMinPerDay) % kBuckets[WHEEL_DAY];
+  }
+  e.head = head;
+  e.prev = kNone;
+  e.next = s_heads[head];
+  if (e.next != kNone) s_entries[e.next].prev = i;
+  s_heads[head] = i;
+  s_stats.entries++;
+}
+
+// 항목 하나를 지금 시각 기준으로 다시 겁니다. (바뀌었거나 지워진 칸)
+void rearm(uint8_t i) {
+  unlink(i);
+  SchedEntry &e = s_entries[i];
+  if (!armed(e)) return;
+  e.nextMin = nextFire(e.when, s_curMin);
+  place(i);
+}
+
+void rebuild(uint32_t curMin) {
+  memset(s_heads, kNone, sizeof(s_heads));
+  s_stats.entries = 0;
+  s_curMin = curMin;
+  for (uint8_t i = 0; i < SCHEDULE_MAX_ENTRIES; ++i) {
+    s_entries[i].head = kNone;
+    rearm(i);
+  }
+}
+
+// 칸 목록을 통째로 떼어 냅니다. (다시 매달 때 같은 칸으로 돌아오는 항목이 있으므로 먼저 뗌)
+uint8_t detach(uint8_t head) {
+  uint8_t i = s_heads[head];
+  s_heads[head] = kNone;
+  for (uint8_t k = i; k != kNone; k = s_entries[k].next) {
+    s_entries[k].head = kNone;
+    s_stats.entries--;
+  }
+  return i;
+}
+
+void cascade(WheelLevel level, uint32_t bucket) {
+  uint8_t i = detach(kHeadOffset[level] + bucket);
+  while (i != kNone) {
+    uint8_t next = s_entries[i].next;
+    place(i);
+    s_stats.cascades++;
+    i = next;
+  }
+}
+
+struct Fired {
+  uint8_t  slot;
+  uint32_t when;
+  uint32_t action;
+};
+
+// 한 분을 처리합니다. 실행할 항목은 out에 담고, 다음 실행 분으로 다시 겁니다.
+size_t stepMinute(Fired *out) {
+  uint32_t m = ++s_curMin;
+  s_stats.minutes++;
+  if (m % kMinPerDay == 0)  cascade(WHEEL_DAY,  (m / kMinPerDay) % kBuckets[WHEEL_DAY]);
+  if (m % kMinPerHour == 0) cascade(WHEEL_HOUR, (m / kMinPerHour) % kBuckets[WHEEL_HOUR]);
+
+  size_t n = 0;
+  uint8_t i = detach(kHeadOffset[WHEEL_MINUTE] + m % kBuckets[WHEEL_MINUTE]);
+  while (i != kNone) {
+    SchedEntry &e = s_entries[i];
+    uint8_t next = e.next;
+    if (e.nextMin == m) {
+      out[n++] = { i, e.when, e.action };
+      e.nextMin = nextFire(e.when, m);
+    }
+    place(i);
+    i = next;
+  }
+  return n;
+}
+
+void runAction(const Fired &f, bool serverConnected) {
+  if ((f.when & SCHED_FAILSAFE_ONLY) && serverConnected) {
+    portENTER_CRITICAL(&s_schedMux);
+    s_stats.skipped++;
+    portEXIT_CRITICAL(&s_schedMux);
+    return;
+  }
+  if (f.slot == 0) {
+    requestFeederOnce(actionValue(f.action));
+    logEvent(LOG_FAILSAFE_FEED);
+  } else {
+    enqueueCanCommand(actionModule(f.action), actionCommand(f.action), actionValue(f.action));
+    logEvent(LOG_SCHEDULE_FIRED, f.slot, actionModule(f.action), actionValue(f.action));
+  }
+  portENTER_CRITICAL(&s_schedMux);
+  s_stats.fired++;
+  portEXIT_CRITICAL(&s_schedMux);
+}
+
+bool validWhen(uint32_t when) {
+  uint32_t phase = when & SCHED_MINUTE_MASK;
+  if (when & SCHED_INTERVAL) {
+    uint32_t period = (when >> SCHED_PERIOD_SHIFT) & SCHED_MINUTE_MASK;
+    return period >= 1 && period <= kMinPerDay && phase < period;
+  }
+  return ((when >> SCHED_DOW_SHIFT) & SCHED_DOW_ALL) != 0 && phase < kMinPerDay;
+}
+
+void markChanged() {
+  s_lastChangeMs.store(millis(), std::memory_order_relaxed);
+  s_changeSeq.fetch_add(1, std::memory_order_release);
+  if (g_taskFlashLogHandle) xTaskNotifyGive(g_taskFlashLogHandle);
+}
+
+
+//------------------------------------------------------------------------------
+// 예약 블롭: [0] 버전 [1] 항목 수 [칸, 시각 워드 LE, 동작 워드 LE] x 수 [CRC-16 LE]
+//------------------------------------------------------------------------------
+
+void putLe32(uint8_t *p, uint32_t v) {
+  for (int k = 0; k < 4; ++k) p[k] = (uint8_t)(v >> (8 * k));
+}
+
+uint32_t getLe32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t encodeBlob(uint8_t *b) {
+  size_t n = 2;
+  uint8_t count = 0;
+  portENTER_CRITICAL(&s_schedMux);
+  for (uint8_t i = 1; i < SCHEDULE_MAX_ENTRIES; ++i) {
+    const SchedEntry &e = s_entries[i];
+    if (e.when == 0 && e.action == 0) continue;
+    b[n] = i;
+    putLe32(b + n + 1, e.when);
+    putLe32(b + n + 5, e.action);
+    n += kRecordLen;
+    count++;
+  }
+  portEXIT_CRITICAL(&s_schedMux);
+  b[0] = SCHEDULE_BLOB_VERSION;
+  b[1] = count;
+  uint16_t crc = crc16Ccitt(b, n);
+  b[n]     = (uint8_t)crc;
+  b[n + 1] = (uint8_t)(crc >> 8);
+  return n + 2;
+}
+
+// 저장된 항목을 표에 채웁니다. (휠은 호출자가 다시 만듦)
+uint8_t loadBlob() {
+  uint8_t b[kBlobMax];
+  size_t len = prefs.getBytesLength(SCHEDULE_NVS_KEY);
+  if (len == 0) return SETTINGS_LOAD_DEFAULTS;
+  if (len < 4 || len > kBlobMax || prefs.getBytes(SCHEDULE_NVS_KEY, b, len) != len ||
+      len != 2 + (size_t)b[1] * kRecordLen + 2) {
+    return SETTINGS_LOAD_BAD_LENGTH;
+  }
+  if (crc16Ccitt(b, len - 2) != (uint16_t)(b[len - 2] | (b[len - 1] << 8))) {
+    return SETTINGS_LOAD_BAD_CRC;
+  }
+  if (b[0] != SCHEDULE_BLOB_VERSION) return SETTINGS_LOAD_BAD_VERSION;
+
+  for (size_t n = 2; n + 2 < len; n += kRecordLen) {
+    uint8_t  slot = b[n];
+    uint32_t when = getLe32(b + n + 1);
+    if (slot == 0 || slot >= SCHEDULE_MAX_ENTRIES) continue;
+    s_entries[slot].when   = (when == 0 || validWhen(when)) ? when : 0;
+    s_entries[slot].action = getLe32(b + n + 5);
+  }
+  return SETTINGS_LOAD_OK;
+}
+
+} // namespace
+
+void scheduleInit() {
+  uint8_t result = loadBlob();
+  if (result >= SETTINGS_LOAD_BAD_LENGTH) {
+    logEvent(LOG_SCHEDULE_RESET, result);
+    prefs.remove(SCHEDULE_NVS_KEY);
+  }
+  portENTER_CRITICAL(&s_schedMux);
+  s_stats.loadResult = result;
+  rebuild(scheduleLocalTime() / 60);
+  portEXIT_CRITICAL(&s_schedMux);
+  s_savedSeq = s_changeSeq.load(std::memory_order_relaxed);
+  scheduleSyncSettings();
+}
+
+uint32_t scheduleLocalTime() {
+  return g_uptimeSeconds + s_offset.load(std::memory_order_relaxed);
+}
+
+void scheduleSetTime(uint32_t localSeconds) {
+  uint32_t before = scheduleLocalTime();
+  bool first = !s_synced.exchange(true);
+  s_offset.store(localSeconds - g_uptimeSeconds, std::memory_order_relaxed);
+
+  int32_t correction = (int32_t)(localSeconds - before);
+  portENTER_CRITICAL(&s_schedMux);
+  s_stats.timeSyncs++;
+  s_stats.lastCorrectionS = correction;
+  portEXIT_CRITICAL(&s_schedMux);
+  logEvent(LOG_TIME_SYNC, correction, first ? 1 : 0);
+}
+
+bool scheduleTimeSynced() {
+  return s_synced.load(std::memory_order_relaxed);
+}
+
+void scheduleTick(bool serverConnected) {
+  uint32_t target = scheduleLocalTime() / 60;
+  Fired fired[SCHEDULE_MAX_ENTRIES];
+
+  for (;;) {
+    portENTER_CRITICAL(&s_schedMux);
+    int32_t behind = (int32_t)(target - s_curMin);
+    if (behind <= 0 && behind >= -(int32_t)SCHEDULE_CATCHUP_MAX_MIN) {
+      // 같은 분이거나 조금 뒤로 감: 이미 처리한 분을 다시 실행하지 않도록 시계가 따라올 때까지 기다림
+      portEXIT_CRITICAL(&s_schedMux);
+      return;
+    }
+    if (behind < 0 || behind > (int32_t)SCHEDULE_CATCHUP_MAX_MIN) {
+      // 크게 뛰었음 (첫 시각 맞춤 등): 새 시각으로 다시 만들고 건너뛴 분은 실행하지 않음
+      rebuild(target);
+      portEXIT_CRITICAL(&s_schedMux);
+      return;
+    }
+    size_t n = stepMinute(fired);
+    portEXIT_CRITICAL(&s_schedMux);
+
+    // CAN 요청/로그는 구간 밖에서
+    for (size_t k = 0; k < n; ++k) runAction(fired[k], serverConnected);
+  }
+}
+
+bool scheduleHandleCommand(uint8_t command, uint32_t param) {
+  switch (command) {
+    case SYS_CMD_SCHEDULE_SET: {
+      uint8_t slot = (uint8_t)(param >> SCHED_SLOT_SHIFT);
+      uint32_t when = param & ((1u << SCHED_SLOT_SHIFT) - 1);
+      bool clear = (when & SCHED_INTERVAL) ? ((when >> SCHED_PERIOD_SHIFT) & SCHED_MINUTE_MASK) == 0
+                                           : ((when >> SCHED_DOW_SHIFT) & SCHED_DOW_ALL) == 0;
+      if (slot == 0 || slot >= SCHEDULE_MAX_ENTRIES || (!clear && !validWhen(when))) return false;
+      portENTER_CRITICAL(&s_schedMux);
+      s_entries[slot].when = clear ? 0 : when;
+      if (clear) s_entries[slot].action = 0;
+      rearm(slot);
+      portEXIT_CRITICAL(&s_schedMux);
+      break;
+    }
+    case SYS_CMD_SCHEDULE_ACTION: {
+      uint8_t slot = (uint8_t)(param >> 24);
+      if (slot == 0 || slot >= SCHEDULE_MAX_ENTRIES || actionModule(param) > MODULE_FEEDER) return false;
+      portENTER_CRITICAL(&s_schedMux);
+      s_entries[slot].action = param & 0xFFFFFF;
+      rearm(slot);
+      portEXIT_CRITICAL(&s_schedMux);
+      break;
+    }
+    case SYS_CMD_SCHEDULE_CLEAR:
+      portENTER_CRITICAL(&s_schedMux);
+      for (uint8_t i = 1; i < SCHEDULE_MAX_ENTRIES; ++i) {
+        s_entries[i].when = 0;
+        s_entries[i].action = 0;
+        rearm(i);
+      }
+      portEXIT_CRITICAL(&s_schedMux);
+      break;
+    default:
+      return false;
+  }
+  markChanged();
+  return true;
+}
+
+void scheduleSyncSettings() {
+  uint8_t h = g_settings.feederHour;
+  uint8_t m = g_settings.feederMinute;
+  uint8_t amt = g_settings.feederAmountPercent;
+  if (h == s_feedHour && m == s_feedMinute && amt == s_feedAmount) return;
+  s_feedHour = h;
+  s_feedMinute = m;
+  s_feedAmount = amt;
+
+  // 서버 미연결일 때만, 매일 설정 시각에 설정 양만큼 (양 0이면 끔)
+  portENTER_CRITICAL(&s_schedMux);
+  SchedEntry &e = s_entries[0];
+  e.when = (amt > 0 && h < 24 && m < 60)
+             ? SCHED_FAILSAFE_ONLY | (SCHED_DOW_ALL << SCHED_DOW_SHIFT) | ((uint32_t)h * 60 + m)
+             : 0;
+  e.action = ((uint32_t)MODULE_FEEDER << 16) | ((uint32_t)FEEDER_CMD_FEED_ONCE << 8) | amt;
+  rearm(0);
+  portEXIT_CRITICAL(&s_schedMux);
+}
+
+void scheduleService() {
+  uint32_t seq = s_changeSeq.load(std::memory_order_acquire);
+  if (seq == s_savedSeq) return;
+  if (millis() - s_lastChangeMs.load(std::memory_order_relaxed) < SCHEDULE_SAVE_DELAY_MS) return;
+
+  uint8_t blob[kBlobMax];
+  size_t len = encodeBlob(blob);
+  if (prefs.putBytes(SCHEDULE_NVS_KEY, blob, len) != len) return;  // 다음 차례에 다시 시도
+  s_savedSeq = seq;
+}
+
+void getScheduleStats(ScheduleStats &out) {
+  portENTER_CRITICAL(&s_schedMux);
+  out = s_stats;
+  portEXIT_CRITICAL(&s_schedMux);
+}
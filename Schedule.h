@@ -0,0 +1,109 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file Schedule.h
+ * @brief 현지 시계(서버 시각 맞춤)와 분 단위 계층 타이머 휠로 도는 예약 실행을 선언합니다.
+ *
+ * 시계: 현지 시각 = g_uptimeSeconds + 보정값. 서버가 SYS_CMD_SET_TIME으로 현지 초를 보내면
+ * 보정값만 바꾸므로, 부팅 후 시간이 아니라 실제 시각에 맞춰 울리고 맞출 때마다 오차가 사라집니다.
+ * 처음 맞추기 전에는 보정값 0(부팅 = 1970-01-01 00:00 목요일)으로 예전처럼 동작합니다.
+ *
+ * 예약 칸 하나는 "언제(시각 워드) + 무엇을(동작 워드)"이며 두 가지 반복이 있습니다.
+ *  - 매일: 요일 마스크의 요일마다 하루 중 한 분에 (급여, 조명 켜기/끄기 = 광주기)
+ *  - 간격: 매일 자정 기준 phase분부터 period분마다 (펌프 주기)
+ *
+ * 휠은 분(60칸) / 시(24칸) / 일(8칸) 세 단계입니다. 항목은 다음 실행 분까지 남은 시간에 맞는
+ * 단계의 칸에 매달리고, 정시/자정마다 윗 단계의 한 칸만 아래로 내려 보냅니다. 그래서 1분 틱의
+ * 비용은 항목 수와 무관하고, 그 분에 실행할 항목 수에만 비례합니다.
+ *
+ * 서버가 넣은 항목(1번 칸부터)은 NVS 블롭 하나(SCHEDULE_NVS_KEY, 버전 + CRC)에 보관되어
+ * 재부팅 후에도 남습니다. 저장은 설정처럼 taskFlashLog가 모아서 합니다. 0번 칸은 설정 화면의
+ * Fail-safe 급여 시각으로, g_settings에서 만들어지므로 따로 저장하지 않습니다.
+ *
+ * 시각 워드 (SYS_CMD_SCHEDULE_SET 파라미터)
+ *  [31..26] 칸  [25] 1=간격  [24] 1=서버 미연결일 때만 (Fail-safe)
+ *  매일: [23..17] 요일 마스크 (bit0 = 일요일, 0이면 칸 지움)  [10..0] 하루 중 분 (0~1439)
+ *  간격: [21..11] period분 (1~1440, 0이면 칸 지움)            [10..0] phase분 (< period)
+ * 동작 워드 (SYS_CMD_SCHEDULE_ACTION 파라미터)
+ *  [31..24] 칸  [23..16] 모듈 (ModuleId)  [15..8] 명령  [7..0] 값
+ * 동작을 먼저 보내고 시각을 보내면 그때부터 울립니다. (순서가 바뀌어도 둘 다 오면 울림)
+ */
+
+// 시각 워드 필드
+const uint32_t SCHED_SLOT_SHIFT    = 26;
+const uint32_t SCHED_INTERVAL      = 1u << 25;
+const uint32_t SCHED_FAILSAFE_ONLY = 1u << 24;
+const uint32_t SCHED_DOW_SHIFT     = 17;
+const uint32_t SCHED_DOW_ALL       = 0x7F;
+const uint32_t SCHED_PERIOD_SHIFT  = 11;
+const uint32_t SCHED_MINUTE_MASK   = 0x7FF;
+
+/**
+ * @brief 예약 실행 통계 (누적값)
+ */
+struct ScheduleStats {
+  uint32_t entries;      // 지금 휠에 걸린 항목 수
+  uint32_t fired;        // 실행한 동작 수
+  uint32_t skipped;      // 서버 연결 중이라 건너뛴 Fail-safe 항목 수
+  uint32_t minutes;      // 처리한 분 틱 수
+  uint32_t cascades;     // 윗 단계에서 내려 보낸 항목 수
+  uint32_t timeSyncs;    // SYS_CMD_SET_TIME 수
+  int32_t  lastCorrectionS; // 마지막 시각 맞춤 보정량 (초)
+  uint8_t  loadResult;   // 부팅 때 블롭 읽은 결과 (SettingsLoadResult)
+};
+
+/**
+ * @brief 저장된 예약 항목을 읽어 휠을 만듭니다. setup()에서 loadSettings() 뒤에 호출합니다.
+ */
+void scheduleInit();
+
+/**
+ * @brief 지금 현지 시각 (1970-01-01 00:00부터의 초). 맞추기 전에는 부팅 후 초
+ */
+uint32_t scheduleLocalTime();
+
+/**
+ * @brief 서버 시각으로 현지 시계를 맞춥니다. (SYS_CMD_SET_TIME)
+ *
+ * 작게 앞으로 뛰면 건너뛴 분을 다음 틱에 차례로 실행하고, 작게 뒤로 가면 같은 분을 두 번
+ * 실행하지 않도록 시계가 따라올 때까지 기다립니다. 그보다 크면 휠을 새 시각으로 다시 만듭니다.
+ */
+void scheduleSetTime(uint32_t localSeconds);
+
+/**
+ * @brief 처음 시각을 맞췄는지 (맞추기 전에는 부팅 기준 시각)
+ */
+bool scheduleTimeSynced();
+
+/**
+ * @brief 현지 분이 넘어갔으면 그 분의 항목을 실행합니다. (taskLogic 전용, 1초에 한 번)
+ * @param serverConnected false일 때만 Fail-safe 항목의 동작을 실행
+ */
+void scheduleTick(bool serverConnected);
+
+/**
+ * @brief 서버 예약 명령(SYS_CMD_SCHEDULE_*)을 처리합니다. 잘못된 칸이면 false
+ */
+bool scheduleHandleCommand(uint8_t command, uint32_t param);
+
+/**
+ * @brief 설정의 Fail-safe 급여 시각/양이 바뀌었으면 0번 칸을 다시 겁니다. (taskLogic)
+ */
+void scheduleSyncSettings();
+
+/**
+ * @brief 바뀐 예약 항목을 NVS에 저장합니다. (taskFlashLog 전용)
+ */
+void scheduleService();
+
+/**
+ * @brief 예약 실행 통계를 복사합니다.
+ */
+void getScheduleStats(ScheduleStats &out);
+
+
+#endif // SCHEDULE_H
@@ -0,0 +1,225 @@
+#include "Globals.h"
+#include "Settings.h"
+#include "StateStore.h"
+#include "Protocol.h"
+
+#include <atomic>
+
+/**
+ * @file Settings.cpp
+ * @brief 설정 블롭 인코딩, 부팅 때 검사/이전, 지연 저장의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+const size_t  kBlobLen    = 16;
+const size_t  kBlobCrcPos = kBlobLen - 2;
+const uint8_t kLegacyVersion = 1;  // 필드마다 NVS 키 하나 (블롭 이전)
+
+static_assert(SETTINGS_BLOB_VERSION > kLegacyVersion, "blob versions start after the per-key layout");
+
+// 모듈 사용 여부 비트 (블롭 [3])
+const uint8_t kEnTank     = 0x01;
+const uint8_t kEnGrow     = 0x02;
+const uint8_t kEnNutrient = 0x04;
+const uint8_t kEnFeeder   = 0x08;
+
+// 저장 상태: 변경 순번은 saveSettings()가 올리고, 저장한 순번은 taskFlashLog만 씁니다.
+std::atomic<uint32_t> s_changeSeq{0};
+std::atomic<uint32_t> s_lastChangeMs{0};
+uint32_t              s_savedSeq = 0;
+uint8_t               s_savedBlob[kBlobLen];  // 마지막으로 NVS에 있는 블롭
+bool                  s_savedValid = false;
+
+std::atomic<uint32_t> s_changes{0};
+uint32_t              s_writes     = 0;
+uint32_t              s_unchanged  = 0;
+uint8_t               s_loadResult = SETTINGS_LOAD_DEFAULTS;
+
+void applyDefaults(SystemSettings &s) {
+  s.displayOffMinutes     = 10;
+  s.moduleEnabledTank     = true;
+  s.moduleEnabledGrow     = true;
+  s.moduleEnabledNutrient = true;
+  s.moduleEnabledFeeder   = true;
+  s.feederHour            = 8;
+  s.feederMinute          = 0;
+  s.feederAmountPercent   = 50;
+  s.growLedBrightness     = 70;
+  s.fwVersion             = 0x00010000; // v1.0.0
+  s.factoryInitialized    = false;
+}
+
+void encodeBlob(const SystemSettings &s, uint8_t *b) {
+  b[0] = SETTINGS_BLOB_VERSION;
+  b[1] = (uint8_t)kBlobLen;
+  b[2] = s.displayOffMinutes;
+  b[3] = (uint8_t)((s.moduleEnabledTank     ? kEnTank     : 0) |
+                   (s.moduleEnabledGrow     ? kEnGrow     : 0) |
+                   (s.moduleEnabledNutrient ? kEnNutrient : 0) |
+                   (s.moduleEnabledFeeder   ? kEnFeeder   : 0));
+  b[4] = s.feederHour;
+  b[5] = s.feederMinute;
+  b[6] = s.feederAmountPercent;
+  b[7] = s.growLedBrightness;
+  for (int i = 0; i < 4; ++i) b[8 + i] = (uint8_t)(s.fwVersion >> (8 * i));
+  b[12] = s.factoryInitialized ? 1 : 0;
+  b[13] = 0;  // 예약
+  uint16_t crc = crc16Ccitt(b, kBlobCrcPos);
+  b[kBlobCrcPos]     = (uint8_t)crc;
+  b[kBlobCrcPos + 1] = (uint8_t)(crc >> 8);
+}
+
+void decodeBlob(const uint8_t *b, SystemSettings &s) {
+  s.displayOffMinutes     = b[2];
+  s.moduleEnabledTank     = (b[3] & kEnTank) != 0;
+  s.moduleEnabledGrow     = (b[3] & kEnGrow) != 0;
+  s.moduleEnabledNutrient = (b[3] & kEnNutrient) != 0;
+  s.moduleEnabledFeeder   = (b[3] & kEnFeeder) != 0;
+  s.feederHour            = b[4];
+  s.feederMinute          = b[5];
+  s.feederAmountPercent   = b[6];
+  s.growLedBrightness     = b[7];
+  s.fwVersion = (uint32_t)b[8] | ((uint32_t)b[9] << 8) | ((uint32_t)b[10] << 16) | ((uint32_t)b[11] << 24);
+  s.factoryInitialized    = b[12] != 0;
+}
+
+// CRC가 맞아도 범위를 벗어난 값은 기본값으로 (예전 형식에서 옮긴 값 포함)
+void sanitize(SystemSettings &s) {
+  SystemSettings d;
+  applyDefaults(d);
+  if (s.feederHour > 23)           s.feederHour = d.feederHour;
+  if (s.feederMinute > 59)         s.feederMinute = d.feederMinute;
+  if (s.feederAmountPercent > 100) s.feederAmountPercent = d.feederAmountPercent;
+  if (s.growLedBrightness > 100)   s.growLedBrightness = d.growLedBrightness;
+}
+
+// 예전 형식(필드마다 키 하나)을 읽습니다. 하나도 없으면 false
+bool loadLegacyKeys(SystemSettings &s) {
+  if (!prefs.isKey("dispOffMin") && !prefs.isKey("fdHour") && !prefs.isKey("fwVer")) return false;
+  SystemSettings d;
+  applyDefaults(d);
+  s.displayOffMinutes     = prefs.getUChar("dispOffMin", d.displayOffMinutes);
+  s.moduleEnabledTank     = prefs.getBool("enTank", d.moduleEnabledTank);
+  s.moduleEnabledGrow     = prefs.getBool("enGrow", d.moduleEnabledGrow);
+  s.moduleEnabledNutrient = prefs.getBool("enNutr", d.moduleEnabledNutrient);
+  s.moduleEnabledFeeder   = prefs.getBool("enFeed", d.moduleEnabledFeeder);
+  s.feederHour            = prefs.getUChar("fdHour", d.feederHour);
+  s.feederMinute          = prefs.getUChar("fdMin", d.feederMinute);
+  s.feederAmountPercent   = prefs.getUChar("fdAmt", d.feederAmountPercent);
+  s.growLedBrightness     = prefs.getUChar("growBright", d.growLedBrightness);
+  s.fwVersion             = prefs.getULong("fwVer", d.fwVersion);
+  s.factoryInitialized    = prefs.getBool("factoryInit", d.factoryInitialized);
+  return true;
+}
+
+void removeLegacyKeys() {
+  static const char *const kKeys[] = {
+    "dispOffMin", "enTank", "enGrow", "enNutr", "enFeed",
+    "fdHour", "fdMin", "fdAmt", "growBright", "fwVer", "factoryInit",
+  };
+  for (const char *k : kKeys) prefs.remove(k);
+}
+
+// 블롭을 NVS에 씁니다. 마지막으로 쓴 것과 같으면 쓰지 않음
+// @return 저장된 내용이 blob과 같아졌으면 true (쓰기 실패면 false)
+bool writeBlob(const uint8_t *blob) {
+  if (s_savedValid && memcmp(blob, s_savedBlob, kBlobLen) == 0) {
+    s_unchanged++;
+    return true;
+  }
+  if (prefs.putBytes(SETTINGS_NVS_KEY, blob, kBlobLen) != kBlobLen) return false;
+  memcpy(s_savedBlob, blob, kBlobLen);
+  s_savedValid = true;
+  s_writes++;
+  return true;
+}
+
+// 바뀐 설정을 블롭으로 만들어 저장합니다. 쓰는 사이 또 바뀌면 다음 차례에 한 번 더 씁니다.
+void saveNow() {
+  uint32_t seq = s_changeSeq.load(std::memory_order_acquire);
+  SystemSettings copy;
+  memcpy(&copy, (const void *)&g_settings, sizeof(copy));
+  uint8_t blob[kBlobLen];
+  encodeBlob(copy, blob);
+  if (!writeBlob(blob)) return;  // 다음 차례에 다시 시도
+  s_savedSeq = seq;
+}
+
+} // namespace
+
+void loadSettings() {
+  SystemSettings s;
+  applyDefaults(s);
+  uint8_t blob[kBlobLen];
+  size_t len = prefs.getBytesLength(SETTINGS_NVS_KEY);
+  bool stored = false;
+
+  if (len == 0) {
+    if (loadLegacyKeys(s)) {
+      s_loadResult = SETTINGS_LOAD_MIGRATED;
+      logEvent(LOG_SETTINGS_MIGRATED, kLegacyVersion, SETTINGS_BLOB_VERSION);
+    } else {
+      s_loadResult = SETTINGS_LOAD_DEFAULTS;
+    }
+  } else if (len != kBlobLen || prefs.getBytes(SETTINGS_NVS_KEY, blob, kBlobLen) != kBlobLen ||
+             blob[1] != kBlobLen) {
+    s_loadResult = SETTINGS_LOAD_BAD_LENGTH;
+  } else if (crc16Ccitt(blob, kBlobCrcPos) !=
+             (uint16_t)(blob[kBlobCrcPos] | (blob[kBlobCrcPos + 1] << 8))) {
+    s_loadResult = SETTINGS_LOAD_BAD_CRC;
+  } else if (blob[0] != SETTINGS_BLOB_VERSION) {
+    // 블롭 형식이 바뀌면 여기서 이전 버전을 옮겨 담습니다. (지금은 버전 2 하나뿐)
+    s_loadResult = SETTINGS_LOAD_BAD_VERSION;
+  } else {
+    decodeBlob(blob, s);
+    memcpy(s_savedBlob, blob, kBlobLen);
+    s_savedValid = true;
+    stored = true;
+    s_loadResult = SETTINGS_LOAD_OK;
+  }
+
+  if (s_loadResult >= SETTINGS_LOAD_BAD_LENGTH) {
+    logEvent(LOG_SETTINGS_RESET, s_loadResult);
+  }
+  sanitize(s);
+  memcpy((void *)&g_settings, &s, sizeof(s));
+
+  // 첫 부팅/이전/손상: 지금 내용으로 블롭을 만들어 두고 예전 키는 정리
+  // (못 썼으면 예전 키는 남기고, 저장 안 된 변경으로 두어 taskFlashLog가 다시 시도)
+  bool saved = true;
+  if (!stored) {
+    uint8_t fresh[kBlobLen];
+    encodeBlob(s, fresh);
+    saved = writeBlob(fresh);
+    if (saved && s_loadResult == SETTINGS_LOAD_MIGRATED) removeLegacyKeys();
+  }
+  s_savedSeq = s_changeSeq.load(std::memory_order_relaxed) - (saved ? 0 : 1);
+}
+
+void saveSettings() {
+  s_lastChangeMs.store(millis(), std::memory_order_relaxed);
+  s_changeSeq.fetch_add(1, std::memory_order_release);
+  s_changes.fetch_add(1, std::memory_order_relaxed);
+  statePublishChanges(STATE_CHG_SETTINGS);
+  if (g_taskFlashLogHandle) xTaskNotifyGive(g_taskFlashLogHandle);
+}
+
+void settingsService() {
+  if (s_changeSeq.load(std::memory_order_acquire) == s_savedSeq) return;
+  // 연속 변경은 마지막 변경 후 잠잠해질 때까지 모아 한 번에 씀
+  if (millis() - s_lastChangeMs.load(std::memory_order_relaxed) < SETTINGS_SAVE_DELAY_MS) return;
+  saveNow();
+}
+
+void settingsFlush() {
+  if (s_changeSeq.load(std::memory_order_acquire) == s_savedSeq) return;
+  saveNow();
+}
+
+void getSettingsStats(SettingsStats &out) {
+  out.changes    = s_changes.load(std::memory_order_relaxed);
+  out.writes     = s_writes;
+  out.unchanged  = s_unchanged;
+  out.loadResult = s_loadResult;
+}
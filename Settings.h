@@ -0,0 +1,64 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file Settings.h
+ * @brief g_settings를 NVS에 버전 + CRC가 붙은 블롭 하나로 저장하는 지연 저장을 선언합니다.
+ *
+ * 설정은 NVS 키 하나(SETTINGS_NVS_KEY)에 고정 길이 블롭으로 저장합니다.
+ *  [0] 버전  [1] 길이  [2..13] 필드 (모두 LE)  [14..15] CRC-16/CCITT
+ *
+ * saveSettings()(Globals.h)는 NVS를 건드리지 않고 "바뀜"만 표시한 뒤 taskFlashLog를 깨웁니다.
+ * taskFlashLog는 마지막 변경 후 SETTINGS_SAVE_DELAY_MS가 지나면 블롭을 만들어, 마지막으로
+ * 저장한 블롭과 다를 때만 씁니다. 엔코더를 여러 번 돌려도 쓰기는 한 번이고, 값을 바꿨다가
+ * 되돌리면 쓰지 않습니다. UI 태스크는 플래시 쓰기를 기다리지 않습니다.
+ *
+ * loadSettings()(Globals.h)는 부팅 때 블롭을 읽어 버전과 CRC를 확인합니다.
+ *  - 블롭이 없고 예전 방식(필드마다 키 하나)으로 저장된 값이 있으면 옮겨 담고 예전 키를 지움
+ *  - 블롭이 손상되었거나 모르는 버전이면 기본값으로 되돌리고 LOG_SETTINGS_RESET을 남김
+ */
+
+/**
+ * @brief 부팅 때 설정을 읽은 결과
+ */
+enum SettingsLoadResult : uint8_t {
+  SETTINGS_LOAD_OK = 0,       // 현재 버전 블롭
+  SETTINGS_LOAD_DEFAULTS,     // 저장된 설정 없음 (첫 부팅)
+  SETTINGS_LOAD_MIGRATED,     // 예전 형식에서 옮겨 담음
+  SETTINGS_LOAD_BAD_LENGTH,   // 손상: 길이가 맞지 않음 → 기본값
+  SETTINGS_LOAD_BAD_CRC,      // 손상: CRC 불일치 → 기본값
+  SETTINGS_LOAD_BAD_VERSION,  // 모르는 (더 새) 버전 → 기본값
+};
+
+/**
+ * @brief 설정 저장 통계 (누적값)
+ */
+struct SettingsStats {
+  uint32_t changes;     // saveSettings() 호출 수
+  uint32_t writes;      // NVS에 블롭을 쓴 횟수
+  uint32_t unchanged;   // 저장할 때가 되었지만 내용이 같아 쓰지 않은 횟수
+  uint8_t  loadResult;  // SettingsLoadResult
+};
+
+/**
+ * @brief 변경 후 SETTINGS_SAVE_DELAY_MS가 지났으면 설정을 저장합니다. (taskFlashLog 전용)
+ */
+void settingsService();
+
+/**
+ * @brief 표시된 변경을 기다리지 않고 지금 저장합니다.
+ *
+ * 펌웨어에서는 부르지 않습니다. taskFlashLog 없이 도는 호스트 벤치/시험에서 저장 시점을 맞추는 용도입니다.
+ */
+void settingsFlush();
+
+/**
+ * @brief 설정 저장 통계를 복사합니다.
+ */
+void getSettingsStats(SettingsStats &out);
+
+
+#endif // SETTINGS_H
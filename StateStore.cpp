@@ -0,0 +1,94 @@
+#include "Globals.h"
+#include "StateStore.h"
+#include "Profile.h"
+
+#include <atomic>
+
+/**
+ * @file StateStore.cpp
+ * @brief g_state 시퀀스 락(seqlock)의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+portMUX_TYPE s_stateMux = portMUX_INITIALIZER_UNLOCKED;
+
+// 짝수: 안정 상태, 홀수: 쓰기 진행 중
+std::atomic<uint32_t> s_stateSeq{0};
+
+// 통계 (writes는 임계 구역 안에서만, 나머지는 relaxed 원자 연산으로 갱신)
+uint32_t s_writes = 0;
+uint32_t s_writeWaitUs = 0;  // 지금 쓰기 구간을 얻기까지 기다린 시간 (임계 구역 안에서만)
+std::atomic<uint32_t> s_reads{0};
+std::atomic<uint32_t> s_readRetries{0};
+std::atomic<uint32_t> s_maxReadRetries{0};
+
+// taskLogic이 아직 가져가지 않은 STATE_CHG_* 비트 (자동 규칙 평가용)
+std::atomic<uint32_t> s_logicChanges{0};
+
+} // namespace
+
+void stateWriteBegin() {
+  uint32_t t0 = micros();
+  portENTER_CRITICAL(&s_stateMux);
+  s_writeWaitUs = micros() - t0;
+  s_stateSeq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void stateWriteEnd() {
+  s_writes++;
+  uint32_t waitUs = s_writeWaitUs;
+  s_stateSeq.fetch_add(1, std::memory_order_release);
+  portEXIT_CRITICAL(&s_stateMux);
+  profileLockWait(waitUs);
+}
+
+bool snapshotState(SystemState &out) {
+  uint32_t retries = 0;
+  uint32_t t0 = 0;
+
+  for (;;) {
+    uint32_t before = s_stateSeq.load(std::memory_order_acquire);
+    if ((before & 1) == 0) {
+      memcpy(&out, (const void *)&g_state, sizeof(out));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s_stateSeq.load(std::memory_order_relaxed) == before) break;
+    }
+    if (retries++ == 0) t0 = micros();
+    // 쓰는 쪽이 다른 코어에서 구간을 끝낼 때까지 같은 우선순위 태스크에 양보합니다.
+    if (before & 1) taskYIELD();
+  }
+
+  s_reads.fetch_add(1, std::memory_order_relaxed);
+  if (retries) {
+    profileLockWait(micros() - t0);
+    s_readRetries.fetch_add(retries, std::memory_order_relaxed);
+    uint32_t prev = s_maxReadRetries.load(std::memory_order_relaxed);
+    while (retries > prev &&
+           !s_maxReadRetries.compare_exchange_weak(prev, retries, std::memory_order_relaxed)) {
+    }
+  }
+  return true;
+}
+
+void statePublishChanges(uint32_t bits) {
+  if (!bits) return;
+  s_logicChanges.fetch_or(bits, std::memory_order_relaxed);
+  if (g_taskUiHandle) {
+    xTaskNotify(g_taskUiHandle, bits, eSetBits);
+  }
+}
+
+uint32_t stateTakeChanges() {
+  return s_logicChanges.exchange(0, std::memory_order_relaxed);
+}
+
+void getStateSyncStats(StateSyncStats &out) {
+  portENTER_CRITICAL(&s_stateMux);
+  out.writes = s_writes;
+  portEXIT_CRITICAL(&s_stateMux);
+  out.reads          = s_reads.load(std::memory_order_relaxed);
+  out.readRetries    = s_readRetries.load(std::memory_order_relaxed);
+  out.maxReadRetries = s_maxReadRetries.load(std::memory_order_relaxed);
+}
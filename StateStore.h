@@ -0,0 +1,72 @@
+#ifndef STATE_STORE_H
+#define STATE_STORE_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file StateStore.h
+ * @brief g_state의 동기화(시퀀스 락, seqlock)를 선언합니다.
+ *
+ * - 쓰기: stateWriteBegin() ~ stateWriteEnd() 사이에서 g_state 필드를 직접 수정합니다.
+ *   이 구간은 portMUX 임계 구역이므로 그 안에서 로그, 큐 전송, 지연 등
+ *   블로킹 API를 호출하면 안 되며 필드 대입 수준으로 짧게 유지해야 합니다.
+ *   쓰기끼리는 스핀락으로 직렬화되므로 한 시점에 쓰는 쪽은 항상 하나입니다.
+ * - 읽기: snapshotState()로 일관된 복사본을 얻습니다. 락을 잡지 않으므로
+ *   쓰기를 막지 않고, 복사 도중 쓰기가 끼어들면 시퀀스가 바뀐 것을 보고 다시 복사합니다.
+ *   쓰는 쪽은 임계 구역 안에서 선점되지 않으므로 재시도 횟수는 유한합니다.
+ * - 쓰기 구간을 얻기까지 / 다시 복사하느라 기다린 시간은 부른 태스크의 프로파일(Profile.h)에 쌓입니다.
+ */
+
+/**
+ * @brief g_state 동기화 경합 통계
+ */
+struct StateSyncStats {
+  uint32_t writes;           // 쓰기 구간 횟수
+  uint32_t reads;            // 스냅샷 횟수
+  uint32_t readRetries;      // 복사 중 쓰기가 끼어들어 다시 복사한 횟수 (누적)
+  uint32_t maxReadRetries;   // 스냅샷 한 번에서 가장 많이 다시 복사한 횟수
+};
+
+/**
+ * @brief g_state 쓰기 구간을 시작합니다. (반드시 stateWriteEnd()와 짝)
+ */
+void stateWriteBegin();
+
+/**
+ * @brief g_state 쓰기 구간을 끝내고 새 버전을 공개합니다.
+ */
+void stateWriteEnd();
+
+/**
+ * @brief g_state의 일관된 복사본을 만듭니다. 락을 잡지 않으며 실패하지 않습니다.
+ * @param out 복사본을 받을 구조체
+ * @return 항상 true (기존 호출부와의 호환용)
+ */
+bool snapshotState(SystemState &out);
+
+/**
+ * @brief 쓰기로 바뀐 부분(STATE_CHG_* 비트)을 UI 태스크에 알립니다.
+ *
+ * 같은 비트는 stateTakeChanges()가 가져갈 때까지 따로 모아 둡니다.
+ * 태스크 알림을 보내므로 쓰기 구간 안이 아니라 stateWriteEnd() 뒤에 호출합니다.
+ * 구간 안에서는 바뀐 비트를 지역 변수에 모아 두었다가 한 번에 알리면 됩니다.
+ * @param bits 바뀐 부분 (0이면 아무것도 하지 않음)
+ */
+void statePublishChanges(uint32_t bits);
+
+/**
+ * @brief 지난 호출 이후 statePublishChanges()로 알린 비트를 모두 가져오고 비웁니다. (taskLogic 전용)
+ *
+ * CAN 수신처럼 다른 태스크가 바꾼 센서 값을 자동 규칙(Rules.h)이 알 수 있게 합니다.
+ * 복사본을 뜨기 전에 가져와야 그 뒤에 바뀐 것을 다음 주기에 놓치지 않습니다.
+ */
+uint32_t stateTakeChanges();
+
+/**
+ * @brief 현재까지의 경합 통계를 복사합니다.
+ */
+void getStateSyncStats(StateSyncStats &out);
+
+
+#endif // STATE_STORE_H
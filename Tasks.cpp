@@ -1,5 +1,21 @@
 #include "Globals.h"
 #include "Tasks.h"
+#include "Communication.h"
+#include "CanTxScheduler.h"
+#include "CanCommand.h"
+#include "Protocol.h"
+#include "StateStore.h"
+#include "Render.h"
+#include "EventLog.h"
+#include "FlashLog.h"
+#include "History.h"
+#include "Settings.h"
+#include "Indicator.h"
+#include "Schedule.h"
+#include "Rules.h"
+#include "Profile.h"
+#include "Trace.h"
+#include "UI.h"
 
 // twai.h는 C 라이브러리이므로 extern "C"로 감싸야 합니다.
 extern "C" {
@@ -16,57 +32,214 @@ extern "C" {
 // FreeRTOS 태스크 구현
 //==============================================================================
 
+namespace {
+
+// 명령 하나를 컨트롤러 TX 큐에 넘깁니다. 큐가 가득 차면 false
+bool transmitCanItem(const CanTxItem &item) {
+  twai_message_t txMsg;
+  memset(&txMsg, 0, sizeof(txMsg));
+  txMsg.identifier = item.canId;
+  txMsg.data_length_code = item.dlc;
+  memcpy(txMsg.data, item.data, item.dlc);
+  return twai_transmit(&txMsg, 0) == ESP_OK;
+}
+
+} // namespace
+
 void taskCan(void *pvParameters) {
   uint32_t lastPollMs = 0;
+  uint32_t reportedDrops = 0;
+  uint32_t reportedTxDrops = 0;
+  uint32_t reportedCmdFails = 0;
+  CanTxItem pendingTx;        // 컨트롤러 TX 큐가 가득 차 아직 넘기지 못한 명령
+  bool hasPendingTx = false;
+
   for (;;) {
+    // RX 경고, TX 명령 추가, TX 완료 중 하나가 올 때까지 잠듭니다.
+    // 경고를 못 받는 상황(드라이버 미설치 등)에서도 수집 주기마다는 깨어나 폴링하고,
+    // ACK를 기다리는 명령이 있으면 가장 이른 재전송 시각에 맞춰 깨어납니다.
+    uint32_t events = 0;
+    uint32_t waitMs = canCmdMsUntilDeadline(micros(), PERIOD_CAN_COLLECT_MS);
+    xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(waitMs));
+    profileLoopBegin(PROF_TASK_CAN);
     uint32_t now = millis();
 
-    // Rx (non-blocking or 짧은 timeout)
+    // Rx: 드라이버 큐에 쌓인 프레임을 모두 스테이징 링으로 옮기고,
+    // 링이 차면 배치로 상태에 반영해 자리를 만든 뒤 계속 옮깁니다.
     twai_message_t rxMsg;
-    if (twai_receive(&rxMsg, pdMS_TO_TICKS(10)) == ESP_OK) {
-      handleCanFrame(rxMsg);
+    while (twai_receive(&rxMsg, 0) == ESP_OK) {
+      if (!canRxPush(rxMsg)) {
+        canRxApplyPending(CAN_RX_APPLY_BATCH);
+        canRxPush(rxMsg);
+      }
+    }
+    while (canRxApplyPending(CAN_RX_APPLY_BATCH) > 0) {
     }
 
-    // Tx 큐 처리
-    if (g_canTxQueue) {
-      CanTxItem item;
-      if (xQueueReceive(g_canTxQueue, &item, 0) == pdTRUE) {
-        twai_message_t txMsg;
-        memset(&txMsg, 0, sizeof(txMsg));
-        txMsg.identifier = item.canId;
-        txMsg.data_length_code = item.dlc;
-        memcpy(txMsg.data, item.data, item.dlc);
-        twai_transmit(&txMsg, pdMS_TO_TICKS(10));
+    // Tx: ACK 시간이 지난 명령을 같은 seq로 먼저 다시 보냅니다.
+    // (컨트롤러 TX 큐가 가득 차면 횟수를 쓰지 않고 1ms 뒤나 TX 완료 알림 때 다시 시도)
+    CanTxItem retx;
+    while (canCmdNextRetransmit(micros(), retx)) {
+      bool sent = transmitCanItem(retx);
+      canCmdRetransmitDone(retx, sent, micros());
+      if (!sent) break;
+    }
+
+    // Tx: 새 명령은 seq를 붙여 대기 표에 올린 뒤, 컨트롤러 TX 큐가 받아 주는 만큼 넘기고
+    // 가득 차면 TX 완료 알림에서 이어 보냅니다. 대기 표가 차면 ACK가 올 때까지 꺼내지 않되,
+    // 안전 명령은 남겨 둔 자리로 먼저 나갑니다.
+    for (;;) {
+      if (!hasPendingTx) {
+        if (!canCmdHasRoom(true) || !canTxTake(pendingTx, canCmdHasRoom(false))) break;
+        traceStamp(pendingTx.traceId, TRACE_STAGE_CAN_TAKEN);
+        canCmdTrack(pendingTx, micros());
+        hasPendingTx = true;
       }
+      if (!transmitCanItem(pendingTx)) break;
+      traceStamp(pendingTx.traceId, TRACE_STAGE_CAN_TX);
+      hasPendingTx = false;
     }
 
     // 필요 시 100ms 간격으로 Heartbeat 등 송신
     if (now - lastPollMs >= PERIOD_CAN_COLLECT_MS) {
       lastPollMs = now;
       // TODO: 필요 시 CAN 폴링 프레임 송신
+
+      // 송수신 유실은 조용히 넘어가지 않도록 새로 늘어난 만큼 로그로 남깁니다.
+      CanTxStats tx;
+      getCanTxStats(tx);
+      if (tx.dropped != reportedTxDrops) {
+        logEvent(LOG_CAN_TX_DROPPED, (int32_t)(tx.dropped - reportedTxDrops));
+        reportedTxDrops = tx.dropped;
+      }
+
+      CanCmdStats cmd;
+      getCanCmdTotals(cmd);
+      uint32_t cmdFails = cmd.timeouts + cmd.rejected;
+      if (cmdFails != reportedCmdFails) {
+        logEvent(LOG_CAN_CMD_FAILED, (int32_t)(cmdFails - reportedCmdFails),
+                 (int32_t)cmd.timeouts, (int32_t)cmd.rejected);
+        reportedCmdFails = cmdFails;
+      }
+
+      canRxPollDriverStats();
+      CanRxStats rx;
+      getCanRxStats(rx);
+      uint32_t drops = rx.overflowDrops + rx.driverMissed;
+      if (drops != reportedDrops) {
+        logEvent(LOG_CAN_RX_LOST, (int32_t)(drops - reportedDrops),
+                 (int32_t)rx.overflowDrops, (int32_t)rx.driverMissed);
+        reportedDrops = drops;
+      }
     }
+    profileLoopEnd(PROF_TASK_CAN);
+  }
+}
+
+void taskCanAlert(void *pvParameters) {
+  bool configured = false;
 
-    vTaskDelay(pdMS_TO_TICKS(5));
+  for (;;) {
+    if (!configured) {
+      configured = (twai_reconfigure_alerts(CAN_ALERTS_ENABLED, nullptr) == ESP_OK);
+      if (!configured) {
+        // 드라이버가 아직 설치되지 않음: taskCan은 주기 폴링으로 동작
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        continue;
+      }
+    }
+
+    uint32_t alerts = 0;
+    esp_err_t err = twai_read_alerts(&alerts, portMAX_DELAY);
+    if (err != ESP_OK) {
+      if (err != ESP_ERR_TIMEOUT) configured = false;
+      continue;
+    }
+
+    uint32_t bits = 0;
+    if (alerts & (TWAI_ALERT_RX_DATA | TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_RX_FIFO_OVERRUN)) {
+      bits |= CAN_NOTIFY_RX;
+    }
+    if (alerts & (TWAI_ALERT_TX_SUCCESS | TWAI_ALERT_TX_IDLE | TWAI_ALERT_TX_FAILED)) {
+      bits |= CAN_NOTIFY_TX_DONE;
+    }
+    if (bits && g_taskCanHandle) {
+      xTaskNotify(g_taskCanHandle, bits, eSetBits);
+    }
   }
 }
 
 void taskUart(void *pvParameters) {
-  uint32_t lastTxMs = 0;
   String rxBuf;
+  static char txBuf[STATUS_JSON_MAX_LEN];  // 상태 송신 버퍼 (태스크 전용, JSON/프레임 공용)
+  static FrameDecoder rxFrames;            // 바이너리 모드 수신 디코더
+  frameDecoderInit(rxFrames);
+  LinkMode rxMode = g_linkMode;
 
   for (;;) {
+    profileLoopBegin(PROF_TASK_UART);
     uint32_t now = millis();
 
-    // 200ms 주기 상태 전송
-    if (now - lastTxMs >= PERIOD_UART_TX_MS) {
-      lastTxMs = now;
-      String json = buildStatusJson();
-      Serial2.println(json);
+    // 바이너리 모드에서 서버가 끊기면 디버그가 가능한 텍스트 모드로 복귀
+    if (g_linkMode == LINK_MODE_BINARY && !g_state.serverConnected) {
+      setLinkMode(LINK_MODE_TEXT);
+    }
+
+    // 모드가 바뀌면 이전 모드에서 받다 만 데이터는 버림
+    if (rxMode != g_linkMode) {
+      rxMode = g_linkMode;
+      rxBuf = "";
+      frameDecoderInit(rxFrames);
+    }
+
+    // 상태 전송 (전체: 200ms 주기 / 델타: 바뀐 필드만 즉시)
+    size_t txLen = buildTelemetryUpdate((uint8_t *)txBuf, sizeof(txBuf), now);
+    if (txLen > 0) {
+      Serial2.write((const uint8_t *)txBuf, txLen);
+    }
+
+    // 서버가 요청한 로그 내보내기 (한 바퀴에 조금씩)
+    for (size_t i = 0; i < LOG_EXPORT_BATCH; ++i) {
+      size_t logLen = buildLogExport((uint8_t *)txBuf, sizeof(txBuf));
+      if (logLen == 0) break;
+      Serial2.write((const uint8_t *)txBuf, logLen);
+    }
+    for (size_t i = 0; i < FLASH_LOG_EXPORT_BATCH; ++i) {
+      size_t logLen = buildFlashLogExport((uint8_t *)txBuf, sizeof(txBuf));
+      if (logLen == 0) break;
+      Serial2.write((const uint8_t *)txBuf, logLen);
+    }
+    for (size_t i = 0; i < HISTORY_EXPORT_BATCH; ++i) {
+      size_t histLen = buildHistoryExport((uint8_t *)txBuf, sizeof(txBuf));
+      if (histLen == 0) break;
+      Serial2.write((const uint8_t *)txBuf, histLen);
+    }
+    for (size_t i = 0; i < PROFILE_EXPORT_BATCH; ++i) {
+      size_t profLen = buildProfileExport((uint8_t *)txBuf, sizeof(txBuf));
+      if (profLen == 0) break;
+      Serial2.write((const uint8_t *)txBuf, profLen);
+    }
+    for (size_t i = 0; i < TRACE_EXPORT_BATCH; ++i) {
+      size_t traceLen = buildTraceExport((uint8_t *)txBuf, sizeof(txBuf));
+      if (traceLen == 0) break;
+      Serial2.write((const uint8_t *)txBuf, traceLen);
+    }
+    for (size_t i = 0; i < CAN_CMD_EXPORT_BATCH; ++i) {
+      size_t statsLen = buildCanCmdStatsExport((uint8_t *)txBuf, sizeof(txBuf));
+      if (statsLen == 0) break;
+      Serial2.write((const uint8_t *)txBuf, statsLen);
     }
 
     // Rx 수신 및 파싱
     while (Serial2.available()) {
       char c = Serial2.read();
+      if (g_linkMode == LINK_MODE_BINARY) {
+        Frame frame;
+        if (frameDecoderPush(rxFrames, (uint8_t)c, frame) == 1) {
+          handleServerFrame(frame);
+        }
+        continue;
+      }
       if (c == '\n' || c == '\r') {
         if (rxBuf.length() > 0) {
           parseServerLine(rxBuf);
@@ -81,29 +254,53 @@ void taskUart(void *pvParameters) {
     if (g_serverCmdQueue) {
       ServerCommand cmd;
       if (xQueueReceive(g_serverCmdQueue, &cmd, 0) == pdTRUE) {
+        traceStamp(cmd.traceId, TRACE_STAGE_DISPATCH);
         handleServerCommand(cmd);
       }
     }
 
+    profileLoopEnd(PROF_TASK_UART);
     vTaskDelay(pdMS_TO_TICKS(10));
   }
 }
 
 void taskUi(void *pvParameters) {
-  uint32_t lastUpdateMs   = 0;
+  uint32_t lastFullCheckMs = 0;
+  uint32_t lastFrameMs     = 0;
+  uint32_t pendingChanges  = STATE_CHG_ALL;  // 다음 프레임에 반영할 STATE_CHG_* 비트
+  uint32_t pendingInputUs  = 0;              // 아직 그리지 않은 가장 이른 입력 시각 (지연 측정용)
   int16_t  lastScreenIndex = (int16_t)g_currentScreen;
 
   for (;;) {
+    // 상태 변경, 입력 ISR, 렌더 조각 버퍼 반환 알림 중 하나가 올 때까지 잠듭니다.
+    // 보류 중인 변경이 프레임 간격 제한에 걸려 있으면 그 시각에 맞춰 깨어납니다.
+    uint32_t nowMs = millis();
+    uint32_t sinceCheck = nowMs - lastFullCheckMs;
+    uint32_t waitMs = sinceCheck >= PERIOD_UI_UPDATE_MS ? 0 : PERIOD_UI_UPDATE_MS - sinceCheck;
+    if (pendingChanges) {
+      uint32_t sinceFrame = nowMs - lastFrameMs;
+      uint32_t untilFrame = sinceFrame >= UI_MIN_FRAME_MS ? 0 : UI_MIN_FRAME_MS - sinceFrame;
+      if (untilFrame < waitMs) waitMs = untilFrame;
+    }
+    uint32_t changed = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &changed, pdMS_TO_TICKS(waitMs));
+    profileLoopBegin(PROF_TASK_UI);
+    pendingChanges |= changed & STATE_CHG_ALL;
+
     uint32_t now = millis();
 
-    // 로터리 읽기
-    updateRotary();
+    // ISR이 쌓은 회전/버튼 이벤트 반영
+    uint32_t inputUs = updateRotary();
+    if (inputUs && !pendingInputUs) pendingInputUs = inputUs;
 
-    // 로터리 회전량으로 화면 전환 (한 스텝당 화면 1칸 이동)
+    // 로터리 회전량으로 화면 전환 (한 스텝당 화면 1칸 이동). 값 입력 중인 화면이면 그쪽으로
     int16_t pos  = g_encoderPos;
     int16_t diff = pos - g_lastScreenEncPos;
 
-    if (diff >= 1) {
+    if (diff != 0 && g_currentScreen == SCREEN_GROW && handleGrowTurn(diff)) {
+      g_lastScreenEncPos = pos;
+
+    } else if (diff >= 1) {
       g_lastScreenEncPos = pos;
       int16_t idx = (int16_t)g_currentScreen + 1;
       if (idx >= SCREEN_COUNT) idx = 0;
@@ -136,114 +333,156 @@ void taskUi(void *pvParameters) {
         case SCREEN_LOG:
           handleLogClick(shortClick, longClick);
           break;
+        case SCREEN_TREND_TEMP:
+        case SCREEN_TREND_PH:
+        case SCREEN_TREND_DO:
+          handleTrendClick(shortClick, longClick);
+          break;
+        case SCREEN_DIAG:
+          handleDiagClick(shortClick, longClick);
+          break;
         default:
-          logEvent("Button clicked (no special action)");
+          logEvent(LOG_BUTTON_NO_ACTION);
           break;
       }
+      // 클릭 핸들러가 바꾼 값은 각자 알린 상태 변경 비트로 다음 프레임에 그려집니다.
+    }
 
-      // 버튼 눌린 직후, 바로 화면 다시 그림
-      lastUpdateMs    = now;
+    // 화면 전환: 새 화면 전체를 그림
+    if (lastScreenIndex != (int16_t)g_currentScreen) {
       lastScreenIndex = (int16_t)g_currentScreen;
-      drawCurrentScreen();
+      pendingChanges |= STATE_CHG_ALL;
     }
 
-    // UI 갱신
-    if (now - lastUpdateMs >= PERIOD_UI_UPDATE_MS ||
-        lastScreenIndex != (int16_t)g_currentScreen) {
-      lastUpdateMs    = now;
-      lastScreenIndex = (int16_t)g_currentScreen;
-      drawCurrentScreen();
+    // 알림이 빠졌을 경우를 대비한 안전 갱신 (값이 같은 칸은 다시 그리지 않음)
+    if (now - lastFullCheckMs >= PERIOD_UI_UPDATE_MS) {
+      lastFullCheckMs = now;
+      pendingChanges |= STATE_CHG_ALL;
     }
 
-    vTaskDelay(pdMS_TO_TICKS(20));
+    // UI 갱신: 바뀐 값 칸만, 최대 1000 / UI_MIN_FRAME_MS fps
+    if (pendingChanges && now - lastFrameMs >= UI_MIN_FRAME_MS) {
+      lastFrameMs = now;
+      uint32_t frameChanges = pendingChanges;
+      pendingChanges = 0;
+      uiRefresh(frameChanges, pendingInputUs);
+      pendingInputUs = 0;
+    } else if (changed & UI_NOTIFY_RENDER) {
+      // 조각 버퍼가 모자라 남겨 둔 부분을 이어 그림 (같은 프레임)
+      uiFlush();
+    }
+    profileLoopEnd(PROF_TASK_UI);
   }
 }
 
 
+void taskRender(void *pvParameters) {
+  for (;;) {
+    renderService();
+  }
+}
+
 void taskLogic(void *pvParameters) {
   for (;;) {
+    profileLoopBegin(PROF_TASK_LOGIC);
     uint32_t now = millis();
 
-    // ===== 간단 소프트웨어 시계 (부팅 기준) =====
+    // ===== 소프트웨어 시계 (부팅 후 초 + 서버가 맞춘 현지 시각 보정) =====
+    bool clockTicked = false;
     if (now - g_lastClockUpdateMs >= 1000) {  // 1초마다
-      g_lastClockUpdateMs = now;
+      // 기준 시각을 1초씩 올려 루프 주기(100ms)만큼 늦게 봐도 시계가 밀리지 않게 함
+      g_lastClockUpdateMs += 1000;
       g_uptimeSeconds++;
+      clockTicked = true;
 
-      g_timeMinute = (g_uptimeSeconds / 60)   % 60; // 0~59
-      g_timeHour   = (g_uptimeSeconds / 3600) % 24; // 0~23
+      uint32_t local = scheduleLocalTime();
+      g_timeMinute = (local / 60)   % 60; // 0~59
+      g_timeHour   = (local / 3600) % 24; // 0~23
     }
 
-    if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+    // 상태 판정은 g_state에 직접 반영해야 하므로 쓰기 구간에서 한 번에 처리하고,
+    // CAN 전송/로그/GPIO처럼 블로킹될 수 있는 작업은 구간 밖에서 복사본으로 수행합니다.
+    SystemState st;
+    uint32_t changed = 0;
+    uint32_t published = stateTakeChanges();  // 지난 주기 이후 다른 태스크가 알린 변경 (CAN 수신 등)
+    stateWriteBegin();
+    {
       // 서버 연결 상태 (Fail-safe 판단)
-      bool connected = (now - g_state.lastServerRxMs) < SERVER_TIMEOUT_MS;
-      g_state.serverConnected = connected;
+      bool serverConnected = (now - g_state.lastServerRxMs) < SERVER_TIMEOUT_MS;
+      if (serverConnected != g_state.serverConnected) changed |= STATE_CHG_SYSTEM;
+      g_state.serverConnected = serverConnected;
 
       // 모듈 Offline 검사 (1000ms 이상 업데이트 없으면 OFFLINE)
-      if (now - g_state.tank.lastUpdateMs     > 1000) g_state.tank.status     = MODULE_OFFLINE;
-      if (now - g_state.grow.lastUpdateMs     > 1000) g_state.grow.status     = MODULE_OFFLINE;
-      if (now - g_state.nutrient.lastUpdateMs > 1000) g_state.nutrient.status = MODULE_OFFLINE;
-      if (now - g_state.feeder.lastUpdateMs   > 1000) g_state.feeder.status   = MODULE_OFFLINE;
+      if (now - g_state.tank.lastUpdateMs > 1000 && g_state.tank.status != MODULE_OFFLINE) {
+        g_state.tank.status = MODULE_OFFLINE;
+        changed |= STATE_CHG_TANK;
+      }
+      if (now - g_state.grow.lastUpdateMs > 1000 && g_state.grow.status != MODULE_OFFLINE) {
+        g_state.grow.status = MODULE_OFFLINE;
+        changed |= STATE_CHG_GROW;
+      }
+      if (now - g_state.nutrient.lastUpdateMs > 1000 && g_state.nutrient.status != MODULE_OFFLINE) {
+        g_state.nutrient.status = MODULE_OFFLINE;
+        changed |= STATE_CHG_NUTRIENT;
+      }
+      if (now - g_state.feeder.lastUpdateMs > 1000 && g_state.feeder.status != MODULE_OFFLINE) {
+        g_state.feeder.status = MODULE_OFFLINE;
+        changed |= STATE_CHG_FEEDER;
+      }
 
       // 경고/오류 플래그 (예시: 누수 감지 → ERROR)
       bool hasLeak = ( g_state.grow.leak[0] || g_state.grow.leak[1]
                     || g_state.grow.leak[2] || g_state.grow.leak[3] );
-      g_state.hasError = hasLeak;
 
       bool anyOffline = (g_state.tank.status     == MODULE_OFFLINE ||
                          g_state.grow.status     == MODULE_OFFLINE ||
                          g_state.nutrient.status == MODULE_OFFLINE ||
                          g_state.feeder.status   == MODULE_OFFLINE);
-      g_state.hasWarning = anyOffline && !g_state.hasError;
-
-      // Fail-safe: 서버 미연결 시 급여 스케줄 로컬 실행
-      if (!connected) {
-        int currentMinuteOfDay = (int)g_timeHour * 60 + (int)g_timeMinute;
-        int schedMinuteOfDay   = (int)g_settings.feederHour * 60 +
-                                 (int)g_settings.feederMinute;
-
-        if (currentMinuteOfDay == schedMinuteOfDay &&
-            g_lastFeederScheduleMinute != currentMinuteOfDay) {
-
-          uint8_t amt = g_settings.feederAmountPercent;
-          if (amt > 0) {
-            xSemaphoreGive(g_stateMutex);  // CAN 명령 보내는 동안 잠깐 풀고
-            requestFeederOnce(amt);
-            g_lastFeederScheduleMinute = currentMinuteOfDay;
-            logEvent("Fail-safe feeder schedule triggered");
-
-            if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-              vTaskDelay(pdMS_TO_TICKS(100));
-              continue;
-            }
-          }
-        }
-      } else {
-        // 서버가 다시 연결되면 스케줄 플래그 리셋
-        g_lastFeederScheduleMinute = -1;
-      }
+      bool hasWarning = anyOffline && !hasLeak;
 
-      // AlarmLevel 업데이트
-      if (g_state.hasError) {
-        g_alarmLevel = ALARM_ERROR;
-      } else if (g_state.hasWarning) {
-        g_alarmLevel = ALARM_WARNING;
-      } else {
-        g_alarmLevel = ALARM_NONE;
-      }
+      if (hasLeak != g_state.hasError || hasWarning != g_state.hasWarning) changed |= STATE_CHG_SYSTEM;
+      g_state.hasError   = hasLeak;
+      g_state.hasWarning = hasWarning;
+
+      memcpy(&st, &g_state, sizeof(st));
+    }
+    stateWriteEnd();
+    statePublishChanges(changed);
+
+    // 센서 이력: 1초마다 채널 값 하나씩 (오프라인 모듈은 빈 칸)
+    if (clockTicked) historySample(g_uptimeSeconds, st);
+
+    // 예약 실행: 설정 화면의 Fail-safe 급여(서버 미연결 시) + 서버가 넣은 예약 항목
+    scheduleSyncSettings();
+    if (clockTicked) scheduleTick(st.serverConnected);
 
-      xSemaphoreGive(g_stateMutex);
+    // 자동 규칙: 지난 주기 이후 바뀐 모듈의 채널만 평가
+    rulesEvaluate(st, changed | published);
+
+    // AlarmLevel 업데이트 (바뀔 때만 taskAlarm을 깨움)
+    AlarmLevel level = st.hasError ? ALARM_ERROR : st.hasWarning ? ALARM_WARNING : ALARM_NONE;
+    if (level != g_alarmLevel) {
+      g_alarmLevel = level;
+      if (g_taskAlarmHandle) xTaskNotifyGive(g_taskAlarmHandle);
     }
 
-    // LED 상태 표시 (mutex 없이 읽어도 무방한 수준)
-    bool allOk = (g_state.tank.status     == MODULE_OK &&
-                  g_state.grow.status     == MODULE_OK &&
-                  g_state.nutrient.status == MODULE_OK &&
-                  g_state.feeder.status   == MODULE_OK);
+    // LED 상태 표시 (부팅 패턴이 LED를 쓰는 동안에는 끝난 뒤 반영)
+    bool allOk = (st.tank.status     == MODULE_OK &&
+                  st.grow.status     == MODULE_OK &&
+                  st.nutrient.status == MODULE_OK &&
+                  st.feeder.status   == MODULE_OK);
+
+    indicatorSetBase((st.serverConnected ? IND_OUT_BLUE : 0) |
+                     (allOk ? IND_OUT_GREEN : 0) |
+                     ((st.hasWarning || st.hasError) ? IND_OUT_RED : 0));
 
-    digitalWrite(PIN_LED_BLUE,  g_state.serverConnected ? HIGH : LOW);
-    digitalWrite(PIN_LED_GREEN, allOk ? HIGH : LOW);
-    digitalWrite(PIN_LED_RED,   (g_state.hasWarning || g_state.hasError) ? HIGH : LOW);
+    // 새 로그 레코드를 문구로 만들어 시리얼 콘솔로 출력 (기록하는 쪽은 Serial을 기다리지 않음)
+    logConsolePump(LOG_CONSOLE_BATCH);
 
+    // 태스크 프로파일: 지난 1초의 CPU 점유와 스택 여유 (진단 화면 갱신)
+    if (clockTicked) profileService();
+
+    profileLoopEnd(PROF_TASK_LOGIC);
     vTaskDelay(pdMS_TO_TICKS(100));
   }
 }
@@ -251,46 +490,40 @@ void taskLogic(void *pvParameters) {
 
 
 void taskAlarm(void *pvParameters) {
-  uint32_t lastToggleMs = 0;
-  bool buzOn = false;
+  AlarmLevel playing = ALARM_NONE;
 
   for (;;) {
-    uint32_t now = millis();
-    uint32_t onMs = 0;
-    uint32_t offMs = 0;
-
-    if (g_alarmLevel == ALARM_WARNING) {
-      // 경고: 500ms ON, 500ms OFF 반복
-      onMs  = 500;
-      offMs = 500;
-    } else if (g_alarmLevel == ALARM_ERROR) {
-      // 오류/누수: 1000ms ON, 500ms OFF 반복
-      onMs  = 1000;
-      offMs = 500;
-    } else {
-      // 알람 없음
-      digitalWrite(PIN_BUZZER, LOW);
-      buzOn = false;
-      vTaskDelay(pdMS_TO_TICKS(50));
-      continue;
-    }
-
-    if (!buzOn) {
-      // OFF → ON 전환
-      digitalWrite(PIN_BUZZER, HIGH);
-      buzOn = true;
-      lastToggleMs = now;
-    } else {
-      // ON 상태에서 onMs 지나면 OFF, offMs 지나면 다시 ON
-      uint32_t diff = now - lastToggleMs;
-      if ((g_alarmLevel == ALARM_WARNING && diff >= onMs) ||
-          (g_alarmLevel == ALARM_ERROR   && diff >= onMs)) {
-        digitalWrite(PIN_BUZZER, LOW);
-        buzOn = false;
-        lastToggleMs = now;
+    profileLoopBegin(PROF_TASK_ALARM);
+    AlarmLevel level = g_alarmLevel;
+    if (level != playing) {
+      if (playing == ALARM_WARNING) indicatorStop(IND_PATTERN_ALARM_WARNING);
+      if (playing == ALARM_ERROR)   indicatorStop(IND_PATTERN_ALARM_ERROR);
+
+      if (level == ALARM_WARNING) {
+        // 경고: 500ms ON, 500ms OFF 반복
+        indicatorPlay(IND_PATTERN_ALARM_WARNING);
+      } else if (level == ALARM_ERROR) {
+        // 오류/누수: 1000ms ON, 500ms OFF 반복
+        indicatorPlay(IND_PATTERN_ALARM_ERROR);
       }
+      playing = level;
     }
 
-    vTaskDelay(pdMS_TO_TICKS(50));
+    // 알람 수준이 바뀔 때만 깸 (taskLogic이 알림). 켬/끔 단계는 Indicator 타이머가 넘김
+    profileLoopEnd(PROF_TASK_ALARM);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+}
+
+void taskFlashLog(void *pvParameters) {
+  for (;;) {
+    // 새 레코드가 쌓였다는 알림(EventLog) 또는 FLASH_LOG_FLUSH_MS를 기다렸다가 모아 씀
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLASH_LOG_FLUSH_MS));
+    profileLoopBegin(PROF_TASK_FLASH_LOG);
+    flashLogFlush();
+    settingsService();
+    scheduleService();
+    rulesService();
+    profileLoopEnd(PROF_TASK_FLASH_LOG);
   }
 }
@@ -6,6 +6,7 @@
  * @brief FreeRTOS 태스크 함수들의 선언을 포함합니다.
  * 
  * 이 함수들의 실제 구현은 Tasks.cpp 파일에 있습니다.
+ * 각 태스크 루프는 깨어난 뒤 ~ 다시 잠들기 전을 profileLoopBegin/End로 감쌉니다. (Profile.h)
  */
 
 /**
@@ -13,6 +14,14 @@
  */
 void taskCan(void *pvParameters);
 
+/**
+ * @brief TWAI 경고(alert)를 기다렸다가 taskCan에 알림 비트로 전달하는 태스크
+ *
+ * twai_read_alerts()와 태스크 알림을 한 번에 기다릴 수 없으므로, 경고 대기는
+ * 이 태스크가 맡고 taskCan은 알림 하나만 기다립니다.
+ */
+void taskCanAlert(void *pvParameters);
+
 /**
  * @brief UART 통신(서버와 데이터 교환)을 처리하는 태스크
  */
@@ -20,18 +29,41 @@ void taskUart(void *pvParameters);
 
 /**
  * @brief 사용자 입력(로터리 엔코더)을 처리하고 UI를 갱신하는 태스크
+ *
+ * 상태를 쓰는 쪽이 statePublishChanges()로 보낸 STATE_CHG_* 알림을 기다렸다가
+ * 현재 화면에서 바뀐 값 칸만 다시 그립니다. (최소 간격 UI_MIN_FRAME_MS)
+ * 입력은 폴링하지 않고, 엔코더/버튼 ISR의 UI_NOTIFY_INPUT 알림으로 깨어나 처리합니다.
  */
 void taskUi(void *pvParameters);
 
+/**
+ * @brief taskUi가 준비한 화면 조각을 DMA로 패널에 보내는 태스크
+ *
+ * 한 조각이 전송되는 동안 taskUi는 다음 조각을 그릴 수 있습니다. (Render.h)
+ */
+void taskRender(void *pvParameters);
+
 /**
  * @brief 시스템의 주요 로직(상태 점검, Fail-safe 등)을 처리하는 태스크
  */
 void taskLogic(void *pvParameters);
 
 /**
- * @brief 경고/오류 상태에 따라 부저를 울리는 태스크
+ * @brief 경고/오류 상태에 따라 부저 경보 패턴을 켜고 끄는 태스크
+ *
+ * 알람 수준이 바뀌어 taskLogic이 알릴 때만 깹니다. 울리는 동안의 켬/끔은 Indicator가 합니다.
  */
 void taskAlarm(void *pvParameters);
 
+/**
+ * @brief 새 로그 레코드를 모아 플래시 보관 로그에 쓰는 태스크 (낮은 우선순위)
+ *
+ * 플래시 지우기/쓰기 동안 멈추는 것은 이 태스크뿐이며, logEvent()를 부르는 태스크는 기다리지 않습니다.
+ * 설정 블롭 저장(settingsService)도 여기서 하므로 saveSettings() 후 실제 NVS 쓰기는
+ * 마지막 변경에서 SETTINGS_SAVE_DELAY_MS ~ SETTINGS_SAVE_DELAY_MS + FLASH_LOG_FLUSH_MS 뒤입니다.
+ * 서버가 바꾼 예약 항목(scheduleService)과 자동 규칙(rulesService)도 같은 방식으로 여기서 저장합니다.
+ */
+void taskFlashLog(void *pvParameters);
+
 
 #endif // TASKS_H
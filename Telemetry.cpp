@@ -0,0 +1,429 @@
+#include "Globals.h"
+#include "Telemetry.h"
+
+/**
+ * @file Telemetry.cpp
+ * @brief 상태 텔레메트리 인코더의 실제 구현을 포함합니다.
+ */
+
+
+//==============================================================================
+// 고정 버퍼 텍스트 기록기 구현
+//==============================================================================
+
+void twInit(TextWriter &w, char *buf, size_t cap) {
+  w.buf = buf;
+  w.cap = cap;
+  w.len = 0;
+  w.overflow = (cap == 0);
+  if (cap) buf[0] = '\0';
+}
+
+void twChar(TextWriter &w, char c) {
+  if (w.overflow) return;
+  if (w.len + 1 >= w.cap) {
+    w.overflow = true;
+    return;
+  }
+  w.buf[w.len++] = c;
+  w.buf[w.len] = '\0';
+}
+
+void twStr(TextWriter &w, const char *s) {
+  while (*s && !w.overflow) twChar(w, *s++);
+}
+
+void twUInt(TextWriter &w, uint32_t v) {
+  char tmp[10];
+  int n = 0;
+  do {
+    tmp[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  while (n) twChar(w, tmp[--n]);
+}
+
+void twInt(TextWriter &w, int32_t v) {
+  if (v < 0) {
+    twChar(w, '-');
+    twUInt(w, (uint32_t)(-(v + 1)) + 1u);
+  } else {
+    twUInt(w, (uint32_t)v);
+  }
+}
+
+void twFixed(TextWriter &w, float v, uint8_t decimals) {
+  if (isnan(v) || isinf(v)) {
+    twStr(w, "null");
+    return;
+  }
+  if (decimals > 4) decimals = 4;
+
+  static const uint32_t kPow10[] = {1, 10, 100, 1000, 10000};
+  uint32_t scale = kPow10[decimals];
+
+  bool neg = v < 0;
+  float a = neg ? -v : v;
+  // 센서 값 범위를 넘는 값은 uint32 변환이 넘치지 않도록 잘라냅니다.
+  float maxAbs = 4000000000.0f / (float)scale;
+  if (a > maxAbs) a = maxAbs;
+
+  uint32_t scaled = (uint32_t)(a * (float)scale + 0.5f);
+  if (neg && scaled) twChar(w, '-');
+  twUInt(w, scaled / scale);
+  if (decimals) {
+    twChar(w, '.');
+    uint32_t frac = scaled % scale;
+    for (uint32_t p = scale / 10; p > 0; p /= 10) {
+      twChar(w, (char)('0' + (frac / p) % 10));
+    }
+  }
+}
+
+
+//==============================================================================
+// 상태 텔레메트리 인코더 구현
+//==============================================================================
+
+namespace {
+
+// bool 배열을 비트마스크로 묶습니다. (bit i = 채널 i)
+uint32_t packBits(const bool *bits, int count) {
+  uint32_t mask = 0;
+  for (int i = 0; i < count; ++i) {
+    if (bits[i]) mask |= (1u << i);
+  }
+  return mask;
+}
+
+// 스케일을 곱해 정수로 반올림하고 대상 타입 범위로 포화시킵니다.
+int32_t scaleClamp(float v, float scale, int32_t lo, int32_t hi) {
+  if (isnan(v)) return 0;
+  float s = v * scale;
+  if (s <= (float)lo) return lo;
+  if (s >= (float)hi) return hi;
+  return (int32_t)(s < 0 ? s - 0.5f : s + 0.5f);
+}
+
+uint8_t *putU16(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)((v >> 8) & 0xFF);
+  return p + 2;
+}
+
+uint8_t *putU32(uint8_t *p, uint32_t v) {
+  p = putU16(p, v & 0xFFFF);
+  return putU16(p, v >> 16);
+}
+
+uint8_t *putI16Scaled(uint8_t *p, float v, float scale) {
+  return putU16(p, (uint16_t)(int16_t)scaleClamp(v, scale, -32768, 32767));
+}
+
+uint8_t *putU16Scaled(uint8_t *p, float v, float scale) {
+  return putU16(p, (uint16_t)scaleClamp(v, scale, 0, 65535));
+}
+
+// 부호 있는 정수를 zigzag 변환 후 LEB128 varint로 기록합니다. (작은 값일수록 짧음)
+uint8_t *putVarint(uint8_t *p, const uint8_t *end, int32_t v) {
+  uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+  do {
+    if (p >= end) return nullptr;
+    uint8_t b = (uint8_t)(z & 0x7F);
+    z >>= 7;
+    *p++ = z ? (uint8_t)(b | 0x80) : b;
+  } while (z);
+  return p;
+}
+
+
+//------------------------------------------------------------------------------
+// 텔레메트리 필드 표
+//------------------------------------------------------------------------------
+
+enum FieldType : uint8_t {
+  FT_U8,      // uint8_t / uint8_t 기반 enum
+  FT_BOOL,    // bool (JSON 0/1)
+  FT_U32,     // uint32_t
+  FT_F32,     // float (decimals 자리 고정소수점)
+  FT_BOOL4,   // bool[4] → 비트마스크
+  FT_F32X4,   // float[4] → JSON 배열
+};
+
+/**
+ * @brief 텔레메트리 필드 하나의 기술자
+ *  - group    : JSON 상위 객체 키 (nullptr이면 최상위)
+ *  - deadband : 마지막 전송값 대비 이 값을 '초과'해 변해야 델타로 보냄 (0: 변하면 보냄)
+ *  - binScale : 바이너리 델타에서 정수로 바꿀 때 곱하는 값
+ */
+struct FieldDesc {
+  const char *group;
+  const char *key;
+  uint16_t    offset;
+  uint8_t     type;
+  uint8_t     decimals;
+  float       deadband;
+  float       binScale;
+};
+
+#define TF_AT(member) (uint16_t)offsetof(SystemState, member)
+
+// 순서가 곧 TelemetryField ID이며 JSON 출력 순서입니다. (Telemetry.h와 일치해야 함)
+const FieldDesc kFields[TF_COUNT] = {
+  { "tank", "st",    TF_AT(tank.status),              FT_U8,    0, 0.0f,  1.0f   },
+  { "tank", "temp",  TF_AT(tank.tempC),               FT_F32,   1, 0.1f,  10.0f  },
+  { "tank", "lvl",   TF_AT(tank.levelPercent),        FT_F32,   1, 0.5f,  10.0f  },
+  { "tank", "pH",    TF_AT(tank.pH),                  FT_F32,   2, 0.02f, 100.0f },
+  { "tank", "tds",   TF_AT(tank.tds),                 FT_F32,   0, 5.0f,  1.0f   },
+  { "tank", "turb",  TF_AT(tank.turbidity),           FT_F32,   1, 0.5f,  10.0f  },
+  { "tank", "do",    TF_AT(tank.do_mgL),              FT_F32,   1, 0.05f, 100.0f },
+  { "tank", "pump",  TF_AT(tank.pumpOn),              FT_BOOL,  0, 0.0f,  1.0f   },
+  { "tank", "light", TF_AT(tank.lightOn),             FT_BOOL,  0, 0.0f,  1.0f   },
+  { "grow", "st",    TF_AT(grow.status),              FT_U8,    0, 0.0f,  1.0f   },
+  { "grow", "temp",  TF_AT(grow.tempC),               FT_F32,   1, 0.1f,  10.0f  },
+  { "grow", "hum",   TF_AT(grow.humidity),            FT_F32,   1, 0.5f,  10.0f  },
+  { "grow", "leak",  TF_AT(grow.leak),                FT_BOOL4, 0, 0.0f,  1.0f   },
+  { "grow", "led",   TF_AT(grow.ledBrightness),       FT_U8,    0, 0.0f,  1.0f   },
+  { "nutr", "st",    TF_AT(nutrient.status),          FT_U8,    0, 0.0f,  1.0f   },
+  { "nutr", "lvl",   TF_AT(nutrient.levelPercent),    FT_F32,   1, 0.5f,  10.0f  },
+  { "nutr", "ratio", TF_AT(nutrient.channelRatio),    FT_F32X4, 1, 0.5f,  10.0f  },
+  { "nutr", "motor", TF_AT(nutrient.channelMotorOn),  FT_BOOL4, 0, 0.0f,  1.0f   },
+  { "feed", "st",    TF_AT(feeder.status),            FT_U8,    0, 0.0f,  1.0f   },
+  { "feed", "lvl",   TF_AT(feeder.feedLevelPercent),  FT_F32,   1, 0.5f,  10.0f  },
+  { "feed", "last",  TF_AT(feeder.lastFeedTime),      FT_U32,   0, 0.0f,  1.0f   },
+  { "feed", "busy",  TF_AT(feeder.feedingNow),        FT_BOOL,  0, 0.0f,  1.0f   },
+  { nullptr, "srv",  TF_AT(serverConnected),          FT_BOOL,  0, 0.0f,  1.0f   },
+  { nullptr, "warn", TF_AT(hasWarning),               FT_BOOL,  0, 0.0f,  1.0f   },
+  { nullptr, "err",  TF_AT(hasError),                 FT_BOOL,  0, 0.0f,  1.0f   },
+};
+
+#undef TF_AT
+
+const uint8_t *fieldPtr(const SystemState &st, const FieldDesc &f) {
+  return (const uint8_t *)&st + f.offset;
+}
+
+size_t fieldSize(const FieldDesc &f) {
+  switch (f.type) {
+    case FT_U8:
+    case FT_BOOL:  return 1;
+    case FT_U32:
+    case FT_F32:   return 4;
+    case FT_BOOL4: return 4 * sizeof(bool);
+    case FT_F32X4: return 4 * sizeof(float);
+    default:       return 0;
+  }
+}
+
+// 스칼라 필드 값을 실수로 읽습니다. (FT_BOOL4는 비트마스크 값)
+float fieldScalar(const SystemState &st, const FieldDesc &f) {
+  const uint8_t *p = fieldPtr(st, f);
+  switch (f.type) {
+    case FT_U8:    return (float)*p;
+    case FT_BOOL:  return *(const bool *)p ? 1.0f : 0.0f;
+    case FT_U32:   return (float)*(const uint32_t *)p;
+    case FT_F32:   return *(const float *)p;
+    case FT_BOOL4: return (float)packBits((const bool *)p, 4);
+    default:       return 0.0f;
+  }
+}
+
+// 실수 비교: NaN ↔ 숫자 전환도 변화로 봅니다.
+bool exceedsDeadband(float now, float last, float deadband) {
+  if (isnan(now) || isnan(last)) return isnan(now) != isnan(last);
+  float d = now - last;
+  if (d < 0) d = -d;
+  return deadband > 0 ? d > deadband : d != 0.0f;
+}
+
+bool fieldChanged(const SystemState &st, const SystemState &last, const FieldDesc &f) {
+  if (f.type == FT_U32) {
+    return *(const uint32_t *)fieldPtr(st, f) != *(const uint32_t *)fieldPtr(last, f);
+  }
+  if (f.type == FT_F32X4) {
+    const float *a = (const float *)fieldPtr(st, f);
+    const float *b = (const float *)fieldPtr(last, f);
+    for (int i = 0; i < 4; ++i) {
+      if (exceedsDeadband(a[i], b[i], f.deadband)) return true;
+    }
+    return false;
+  }
+  return exceedsDeadband(fieldScalar(st, f), fieldScalar(last, f), f.deadband);
+}
+
+void writeFieldValue(TextWriter &w, const SystemState &st, const FieldDesc &f) {
+  const uint8_t *p = fieldPtr(st, f);
+  switch (f.type) {
+    case FT_U8:    twUInt(w, *p); break;
+    case FT_BOOL:  twUInt(w, *(const bool *)p ? 1 : 0); break;
+    case FT_U32:   twUInt(w, *(const uint32_t *)p); break;
+    case FT_F32:   twFixed(w, *(const float *)p, f.decimals); break;
+    case FT_BOOL4: twUInt(w, packBits((const bool *)p, 4)); break;
+    case FT_F32X4: {
+      const float *v = (const float *)p;
+      twChar(w, '[');
+      for (int i = 0; i < 4; ++i) {
+        if (i) twChar(w, ',');
+        twFixed(w, v[i], f.decimals);
+      }
+      twChar(w, ']');
+      break;
+    }
+    default: break;
+  }
+}
+
+/**
+ * @brief mask에 포함된 필드만 JSON으로 기록합니다.
+ * @param keyframeTag 0/1이면 선두에 "kf" 키를 붙이고, 음수면 생략 (기존 전체 형식)
+ */
+size_t encodeFieldsJson(const SystemState &st, uint32_t mask, int keyframeTag,
+                        char *buf, size_t bufSize) {
+  TextWriter w;
+  twInit(w, buf, bufSize);
+  twChar(w, '{');
+
+  bool any = false;                 // 최상위에 이미 항목이 있는지
+  bool inGroupFirst = false;        // 현재 그룹의 첫 항목인지
+  const char *openGroup = nullptr;
+
+  if (keyframeTag >= 0) {
+    twStr(w, "\"kf\":");
+    twUInt(w, (uint32_t)keyframeTag);
+    any = true;
+  }
+
+  for (int i = 0; i < TF_COUNT; ++i) {
+    if (!(mask & (1u << i))) continue;
+    const FieldDesc &f = kFields[i];
+
+    if (f.group != openGroup) {
+      if (openGroup) twChar(w, '}');
+      openGroup = f.group;
+      if (openGroup) {
+        if (any) twChar(w, ',');
+        twChar(w, '"');
+        twStr(w, openGroup);
+        twStr(w, "\":{");
+        any = true;
+        inGroupFirst = true;
+      }
+    }
+
+    if (openGroup) {
+      if (!inGroupFirst) twChar(w, ',');
+      inGroupFirst = false;
+    } else {
+      if (any) twChar(w, ',');
+      any = true;
+    }
+    twChar(w, '"');
+    twStr(w, f.key);
+    twStr(w, "\":");
+    writeFieldValue(w, st, f);
+  }
+
+  if (openGroup) twChar(w, '}');
+  twChar(w, '}');
+  return w.overflow ? 0 : w.len;
+}
+
+} // namespace
+
+size_t encodeStatusJson(const SystemState &st, char *buf, size_t bufSize) {
+  return encodeFieldsJson(st, TF_ALL_MASK, -1, buf, bufSize);
+}
+
+uint32_t telemetryChangedFields(const SystemState &st, const SystemState &lastSent) {
+  uint32_t mask = 0;
+  for (int i = 0; i < TF_COUNT; ++i) {
+    if (fieldChanged(st, lastSent, kFields[i])) mask |= (1u << i);
+  }
+  return mask;
+}
+
+void telemetryMarkSent(SystemState &lastSent, const SystemState &st, uint32_t mask) {
+  for (int i = 0; i < TF_COUNT; ++i) {
+    if (!(mask & (1u << i))) continue;
+    const FieldDesc &f = kFields[i];
+    memcpy((uint8_t *)&lastSent + f.offset, fieldPtr(st, f), fieldSize(f));
+  }
+}
+
+size_t encodeStatusDeltaJson(const SystemState &st, uint32_t mask, bool keyframe,
+                             char *buf, size_t bufSize) {
+  return encodeFieldsJson(st, keyframe ? TF_ALL_MASK : mask, keyframe ? 1 : 0, buf, bufSize);
+}
+
+size_t encodeStatusDeltaRecord(const SystemState &st, uint32_t mask, uint32_t uptimeMs,
+                               uint8_t *buf, size_t bufSize) {
+  if (bufSize < 5) return 0;
+  const uint8_t *end = buf + bufSize;
+  uint8_t *p = putU32(buf, uptimeMs);
+  uint8_t *countAt = p++;
+  uint8_t count = 0;
+
+  for (int i = 0; i < TF_COUNT; ++i) {
+    if (!(mask & (1u << i))) continue;
+    const FieldDesc &f = kFields[i];
+    if (p >= end) return 0;
+    *p++ = (uint8_t)i;
+
+    if (f.type == FT_F32X4) {
+      const float *v = (const float *)fieldPtr(st, f);
+      for (int k = 0; k < 4 && p; ++k) {
+        p = putVarint(p, end, scaleClamp(v[k], f.binScale, INT32_MIN, INT32_MAX));
+      }
+    } else if (f.type == FT_U32) {
+      p = putVarint(p, end, (int32_t)*(const uint32_t *)fieldPtr(st, f));
+    } else {
+      p = putVarint(p, end, scaleClamp(fieldScalar(st, f), f.binScale, INT32_MIN, INT32_MAX));
+    }
+    if (!p) return 0;
+    count++;
+  }
+
+  *countAt = count;
+  return (size_t)(p - buf);
+}
+
+size_t encodeStatusRecord(const SystemState &st, uint32_t uptimeMs, uint8_t *buf, size_t bufSize) {
+  if (bufSize < TELEMETRY_RECORD_LEN) return 0;
+
+  uint8_t *p = buf;
+  p = putU32(p, uptimeMs);
+
+  *p++ = (uint8_t)(( st.tank.status     & 0x3)       |
+                   ((st.grow.status     & 0x3) << 2) |
+                   ((st.nutrient.status & 0x3) << 4) |
+                   ((st.feeder.status   & 0x3) << 6));
+  *p++ = (uint8_t)((st.serverConnected   ? 0x01 : 0) |
+                   (st.hasWarning        ? 0x02 : 0) |
+                   (st.hasError          ? 0x04 : 0) |
+                   (st.tank.pumpOn       ? 0x08 : 0) |
+                   (st.tank.lightOn      ? 0x10 : 0) |
+                   (st.feeder.feedingNow ? 0x20 : 0));
+
+  p = putI16Scaled(p, st.tank.tempC,        10.0f);
+  p = putU16Scaled(p, st.tank.levelPercent, 10.0f);
+  p = putU16Scaled(p, st.tank.pH,           100.0f);
+  p = putU16Scaled(p, st.tank.tds,          1.0f);
+  p = putU16Scaled(p, st.tank.turbidity,    10.0f);
+  p = putU16Scaled(p, st.tank.do_mgL,       100.0f);
+
+  p = putI16Scaled(p, st.grow.tempC,    10.0f);
+  p = putU16Scaled(p, st.grow.humidity, 10.0f);
+  *p++ = (uint8_t)packBits(st.grow.leak, 4);
+  *p++ = st.grow.ledBrightness;
+
+  p = putU16Scaled(p, st.nutrient.levelPercent, 10.0f);
+  for (int i = 0; i < 4; ++i) {
+    *p++ = (uint8_t)scaleClamp(st.nutrient.channelRatio[i], 1.0f, 0, 255);
+  }
+  *p++ = (uint8_t)packBits(st.nutrient.channelMotorOn, 4);
+
+  p = putU16Scaled(p, st.feeder.feedLevelPercent, 10.0f);
+  p = putU32(p, st.feeder.lastFeedTime);
+
+  return (size_t)(p - buf);
+}
@@ -0,0 +1,155 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+/**
+ * @file Telemetry.h
+ * @brief 서버로 보내는 상태 텔레메트리의 인코더를 선언합니다.
+ *
+ * 모든 인코더는 호출자가 넘긴 고정 크기 버퍼에만 기록하며 힙을 사용하지
+ * 않습니다. 입력은 snapshotState()로 얻은 SystemState 복사본입니다.
+ */
+
+
+//==============================================================================
+// 고정 버퍼 텍스트 기록기
+//==============================================================================
+
+/**
+ * @brief 고정 크기 버퍼에 텍스트를 이어 붙이는 기록기
+ *
+ * 버퍼가 모자라면 overflow 플래그만 세우고 이후 기록은 무시합니다.
+ * 버퍼는 항상 NUL로 끝나도록 유지됩니다.
+ */
+struct TextWriter {
+  char    *buf;
+  size_t   cap;
+  size_t   len;
+  bool     overflow;
+};
+
+void twInit(TextWriter &w, char *buf, size_t cap);
+void twChar(TextWriter &w, char c);
+void twStr(TextWriter &w, const char *s);
+void twUInt(TextWriter &w, uint32_t v);
+void twInt(TextWriter &w, int32_t v);
+
+/**
+ * @brief 실수를 소수점 decimals자리 고정소수점 문자열로 기록합니다.
+ * NaN/Inf는 JSON에서 표현할 수 없으므로 null로 기록합니다.
+ */
+void twFixed(TextWriter &w, float v, uint8_t decimals);
+
+
+//==============================================================================
+// 텔레메트리 필드
+//==============================================================================
+
+/**
+ * @brief 텔레메트리 필드 ID
+ *
+ * 델타 전송에서 바뀐 필드를 가리키는 번호이며, 바이너리 델타 레코드의
+ * 필드 ID로 그대로 쓰이므로 순서를 바꾸면 안 됩니다. (새 필드는 끝에 추가)
+ */
+enum TelemetryField : uint8_t {
+  TF_TANK_STATUS = 0, TF_TANK_TEMP, TF_TANK_LEVEL, TF_TANK_PH, TF_TANK_TDS,
+  TF_TANK_TURBIDITY, TF_TANK_DO, TF_TANK_PUMP, TF_TANK_LIGHT,
+  TF_GROW_STATUS, TF_GROW_TEMP, TF_GROW_HUMIDITY, TF_GROW_LEAK, TF_GROW_LED,
+  TF_NUTR_STATUS, TF_NUTR_LEVEL, TF_NUTR_RATIO, TF_NUTR_MOTOR,
+  TF_FEED_STATUS, TF_FEED_LEVEL, TF_FEED_LAST, TF_FEED_BUSY,
+  TF_SERVER, TF_WARNING, TF_ERROR,
+  TF_COUNT
+};
+
+const uint32_t TF_ALL_MASK = (1u << TF_COUNT) - 1;
+
+
+//==============================================================================
+// 상태 텔레메트리 인코더
+//==============================================================================
+
+/**
+ * @brief 상태 스냅샷을 한 줄짜리 JSON으로 인코딩합니다. (줄바꿈 미포함)
+ * @param st 인코딩할 상태 스냅샷
+ * @param buf 출력 버퍼 (STATUS_JSON_MAX_LEN 이상 권장)
+ * @param bufSize 출력 버퍼 크기
+ * @return 기록한 바이트 수 (NUL 제외). 버퍼가 부족하면 0
+ */
+size_t encodeStatusJson(const SystemState &st, char *buf, size_t bufSize);
+
+/**
+ * @brief 바이너리 텔레메트리 레코드 길이 (FRAME_TELEMETRY payload)
+ *
+ * 레이아웃 (모든 다바이트 값은 little-endian, 스케일은 괄호 안 단위):
+ *
+ *   off len  필드
+ *    0   4   uptimeMs
+ *    4   1   모듈 상태 (bit1:0 수조, 3:2 재배기, 5:4 양액기, 7:6 급여기)
+ *    5   1   플래그 (bit0 서버, 1 경고, 2 오류, 3 펌프, 4 조명, 5 급여중)
+ *    6   2   수조 수온        int16  (0.1 C)
+ *    8   2   수조 수위        uint16 (0.1 %)
+ *   10   2   수조 pH          uint16 (0.01)
+ *   12   2   수조 TDS         uint16 (1 ppm)
+ *   14   2   수조 탁도        uint16 (0.1)
+ *   16   2   수조 DO          uint16 (0.01 mg/L)
+ *   18   2   재배기 온도      int16  (0.1 C)
+ *   20   2   재배기 습도      uint16 (0.1 %)
+ *   22   1   재배기 누수 비트마스크
+ *   23   1   재배기 LED 밝기 (%)
+ *   24   2   양액 잔량        uint16 (0.1 %)
+ *   26   4   양액 채널 비율 x4 uint8 (1 %)
+ *   30   1   양액 모터 비트마스크
+ *   31   2   사료 잔량        uint16 (0.1 %)
+ *   33   4   마지막 급여 시각
+ */
+const size_t TELEMETRY_RECORD_LEN = 37;
+
+/**
+ * @brief 상태 스냅샷을 고정 레이아웃 바이너리 레코드로 인코딩합니다.
+ * @return 기록한 바이트 수 (TELEMETRY_RECORD_LEN). 버퍼가 부족하면 0
+ */
+size_t encodeStatusRecord(const SystemState &st, uint32_t uptimeMs, uint8_t *buf, size_t bufSize);
+
+
+//==============================================================================
+// 델타(데드밴드) 인코더
+//==============================================================================
+
+/**
+ * @brief 마지막 전송값 대비 필드별 데드밴드를 넘어 바뀐 필드를 찾습니다.
+ * @return 바뀐 필드의 비트마스크 (bit = TelemetryField)
+ */
+uint32_t telemetryChangedFields(const SystemState &st, const SystemState &lastSent);
+
+/**
+ * @brief mask의 필드만 lastSent에 반영합니다.
+ *
+ * 보내지 않은 필드는 이전 전송값을 유지하므로, 데드밴드보다 작은 변화가
+ * 누적되어 넘어서는 순간 전송됩니다.
+ */
+void telemetryMarkSent(SystemState &lastSent, const SystemState &st, uint32_t mask);
+
+/**
+ * @brief 델타 모드 JSON. 선두에 "kf"(1: 키프레임, 0: 델타)가 붙으며,
+ * 델타는 mask의 필드만, 키프레임은 모든 필드를 전체 JSON과 같은 키로 기록합니다.
+ * @return 기록한 바이트 수 (NUL 제외). 버퍼가 부족하면 0
+ */
+size_t encodeStatusDeltaJson(const SystemState &st, uint32_t mask, bool keyframe,
+                             char *buf, size_t bufSize);
+
+/**
+ * @brief 바이너리 델타 레코드 (FRAME_TELEMETRY_DELTA payload)
+ *
+ *   [0..3] uptimeMs (LE)  [4] 필드 개수 N
+ *   이후 N회: [필드 ID] [값: zigzag varint, 필드별 스케일 정수]
+ *             (TF_NUTR_RATIO는 값 4개, 비트마스크/상태는 정수 그대로)
+ *
+ * @return 기록한 바이트 수. 버퍼가 부족하면 0 (이 경우 키프레임을 대신 보냄)
+ */
+size_t encodeStatusDeltaRecord(const SystemState &st, uint32_t mask, uint32_t uptimeMs,
+                               uint8_t *buf, size_t bufSize);
+
+
+#endif // TELEMETRY_H
@@ -0,0 +1,149 @@
+#include "Globals.h"
+#include "Trace.h"
+
+/**
+ * @file Trace.cpp
+ * @brief 서버 명령 추적 링과 단계별 p50/p99 계산의 실제 구현을 포함합니다.
+ */
+
+namespace {
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of two");
+static_assert(TRACE_RING_SIZE <= 0x8000, "trace ids must not alias within the ring");
+
+const char *const kStageNames[] = {
+  "rx", "queued", "dispatch", "canq", "cantake", "cantx", "ack",
+};
+
+static_assert(sizeof(kStageNames) / sizeof(kStageNames[0]) == TRACE_STAGE_COUNT,
+              "kStageNames must have one entry per TraceStage");
+
+portMUX_TYPE s_traceMux = portMUX_INITIALIZER_UNLOCKED;
+TraceRecord  s_ring[TRACE_RING_SIZE];  // s_traceMux 안에서만 접근, 자리는 id & (크기 - 1)
+uint16_t     s_nextId = 1;
+
+// traceStageStats() 정렬용 (taskUart 전용)
+uint32_t s_hopScratch[TRACE_RING_SIZE];
+uint32_t s_cumScratch[TRACE_RING_SIZE];
+
+inline TraceRecord &slotOf(uint16_t id) {
+  return s_ring[id & (TRACE_RING_SIZE - 1)];
+}
+
+// 표본이 많지 않아 삽입 정렬로 충분
+void sortValues(uint32_t *v, size_t n) {
+  for (size_t i = 1; i < n; ++i) {
+    uint32_t x = v[i];
+    size_t j = i;
+    while (j > 0 && v[j - 1] > x) {
+      v[j] = v[j - 1];
+      --j;
+    }
+    v[j] = x;
+  }
+}
+
+// 정렬된 값의 nearest-rank 백분위
+uint32_t percentile(const uint32_t *sorted, size_t n, uint32_t pct) {
+  if (n == 0) return 0;
+  size_t rank = (n * pct + 99) / 100;
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+} // namespace
+
+uint16_t traceBegin(uint8_t module, uint8_t cmd) {
+  uint32_t now = micros();
+
+  portENTER_CRITICAL(&s_traceMux);
+  uint16_t id = s_nextId++;
+  if (s_nextId == 0) s_nextId = 1;
+  TraceRecord &r = slotOf(id);
+  r = {};
+  r.id      = id;
+  r.module  = module;
+  r.cmd     = cmd;
+  r.reached = 1u << TRACE_STAGE_RX;
+  r.t[TRACE_STAGE_RX] = now;
+  portEXIT_CRITICAL(&s_traceMux);
+
+  return id;
+}
+
+void traceStamp(uint16_t id, TraceStage stage) {
+  if (id == 0 || stage >= TRACE_STAGE_COUNT) return;
+  uint32_t now = micros();
+  uint8_t bit = (uint8_t)(1u << stage);
+
+  portENTER_CRITICAL(&s_traceMux);
+  TraceRecord &r = slotOf(id);
+  if (r.id == id && !(r.reached & bit)) {
+    r.reached |= bit;
+    r.t[stage] = now;
+  }
+  portEXIT_CRITICAL(&s_traceMux);
+}
+
+void traceFlag(uint16_t id, uint8_t flag) {
+  if (id == 0) return;
+
+  portENTER_CRITICAL(&s_traceMux);
+  TraceRecord &r = slotOf(id);
+  if (r.id == id) r.flags |= flag;
+  portEXIT_CRITICAL(&s_traceMux);
+}
+
+bool traceRead(uint16_t id, TraceRecord &out) {
+  if (id == 0) return false;
+
+  portENTER_CRITICAL(&s_traceMux);
+  out = slotOf(id);
+  portEXIT_CRITICAL(&s_traceMux);
+
+  return out.id == id;
+}
+
+uint16_t traceNextId() {
+  portENTER_CRITICAL(&s_traceMux);
+  uint16_t id = s_nextId;
+  portEXIT_CRITICAL(&s_traceMux);
+  return id;
+}
+
+void traceStageStats(TraceStage stage, TraceStageStats &out) {
+  out = {};
+  if (stage >= TRACE_STAGE_COUNT) return;
+  uint8_t bit  = (uint8_t)(1u << stage);
+  uint8_t prev = (uint8_t)(1u << (stage > 0 ? stage - 1 : 0));
+
+  // 레코드 하나씩 복사해 구간을 짧게 유지하고, 정렬은 구간 밖에서
+  size_t n = 0;
+  for (size_t i = 0; i < TRACE_RING_SIZE; ++i) {
+    TraceRecord r;
+    portENTER_CRITICAL(&s_traceMux);
+    r = s_ring[i];
+    portEXIT_CRITICAL(&s_traceMux);
+
+    if (r.id == 0 || !(r.reached & bit) || !(r.reached & prev)) continue;
+    uint32_t cum = r.t[stage] - r.t[TRACE_STAGE_RX];
+    s_hopScratch[n] = stage > 0 ? r.t[stage] - r.t[stage - 1] : 0;
+    s_cumScratch[n] = cum;
+    if (cum > TRACE_SLA_US) out.overSla++;
+    n++;
+  }
+  if (n == 0) return;
+
+  sortValues(s_hopScratch, n);
+  sortValues(s_cumScratch, n);
+  out.count    = (uint16_t)n;
+  out.hopP50Us = percentile(s_hopScratch, n, 50);
+  out.hopP99Us = percentile(s_hopScratch, n, 99);
+  out.hopMaxUs = s_hopScratch[n - 1];
+  out.cumP50Us = percentile(s_cumScratch, n, 50);
+  out.cumP99Us = percentile(s_cumScratch, n, 99);
+  out.cumMaxUs = s_cumScratch[n - 1];
+}
+
+const char *traceStageName(TraceStage stage) {
+  return stage < TRACE_STAGE_COUNT ? kStageNames[stage] : "?";
+}
@@ -0,0 +1,99 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "DataTypes.h"
+
+/**
+ * @file Trace.h
+ * @brief 서버 명령 하나가 UART 수신부터 CAN 송신/모듈 ACK까지 지나간 단계별 시각을 기록하는 추적기를 선언합니다.
+ *
+ * 경로: parseServerLine/handleServerFrame(RX) → g_serverCmdQueue(QUEUED) → taskUart가 10ms마다
+ * 하나씩 꺼냄(DISPATCH) → enqueueCanCommand(CAN_QUEUED) → taskCan이 꺼냄(CAN_TAKEN) →
+ * twai_transmit(CAN_TX) → 모듈 ACK(ACK)
+ *
+ * 명령마다 traceBegin()으로 추적 ID를 받아 ServerCommand/CanTxItem에 실어 보내고, 지나가는 곳마다
+ * traceStamp()로 micros()를 찍습니다. 레코드는 ID로 자리가 정해지는 TRACE_RING_SIZE칸 링에 있어
+ * 오래된 명령은 새 명령에 덮어쓰이고, 덮어쓰인 ID로 찍는 시각은 버려집니다.
+ *
+ * RX는 taskUart가 줄을 다 읽은 때입니다. 바이트가 UART FIFO에서 taskUart를 기다린 시간(최대 한 바퀴,
+ * 10ms)은 보이지 않으므로 SLA는 요약의 누적값에 그만큼을 더해 판단합니다.
+ *
+ * 값은 서버 명령 SYS_CMD_EXPORT_TRACE(FRAME_TRACE / "TRACE,...")로 봅니다.
+ */
+
+/**
+ * @brief 레코드에 붙는 표시 (비트)
+ */
+enum TraceFlag : uint8_t {
+  TRACE_FLAG_DROPPED    = 0x01,  // 큐/스케줄러가 가득 차 버려짐
+  TRACE_FLAG_COALESCED  = 0x02,  // 스케줄러에서 더 새 값에 덮어쓰여 나가지 않음
+  TRACE_FLAG_RETRANSMIT = 0x04,  // ACK가 없어 다시 보냄 (ACK 시각은 처음 송신부터 재전송을 포함)
+};
+
+/**
+ * @brief 명령 하나의 추적 레코드
+ */
+struct TraceRecord {
+  uint16_t id;       // 추적 ID (0: 빈 칸)
+  uint8_t  module;   // 대상 모듈
+  uint8_t  cmd;      // 명령 코드
+  uint8_t  reached;  // 지나간 단계 비트 (1 << TraceStage)
+  uint8_t  flags;    // TraceFlag 비트
+  uint32_t t[TRACE_STAGE_COUNT];  // 단계별 micros() (reached 비트가 있는 것만 유효)
+};
+
+/**
+ * @brief 단계 하나의 요약 (링에 남아 있는 레코드 중 그 단계를 지난 것)
+ */
+struct TraceStageStats {
+  uint16_t count;      // 표본 수
+  uint16_t overSla;    // 수신부터 TRACE_SLA_US보다 늦은 수
+  uint32_t hopP50Us;   // 직전 단계부터
+  uint32_t hopP99Us;
+  uint32_t hopMaxUs;
+  uint32_t cumP50Us;   // 수신부터
+  uint32_t cumP99Us;
+  uint32_t cumMaxUs;
+};
+
+/**
+ * @brief 새 명령의 추적을 시작하고 RX 시각을 찍습니다. (taskUart)
+ * @return 추적 ID (1~65535)
+ */
+uint16_t traceBegin(uint8_t module, uint8_t cmd);
+
+/**
+ * @brief 명령이 단계를 지났음을 기록합니다. 처음 찍은 시각만 남습니다. (id 0은 무시, 어느 태스크에서나)
+ */
+void traceStamp(uint16_t id, TraceStage stage);
+
+/**
+ * @brief 레코드에 TraceFlag를 붙입니다. (id 0은 무시)
+ */
+void traceFlag(uint16_t id, uint8_t flag);
+
+/**
+ * @brief 레코드 하나를 복사합니다.
+ * @return 그 ID의 레코드가 아직 링에 있으면 true
+ */
+bool traceRead(uint16_t id, TraceRecord &out);
+
+/**
+ * @brief 다음 traceBegin()이 돌려줄 ID (최근 레코드를 거꾸로 훑을 때 기준)
+ */
+uint16_t traceNextId();
+
+/**
+ * @brief 단계 하나의 p50/p99/최대를 링 전체에서 계산합니다. (정렬용 작업 버퍼를 같이 쓰므로 taskUart 전용)
+ */
+void traceStageStats(TraceStage stage, TraceStageStats &out);
+
+/**
+ * @brief 단계 이름 (내보내기용)
+ */
+const char *traceStageName(TraceStage stage);
+
+
+#endif // TRACE_H
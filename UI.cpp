@@ -1,5 +1,14 @@
 #include "Globals.h"
 #include "UI.h"
+#include "StateStore.h"
+#include "Render.h"
+#include "EventLog.h"
+#include "FlashLog.h"
+#include "History.h"
+#include "Profile.h"
+#include "Input.h"
+
+#include <stddef.h>
 
 /**
  * @file UI.cpp
@@ -7,141 +16,1006 @@
  */
 
 
+//==============================================================================
+// 화면 구성 (위젯 표)
+//==============================================================================
+// 화면은 위젯 표로만 선언합니다. 위젯은 고정 텍스트(UiText)와, 라벨 + 상태 필드 + 포맷 + 색을
+// 묶은 값 칸(UiCell) 두 가지입니다. 위치는 텍스트 크기 2(글자 12x16) 기준 열/행으로 적고,
+// 값은 라벨 바로 뒤에 놓입니다. 픽셀 상자, 상태 변경 비트, 위젯이 있는 줄은 아래 매크로가
+// 컴파일 시점에 계산해 표에 넣으므로, 그릴 때는 표의 값을 그대로 씁니다.
+// 상자가 화면을 벗어나거나 서로 겹치면 static_assert로 빌드가 실패합니다.
+
+namespace {
+
+const int16_t UI_CHAR_W = 12;
+const int16_t UI_CHAR_H = 16;
+const int16_t UI_SCREEN_W = 320;      // setRotation(1) 기준
+const int16_t UI_SCREEN_H = 240;
+const uint8_t UI_ROWS = UI_SCREEN_H / UI_CHAR_H;
+const size_t  UI_MAX_CELLS     = 16;  // 한 화면의 최대 값 칸 수
+const size_t  UI_CELL_MAX_CHARS = 26; // 값 칸 최대 폭 (320px / 12px)
+
+static_assert((size_t)UI_SCREEN_W * UI_CHAR_H <= RENDER_STRIP_MAX_PIXELS,
+              "a full text row must fit in one render strip");
+
+// 색 (RGB565)
+const uint16_t UI_COLOR_BG      = TFT_BLACK;
+const uint16_t UI_COLOR_TITLE   = TFT_CYAN;
+const uint16_t UI_COLOR_LABEL   = TFT_WHITE;     // 값 칸의 라벨
+const uint16_t UI_COLOR_HINT    = TFT_DARKGREY;  // 조작 안내
+const uint16_t UI_COLOR_VALUE   = TFT_GREEN;     // 모듈 측정값/상태
+const uint16_t UI_COLOR_SETTING = TFT_ORANGE;    // 설정값
+const uint16_t UI_COLOR_ALERT   = TFT_RED;       // 경고/오류 플래그
+const uint16_t UI_COLOR_LOG     = TFT_LIGHTGREY;
+const uint16_t UI_COLOR_GRID    = 0x2104;        // 그래프 눈금선 (어두운 회색)
+
+enum UiCellKind : uint8_t {
+  UC_F32,    // float → fmt
+  UC_U8,     // uint8_t(enum 포함) → fmt (%d)
+  UC_U32,    // uint32_t → fmt (%lu/%lx)
+  UC_BOOL,   // bool → fmt (%d)
+  UC_ONOFF,  // bool → "ON"/"OFF"
+  UC_LOG,    // 최신부터 offset번째 로그 한 줄 (보고 있는 페이지 기준)
+  UC_LOGPAGE, // 로그 화면에서 보고 있는 페이지
+  UC_GRAPH,   // 추이 그래프 값 (offset: UiGraphValue) → fmt
+  UC_PROF,    // 태스크 프로파일 한 줄 (offset: ProfileTask)
+  UC_PROFSEL, // 고른 태스크의 루프 시간 중앙값/99% 구간
+  UC_EDIT,    // 재배기 LED 밝기 입력 중 표시
+  UC_UISTATS, // 화면 갱신 한 번의 평균 SPI 전송량/전체 다시 그린 수
+  UC_RENDER,  // 입력→패널 지연 평균/최대와 렌더 태스크 CPU 점유
+};
+
+enum UiGraphValue : uint8_t {
+  UG_TOP,     // 세로 축 위쪽 끝 값
+  UG_BOTTOM,  // 세로 축 아래쪽 끝 값
+  UG_LATEST,  // 가장 최근 칸의 평균
+  UG_WINDOW,  // 시간 창 ("5m" 등, fmt 사용 안 함)
+};
+
+enum UiCellSource : uint8_t {
+  US_STATE,     // SystemState 스냅샷
+  US_SETTINGS,  // g_settings
+  US_NONE,
+};
+
+struct UiText {
+  uint8_t  row;
+  int16_t  x;       // 픽셀
+  int16_t  w;       // 픽셀 (글자 수 x UI_CHAR_W)
+  uint16_t color;
+  const char *text;
+};
+
+struct UiCell {
+  uint8_t  row;
+  int16_t  labelX;     // 라벨 시작 (픽셀). 라벨이 없으면 x와 같음
+  int16_t  x;          // 값 상자 시작 (픽셀) = 라벨 끝
+  int16_t  w;          // 값 상자 폭 (픽셀). 값이 짧아지면 남는 부분은 배경색으로 지움
+  uint8_t  width;      // 값 상자 글자 수
+  const char *label;
+  uint8_t  kind;
+  uint8_t  src;
+  uint16_t offset;     // 원본 구조체 안의 필드 위치 (UC_LOG: 최신부터 몇 번째)
+  uint32_t changeBit;  // 이 값을 바꾸는 상태 변경 비트 (STATE_CHG_*)
+  const char *fmt;
+  uint16_t color;
+};
+
+// 추이 그래프 영역: 화면 폭 전체 x 연속한 글자 줄. 열 하나 = 센서 이력 칸 하나
+struct UiGraph {
+  uint8_t  channel;    // HistoryChannel
+  uint8_t  firstRow;
+  uint8_t  rows;
+  uint16_t color;      // 선 색
+  float    minSpan;    // 세로 축 최소 폭 (값 단위). 평평한 값의 잡음이 화면 전체로 부풀지 않게
+};
+
+struct UiScreen {
+  const UiText *texts;
+  uint8_t  textCount;
+  const UiCell *cells;
+  uint8_t  cellCount;
+  uint16_t usedRows;   // 위젯이 있는 줄 (비트 = 줄 번호). 빈 줄은 단색 채우기로 보냄
+  uint32_t changeDeps; // 값 칸들의 상태 변경 비트를 모두 OR한 것
+  const UiGraph *graph;  // 추이 그래프 (없으면 nullptr)
+  uint16_t graphRows;    // 그래프가 차지하는 줄 (글자 줄로 그리지 않음)
+};
+
+// SystemState 필드 위치 → 그 필드가 속한 상태 변경 비트
+constexpr uint32_t stateChangeBit(size_t offset) {
+  return offset < offsetof(SystemState, grow)            ? STATE_CHG_TANK :
+         offset < offsetof(SystemState, nutrient)        ? STATE_CHG_GROW :
+         offset < offsetof(SystemState, feeder)          ? STATE_CHG_NUTRIENT :
+         offset < offsetof(SystemState, serverConnected) ? STATE_CHG_FEEDER :
+                                                           STATE_CHG_SYSTEM;
+}
+
+// 값 출처: (출처, 필드 위치, 상태 변경 비트)
+#define UI_ST(member)  US_STATE, (uint16_t)offsetof(SystemState, member), \
+                       stateChangeBit(offsetof(SystemState, member))
+#define UI_SET(member) US_SETTINGS, (uint16_t)offsetof(SystemSettings, member), STATE_CHG_SETTINGS
+#define UI_LOGLINE(n)  US_NONE, (uint16_t)(n), STATE_CHG_LOG
+#define UI_GRAPHVAL(v) US_NONE, (uint16_t)(v), STATE_CHG_HISTORY
+#define UI_PROFROW(t)  US_NONE, (uint16_t)(t), STATE_CHG_PROFILE
+#define UI_EDITMARK    US_NONE, (uint16_t)0, STATE_CHG_SETTINGS
+
+// 고정 텍스트: (열, 줄, 문자열, 색)
+#define UI_TEXT(col, row, text, color) \
+  { (uint8_t)(row), (int16_t)((col) * UI_CHAR_W), \
+    (int16_t)((sizeof(text) - 1) * UI_CHAR_W), (uint16_t)(color), text }
+
+// 값 칸: (열, 줄, 라벨, 값 글자 수, 종류, 출처, 포맷, 값 색). 라벨과 값 사이 간격은 라벨에 공백으로 넣습니다.
+#define UI_FIELD(col, row, label, width, kind, source, fmt, color) \
+  { (uint8_t)(row), (int16_t)((col) * UI_CHAR_W), \
+    (int16_t)(((col) + sizeof(label) - 1) * UI_CHAR_W), (int16_t)((width) * UI_CHAR_W), \
+    (uint8_t)(width), label, kind, source, fmt, (uint16_t)(color) }
+
+#define UI_COUNT(arr)  (uint8_t)(sizeof(arr) / sizeof(arr[0]))
+
+constexpr uint16_t textRows(const UiText *t, size_t n) {
+  return n == 0 ? 0 : (uint16_t)((1u << t->row) | textRows(t + 1, n - 1));
+}
+
+constexpr uint16_t cellRows(const UiCell *c, size_t n) {
+  return n == 0 ? 0 : (uint16_t)((1u << c->row) | cellRows(c + 1, n - 1));
+}
+
+constexpr uint32_t cellDeps(const UiCell *c, size_t n) {
+  return n == 0 ? 0 : c->changeBit | cellDeps(c + 1, n - 1);
+}
+
+constexpr uint16_t graphRowMask(const UiGraph &g) {
+  return (uint16_t)(((1u << g.rows) - 1u) << g.firstRow);
+}
+
+#define UI_SCREEN(texts, cells) \
+  { texts, UI_COUNT(texts), cells, UI_COUNT(cells), \
+    (uint16_t)(textRows(texts, UI_COUNT(texts)) | cellRows(cells, UI_COUNT(cells))), \
+    cellDeps(cells, UI_COUNT(cells)), nullptr, 0 }
+
+// 그래프가 있는 화면: 그래프 줄은 usedRows에서 빼고 따로 그립니다.
+#define UI_GRAPH_SCREEN(texts, cells, graph) \
+  { texts, UI_COUNT(texts), cells, UI_COUNT(cells), \
+    (uint16_t)(textRows(texts, UI_COUNT(texts)) | cellRows(cells, UI_COUNT(cells))), \
+    cellDeps(cells, UI_COUNT(cells)) | STATE_CHG_HISTORY, &graph, graphRowMask(graph) }
+
+constexpr UiText kDashboardTexts[] = {
+  UI_TEXT(0, 0, "[Dashboard]",           UI_COLOR_TITLE),
+  UI_TEXT(0, 8, "Rotary: change screen", UI_COLOR_HINT),
+  UI_TEXT(0, 9, "Btn:   select/confirm", UI_COLOR_HINT),
+};
+
+constexpr UiCell kDashboardCells[] = {
+  UI_FIELD( 0, 1, "Tank st=", 1, UC_U8,    UI_ST(tank.status),       "%d",     UI_COLOR_VALUE),
+  UI_FIELD(10, 1, "",         6, UC_F32,   UI_ST(tank.tempC),        "%.1fC",  UI_COLOR_VALUE),
+  UI_FIELD(17, 1, "",         7, UC_F32,   UI_ST(tank.levelPercent), "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD( 0, 2, "Grow st=", 1, UC_U8,    UI_ST(grow.status),       "%d",     UI_COLOR_VALUE),
+  UI_FIELD(10, 2, "",         6, UC_F32,   UI_ST(grow.tempC),        "%.1fC",  UI_COLOR_VALUE),
+  UI_FIELD(17, 2, "",         7, UC_F32,   UI_ST(grow.humidity),     "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD( 0, 3, "Nutr st=", 1, UC_U8,    UI_ST(nutrient.status),   "%d",     UI_COLOR_VALUE),
+  UI_FIELD(10, 3, "",         7, UC_F32,   UI_ST(nutrient.levelPercent), "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD( 0, 4, "Feed st=", 1, UC_U8,    UI_ST(feeder.status),     "%d",     UI_COLOR_VALUE),
+  UI_FIELD(10, 4, "",         7, UC_F32,   UI_ST(feeder.feedLevelPercent), "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD( 0, 5, "Server: ", 3, UC_ONOFF, UI_ST(serverConnected),   nullptr,  UI_COLOR_VALUE),
+  UI_FIELD( 0, 6, "Warn: ",   1, UC_BOOL,  UI_ST(hasWarning),        "%d",     UI_COLOR_ALERT),
+  UI_FIELD( 8, 6, "Err: ",    1, UC_BOOL,  UI_ST(hasError),          "%d",     UI_COLOR_ALERT),
+};
+
+constexpr UiText kTankTexts[] = {
+  UI_TEXT(0,  0, "[Tank]",                  UI_COLOR_TITLE),
+  UI_TEXT(0,  9, "Short Btn: Pump ON/OFF",  UI_COLOR_HINT),
+  UI_TEXT(0, 10, "Long  Btn: Light ON/OFF", UI_COLOR_HINT),
+};
+
+constexpr UiCell kTankCells[] = {
+  UI_FIELD(0, 1, "Temp:  ",  8, UC_F32,   UI_ST(tank.tempC),        "%.1fC",     UI_COLOR_VALUE),
+  UI_FIELD(0, 2, "Level: ",  8, UC_F32,   UI_ST(tank.levelPercent), "%.1f%%",    UI_COLOR_VALUE),
+  UI_FIELD(0, 3, "pH:    ",  8, UC_F32,   UI_ST(tank.pH),           "%.2f",      UI_COLOR_VALUE),
+  UI_FIELD(0, 4, "TDS:   ",  8, UC_F32,   UI_ST(tank.tds),          "%.0f",      UI_COLOR_VALUE),
+  UI_FIELD(0, 5, "DO:    ", 12, UC_F32,   UI_ST(tank.do_mgL),       "%.1f mg/L", UI_COLOR_VALUE),
+  UI_FIELD(0, 6, "Pump:  ",  3, UC_ONOFF, UI_ST(tank.pumpOn),       nullptr,     UI_COLOR_VALUE),
+  UI_FIELD(0, 7, "Light: ",  3, UC_ONOFF, UI_ST(tank.lightOn),      nullptr,     UI_COLOR_VALUE),
+};
+
+// 추이 그래프 화면: 0줄 제목/시간 창, 1줄 위쪽 값, 2~12줄 그래프, 13줄 아래쪽/최근 값
+#define UI_TREND_CELLS(fmt) \
+  UI_FIELD(14, 0,  "win ", 4, UC_GRAPH, UI_GRAPHVAL(UG_WINDOW), nullptr, UI_COLOR_HINT),  \
+  UI_FIELD( 0, 1,  "max ", 8, UC_GRAPH, UI_GRAPHVAL(UG_TOP),    fmt,     UI_COLOR_LABEL), \
+  UI_FIELD( 0, 13, "min ", 8, UC_GRAPH, UI_GRAPHVAL(UG_BOTTOM), fmt,     UI_COLOR_LABEL), \
+  UI_FIELD(13, 13, "now ", 8, UC_GRAPH, UI_GRAPHVAL(UG_LATEST), fmt,     UI_COLOR_VALUE)
+
+constexpr UiText kTrendTempTexts[] = {
+  UI_TEXT(0,  0, "[Temp trend]",      UI_COLOR_TITLE),
+  UI_TEXT(0, 14, "Btn: window  Long: fit", UI_COLOR_HINT),
+};
+
+constexpr UiText kTrendPhTexts[] = {
+  UI_TEXT(0,  0, "[pH trend]",        UI_COLOR_TITLE),
+  UI_TEXT(0, 14, "Btn: window  Long: fit", UI_COLOR_HINT),
+};
+
+constexpr UiText kTrendDoTexts[] = {
+  UI_TEXT(0,  0, "[DO trend]",        UI_COLOR_TITLE),
+  UI_TEXT(0, 14, "Btn: window  Long: fit", UI_COLOR_HINT),
+};
+
+constexpr UiCell kTrendTempCells[] = { UI_TREND_CELLS("%.1fC") };
+constexpr UiCell kTrendPhCells[]   = { UI_TREND_CELLS("%.2f") };
+constexpr UiCell kTrendDoCells[]   = { UI_TREND_CELLS("%.1fmg") };
+
+constexpr UiGraph kTrendTempGraph = { HIST_TANK_TEMP, 2, 11, UI_COLOR_VALUE, 1.0f };
+constexpr UiGraph kTrendPhGraph   = { HIST_TANK_PH,   2, 11, UI_COLOR_VALUE, 0.2f };
+constexpr UiGraph kTrendDoGraph   = { HIST_TANK_DO,   2, 11, UI_COLOR_VALUE, 1.0f };
+
+constexpr UiText kGrowTexts[] = {
+  UI_TEXT(0, 0, "[Grow]",                   UI_COLOR_TITLE),
+  UI_TEXT(0, 6, "Short Btn: LED edit on/off", UI_COLOR_HINT),
+  UI_TEXT(0, 7, "Long  Btn: Reset leaks",     UI_COLOR_HINT),
+  UI_TEXT(0, 8, "Turn(edit): LED 1/5/10%",    UI_COLOR_HINT),
+};
+
+constexpr UiCell kGrowCells[] = {
+  UI_FIELD(0, 1, "Temp: ", 8, UC_F32,  UI_ST(grow.tempC),         "%.1fC",  UI_COLOR_VALUE),
+  UI_FIELD(0, 2, "Hum:  ", 8, UC_F32,  UI_ST(grow.humidity),      "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD(0, 3, "Leak: ", 1, UC_BOOL, UI_ST(grow.leak[0]),       "%d",     UI_COLOR_ALERT),
+  UI_FIELD(7, 3, "",       1, UC_BOOL, UI_ST(grow.leak[1]),       "%d",     UI_COLOR_ALERT),
+  UI_FIELD(8, 3, "",       1, UC_BOOL, UI_ST(grow.leak[2]),       "%d",     UI_COLOR_ALERT),
+  UI_FIELD(9, 3, "",       1, UC_BOOL, UI_ST(grow.leak[3]),       "%d",     UI_COLOR_ALERT),
+  UI_FIELD(0, 4, "LED:  ", 4, UC_U8,   UI_ST(grow.ledBrightness), "%d%%",   UI_COLOR_VALUE),
+  UI_FIELD(11, 4, "set=",  4, UC_U8,   UI_SET(growLedBrightness), "%d%%",   UI_COLOR_SETTING),
+  UI_FIELD(20, 4, "",      4, UC_EDIT, UI_EDITMARK,               nullptr,  UI_COLOR_SETTING),
+};
+
+constexpr UiText kNutrientTexts[] = {
+  UI_TEXT(0, 0, "[Nutrient]",        UI_COLOR_TITLE),
+  UI_TEXT(0, 3, "Ch  Ratio   Motor", UI_COLOR_LABEL),
+};
+
+constexpr UiCell kNutrientCells[] = {
+  UI_FIELD(12, 0, "st=",     1, UC_U8,    UI_ST(nutrient.status),            "%d",     UI_COLOR_VALUE),
+  UI_FIELD( 0, 1, "Level: ", 7, UC_F32,   UI_ST(nutrient.levelPercent),      "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD( 0, 4, "1   ",    6, UC_F32,   UI_ST(nutrient.channelRatio[0]),   "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD(12, 4, "",        3, UC_ONOFF, UI_ST(nutrient.channelMotorOn[0]), nullptr,  UI_COLOR_VALUE),
+  UI_FIELD( 0, 5, "2   ",    6, UC_F32,   UI_ST(nutrient.channelRatio[1]),   "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD(12, 5, "",        3, UC_ONOFF, UI_ST(nutrient.channelMotorOn[1]), nullptr,  UI_COLOR_VALUE),
+  UI_FIELD( 0, 6, "3   ",    6, UC_F32,   UI_ST(nutrient.channelRatio[2]),   "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD(12, 6, "",        3, UC_ONOFF, UI_ST(nutrient.channelMotorOn[2]), nullptr,  UI_COLOR_VALUE),
+  UI_FIELD( 0, 7, "4   ",    6, UC_F32,   UI_ST(nutrient.channelRatio[3]),   "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD(12, 7, "",        3, UC_ONOFF, UI_ST(nutrient.channelMotorOn[3]), nullptr,  UI_COLOR_VALUE),
+};
+
+constexpr UiText kFeederTexts[] = {
+  UI_TEXT(0, 0, "[Feeder]",              UI_COLOR_TITLE),
+  UI_TEXT(0, 6, "Schedule: Settings tab", UI_COLOR_HINT),
+};
+
+constexpr UiCell kFeederCells[] = {
+  UI_FIELD(12, 0, "st=",       1, UC_U8,    UI_ST(feeder.status),           "%d",     UI_COLOR_VALUE),
+  UI_FIELD( 0, 1, "Remain:  ", 7, UC_F32,   UI_ST(feeder.feedLevelPercent), "%.1f%%", UI_COLOR_VALUE),
+  UI_FIELD( 0, 2, "Feeding: ", 3, UC_ONOFF, UI_ST(feeder.feedingNow),       nullptr,  UI_COLOR_VALUE),
+  UI_FIELD( 0, 3, "Last:    ",10, UC_U32,   UI_ST(feeder.lastFeedTime),     "%lu",    UI_COLOR_VALUE),
+  UI_FIELD( 0, 4, "Sched:   ", 2, UC_U8,    UI_SET(feederHour),             "%02d",   UI_COLOR_SETTING),
+  UI_FIELD(11, 4, ":",         2, UC_U8,    UI_SET(feederMinute),           "%02d",   UI_COLOR_SETTING),
+  UI_FIELD(15, 4, "amt=",      4, UC_U8,    UI_SET(feederAmountPercent),    "%d%%",   UI_COLOR_SETTING),
+};
+
+constexpr UiText kLogTexts[] = {
+  UI_TEXT(0, 0, "[Logs]",              UI_COLOR_TITLE),
+  UI_TEXT(0, 7, "Short: older page",   UI_COLOR_HINT),
+  UI_TEXT(0, 8, "Long : live / clear", UI_COLOR_HINT),
+};
+
+constexpr UiCell kLogCells[] = {
+  UI_FIELD(7, 0, "", 19, UC_LOGPAGE, UI_LOGLINE(0), nullptr, UI_COLOR_HINT),
+  UI_FIELD(0, 1, "", UI_CELL_MAX_CHARS, UC_LOG, UI_LOGLINE(0), nullptr, UI_COLOR_LOG),
+  UI_FIELD(0, 2, "", UI_CELL_MAX_CHARS, UC_LOG, UI_LOGLINE(1), nullptr, UI_COLOR_LOG),
+  UI_FIELD(0, 3, "", UI_CELL_MAX_CHARS, UC_LOG, UI_LOGLINE(2), nullptr, UI_COLOR_LOG),
+  UI_FIELD(0, 4, "", UI_CELL_MAX_CHARS, UC_LOG, UI_LOGLINE(3), nullptr, UI_COLOR_LOG),
+  UI_FIELD(0, 5, "", UI_CELL_MAX_CHARS, UC_LOG, UI_LOGLINE(4), nullptr, UI_COLOR_LOG),
+  UI_FIELD(0, 6, "", UI_CELL_MAX_CHARS, UC_LOG, UI_LOGLINE(5), nullptr, UI_COLOR_LOG),
+};
+
+constexpr UiText kSettingsTexts[] = {
+  UI_TEXT(0, 0, "[Settings]",                UI_COLOR_TITLE),
+  UI_TEXT(0, 7, "Short: DispOff cycle",      UI_COLOR_HINT),
+  UI_TEXT(0, 8, "Long : FactoryInit toggle", UI_COLOR_HINT),
+};
+
+constexpr UiCell kSettingsCells[] = {
+  UI_FIELD( 0, 1, "DisplayOff: ",   7, UC_U8,   UI_SET(displayOffMinutes),   "%d min",  UI_COLOR_SETTING),
+  UI_FIELD( 0, 2, "Feeder: ",       2, UC_U8,   UI_SET(feederHour),          "%02d",    UI_COLOR_SETTING),
+  UI_FIELD(10, 2, ":",              2, UC_U8,   UI_SET(feederMinute),        "%02d",    UI_COLOR_SETTING),
+  UI_FIELD(14, 2, "amt=",           4, UC_U8,   UI_SET(feederAmountPercent), "%d%%",    UI_COLOR_SETTING),
+  UI_FIELD( 0, 3, "GrowLED: ",      4, UC_U8,   UI_SET(growLedBrightness),   "%d%%",    UI_COLOR_SETTING),
+  UI_FIELD( 0, 4, "FW: ",          10, UC_U32,  UI_SET(fwVersion),           "0x%08lx", UI_COLOR_SETTING),
+  UI_FIELD( 0, 5, "FactoryInit: ",  1, UC_BOOL, UI_SET(factoryInitialized),  "%d",      UI_COLOR_SETTING),
+};
+
+// 진단 화면: 태스크마다 "이름 CPU% 최대 루프(ms) 최대 락 대기(us) 남은 스택(B)"
+constexpr UiText kDiagTexts[] = {
+  UI_TEXT(0,  0, "[Diagnostics]",              UI_COLOR_TITLE),
+  UI_TEXT(0,  1, "Task CPU% maxms lkus stack", UI_COLOR_LABEL),
+  UI_TEXT(0, 12, "Short: select task",         UI_COLOR_HINT),
+  UI_TEXT(0, 13, "Long : reset counters",      UI_COLOR_HINT),
+};
+
+constexpr UiCell kDiagCells[] = {
+  UI_FIELD(0,  2, "", UI_CELL_MAX_CHARS, UC_PROF,    UI_PROFROW(PROF_TASK_CAN),       nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0,  3, "", UI_CELL_MAX_CHARS, UC_PROF,    UI_PROFROW(PROF_TASK_UART),      nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0,  4, "", UI_CELL_MAX_CHARS, UC_PROF,    UI_PROFROW(PROF_TASK_UI),        nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0,  5, "", UI_CELL_MAX_CHARS, UC_PROF,    UI_PROFROW(PROF_TASK_LOGIC),     nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0,  6, "", UI_CELL_MAX_CHARS, UC_PROF,    UI_PROFROW(PROF_TASK_ALARM),     nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0,  7, "", UI_CELL_MAX_CHARS, UC_PROF,    UI_PROFROW(PROF_TASK_RENDER),    nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0,  8, "", UI_CELL_MAX_CHARS, UC_PROF,    UI_PROFROW(PROF_TASK_FLASH_LOG), nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0,  9, "", UI_CELL_MAX_CHARS, UC_UISTATS, UI_PROFROW(0),                   nullptr, UI_COLOR_VALUE),
+  UI_FIELD(0, 10, "", UI_CELL_MAX_CHARS, UC_PROFSEL, UI_PROFROW(0),                   nullptr, UI_COLOR_SETTING),
+  UI_FIELD(0, 11, "", UI_CELL_MAX_CHARS, UC_RENDER,  UI_PROFROW(0),                   nullptr, UI_COLOR_VALUE),
+};
+
+static_assert(PROF_TASK_COUNT == 7, "kDiagCells has one row per ProfileTask");
+
+// ScreenId 순서와 같아야 합니다.
+constexpr UiScreen kScreens[SCREEN_COUNT] = {
+  UI_SCREEN(kDashboardTexts, kDashboardCells),
+  UI_SCREEN(kTankTexts,      kTankCells),
+  UI_GRAPH_SCREEN(kTrendTempTexts, kTrendTempCells, kTrendTempGraph),
+  UI_GRAPH_SCREEN(kTrendPhTexts,   kTrendPhCells,   kTrendPhGraph),
+  UI_GRAPH_SCREEN(kTrendDoTexts,   kTrendDoCells,   kTrendDoGraph),
+  UI_SCREEN(kGrowTexts,      kGrowCells),
+  UI_SCREEN(kNutrientTexts,  kNutrientCells),
+  UI_SCREEN(kFeederTexts,    kFeederCells),
+  UI_SCREEN(kLogTexts,       kLogCells),
+  UI_SCREEN(kSettingsTexts,  kSettingsCells),
+  UI_SCREEN(kDiagTexts,      kDiagCells),
+};
+
+// 컴파일 시점 검사: 모든 상자가 화면 안에 있고, 같은 줄의 위젯끼리 겹치지 않는지
+constexpr bool boxInScreen(uint8_t row, int16_t x0, int16_t x1) {
+  return row < UI_ROWS && x0 >= 0 && x0 <= x1 && x1 <= UI_SCREEN_W;
+}
+
+constexpr bool boxesOverlap(uint8_t rowA, int16_t a0, int16_t a1,
+                            uint8_t rowB, int16_t b0, int16_t b1) {
+  return rowA == rowB && a0 < b1 && b0 < a1;
+}
+
+constexpr int16_t cellEnd(const UiCell &c) { return (int16_t)(c.x + c.w); }
+constexpr int16_t textEnd(const UiText &t) { return (int16_t)(t.x + t.w); }
+
+constexpr bool cellClearOfCells(const UiScreen &sc, size_t i, size_t j) {
+  return j == sc.cellCount ||
+         (!boxesOverlap(sc.cells[i].row, sc.cells[i].labelX, cellEnd(sc.cells[i]),
+                        sc.cells[j].row, sc.cells[j].labelX, cellEnd(sc.cells[j])) &&
+          cellClearOfCells(sc, i, j + 1));
+}
+
+constexpr bool cellClearOfTexts(const UiScreen &sc, size_t i, size_t j) {
+  return j == sc.textCount ||
+         (!boxesOverlap(sc.cells[i].row, sc.cells[i].labelX, cellEnd(sc.cells[i]),
+                        sc.texts[j].row, sc.texts[j].x, textEnd(sc.texts[j])) &&
+          cellClearOfTexts(sc, i, j + 1));
+}
+
+constexpr bool textClearOfTexts(const UiScreen &sc, size_t i, size_t j) {
+  return j == sc.textCount ||
+         (!boxesOverlap(sc.texts[i].row, sc.texts[i].x, textEnd(sc.texts[i]),
+                        sc.texts[j].row, sc.texts[j].x, textEnd(sc.texts[j])) &&
+          textClearOfTexts(sc, i, j + 1));
+}
+
+constexpr bool cellsValid(const UiScreen &sc, size_t i = 0) {
+  return i == sc.cellCount ||
+         (sc.cells[i].width <= UI_CELL_MAX_CHARS &&
+          boxInScreen(sc.cells[i].row, sc.cells[i].labelX, cellEnd(sc.cells[i])) &&
+          cellClearOfCells(sc, i, i + 1) && cellClearOfTexts(sc, i, 0) &&
+          cellsValid(sc, i + 1));
+}
+
+constexpr bool textsValid(const UiScreen &sc, size_t i = 0) {
+  return i == sc.textCount ||
+         (boxInScreen(sc.texts[i].row, sc.texts[i].x, textEnd(sc.texts[i])) &&
+          textClearOfTexts(sc, i, i + 1) && textsValid(sc, i + 1));
+}
+
+// 그래프는 화면 안에 있고, 그래프 줄에는 다른 위젯이 없어야 함
+constexpr bool graphValid(const UiScreen &sc) {
+  return sc.graph == nullptr ||
+         (sc.graph->rows > 0 && sc.graph->firstRow + sc.graph->rows <= UI_ROWS &&
+          sc.graph->minSpan > 0.0f && sc.graph->channel < HIST_CHANNEL_COUNT &&
+          (sc.usedRows & sc.graphRows) == 0);
+}
+
+constexpr bool screensValid(size_t i = 0) {
+  return i == SCREEN_COUNT ||
+         (kScreens[i].cellCount <= UI_MAX_CELLS &&
+          cellsValid(kScreens[i]) && textsValid(kScreens[i]) && graphValid(kScreens[i]) &&
+          screensValid(i + 1));
+}
+
+static_assert(screensValid(), "UI screen table: too many cells, or a widget runs off the screen or overlaps another");
+
+
+//------------------------------------------------------------------------------
+// 보존형 렌더링 상태
+//------------------------------------------------------------------------------
+// 갱신은 "다시 그릴 줄/칸" 표시와 실제 그리기(조각 제출)로 나뉩니다. 조각 버퍼가 모두
+// 전송 중이면 표시만 남겨 두고 돌아가며, 버퍼가 비면 uiFlush()가 남은 것을 이어 그립니다.
+
+static_assert(UI_ROWS <= 16 && UI_MAX_CELLS <= 16, "dirty masks are 16 bits wide");
+
+ScreenId       s_drawnScreen = SCREEN_COUNT;  // 패널에 그렸거나 그리는 중인 화면 (SCREEN_COUNT: 없음)
+char           s_cellText[UI_MAX_CELLS][UI_CELL_MAX_CHARS + 1];  // 칸별로 패널에 그렸거나 그릴 문자열
+uint16_t       s_dirtyRows  = 0;  // 전체를 다시 그릴 줄 (비트 = 줄 번호)
+uint16_t       s_dirtyCells = 0;  // 값만 다시 그릴 칸 (비트 = 칸 번호)
+uint32_t       s_frameBytes   = 0;  // 지금 프레임에서 제출한 SPI 전송량
+uint32_t       s_frameInputUs = 0;  // 지금 프레임에 반영할 가장 이른 입력 시각
+UiRenderStats  s_renderStats = {};
+
+// 로그 화면 페이지 (taskUi 전용). 0은 RAM 로그 실시간, 1부터는 플래시 보관 로그를 한 페이지씩 거슬러 감
+const uint8_t UI_LOG_LINES = 6;
+uint16_t      s_logPage = 0;
+uint32_t      s_logPageOldest = 0;               // 보고 있는 페이지의 가장 오래된 위치
+FlashLogEntry s_logPageLines[UI_LOG_LINES];      // 최신부터
+uint8_t       s_logPageCount = 0;
+
+// 진단 화면에서 루프 시간 구간을 보여 줄 태스크 (taskUi 전용)
+ProfileTask   s_profSel = PROF_TASK_UART;
+
+// 진단 화면 렌더 CPU 점유 계산용 (taskUi 전용). 1초 이상 지난 구간으로만 다시 계산
+RenderStats   s_renderPrev = {};
+uint32_t      s_renderCpuPermille = 0;
+
+// 재배기 화면에서 엔코더 회전이 LED 밝기 입력으로 쓰이는 중인지 (taskUi 전용)
+bool          s_growLedEdit = false;
+
+// 분포 칸 경계를 짧게: "<64us", "<4ms", ">65ms" (최대 6글자, ms는 999에서 자름)
+const size_t UI_BUCKET_LIMIT_LEN = 6;
+
+void formatBucketLimit(uint8_t bucket, char *buf, size_t bufSize) {
+  uint32_t us = profileBucketLimitUs(bucket);
+  bool over = (us == UINT32_MAX);
+  if (over) us = profileBucketLimitUs(bucket - 1);
+  uint32_t ms = us / 1000;
+  if (ms > 999) ms = 999;
+  if (!over && us < 1000) snprintf(buf, bufSize, "<%uus", (unsigned)us);
+  else                    snprintf(buf, bufSize, "%c%ums", over ? '>' : '<', (unsigned)ms);
+}
+
+// 보고 있는 페이지보다 앞선 보관 로그 한 페이지를 읽습니다. 더 없으면 false
+bool loadOlderLogPage() {
+  uint32_t start = flashLogStartPos();
+  uint32_t pos = s_logPage == 0 ? flashLogEndPos() : s_logPageOldest;
+  uint8_t n = 0;
+  while (n < UI_LOG_LINES && (int32_t)(pos - start) > 0) {
+    --pos;
+    if (flashLogRead(pos, s_logPageLines[n])) n++;
+  }
+  if (n == 0) return false;
+  s_logPageCount  = n;
+  s_logPageOldest = pos;
+  s_logPage++;
+  return true;
+}
+
+// 글자 한 줄(화면 폭 x UI_CHAR_H) 크기의 오프스크린 캔버스. 여기에 그린 뒤
+// 바뀐 사각형만 렌더 조각 버퍼로 옮겨 제출합니다.
+TFT_eSprite    s_canvas(&tft);
+
+// ILI9341 전송량 추정: 주소창 설정 11바이트 + 픽셀당 2바이트
+inline uint32_t spiWindowBytes(int32_t w, int32_t h) {
+  return 11u + (uint32_t)(w * h) * 2u;
+}
+
+// 추이 그래프 (taskUi 전용)
+// 열 링 s_graphPts가 그래프 내용입니다. 새 이력 칸이 생기면 머리만 한 칸 옮겨(스크롤) 가장
+// 오래된 열 자리에 새 칸을 넣고, 열마다 선이 지나는 세로 구간(s_graphSpan)을 다시 계산합니다.
+// 구간이 바뀐 열은 UI_GRAPH_TILE_W 폭 타일로 묶어, 타일에서 바뀐 높이 범위만 타일 스프라이트에
+// 그려 보냅니다. 세로 축은 들어온 값이 범위를 벗어날 때만 다시 맞추고 그때는 그래프 전체를 그립니다.
+const int16_t UI_GRAPH_TILE_W   = 8;
+const uint8_t UI_GRAPH_TILES    = UI_SCREEN_W / UI_GRAPH_TILE_W;
+const int16_t UI_GRAPH_MAX_H    = 11 * UI_CHAR_H;  // 그래프 최대 높이 (타일 스프라이트 크기)
+const uint8_t UI_GRAPH_GRID     = 4;               // 세로 축을 나누는 눈금 칸 수
+const size_t  UI_GRAPH_MAX_STEP = 8;               // 한 번에 이어 붙일 최대 새 칸 수 (넘으면 다시 읽음)
+
+static_assert(UI_SCREEN_W % UI_GRAPH_TILE_W == 0 && UI_GRAPH_TILES <= 64, "dirty tiles are a 64-bit mask");
+static_assert((size_t)UI_GRAPH_TILE_W * UI_GRAPH_MAX_H <= RENDER_STRIP_MAX_PIXELS,
+              "a graph tile must fit in one render strip");
+
+struct GraphSpan {
+  int16_t top;     // 그래프 영역 기준 y (top > bottom이면 그릴 선 없음)
+  int16_t bottom;
+  bool operator==(const GraphSpan &o) const { return top == o.top && bottom == o.bottom; }
+};
+
+HistoryTier  s_graphTier = HIST_TIER_RAW;      // 시간 창 (그래프 화면끼리 공유)
+bool         s_graphReload = true;             // 다음 갱신에서 이력을 처음부터 다시 읽음
+bool         s_graphRefit  = false;            // 다음 갱신에서 세로 축을 다시 맞춤
+HistoryPoint s_graphPts[UI_SCREEN_W];          // 열 링: s_graphHead가 가장 왼쪽(오래된) 열
+uint16_t     s_graphHead = 0;
+uint32_t     s_graphNewestT = 0;               // 가장 오른쪽 열의 칸 시작 시각
+float        s_graphTop = 1.0f, s_graphBottom = 0.0f;
+GraphSpan    s_graphSpan[UI_SCREEN_W];         // 열마다 패널에 그렸거나 그릴 선 구간
+uint64_t     s_dirtyTiles = 0;                 // 다시 그릴 타일 (비트 = 타일 번호)
+int16_t      s_tileTop[UI_GRAPH_TILES];        // 타일에서 다시 그릴 높이 범위
+int16_t      s_tileBottom[UI_GRAPH_TILES];
+TFT_eSprite  s_graphTile(&tft);                // 타일 한 장 (UI_GRAPH_TILE_W x 그래프 높이)
+
+inline const HistoryPoint &graphColumn(int16_t x) {
+  return s_graphPts[(s_graphHead + x) % UI_SCREEN_W];
+}
+
+inline int16_t graphHeight(const UiGraph &g) {
+  return (int16_t)(g.rows * UI_CHAR_H);
+}
+
+int16_t graphValueY(const UiGraph &g, float v) {
+  int16_t h = graphHeight(g);
+  float y = (float)(h - 1) * (s_graphTop - v) / (s_graphTop - s_graphBottom);
+  if (y < 0.0f) return 0;
+  if (y > (float)(h - 1)) return (int16_t)(h - 1);
+  return (int16_t)lroundf(y);
+}
+
+// 보이는 값 전체가 들어가도록 세로 축을 맞춥니다. (위아래 여유 10%)
+void graphFitRange(const UiGraph &g) {
+  float lo = 0.0f, hi = 0.0f;
+  bool any = false;
+  for (int16_t x = 0; x < UI_SCREEN_W; ++x) {
+    const HistoryPoint &p = graphColumn(x);
+    if (!p.valid) continue;
+    if (!any || p.min < lo) lo = p.min;
+    if (!any || p.max > hi) hi = p.max;
+    any = true;
+  }
+  float span = hi - lo;
+  if (span < g.minSpan) span = g.minSpan;
+  float mid = (lo + hi) * 0.5f;
+  s_graphBottom = mid - span * 0.6f;
+  s_graphTop    = mid + span * 0.6f;
+}
+
+bool graphInRange(const HistoryPoint &p) {
+  return !p.valid || (p.min >= s_graphBottom && p.max <= s_graphTop);
+}
+
+// 열 x에 그릴 선: 칸의 최소~최대, 그리고 앞 열 평균까지 이어 선이 끊기지 않게 함
+GraphSpan graphColumnSpan(const UiGraph &g, int16_t x) {
+  const HistoryPoint &p = graphColumn(x);
+  if (!p.valid) return { 1, 0 };
+  float lo = p.min, hi = p.max;
+  if (x > 0) {
+    const HistoryPoint &prev = graphColumn(x - 1);
+    if (prev.valid) {
+      if (prev.avg < lo) lo = prev.avg;
+      if (prev.avg > hi) hi = prev.avg;
+    }
+  }
+  return { graphValueY(g, hi), graphValueY(g, lo) };
+}
+
+// 열마다 선 구간을 다시 계산하고 바뀐 열의 타일에 다시 그릴 높이를 표시합니다.
+// all이면 구간과 관계없이 그래프 전체를 다시 그립니다.
+void graphMarkSpans(const UiGraph &g, bool all) {
+  int16_t h = graphHeight(g);
+  for (int16_t x = 0; x < UI_SCREEN_W; ++x) {
+    GraphSpan ns = graphColumnSpan(g, x);
+    GraphSpan &os = s_graphSpan[x];
+    if (!all && ns == os) continue;
+
+    int16_t top = 0, bottom = h - 1;
+    if (!all) {
+      // 지울 이전 선과 그릴 새 선을 모두 덮는 범위
+      top = INT16_MAX;
+      bottom = INT16_MIN;
+      if (os.top <= os.bottom) { top = os.top; bottom = os.bottom; }
+      if (ns.top <= ns.bottom) {
+        if (ns.top < top) top = ns.top;
+        if (ns.bottom > bottom) bottom = ns.bottom;
+      }
+    }
+    os = ns;
+    if (top > bottom) continue;
+
+    uint8_t tile = (uint8_t)(x / UI_GRAPH_TILE_W);
+    if (!(s_dirtyTiles & (1ull << tile))) {
+      s_dirtyTiles |= 1ull << tile;
+      s_tileTop[tile] = top;
+      s_tileBottom[tile] = bottom;
+    } else {
+      if (top < s_tileTop[tile]) s_tileTop[tile] = top;
+      if (bottom > s_tileBottom[tile]) s_tileBottom[tile] = bottom;
+    }
+  }
+}
+
+// 시간 창 전체를 이력에서 다시 읽습니다. 오른쪽 끝 열이 가장 최근 칸입니다.
+void graphLoad(const UiGraph &g) {
+  uint32_t period = historyPeriod(s_graphTier);
+  s_graphHead = 0;
+  size_t n = 0;
+  if (historyNewest(s_graphTier, s_graphNewestT)) {
+    uint32_t span = (uint32_t)(UI_SCREEN_W - 1) * period;
+    uint32_t from = s_graphNewestT > span ? s_graphNewestT - span : 0;
+    n = historyQuery((HistoryChannel)g.channel, s_graphTier, from, s_graphNewestT,
+                     s_graphPts, UI_SCREEN_W);
+  } else {
+    s_graphNewestT = 0;
+  }
+  // 오른쪽 정렬: 남아 있지 않은 앞부분은 빈 열
+  size_t pad = UI_SCREEN_W - n;
+  if (pad) {
+    memmove(&s_graphPts[pad], &s_graphPts[0], n * sizeof(HistoryPoint));
+    for (size_t i = 0; i < pad; ++i) {
+      s_graphPts[i] = {};
+      s_graphPts[i].t = s_graphNewestT - (uint32_t)(UI_SCREEN_W - i) * period;
+    }
+  }
+  s_graphReload = false;
+}
+
+// 새 이력 칸을 열 링에 이어 붙입니다. 다시 읽어야 하면 false
+bool graphAppend(const UiGraph &g) {
+  uint32_t newest;
+  if (!historyNewest(s_graphTier, newest)) return true;
+  uint32_t period = historyPeriod(s_graphTier);
+  if (newest < s_graphNewestT || (newest - s_graphNewestT) / period >= UI_GRAPH_MAX_STEP) return false;
+
+  // 가장 오른쪽 열(요약 단계면 아직 누적 중이었던 칸)부터 다시 읽음
+  HistoryPoint pts[UI_GRAPH_MAX_STEP];
+  size_t n = historyQuery((HistoryChannel)g.channel, s_graphTier, s_graphNewestT, newest,
+                          pts, UI_GRAPH_MAX_STEP);
+  for (size_t i = 0; i < n; ++i) {
+    if (pts[i].t != s_graphNewestT) {
+      s_graphHead = (uint16_t)((s_graphHead + 1) % UI_SCREEN_W);  // 한 열 스크롤
+      s_graphNewestT = pts[i].t;
+    }
+    s_graphPts[(s_graphHead + UI_SCREEN_W - 1) % UI_SCREEN_W] = pts[i];
+    if (!graphInRange(pts[i])) s_graphRefit = true;
+  }
+  return true;
+}
+
+// 화면의 그래프를 최신 이력에 맞추고 다시 그릴 타일을 표시합니다.
+void graphRefresh(const UiGraph &g, bool full) {
+  bool all = full;
+  if (full || s_graphReload || !graphAppend(g)) {
+    graphLoad(g);
+    s_graphRefit = true;
+  }
+  if (s_graphRefit) {
+    graphFitRange(g);
+    s_graphRefit = false;
+    all = true;
+  }
+  graphMarkSpans(g, all);
+}
+
+// 타일 하나의 [top, bottom] 높이를 스프라이트에 그려 조각 버퍼로 보냅니다.
+void submitGraphTile(const UiGraph &g, uint8_t tile, uint16_t *strip) {
+  int16_t top = s_tileTop[tile], bottom = s_tileBottom[tile];
+  int16_t h = bottom - top + 1;
+  int16_t x0 = (int16_t)(tile * UI_GRAPH_TILE_W);
+  int16_t gh = graphHeight(g);
+
+  s_graphTile.fillRect(0, 0, UI_GRAPH_TILE_W, h, UI_COLOR_BG);
+  for (uint8_t k = 0; k <= UI_GRAPH_GRID; ++k) {
+    int16_t y = (int16_t)((gh - 1) * k / UI_GRAPH_GRID);
+    if (y >= top && y <= bottom) s_graphTile.drawFastHLine(0, y - top, UI_GRAPH_TILE_W, UI_COLOR_GRID);
+  }
+  for (int16_t i = 0; i < UI_GRAPH_TILE_W; ++i) {
+    const GraphSpan &sp = s_graphSpan[x0 + i];
+    int16_t a = sp.top > top ? sp.top : top;
+    int16_t b = sp.bottom < bottom ? sp.bottom : bottom;
+    if (a <= b) s_graphTile.drawFastVLine(i, a - top, b - a + 1, g.color);
+  }
+
+  const uint16_t *src = (const uint16_t *)s_graphTile.getPointer();
+  memcpy(strip, src, (size_t)UI_GRAPH_TILE_W * h * sizeof(uint16_t));
+  int16_t y = (int16_t)(g.firstRow * UI_CHAR_H + top);
+  renderSubmitStrip(strip, x0, y, UI_GRAPH_TILE_W, h);
+  s_frameBytes += spiWindowBytes(UI_GRAPH_TILE_W, h);
+}
+
+void formatCell(const UiCell &c, const SystemState &st, char *buf, size_t bufSize) {
+  const uint8_t *base = c.src == US_STATE    ? (const uint8_t *)&st :
+                        c.src == US_SETTINGS ? (const uint8_t *)&g_settings : nullptr;
+  const uint8_t *p = base ? base + c.offset : nullptr;
+
+  switch (c.kind) {
+    case UC_F32:   snprintf(buf, bufSize, c.fmt, (double)*(const float *)p); break;
+    case UC_U8:    snprintf(buf, bufSize, c.fmt, (int)*p); break;
+    case UC_U32:   snprintf(buf, bufSize, c.fmt, (unsigned long)*(const uint32_t *)p); break;
+    case UC_BOOL:  snprintf(buf, bufSize, c.fmt, (int)*(const bool *)p); break;
+    case UC_ONOFF: snprintf(buf, bufSize, "%s", *(const bool *)p ? "ON" : "OFF"); break;
+    case UC_LOG:
+    {
+      if (s_logPage) {
+        // 보관 로그 페이지: 줄 앞에 부팅 번호
+        if (c.offset >= s_logPageCount) {
+          buf[0] = '\0';
+          break;
+        }
+        const FlashLogEntry &e = s_logPageLines[c.offset];
+        int n = snprintf(buf, bufSize, "#%lu ", (unsigned long)e.boot);
+        if (n > 0 && (size_t)n < bufSize) logFormat(e.rec, buf + n, bufSize - (size_t)n, true);
+        break;
+      }
+      // 보이는 줄만 여기서 문구로 만듭니다. (아직 쓰는 중이면 빈 줄, 다음 알림에 다시 그림)
+      LogRecord rec;
+      uint32_t seq = logNextSeq() - 1 - c.offset;
+      if ((int32_t)(seq - logFirstSeq()) >= 0 && logRead(seq, rec)) {
+        logFormat(rec, buf, bufSize, true);
+      } else {
+        buf[0] = '\0';
+      }
+      break;
+    }
+    case UC_LOGPAGE:
+      if (s_logPage) snprintf(buf, bufSize, "flash p%u", (unsigned)s_logPage);
+      else           snprintf(buf, bufSize, "live");
+      break;
+    case UC_GRAPH:
+    {
+      if (c.offset == UG_WINDOW) {
+        uint32_t secs = historyPeriod(s_graphTier) * UI_SCREEN_W;
+        if (secs < 3600)           snprintf(buf, bufSize, "%lum", (unsigned long)(secs / 60));
+        else if (secs < 2 * 86400) snprintf(buf, bufSize, "%luh", (unsigned long)(secs / 3600));
+        else                       snprintf(buf, bufSize, "%lud", (unsigned long)(secs / 86400));
+        break;
+      }
+      if (c.offset == UG_LATEST) {
+        const HistoryPoint &p = graphColumn(UI_SCREEN_W - 1);
+        if (p.valid) snprintf(buf, bufSize, c.fmt, (double)p.avg);
+        else         snprintf(buf, bufSize, "--");
+        break;
+      }
+      snprintf(buf, bufSize, c.fmt, (double)(c.offset == UG_TOP ? s_graphTop : s_graphBottom));
+      break;
+    }
+    case UC_PROF:
+    {
+      TaskProfile p;
+      getTaskProfile((ProfileTask)c.offset, p);
+      float maxMs = p.maxUs / 1000.0f;
+      snprintf(buf, bufSize, "%-4.4s%5.1f %5.1f %4lu %5u", profileTaskName((ProfileTask)c.offset),
+               p.cpuPermille / 10.0, (double)(maxMs < 999.9f ? maxMs : 999.9f),
+               (unsigned long)(p.lockMaxUs < 9999 ? p.lockMaxUs : 9999), (unsigned)p.stackFree);
+      break;
+    }
+    case UC_PROFSEL:
+    {
+      TaskProfile p;
+      getTaskProfile(s_profSel, p);
+      char p50[UI_BUCKET_LIMIT_LEN + 1], p99[UI_BUCKET_LIMIT_LEN + 1];
+      formatBucketLimit(profilePercentileBucket(p, 500), p50, sizeof(p50));
+      formatBucketLimit(profilePercentileBucket(p, 990), p99, sizeof(p99));
+      // 6 + " p50" + 6 + " p99" + 6 = 26 = UI_CELL_MAX_CHARS
+      snprintf(buf, bufSize, "%-6.6s p50%.6s p99%.6s", profileTaskName(s_profSel), p50, p99);
+      break;
+    }
+    case UC_UISTATS:
+    {
+      // "UI avg  3083B full     12": 갱신 한 번의 평균 SPI 전송량 (ILI9341 기준 추정)과 전체 다시 그린 수.
+      // 마지막 갱신량은 진단 화면에서는 늘 이 줄 자신이라 보이지 않습니다.
+      uint32_t refreshes = s_renderStats.fullRedraws + s_renderStats.partialRedraws;
+      uint32_t avg = refreshes ? (uint32_t)(s_renderStats.totalSpiBytes / refreshes) : 0;
+      snprintf(buf, bufSize, "UI avg%6luB full%7lu", (unsigned long)(avg < 999999 ? avg : 999999),
+               (unsigned long)(s_renderStats.fullRedraws < 9999999 ? s_renderStats.fullRedraws : 9999999));
+      break;
+    }
+    case UC_RENDER:
+    {
+      // "Lat 12.3/ 45.6ms Rnd 3.2%": 입력→패널 지연 평균/최대와 렌더 태스크 CPU 점유
+      RenderStats r;
+      getRenderStats(r);
+      uint32_t runUs = r.runUs - s_renderPrev.runUs;
+      if (runUs >= 1000000u) {
+        s_renderCpuPermille = (uint32_t)((r.busyUs - s_renderPrev.busyUs) * 1000u / runUs);
+        s_renderPrev = r;
+      }
+      float avgMs = r.photonCount ? (float)(r.photonSumUs / r.photonCount) / 1000.0f : 0.0f;
+      float maxMs = r.photonMaxUs / 1000.0f;
+      snprintf(buf, bufSize, "Lat%5.1f/%5.1fms Rnd%4.1f%%", (double)(avgMs < 999.9f ? avgMs : 999.9f),
+               (double)(maxMs < 999.9f ? maxMs : 999.9f), s_renderCpuPermille / 10.0);
+      break;
+    }
+    case UC_EDIT:
+      snprintf(buf, bufSize, "%s", s_growLedEdit ? "EDIT" : "");
+      break;
+    default:
+      buf[0] = '\0';
+      break;
+  }
+  if (strlen(buf) > c.width) buf[c.width] = '\0';  // 칸 밖으로 넘치지 않게 자름
+}
+
+bool prepareCanvas() {
+  if (!s_canvas.created()) {
+    s_canvas.setColorDepth(16);
+    if (!s_canvas.createSprite(UI_SCREEN_W, UI_CHAR_H)) return false;
+    s_canvas.setTextSize(2);
+    s_canvas.setTextDatum(TL_DATUM);
+    s_canvas.setTextColor(UI_COLOR_LABEL, UI_COLOR_BG);
+  }
+  if (!s_graphTile.created()) {
+    s_graphTile.setColorDepth(16);
+    if (!s_graphTile.createSprite(UI_GRAPH_TILE_W, UI_GRAPH_MAX_H)) return false;
+  }
+  return true;
+}
+
+// 캔버스의 [x, x + w) 열을 조각 버퍼로 옮겨 패널 (x, y)에 보내도록 제출합니다.
+void submitCanvas(uint16_t *strip, int16_t x, int16_t w, int16_t y) {
+  const uint16_t *src = (const uint16_t *)s_canvas.getPointer() + x;
+  for (int16_t r = 0; r < UI_CHAR_H; ++r) {
+    memcpy(strip + r * w, src + r * UI_SCREEN_W, (size_t)w * sizeof(uint16_t));
+  }
+  renderSubmitStrip(strip, x, y, w, UI_CHAR_H);
+  s_frameBytes += spiWindowBytes(w, UI_CHAR_H);
+}
+
+// 캔버스의 값 상자에 칸 문자열을 그립니다. 남는 폭은 패딩(배경색)으로 지워 이전 값이 남지 않게 합니다.
+void drawCellText(const UiCell &c, const char *text) {
+  s_canvas.setTextColor(c.color, UI_COLOR_BG);
+  s_canvas.setTextPadding(c.w);
+  s_canvas.drawString(text, c.x, 0);
+  s_canvas.setTextPadding(0);
+}
+
+// 한 줄 전체(고정 텍스트 + 라벨 + 값)를 그려 보냅니다.
+void composeRow(const UiScreen &sc, uint8_t row, uint16_t *strip) {
+  s_canvas.fillSprite(UI_COLOR_BG);
+  for (uint8_t i = 0; i < sc.textCount; ++i) {
+    const UiText &t = sc.texts[i];
+    if (t.row != row) continue;
+    s_canvas.setTextColor(t.color, UI_COLOR_BG);
+    s_canvas.drawString(t.text, t.x, 0);
+  }
+  for (uint8_t i = 0; i < sc.cellCount; ++i) {
+    const UiCell &c = sc.cells[i];
+    if (c.row != row) continue;
+    if (c.label[0]) {
+      s_canvas.setTextColor(UI_COLOR_LABEL, UI_COLOR_BG);
+      s_canvas.drawString(c.label, c.labelX, 0);
+    }
+    drawCellText(c, s_cellText[i]);
+  }
+  submitCanvas(strip, 0, UI_SCREEN_W, row * UI_CHAR_H);
+}
+
+// 표시해 둔 줄/칸을 그려 제출합니다.
+// wait가 false면 조각 버퍼가 없을 때 나머지를 남기고 돌아갑니다. (남았으면 true)
+bool flushDirty(bool wait) {
+  if (s_drawnScreen >= SCREEN_COUNT) return false;
+  const UiScreen &sc = kScreens[s_drawnScreen];
+
+  while (s_dirtyRows) {
+    uint8_t row = (uint8_t)__builtin_ctz(s_dirtyRows);
+    if (!(sc.usedRows & (1u << row))) {
+      renderSubmitFill(0, row * UI_CHAR_H, UI_SCREEN_W, UI_CHAR_H, UI_COLOR_BG);
+      s_frameBytes += spiWindowBytes(UI_SCREEN_W, UI_CHAR_H);
+    } else {
+      uint16_t *strip = renderAcquireStrip(wait);
+      if (!strip) return true;
+      composeRow(sc, row, strip);
+    }
+    s_dirtyRows &= (uint16_t)~(1u << row);
+  }
+
+  while (s_dirtyCells) {
+    uint8_t i = (uint8_t)__builtin_ctz(s_dirtyCells);
+    uint16_t *strip = renderAcquireStrip(wait);
+    if (!strip) return true;
+    const UiCell &c = sc.cells[i];
+    drawCellText(c, s_cellText[i]);
+    submitCanvas(strip, c.x, c.w, c.row * UI_CHAR_H);
+    s_dirtyCells &= (uint16_t)~(1u << i);
+  }
+
+  while (s_dirtyTiles && sc.graph) {
+    uint8_t tile = (uint8_t)__builtin_ctzll(s_dirtyTiles);
+    uint16_t *strip = renderAcquireStrip(wait);
+    if (!strip) return true;
+    submitGraphTile(*sc.graph, tile, strip);
+    s_dirtyTiles &= ~(1ull << tile);
+  }
+
+  // 이번 프레임에 제출한 것이 모두 나가면 렌더 태스크가 프레임 완료(입력→패널 지연)를 셉니다.
+  if (s_frameBytes) {
+    renderEndFrame(s_frameInputUs);
+    s_renderStats.lastSpiBytes   = s_frameBytes;
+    s_renderStats.totalSpiBytes += s_frameBytes;
+  }
+  s_frameBytes   = 0;
+  s_frameInputUs = 0;
+  return false;
+}
+
+// 화면 id에서 changed에 해당하는 값 칸 중 문자열이 바뀐 것을 다시 그릴 대상으로 표시합니다.
+void markScreen(ScreenId id, uint32_t changed, uint32_t inputUs) {
+  if (id >= SCREEN_COUNT) id = SCREEN_DASHBOARD;
+  const UiScreen &sc = kScreens[id];
+  bool full = (s_drawnScreen != id);
+
+  // 바뀐 부분과 관계없는 화면이면 스냅샷도 뜨지 않습니다.
+  if (!full && !(changed & sc.changeDeps)) return;
+
+  SystemState st;
+  snapshotState(st);
+
+  uint8_t repainted = 0;
+  if (full) {
+    // 로그 화면을 떠나면 다음에는 실시간 로그부터 보여 줌
+    if (id != SCREEN_LOG) s_logPage = 0;
+
+    // 그래프는 이력을 다시 읽어 타일로 그리고, 그 줄은 글자 줄로 그리지 않음
+    s_dirtyTiles = 0;
+    if (sc.graph) graphRefresh(*sc.graph, true);
+
+    // 화면이 바뀌었을 때만 모든 줄을 라벨과 값을 함께 그려 덮어씁니다.
+    for (uint8_t i = 0; i < sc.cellCount; ++i) {
+      formatCell(sc.cells[i], st, s_cellText[i], sizeof(s_cellText[i]));
+    }
+    s_dirtyRows  = (uint16_t)(((1u << UI_ROWS) - 1) & ~sc.graphRows);
+    s_dirtyCells = 0;
+    s_drawnScreen = id;
+    repainted = sc.cellCount;
+  } else {
+    // 새 이력 칸: 열 링을 스크롤하고 선이 바뀐 타일만 표시 (축 값 칸은 아래에서 함께 갱신)
+    if (sc.graph && (changed & STATE_CHG_HISTORY)) graphRefresh(*sc.graph, false);
+
+    char text[UI_CELL_MAX_CHARS + 1];
+    for (uint8_t i = 0; i < sc.cellCount; ++i) {
+      if (!(changed & sc.cells[i].changeBit)) continue;
+      formatCell(sc.cells[i], st, text, sizeof(text));
+      if (strcmp(text, s_cellText[i]) == 0) continue;
+      memcpy(s_cellText[i], text, sizeof(text));
+      // 아직 안 그린 줄에 있는 칸은 그 줄을 그릴 때 함께 그려집니다.
+      if (!(s_dirtyRows & (1u << sc.cells[i].row))) s_dirtyCells |= (uint16_t)(1u << i);
+      repainted++;
+    }
+  }
+
+  if (inputUs && !s_frameInputUs) s_frameInputUs = inputUs;
+
+  if (full) s_renderStats.fullRedraws++;
+  else      s_renderStats.partialRedraws++;
+  s_renderStats.cellsRepainted += repainted;
+}
+
+void drawScreen(ScreenId id, uint32_t changed) {
+  if (!prepareCanvas()) return;
+  markScreen(id, changed, 0);
+  flushDirty(true);
+}
+
+} // namespace
+
+
 //==============================================================================
 // UI 화면 그리기 구현
 //==============================================================================
 
 void drawCurrentScreen() {
-  switch (g_currentScreen) {
-    case SCREEN_DASHBOARD:  drawDashboard();   break;
-    case SCREEN_TANK:       drawTankScreen();  break;
-    case SCREEN_GROW:       drawGrowScreen();  break;
-    case SCREEN_NUTRIENT:   drawNutrientScreen(); break;
-    case SCREEN_FEEDER:     drawFeederScreen();   break;
-    case SCREEN_LOG:        drawLogScreen();      break;
-    case SCREEN_SETTINGS:   drawSettingsScreen(); break;
-    default:                drawDashboard();   break;
-  }
-}
-
-void drawDashboard() {
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0, 0);
-  tft.setTextSize(2);
-  tft.println("[Dashboard]");
-
-  if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-    tft.printf("Tank: st=%d temp=%.1fC lvl=%.1f%%\n",
-               g_state.tank.status,
-               g_state.tank.tempC,
-               g_state.tank.levelPercent);
-    tft.printf("Grow: st=%d temp=%.1fC hum=%.1f%%\n",
-               g_state.grow.status,
-               g_state.grow.tempC,
-               g_state.grow.humidity);
-    tft.printf("Nutr: st=%d\n", g_state.nutrient.status);
-    tft.printf("Feed: st=%d\n", g_state.feeder.status);
-
-    tft.printf("Server: %s\n", g_state.serverConnected ? "ON" : "OFF");
-    tft.printf("Warn: %d Err: %d\n", g_state.hasWarning, g_state.hasError);
-
-    xSemaphoreGive(g_stateMutex);
-  }
-
-  tft.println();
-  tft.println("Rotary: change screen");
-  tft.println("Btn:   select/confirm");
-}
-
-void drawTankScreen() {
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0, 0);
-  tft.setTextSize(2);
-  tft.println("[Tank]");
-
-  if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-    tft.printf("Temp: %.1fC\n", g_state.tank.tempC);
-    tft.printf("Level: %.1f%%\n", g_state.tank.levelPercent);
-    tft.printf("pH: %.2f\n", g_state.tank.pH);
-    tft.printf("TDS: %.0f\n", g_state.tank.tds);
-    tft.printf("DO: %.1f mg/L\n", g_state.tank.do_mgL);
-    tft.printf("Pump: %s\n", g_state.tank.pumpOn ? "ON" : "OFF");
-    tft.printf("Light: %s\n", g_state.tank.lightOn ? "ON" : "OFF");
-    xSemaphoreGive(g_stateMutex);
-  }
-
-  tft.println();
-  tft.println("Short Btn: Pump ON/OFF");
-  tft.println("Long  Btn: Light ON/OFF");
-}
-
-void drawGrowScreen() {
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0, 0);
-  tft.setTextSize(2);
-  tft.println("[Grow]");
-
-  if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-    tft.printf("Temp: %.1fC\n", g_state.grow.tempC);
-    tft.printf("Hum:  %.1f%%\n", g_state.grow.humidity);
-    tft.printf("Leak: %d%d%d%d\n",
-               g_state.grow.leak[0], g_state.grow.leak[1],
-               g_state.grow.leak[2], g_state.grow.leak[3]);
-    tft.printf("LED:  %d%%\n", g_state.grow.ledBrightness);
-    xSemaphoreGive(g_stateMutex);
-  }
-
-  tft.println();
-  tft.println("Short Btn: LED 0/50/100%");
-  tft.println("Long  Btn: Reset leaks");
-}
-
-void drawNutrientScreen() {
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0, 0);
-  tft.setTextSize(2);
-  tft.println("[Nutrient] (TODO)");
-  tft.println("Show channel ratio, motor, level");
-}
-
-void drawFeederScreen() {
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0, 0);
-  tft.setTextSize(2);
-  tft.println("[Feeder] (TODO)");
-  tft.println("Show remain, history, schedule");
-}
-
-void drawLogScreen() {
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0, 0);
-  tft.setTextSize(2);
-  tft.println("[Logs]");
-  int idx = g_logHead;
-  for (int i = 0; i < g_logCount && i < 6; ++i) {
-    idx = (idx - 1 + LOG_BUFFER_SIZE) % LOG_BUFFER_SIZE;
-    // TFT 라이브러리가 String 객체를 직접 처리하지 못할 수 있으므로 c_str() 사용
-    tft.println(g_logBuffer[idx].c_str());
-  }
-}
-
-void drawSettingsScreen() {
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0, 0);
-  tft.setTextSize(2);
-  tft.println("[Settings]");
-  tft.printf("DisplayOff: %d min\n", g_settings.displayOffMinutes);
-  tft.printf("Feeder: %02d:%02d amt=%d%%\n",
-             g_settings.feederHour,
-             g_settings.feederMinute,
-             g_settings.feederAmountPercent);
-  tft.printf("GrowLED: %d%%\n", g_settings.growLedBrightness);
-  tft.printf("FW: 0x%08lx\n", g_settings.fwVersion);
-  tft.printf("FactoryInit: %d\n", g_settings.factoryInitialized);
+  drawScreen(g_currentScreen, STATE_CHG_ALL);
+}
+
+bool uiRefresh(uint32_t changed, uint32_t inputUs) {
+  if (!prepareCanvas()) return false;
+  markScreen(g_currentScreen, changed, inputUs);
+  return flushDirty(false);
+}
+
+bool uiFlush() {
+  return flushDirty(false);
+}
+
+void uiInvalidate() {
+  s_drawnScreen = SCREEN_COUNT;
+}
 
-  tft.println();
-  tft.println("Short: DispOff cycle");
-  tft.println("Long : FactoryInit toggle");
+void getUiRenderStats(UiRenderStats &out) {
+  out = s_renderStats;
 }
 
 
@@ -150,71 +1024,91 @@ void drawSettingsScreen() {
 //==============================================================================
 
 void handleTankClick(bool shortClick, bool longClick) {
-  if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    logEvent("handleTankClick: mutex timeout");
-    return;
-  }
+  // 펌프/조명 상태는 모듈 ACK를 받으면 바뀌므로 여기서는 현재 값의 반대를 요청만 합니다.
+  SystemState st;
+  snapshotState(st);
 
   if (shortClick) {
     // 펌프 토글
-    g_state.tank.pumpOn = !g_state.tank.pumpOn;
-    bool on = g_state.tank.pumpOn;
-    xSemaphoreGive(g_stateMutex);
-
-    requestTankPump(on);
+    requestTankPump(!st.tank.pumpOn);
   } else if (longClick) {
     // 조명 토글
-    g_state.tank.lightOn = !g_state.tank.lightOn;
-    bool on = g_state.tank.lightOn;
-    xSemaphoreGive(g_stateMutex);
-
-    requestTankLight(on);
-  } else {
-    xSemaphoreGive(g_stateMutex);
+    requestTankLight(!st.tank.lightOn);
   }
 }
 
 void handleGrowClick(bool shortClick, bool longClick) {
-  if (xSemaphoreTake(g_stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    logEvent("handleGrowClick: mutex timeout");
-    return;
-  }
-
   if (shortClick) {
-    // LED 밝기 0 → 50 → 100 → 0 순환
-    uint8_t b = g_state.grow.ledBrightness;
-    if (b == 0)      b = 50;
-    else if (b == 50) b = 100;
-    else             b = 0;
-
-    g_state.grow.ledBrightness   = b;
-    g_settings.growLedBrightness = b;
-    xSemaphoreGive(g_stateMutex);
-
-    // 설정 저장 및 CAN 전송
-    saveSettings();
-    requestGrowLedBrightness(b);
+    // LED 밝기 입력 시작/끝. 입력 중에는 엔코더 회전이 화면 전환 대신 handleGrowTurn()으로 감
+    s_growLedEdit = !s_growLedEdit;
+    statePublishChanges(STATE_CHG_SETTINGS);
   } else if (longClick) {
     // 누수 플래그 리셋 + 에러 해제
+    stateWriteBegin();
     g_state.grow.leak[0] = false;
     g_state.grow.leak[1] = false;
     g_state.grow.leak[2] = false;
     g_state.grow.leak[3] = false;
     g_state.hasError     = false;
-    xSemaphoreGive(g_stateMutex);
+    stateWriteEnd();
+    statePublishChanges(STATE_CHG_GROW | STATE_CHG_SYSTEM);
 
-    logEvent("Grow leaks reset (long click)");
-  } else {
-    xSemaphoreGive(g_stateMutex);
+    logEvent(LOG_GROW_LEAKS_RESET);
   }
 }
 
+bool handleGrowTurn(int16_t steps) {
+  if (!s_growLedEdit) return false;
+
+  // 빨리 돌릴수록 한 스텝에 더 많이 (0 → 100%를 한 바퀴 안쪽으로)
+  int32_t speed = getEncoderVelocity();
+  if (speed < 0) speed = -speed;
+  int32_t increment = speed >= ENCODER_FASTER_STEPS_PER_S ? ENCODER_FASTER_INCREMENT :
+                      speed >= ENCODER_FAST_STEPS_PER_S   ? ENCODER_FAST_INCREMENT : 1;
+
+  int32_t b = (int32_t)g_settings.growLedBrightness + steps * increment;
+  if (b < 0)   b = 0;
+  if (b > 100) b = 100;
+  if (b == g_settings.growLedBrightness) return true;
+
+  // 설정 저장(연속 변경은 모아서 씀) 및 CAN 전송 (표시값은 모듈 ACK 후 바뀜)
+  g_settings.growLedBrightness = (uint8_t)b;
+  saveSettings();
+  requestGrowLedBrightness((uint8_t)b);
+  return true;
+}
+
 void handleLogClick(bool shortClick, bool longClick) {
   if (longClick) {
-    clearLogs();
+    // 보관 로그를 보던 중이면 실시간으로, 실시간이면 화면 로그 지우기 (플래시 기록은 남음)
+    if (s_logPage) s_logPage = 0;
+    else           clearLogs();
   } else if (shortClick) {
-    logEvent("Log screen short click");
+    // 한 페이지 이전으로. 가장 오래된 페이지 다음은 다시 실시간
+    if (!loadOlderLogPage()) s_logPage = 0;
+  }
+  statePublishChanges(STATE_CHG_LOG);
+}
+
+void handleTrendClick(bool shortClick, bool longClick) {
+  if (shortClick) {
+    // 시간 창 순환: 원본 → 1분 요약 → 15분 요약 → 원본
+    s_graphTier = (HistoryTier)((s_graphTier + 1) % HIST_TIER_COUNT);
+    s_graphReload = true;
+  } else if (longClick) {
+    s_graphRefit = true;
+  }
+  statePublishChanges(STATE_CHG_HISTORY);
+}
+
+void handleDiagClick(bool shortClick, bool longClick) {
+  if (shortClick) {
+    // 루프 시간 구간을 볼 태스크를 차례로
+    s_profSel = (ProfileTask)((s_profSel + 1) % PROF_TASK_COUNT);
+  } else if (longClick) {
+    profileReset();
   }
+  statePublishChanges(STATE_CHG_PROFILE);
 }
 
 void handleSettingsClick(bool shortClick, bool longClick) {
@@ -229,16 +1123,14 @@ void handleSettingsClick(bool shortClick, bool longClick) {
     g_settings.displayOffMinutes = v;
     saveSettings();
 
-    logEvent(("Settings: displayOffMinutes = " + String(v)).c_str());
+    logEvent(LOG_SET_DISPLAY_OFF, v);
   }
   else if (longClick) {
     // 공장 초기화 플래그 토글 (예시)
     g_settings.factoryInitialized = !g_settings.factoryInitialized;
     saveSettings();
 
-    logEvent(g_settings.factoryInitialized
-             ? "Settings: factoryInitialized = 1"
-             : "Settings: factoryInitialized = 0");
+    logEvent(LOG_SET_FACTORY_INIT, g_settings.factoryInitialized);
   }
 }
 
@@ -1,56 +1,79 @@
 #ifndef UI_H
 #define UI_H
 
+#include <Arduino.h>
+
 /**
  * @file UI.h
  * @brief UI 관련 함수(화면 그리기, 클릭 핸들러)들의 선언을 포함합니다.
  * 
  * 이 함수들의 실제 구현은 UI.cpp 파일에 있습니다.
+ *
+ * 화면은 보존형(retained)으로 그립니다. 각 화면은 UI.cpp의 위젯 표(고정 텍스트, 그리고
+ * 라벨 + 상태 필드 + 포맷 + 색으로 된 값 칸)로만 선언하며, 위치와 상자는 컴파일 시점에
+ * 계산·검사됩니다. 화면이 바뀔 때만 전체를 그리고, 그 뒤로는 포맷한 문자열이
+ * 이전과 달라진 값 칸만 다시 그립니다. 새 화면은 표만 추가하면 됩니다.
+ *
+ * 패널에 직접 그리지 않고 오프스크린 캔버스(글자 한 줄 크기)에 그린 뒤, 바뀐 사각형을
+ * 렌더 조각으로 제출합니다. 실제 SPI 전송은 렌더 태스크가 DMA로 합니다. (Render.h)
+ *
+ * 추이 그래프 화면은 센서 이력(History.h)의 칸 하나를 열 하나로 그립니다. 새 칸이 생기면
+ * 열 링을 한 칸 밀고(스크롤), 8열 묶음(타일)마다 선이 실제로 바뀐 높이만
+ * 타일 스프라이트에 다시 그려 보내므로 그래프 전체를 다시 보내지 않습니다.
+ */
+
+/**
+ * @brief 화면 갱신 통계 (SPI 전송량은 ILI9341 기준 추정치). 진단 화면의 "UI avg" 줄에도 보입니다.
  */
+struct UiRenderStats {
+  uint32_t fullRedraws;     // 전체 지우고 다시 그린 횟수 (화면 전환/무효화)
+  uint32_t partialRedraws;  // 바뀐 칸만 그린 갱신 횟수
+  uint32_t cellsRepainted;  // 다시 그린 값 칸 수 (누적)
+  uint32_t lastSpiBytes;    // 마지막 갱신 한 번에 제출한 SPI 전송량
+  uint64_t totalSpiBytes;   // 누적 SPI 전송량
+};
 
 //==============================================================================
 // UI 화면 그리기 함수
 //==============================================================================
 
 /**
- * @brief g_currentScreen 값에 따라 현재 화면을 다시 그립니다.
+ * @brief g_currentScreen 값에 따라 현재 화면을 갱신합니다.
+ *
+ * 직전에 그린 화면과 같으면 값이 바뀐 칸만 다시 그립니다.
+ * uiRefresh()와 달리 조각 버퍼를 기다려서라도 끝까지 제출하고 돌아갑니다.
  */
 void drawCurrentScreen();
 
 /**
- * @brief 대시보드 화면을 그립니다.
- */
-void drawDashboard();
-
-/**
- * @brief 수조(Tank) 상세 화면을 그립니다.
- */
-void drawTankScreen();
-
-/**
- * @brief 재배기(Grow) 상세 화면을 그립니다.
- */
-void drawGrowScreen();
-
-/**
- * @brief 양액기(Nutrient) 상세 화면을 그립니다.
+ * @brief 상태 변경 알림(STATE_CHG_* 비트)을 받아 현재 화면에서 해당 값 칸만 갱신합니다.
+ *
+ * 현재 화면이 바뀐 부분을 표시하지 않으면 아무것도 하지 않습니다.
+ * 화면이 전환된 뒤 처음 호출되면 비트와 관계없이 전체를 그립니다.
+ * 조각 버퍼가 모두 전송 중이면 기다리지 않고 남은 부분을 표시만 해 둡니다.
+ * @param changed 마지막 갱신 이후 모인 STATE_CHG_* 비트
+ * @param inputUs 이 갱신에 반영되는 가장 이른 입력 시각 (입력→패널 지연 측정용, 없으면 0)
+ * @return 아직 그리지 못한 부분이 남았으면 true (UI_NOTIFY_RENDER 후 uiFlush())
  */
-void drawNutrientScreen();
+bool uiRefresh(uint32_t changed, uint32_t inputUs);
 
 /**
- * @brief 급여기(Feeder) 상세 화면을 그립니다.
+ * @brief uiRefresh()가 남겨 둔 부분을 조각 버퍼가 허락하는 만큼 이어 그립니다.
+ * @return 아직 남았으면 true
  */
-void drawFeederScreen();
+bool uiFlush();
 
 /**
- * @brief 로그(Log) 화면을 그립니다.
+ * @brief 패널 내용을 알 수 없게 되었음을 알립니다. (다음 갱신은 전체 다시 그리기)
+ *
+ * UI 밖에서 화면에 직접 그렸거나 패널을 다시 켰을 때 호출합니다.
  */
-void drawLogScreen();
+void uiInvalidate();
 
 /**
- * @brief 설정(Settings) 화면을 그립니다.
+ * @brief 화면 갱신 통계를 복사합니다. (taskUi와 같은 태스크에서 호출)
  */
-void drawSettingsScreen();
+void getUiRenderStats(UiRenderStats &out);
 
 
 //==============================================================================
@@ -71,6 +94,14 @@ void handleTankClick(bool shortClick, bool longClick);
  */
 void handleGrowClick(bool shortClick, bool longClick);
 
+/**
+ * @brief 재배기 화면에서 엔코더 회전을 처리합니다. LED 밝기 입력 중이면 회전 속도에 따라
+ * 한 스텝에 1/5/10%씩 바꿉니다.
+ * @param steps 회전 스텝 수 (부호는 방향)
+ * @return 값 입력에 썼으면 true (화면 전환에 쓰지 않음)
+ */
+bool handleGrowTurn(int16_t steps);
+
 /**
  * @brief 설정 화면에서 버튼 클릭 이벤트를 처리합니다.
  * @param shortClick 짧은 클릭이면 true
@@ -80,10 +111,32 @@ void handleSettingsClick(bool shortClick, bool longClick);
 
 /**
  * @brief 로그 화면에서 버튼 클릭 이벤트를 처리합니다.
+ *
+ * 짧은 클릭은 플래시 보관 로그의 이전 페이지로, 긴 클릭은 실시간 보기로 돌아가거나
+ * (이미 실시간이면) 화면 로그를 지웁니다.
  * @param shortClick 짧은 클릭이면 true
  * @param longClick 긴 클릭이면 true
  */
 void handleLogClick(bool shortClick, bool longClick);
 
+/**
+ * @brief 추이 그래프 화면에서 버튼 클릭 이벤트를 처리합니다.
+ *
+ * 짧은 클릭은 시간 창(원본 약 5분 → 1분 요약 약 5시간 → 15분 요약 약 3일)을 바꾸고,
+ * 긴 클릭은 세로 축을 지금 보이는 값에 다시 맞춥니다. 시간 창은 그래프 화면끼리 공유합니다.
+ * @param shortClick 짧은 클릭이면 true
+ * @param longClick 긴 클릭이면 true
+ */
+void handleTrendClick(bool shortClick, bool longClick);
+
+/**
+ * @brief 진단 화면에서 버튼 클릭 이벤트를 처리합니다.
+ *
+ * 짧은 클릭은 루프 시간 중앙값/99% 구간을 볼 태스크를 바꾸고, 긴 클릭은 프로파일 누적값을 초기화합니다.
+ * @param shortClick 짧은 클릭이면 true
+ * @param longClick 긴 클릭이면 true
+ */
+void handleDiagClick(bool shortClick, bool longClick);
+
 
 #endif // UI_H
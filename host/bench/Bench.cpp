@@ -0,0 +1,164 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "Globals.h"
+#include "FlashLog.h"
+#include "History.h"
+#include "Indicator.h"
+#include "Schedule.h"
+#include "Rules.h"
+
+/**
+ * @file Bench.cpp
+ * @brief 호스트 벤치마크 러너의 공통 도구 구현입니다.
+ */
+
+//==============================================================================
+// 힙 할당 집계 (전역 operator new 대체)
+//==============================================================================
+
+namespace {
+std::atomic<uint64_t> s_allocCount{0};
+}
+
+void *operator new(size_t size) {
+  s_allocCount.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) {
+  s_allocCount.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+uint64_t benchAllocCount() {
+  return s_allocCount.load(std::memory_order_relaxed);
+}
+
+
+//==============================================================================
+// 펌웨어 초기화
+//==============================================================================
+
+void benchInitFirmware() {
+  Serial.begin(115200);
+  initPins();
+  indicatorInit();
+  initTft();
+
+  prefs.begin("aq_main", false);
+  loadSettings();
+
+  resetSystemState();
+
+  flashLogInit();
+  historyInit();
+  scheduleInit();
+  rulesInit();
+
+  initCan();
+  initUart();
+
+  g_serverCmdQueue  = xQueueCreate(16, sizeof(ServerCommand));
+}
+
+
+//==============================================================================
+// 측정 / 출력
+//==============================================================================
+
+BenchResult benchRun(const BenchCase &c, const BenchOptions &opt) {
+  using Clock = std::chrono::steady_clock;
+
+  if (c.setup) c.setup();
+
+  const uint32_t iters = (c.maxIters && c.maxIters < opt.iters) ? c.maxIters : opt.iters;
+
+  // 워밍업 (캐시, 지연 초기화 영향 제거)
+  uint32_t warmup = iters / 10 + 1;
+  for (uint32_t i = 0; i < warmup; ++i) {
+    if (c.prepare) c.prepare(i);
+    c.op(i);
+  }
+  if (c.extraTotal) c.extraTotal(); // 워밍업 구간의 지표는 버림
+
+  std::vector<double> samples;
+  samples.reserve(iters);
+  double totalUs = 0;
+  uint64_t allocBefore = benchAllocCount();
+  uint64_t allocPrepare = 0;
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    if (c.prepare) {
+      uint64_t a = benchAllocCount();
+      c.prepare(i);
+      allocPrepare += benchAllocCount() - a;
+    }
+    Clock::time_point t0 = Clock::now();
+    c.op(i);
+    Clock::time_point t1 = Clock::now();
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    samples.push_back(us);
+    totalUs += us;
+  }
+
+  uint64_t allocs = benchAllocCount() - allocBefore - allocPrepare;
+  if (c.teardown) c.teardown();
+
+  BenchResult r;
+  r.name = c.name;
+  r.iters = iters;
+  std::sort(samples.begin(), samples.end());
+  r.meanUs = totalUs / iters;
+  r.p50Us = samples[samples.size() / 2];
+  r.p99Us = samples[std::min(samples.size() - 1, (size_t)(samples.size() * 0.99))];
+  r.maxUs = samples.back();
+  r.opsPerSec = totalUs > 0 ? iters / (totalUs / 1e6) : 0;
+  // 측정 중 벡터 확장은 없으므로(reserve) 집계된 할당은 모두 op에서 발생한 것입니다.
+  r.allocsPerOp = (double)allocs / iters;
+  r.extraLabel = c.extraLabel;
+  if (c.extraTotal) r.extraPerOp = c.extraTotal() / iters;
+  return r;
+}
+
+void benchPrintHeader(const BenchOptions &opt) {
+  if (opt.csv) {
+    printf("case,iters,ops_per_s,mean_us,p50_us,p99_us,max_us,allocs_per_op,extra_label,extra_per_op\n");
+  } else {
+    printf("%-34s %8s %12s %9s %9s %9s %9s %9s  %s\n",
+           "case", "iters", "ops/s", "mean(us)", "p50(us)", "p99(us)", "max(us)",
+           "allocs/op", "extra");
+  }
+}
+
+void benchPrintResult(const BenchResult &r, const BenchOptions &opt) {
+  if (opt.csv) {
+    printf("%s,%u,%.0f,%.3f,%.3f,%.3f,%.3f,%.2f,%s,%.1f\n",
+           r.name.c_str(), r.iters, r.opsPerSec, r.meanUs, r.p50Us, r.p99Us, r.maxUs,
+           r.allocsPerOp, r.extraLabel.c_str(), r.extraPerOp);
+  } else {
+    char extra[64] = "";
+    if (!r.extraLabel.empty()) {
+      snprintf(extra, sizeof(extra), "%.1f %s", r.extraPerOp, r.extraLabel.c_str());
+    }
+    printf("%-34s %8u %12.0f %9.3f %9.3f %9.3f %9.3f %9.2f  %s\n",
+           r.name.c_str(), r.iters, r.opsPerSec, r.meanUs, r.p50Us, r.p99Us, r.maxUs,
+           r.allocsPerOp, extra);
+  }
+  fflush(stdout);
+}
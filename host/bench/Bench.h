@@ -0,0 +1,72 @@
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file Bench.h
+ * @brief 호스트 벤치마크 러너의 공통 도구(측정, 집계, 출력)입니다.
+ */
+
+/**
+ * @brief 벤치마크 한 케이스의 측정 결과
+ */
+struct BenchResult {
+  std::string name;
+  uint32_t iters = 0;
+  double opsPerSec = 0;
+  double meanUs = 0;
+  double p50Us = 0;
+  double p99Us = 0;
+  double maxUs = 0;
+  double allocsPerOp = 0;
+  std::string extraLabel;    // 케이스별 추가 지표 이름 (예: "spiB/op")
+  double extraPerOp = 0;     // 케이스별 추가 지표 값
+};
+
+/**
+ * @brief 벤치마크 케이스 정의
+ *  - setup : 측정 전 1회 호출
+ *  - prepare : 매 반복 직전 호출 (측정 시간에서 제외)
+ *  - op : 측정 대상 (반복 인덱스를 받음)
+ *  - teardown : 측정 후 1회 호출 (예: setup에서 띄운 경합 스레드 정리)
+ *  - extra : 반복 전체에 대한 추가 지표 합계를 돌려줌 (선택)
+ *  - maxIters : 한 번에 수 ms씩 걸리는 케이스의 반복 상한 (0: 제한 없음)
+ */
+struct BenchCase {
+  std::string name;
+  std::function<void()> setup;
+  std::function<void(uint32_t)> prepare;
+  std::function<void(uint32_t)> op;
+  std::function<void()> teardown;
+  std::string extraLabel;
+  std::function<double()> extraTotal;
+  uint32_t maxIters = 0;
+};
+
+struct BenchOptions {
+  uint32_t iters = 20000;
+  std::string filter;
+  bool csv = false;
+  uint32_t spiHz = 0;        // 0이 아니면 TFT SPI 전송 시간을 실제로 소모
+};
+
+/**
+ * @brief 펌웨어 setup()과 같은 순서로 전역 상태/동기화 객체를 초기화합니다.
+ * 태스크는 생성하지 않으므로 각 케이스가 함수를 직접 호출해 측정합니다.
+ */
+void benchInitFirmware();
+
+/**
+ * @brief 현재까지 전역 operator new가 호출된 횟수
+ */
+uint64_t benchAllocCount();
+
+BenchResult benchRun(const BenchCase &c, const BenchOptions &opt);
+void benchPrintHeader(const BenchOptions &opt);
+void benchPrintResult(const BenchResult &r, const BenchOptions &opt);
+
+#endif // HOST_BENCH_H
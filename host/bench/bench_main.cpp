@@ -0,0 +1,1356 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "Globals.h"
+#include "Protocol.h"
+#include "StateStore.h"
+#include "CanDecode.h"
+#include "CanCommand.h"
+#include "UI.h"
+#include "Input.h"
+#include "Render.h"
+#include "EventLog.h"
+#include "FlashLog.h"
+#include "History.h"
+#include "Settings.h"
+#include "Indicator.h"
+#include "Schedule.h"
+#include "Rules.h"
+#include "Profile.h"
+#include "Trace.h"
+#include <esp_partition.h>
+
+/**
+ * @file bench_main.cpp
+ * @brief 메인 컨트롤러 핫패스 벤치마크 러너
+ *
+ * 사용법: bench [--iters N] [--filter 부분문자열] [--csv] [--spi-hz HZ]
+ *
+ * --spi-hz를 주면(예: 40000000) 화면 그리기가 SPI 전송 시간만큼 실제로
+ * CPU를 점유하므로, 렌더링 지연까지 포함한 수치를 볼 수 있습니다.
+ */
+
+namespace {
+
+twai_message_t makeFrame(uint32_t id, const uint8_t *data, uint8_t dlc) {
+  twai_message_t msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.identifier = id;
+  msg.data_length_code = dlc;
+  memcpy(msg.data, data, dlc);
+  return msg;
+}
+
+/**
+ * @brief 모든 모듈이 온라인인 전형적인 운전 상태를 만듭니다.
+ */
+void fillTypicalState() {
+  const uint8_t tank[8] = {24, 80, 68, 45, 3, 72, 0, 0};
+  const uint8_t grow[8] = {26, 55, 0x00, 0, 0, 0, 0, 0};
+  handleCanFrame(makeFrame(0x010, tank, 8));
+  handleCanFrame(makeFrame(0x020, grow, 8));
+
+  stateWriteBegin();
+  g_state.nutrient.status = MODULE_OK;
+  g_state.nutrient.levelPercent = 63.5f;
+  for (int i = 0; i < 4; ++i) g_state.nutrient.channelRatio[i] = 25.0f;
+  g_state.feeder.status = MODULE_OK;
+  g_state.feeder.feedLevelPercent = 41.0f;
+  g_state.serverConnected = true;
+  g_state.lastServerRxMs = millis();
+  stateWriteEnd();
+
+  for (int i = 0; i < 8; ++i) logEvent(LOG_LOG_SCREEN_CLICK);
+}
+
+/**
+ * @brief setup/teardown 사이에 다른 코어의 태스크처럼 fn을 계속 돌리는 경합 스레드
+ */
+struct Contender {
+  std::atomic<bool> run{false};
+  std::thread th;
+
+  void start(std::function<void()> fn) {
+    run = true;
+    th = std::thread([this, fn] { while (run.load(std::memory_order_relaxed)) fn(); });
+  }
+  void stop() {
+    run = false;
+    if (th.joinable()) th.join();
+  }
+};
+
+const uint8_t kTankPayload[8] = {24, 80, 68, 45, 3, 72, 0, 0};
+
+// 모듈 시뮬레이터: 명령 프레임이 버스에 나가면 같은 seq로 ACK를 돌려줍니다.
+// s_ackDropEvery가 N(>0)이면 N번째 ACK마다 하나를 버립니다. (손실 링크 흉내)
+// s_silentModule이 모듈 ID(>0)면 그 모듈은 ACK를 돌려주지 않습니다. (꺼진 모듈 흉내)
+std::atomic<uint32_t> s_ackDropEvery{0};
+std::atomic<uint32_t> s_ackCount{0};
+std::atomic<uint32_t> s_silentModule{0};
+
+void moduleSimAck(const twai_message_t *cmd) {
+  if ((cmd->identifier & ~0x7Fu) != CAN_ID_CMD_BASE) return;
+  if (s_silentModule.load() == (cmd->identifier & 0x7F)) return;
+  uint32_t every = s_ackDropEvery.load();
+  if (every && s_ackCount.fetch_add(1) % every == 0) return;
+
+  uint8_t ack[3] = { cmd->data[0], cmd->data[5], CAN_ACK_OK };
+  twai_message_t msg = makeFrame(CAN_ID_ACK_BASE | (cmd->identifier & 0x7F), ack, sizeof(ack));
+  hostCanInjectRx(&msg);
+}
+
+// taskUi를 (처음 한 번만) 띄우고 첫 화면을 다 그릴 때까지 기다립니다.
+void startUiTask(ScreenId screen) {
+  static bool started = false;
+  g_currentScreen = screen;
+  g_lastScreenEncPos = g_encoderPos;  // 앞 케이스가 돌려 둔 엔코더 위치를 화면 전환으로 읽지 않도록
+  if (!started) {
+    started = true;
+    xTaskCreatePinnedToCore(taskUi, "UI_Task", 4096, nullptr, 2, &g_taskUiHandle, 1);
+  }
+  delay(100);
+}
+
+// 렌더 태스크를 (처음 한 번만) 띄웁니다. 이후 화면 조각은 DMA로 나갑니다.
+void startRenderTask() {
+  if (!g_taskRenderHandle) {
+    xTaskCreatePinnedToCore(taskRender, "Render_Task", 4096, nullptr, 3, &g_taskRenderHandle, 1);
+  }
+}
+
+// 플래시 로그 기록 태스크를 (처음 한 번만) 띄웁니다. 이후 flashLogFlush()는 이 태스크만 부릅니다.
+void startFlashLogTask() {
+  if (!g_taskFlashLogHandle) {
+    xTaskCreatePinnedToCore(taskFlashLog, "FlashLog_Task", 3072, nullptr, 1, &g_taskFlashLogHandle, 0);
+  }
+}
+
+// 판정 태스크를 (처음 한 번만) 띄웁니다. 이후 100ms마다 오프라인 판정/자동 규칙을 돌립니다.
+void startLogicTask() {
+  if (!g_taskLogicHandle) {
+    xTaskCreatePinnedToCore(taskLogic, "Logic_Task", 4096, nullptr, 2, &g_taskLogicHandle, 0);
+  }
+}
+
+// 제출한 프레임이 모두 패널에 나갈 때까지 기다립니다.
+void waitRenderIdle(uint32_t frames) {
+  RenderStats r;
+  do {
+    std::this_thread::yield();
+    getRenderStats(r);
+  } while (r.frames < frames);
+}
+
+// 엔코더를 n칸 돌립니다. +1: A가 먼저 떨어짐 (A,B = 11 → 01 → 00 → 10 → 11)
+// edgeGapUs: 에지 사이 간격 (0이면 쉬지 않음)
+void spinDetents(uint32_t n, int dir, uint32_t edgeGapUs) {
+  const uint8_t first  = dir > 0 ? PIN_ROTARY_A : PIN_ROTARY_B;
+  const uint8_t second = dir > 0 ? PIN_ROTARY_B : PIN_ROTARY_A;
+  for (uint32_t k = 0; k < n; ++k) {
+    hostSetPinLevel(first, LOW);
+    if (edgeGapUs) delayMicroseconds(edgeGapUs);
+    hostSetPinLevel(second, LOW);
+    if (edgeGapUs) delayMicroseconds(edgeGapUs);
+    hostSetPinLevel(first, HIGH);
+    if (edgeGapUs) delayMicroseconds(edgeGapUs);
+    hostSetPinLevel(second, HIGH);
+    if (edgeGapUs) delayMicroseconds(edgeGapUs);
+  }
+}
+
+std::vector<BenchCase> buildCases() {
+  std::vector<BenchCase> cases;
+
+  //----------------------------------------------------------------------------
+  // CAN 수신 → 상태 반영
+  //----------------------------------------------------------------------------
+  {
+    static twai_message_t frames[2];
+    BenchCase c;
+    c.name = "can/handleCanFrame";
+    c.setup = [] {
+      const uint8_t tank[8] = {24, 80, 68, 45, 3, 72, 0, 0};
+      const uint8_t grow[8] = {26, 55, 0x00, 0, 0, 0, 0, 0};
+      frames[0] = makeFrame(0x010, tank, 8);
+      frames[1] = makeFrame(0x020, grow, 8);
+    };
+    c.op = [](uint32_t i) {
+      frames[i & 1].data[0] = (uint8_t)(20 + (i & 7));
+      handleCanFrame(frames[i & 1]);
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // CAN 디코드 표: ID별 디코드 비용 (상태 복사본에 반영, 쓰기 구간 제외)
+  //----------------------------------------------------------------------------
+  {
+    static const uint32_t kIds[] = {0x010, 0x011, 0x020, 0x030, 0x040, 0x055};
+    for (uint32_t id : kIds) {
+      char name[40];
+      snprintf(name, sizeof(name), "can/decode/0x%03x", (unsigned)id);
+      BenchCase c;
+      c.name = name;
+      c.op = [id](uint32_t i) {
+        static SystemState st;
+        const uint8_t data[8] = {24, 80, 68, 45, 0x05, 72, 1, 2};
+        twai_message_t msg = makeFrame(id, data, 8);
+        msg.data[0] = (uint8_t)(20 + (i & 7));
+        canDecodeFrame(st, msg, i);
+      };
+      cases.push_back(c);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // CAN 수신 버스트 16프레임: 프레임마다 반영 vs 스테이징 링 + 배치 반영
+  //----------------------------------------------------------------------------
+  {
+    static twai_message_t burst[16];
+    static CanRxStats before;
+    auto setup = [] {
+      const uint8_t tank[8] = {24, 80, 68, 45, 3, 72, 0, 0};
+      const uint8_t grow[8] = {26, 55, 0x00, 0, 0, 0, 0, 0};
+      for (int k = 0; k < 16; ++k) burst[k] = makeFrame((k & 1) ? 0x020 : 0x010, (k & 1) ? grow : tank, 8);
+      getCanRxStats(before);
+    };
+
+    BenchCase perFrame;
+    perFrame.name = "can/burst16/handleCanFrame";
+    perFrame.setup = setup;
+    perFrame.op = [](uint32_t) {
+      for (int k = 0; k < 16; ++k) handleCanFrame(burst[k]);
+    };
+    cases.push_back(perFrame);
+
+    BenchCase ring;
+    ring.name = "can/burst16/rxRing";
+    ring.setup = setup;
+    ring.op = [](uint32_t) {
+      for (int k = 0; k < 16; ++k) canRxPush(burst[k]);
+      while (canRxApplyPending(CAN_RX_APPLY_BATCH) > 0) {
+      }
+    };
+    ring.extraLabel = "lost/op";
+    ring.extraTotal = [] {
+      CanRxStats now;
+      getCanRxStats(now);
+      double lost = now.overflowDrops - before.overflowDrops;
+      before = now;
+      return lost;
+    };
+    cases.push_back(ring);
+  }
+
+  //----------------------------------------------------------------------------
+  // 상태 JSON 생성 (UART 송신 1회분)
+  //----------------------------------------------------------------------------
+  {
+    static double bytes = 0;
+    BenchCase c;
+    c.name = "uart/buildStatusJson";
+    c.setup = [] { bytes = 0; };
+    c.op = [](uint32_t) {
+      static char buf[STATUS_JSON_MAX_LEN];
+      bytes += buildStatusJson(buf, sizeof(buf));
+    };
+    c.extraLabel = "B/op";
+    c.extraTotal = [] { double b = bytes; bytes = 0; return b; };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 상태 바이너리 프레임 생성 (UART 송신 1회분, 바이너리 모드)
+  //----------------------------------------------------------------------------
+  {
+    static double bytes = 0;
+    BenchCase c;
+    c.name = "uart/buildStatusFrame";
+    c.setup = [] { bytes = 0; };
+    c.op = [](uint32_t) {
+      static uint8_t buf[FRAME_MAX_ENCODED];
+      bytes += buildStatusFrame(buf, sizeof(buf));
+    };
+    c.extraLabel = "B/op";
+    c.extraTotal = [] { double b = bytes; bytes = 0; return b; };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 텔레메트리 스트림 (taskUart 10ms 루프 1회 = op 1회, 가상 시간)
+  //  - CAN 센서 프레임이 100ms마다 들어오고 가끔 1LSB씩 흔들리는 전형적인 상황
+  //  - extra는 링크 점유량(B/s)
+  //----------------------------------------------------------------------------
+  {
+    struct StreamVariant { const char *name; LinkMode link; TelemetryMode mode; };
+    static const StreamVariant kVariants[] = {
+      { "uart/stream/text-full",    LINK_MODE_TEXT,   TELEMETRY_MODE_FULL  },
+      { "uart/stream/text-delta",   LINK_MODE_TEXT,   TELEMETRY_MODE_DELTA },
+      { "uart/stream/binary-full",  LINK_MODE_BINARY, TELEMETRY_MODE_FULL  },
+      { "uart/stream/binary-delta", LINK_MODE_BINARY, TELEMETRY_MODE_DELTA },
+    };
+    static uint32_t vnow = 1000000;  // 케이스 사이에도 단조 증가하는 가상 시각
+    static double bytes = 0;
+    static uint32_t rng = 12345;
+
+    for (const StreamVariant &v : kVariants) {
+      BenchCase c;
+      c.name = v.name;
+      c.setup = [v] {
+        g_linkMode = v.link;
+        setTelemetryMode(v.mode);
+        requestTelemetryKeyframe();
+        bytes = 0;
+      };
+      c.prepare = [](uint32_t i) {
+        vnow += 10;
+        if (i % 10 != 0) return;
+        // 약 3% 확률로 한 센서 값이 1LSB 흔들림
+        rng = rng * 1103515245u + 12345u;
+        uint8_t jitter = ((rng >> 16) % 100) < 3 ? 1 : 0;
+        const uint8_t tank[8] = {24, 80, (uint8_t)(70 + jitter), 45, 3, 72, 0, 0};
+        const uint8_t grow[8] = {26, 55, 0x00, 0, 0, 0, 0, 0};
+        handleCanFrame(makeFrame(0x010, tank, 8));
+        handleCanFrame(makeFrame(0x020, grow, 8));
+      };
+      c.op = [](uint32_t) {
+        static uint8_t buf[STATUS_JSON_MAX_LEN];
+        bytes += buildTelemetryUpdate(buf, sizeof(buf), vnow);
+      };
+      c.extraLabel = "linkB/s";
+      c.extraTotal = [] { double b = bytes * 100.0; bytes = 0; return b; };
+      cases.push_back(c);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // 상태 스냅샷 복사 (경합 없음)
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "state/snapshotState";
+    c.op = [](uint32_t) {
+      static SystemState snap;
+      snapshotState(snap);
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 태스크 프로파일: 루프 한 번에 더해지는 계측 비용 (시작/끝 한 쌍)
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "profile/loopBeginEnd";
+    c.op = [](uint32_t) {
+      profileLoopBegin(PROF_TASK_UART);
+      profileLoopEnd(PROF_TASK_UART);
+    };
+    c.teardown = [] { profileReset(); };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 명령 추적: 명령 하나가 거치는 시각 기록 전부 (시작 + 단계 6개)
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "trace/stampPath";
+    c.op = [](uint32_t) {
+      uint16_t id = traceBegin(MODULE_TANK, TANK_CMD_SET_PUMP);
+      for (uint8_t st = TRACE_STAGE_QUEUED; st < TRACE_STAGE_COUNT; ++st) traceStamp(id, (TraceStage)st);
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 경합: CAN 수신이 쉬지 않고 쓰는 동안의 스냅샷 / UI가 계속 읽는 동안의 CAN 반영
+  //----------------------------------------------------------------------------
+  {
+    static Contender contender;
+    static StateSyncStats before;
+
+    BenchCase c;
+    c.name = "state/snapshotState+canWriter";
+    c.setup = [] {
+      contender.start([] { handleCanFrame(makeFrame(0x010, kTankPayload, 8)); });
+      getStateSyncStats(before);
+    };
+    c.op = [](uint32_t) {
+      static SystemState snap;
+      snapshotState(snap);
+    };
+    c.teardown = [] { contender.stop(); };
+    c.extraLabel = "retries/op";
+    c.extraTotal = [] {
+      StateSyncStats now;
+      getStateSyncStats(now);
+      double r = now.readRetries - before.readRetries;
+      before = now;
+      return r;
+    };
+    cases.push_back(c);
+  }
+  {
+    static Contender contender;
+
+    BenchCase c;
+    c.name = "can/handleCanFrame+uiReader";
+    c.setup = [] {
+      contender.start([] {
+        static SystemState snap;
+        snapshotState(snap);
+      });
+    };
+    c.op = [](uint32_t) { handleCanFrame(makeFrame(0x010, kTankPayload, 8)); };
+    c.teardown = [] { contender.stop(); };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 이벤트 로그: 레코드 기록 / 다른 태스크도 계속 기록하는 동안
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "log/logEvent";
+    c.op = [](uint32_t i) { logEvent(LOG_CAN_RX_LOST, 1, (int32_t)i, 0); };
+    cases.push_back(c);
+  }
+  {
+    static Contender contender;
+    static LogStats before;
+
+    BenchCase c;
+    c.name = "log/logEvent+writer";
+    c.setup = [] {
+      contender.start([] { logEvent(LOG_CAN_TX_DROPPED, 1); });
+      getLogStats(before);
+    };
+    c.op = [](uint32_t i) { logEvent(LOG_CAN_RX_LOST, 1, (int32_t)i, 0); };
+    c.teardown = [] { contender.stop(); };
+    c.extraLabel = "busyDrops/op";
+    c.extraTotal = [] {
+      LogStats now;
+      getLogStats(now);
+      double r = now.busyDrops - before.busyDrops;
+      before = now;
+      return r;
+    };
+    cases.push_back(c);
+  }
+  {
+    BenchCase c;
+    c.name = "log/format";
+    c.prepare = [](uint32_t i) { logEvent(LOG_CAN_RX_LOST, 1, (int32_t)i, 0); };
+    c.op = [](uint32_t) {
+      LogRecord rec;
+      char line[64];
+      if (logRead(logNextSeq() - 1, rec)) logFormat(rec, line, sizeof(line), true);
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 플래시 보관 로그: 모아 쓰기 / 재부팅 마운트 / 내보내기 / 기록 태스크가 도는 동안의 logEvent
+  //----------------------------------------------------------------------------
+  {
+    static HostFlashStats before;
+
+    BenchCase c;
+    c.name = "flashlog/flush16";
+    c.setup = [] { hostFlashGetStats(&before); };
+    c.prepare = [](uint32_t i) {
+      for (int k = 0; k < 16; ++k) logEvent(LOG_CAN_TX_DROPPED, (int32_t)i);
+    };
+    c.op = [](uint32_t) { flashLogFlush(); };
+    c.extraLabel = "flashBusyUs/op";
+    c.extraTotal = [] {
+      HostFlashStats now;
+      hostFlashGetStats(&now);
+      double r = (double)(now.busyUs - before.busyUs);
+      before = now;
+      return r;
+    };
+    c.maxIters = 300;
+    cases.push_back(c);
+  }
+  {
+    BenchCase c;
+    c.name = "flashlog/mount";
+    c.prepare = [](uint32_t) { clearLogs(); };  // 재부팅하면 RAM 링은 비어 있음
+    c.op = [](uint32_t) { flashLogInit(); };  // 재부팅: 세그먼트 검색 + 부팅 레코드 기록
+    c.maxIters = 100;
+    cases.push_back(c);
+  }
+  {
+    BenchCase c;
+    c.name = "flashlog/exportRecord";
+    c.prepare = [](uint32_t) {
+      ServerCommand cmd = { MODULE_SYSTEM, SYS_CMD_EXPORT_FLASH_LOG, 1, 0 };
+      handleServerCommand(cmd);
+    };
+    c.op = [](uint32_t) {
+      static uint8_t buf[STATUS_JSON_MAX_LEN];
+      buildFlashLogExport(buf, sizeof(buf));
+    };
+    cases.push_back(c);
+  }
+
+  {
+    static FlashLogStats before;
+
+    BenchCase c;
+    c.name = "flashlog/logEvent+flusher";
+    c.setup = [] {
+      startFlashLogTask();  // 이후 케이스에서도 계속 돎 (flushN/mount보다 뒤에 둠)
+      getFlashLogStats(before);
+    };
+    c.prepare = [](uint32_t) { delay(1); };  // 초당 1000건 (실제보다 훨씬 잦음)
+    c.op = [](uint32_t i) { logEvent(LOG_CAN_RX_LOST, 1, (int32_t)i, 0); };
+    c.extraLabel = "lost/op";
+    c.extraTotal = [] {
+      FlashLogStats now;
+      getFlashLogStats(now);
+      double r = now.lost - before.lost;
+      before = now;
+      return r;
+    };
+    c.maxIters = 300;
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 센서 이력: 1초 샘플 / 10분 원본·24시간 1분 요약 조회
+  //----------------------------------------------------------------------------
+  {
+    static SystemState st;
+    static uint32_t    t;
+
+    BenchCase c;
+    c.name = "history/sample";
+    c.setup = [] {
+      historyInit();
+      snapshotState(st);
+      st.tank.status = MODULE_OK;
+      st.grow.status = MODULE_OK;
+      t = 0;
+    };
+    c.op = [](uint32_t i) {
+      st.tank.tempC = 24.0f + (float)(i % 50) * 0.01f;
+      historySample(++t, st);
+    };
+    cases.push_back(c);
+  }
+  {
+    static HistoryPoint pts[HISTORY_MINUTE_POINTS];
+    static uint32_t     newest;
+
+    auto fillDay = [] {
+      historyInit();
+      SystemState st;
+      snapshotState(st);
+      st.tank.status = MODULE_OK;
+      st.grow.status = MODULE_OK;
+      for (uint32_t t = 1; t <= 86400; ++t) {
+        st.tank.tempC = 24.0f + (float)(t % 600) * 0.01f;
+        historySample(t, st);
+      }
+      historyNewest(HIST_TIER_RAW, newest);
+    };
+
+    BenchCase raw;
+    raw.name = "history/query/raw600";
+    raw.setup = fillDay;
+    raw.op = [](uint32_t) {
+      historyQuery(HIST_TANK_TEMP, HIST_TIER_RAW, newest - 599, newest, pts, HISTORY_RAW_POINTS);
+    };
+    cases.push_back(raw);
+
+    BenchCase day;
+    day.name = "history/query/minute1440";
+    day.setup = fillDay;
+    day.op = [](uint32_t) {
+      historyQuery(HIST_TANK_TEMP, HIST_TIER_MINUTE, newest - 86399, newest, pts, HISTORY_MINUTE_POINTS);
+    };
+    cases.push_back(day);
+  }
+
+  //----------------------------------------------------------------------------
+  // 설정 저장: UI 쪽 saveSettings() / 연속 10번 변경 후 한 번 저장 / 부팅 때 블롭 읽기
+  //  - nvsWrites/op: Preferences put 호출 수 (예전 필드별 키 방식은 클릭마다 11번)
+  //----------------------------------------------------------------------------
+  {
+    auto nvsWrites = [] {
+      double r = prefs.hostWriteCount();
+      prefs.hostResetStats();
+      return r;
+    };
+
+    BenchCase click;
+    click.name = "settings/saveClick";
+    click.setup = [] { settingsFlush(); prefs.hostResetStats(); };
+    click.op = [](uint32_t i) {
+      g_settings.growLedBrightness = (uint8_t)(i % 100);
+      saveSettings();
+    };
+    click.teardown = [] { settingsFlush(); };
+    click.extraLabel = "nvsWrites/op";
+    click.extraTotal = nvsWrites;
+    cases.push_back(click);
+
+    BenchCase burst;
+    burst.name = "settings/burst10+flush";
+    burst.setup = [] { settingsFlush(); prefs.hostResetStats(); };
+    burst.prepare = [](uint32_t i) {
+      for (uint32_t k = 0; k < 10; ++k) {
+        g_settings.growLedBrightness = (uint8_t)((i * 10 + k) % 100);
+        saveSettings();
+      }
+    };
+    burst.op = [](uint32_t) { settingsFlush(); };
+    burst.extraLabel = "nvsWrites/op";
+    burst.extraTotal = nvsWrites;
+    cases.push_back(burst);
+
+    BenchCase load;
+    load.name = "settings/load";
+    load.op = [](uint32_t) { loadSettings(); };
+    cases.push_back(load);
+  }
+
+  //----------------------------------------------------------------------------
+  // 예약 실행: 예약 31개 (매일 서로 다른 분 + 15분 간격 몇 개, Fail-safe 전용이라 동작은 건너뜀)
+  //  - tickSecond : 분이 안 바뀐 1초 틱 (대부분의 호출)
+  //  - tickMinute : 1분 틱 (정시/자정 내려 보내기 포함, 평균)
+  //----------------------------------------------------------------------------
+  {
+    auto fill = [] {
+      scheduleHandleCommand(SYS_CMD_SCHEDULE_CLEAR, 0);
+      for (uint32_t slot = 1; slot < SCHEDULE_MAX_ENTRIES; ++slot) {
+        uint32_t when = (slot % 8 == 0)
+            ? SCHED_INTERVAL | (15u << SCHED_PERIOD_SHIFT) | (slot % 15)
+            : (SCHED_DOW_ALL << SCHED_DOW_SHIFT) | ((slot * 47) % 1440);
+        scheduleHandleCommand(SYS_CMD_SCHEDULE_ACTION,
+                              (slot << 24) | (MODULE_TANK << 16) | (TANK_CMD_SET_PUMP << 8) | 1);
+        scheduleHandleCommand(SYS_CMD_SCHEDULE_SET,
+                              (slot << SCHED_SLOT_SHIFT) | SCHED_FAILSAFE_ONLY | when);
+      }
+    };
+
+    BenchCase sec;
+    sec.name = "schedule/tickSecond";
+    sec.setup = fill;
+    sec.op = [](uint32_t) { scheduleTick(true); };
+    sec.teardown = [] { scheduleHandleCommand(SYS_CMD_SCHEDULE_CLEAR, 0); };
+    cases.push_back(sec);
+
+    BenchCase min;
+    min.name = "schedule/tickMinute";
+    min.setup = fill;
+    min.prepare = [](uint32_t) { g_uptimeSeconds += 60; };
+    min.op = [](uint32_t) { scheduleTick(true); };
+    min.teardown = [] { scheduleHandleCommand(SYS_CMD_SCHEDULE_CLEAR, 0); };
+    cases.push_back(min);
+  }
+
+  //----------------------------------------------------------------------------
+  // 자동 규칙: 128개 규칙 (탱크 채널마다 32개)에서 한 주기 평가 비용
+  //  - evalChanged   : 용존산소 값만 바뀐 주기 (그 채널의 명령열만 실행)
+  //  - evalUnchanged : 탱크 상태는 왔지만 값이 같은 주기 (명령열 실행 없음)
+  //----------------------------------------------------------------------------
+  {
+    static SystemState st;
+    static RulesStats before;
+    auto fill = [] {
+      rulesHandleCommand(SYS_CMD_RULE_CLEAR, 0);
+      for (uint32_t slot = 0; slot < RULES_MAX; ++slot) {
+        uint32_t ch  = slot % 4;
+        uint32_t thr = 20000 + slot * 50;  // 값이 닿지 않는 임계값 (동작 없이 평가만)
+        rulesHandleCommand(SYS_CMD_RULE_CONDITION,
+                           (slot << RULE_SLOT_SHIFT) | (ch << RULE_CHANNEL_SHIFT) | (RULE_CMP_ABOVE << RULE_CMP_SHIFT) | thr);
+        rulesHandleCommand(SYS_CMD_RULE_ACTION,
+                           (slot << RULE_SLOT_SHIFT) | (MODULE_TANK << RULE_MODULE_SHIFT) |
+                           (TANK_CMD_SET_PUMP << RULE_COMMAND_SHIFT) | (1 << 8) | 0);
+      }
+      memset(&st, 0, sizeof(st));
+      st.tank.status = MODULE_OK;
+      st.serverConnected = true;
+      rulesEvaluate(st, STATE_CHG_TANK);
+      getRulesStats(before);
+    };
+    auto steps = [] {
+      RulesStats now;
+      getRulesStats(now);
+      double d = now.steps - before.steps;
+      before = now;
+      return d;
+    };
+
+    BenchCase changed;
+    changed.name = "rules/evalChanged";
+    changed.setup = fill;
+    changed.prepare = [](uint32_t i) { st.tank.do_mgL = (i & 1) ? 6.0f : 6.5f; };
+    changed.op = [](uint32_t) { rulesEvaluate(st, STATE_CHG_TANK); };
+    changed.teardown = [] { rulesHandleCommand(SYS_CMD_RULE_CLEAR, 0); };
+    changed.extraLabel = "steps/op";
+    changed.extraTotal = steps;
+    cases.push_back(changed);
+
+    BenchCase same;
+    same.name = "rules/evalUnchanged";
+    same.setup = fill;
+    same.op = [](uint32_t) { rulesEvaluate(st, STATE_CHG_TANK); };
+    same.teardown = [] { rulesHandleCommand(SYS_CMD_RULE_CLEAR, 0); };
+    same.extraLabel = "steps/op";
+    same.extraTotal = steps;
+    cases.push_back(same);
+  }
+
+  //----------------------------------------------------------------------------
+  // 부저/LED 패턴: UI 클릭음 비용 (예전에는 delay(50)) / 경보가 울리는 동안 깨어나는 횟수
+  //  - wakeups/op: 100ms 동안의 단계 타이머 콜백 수 (예전 taskAlarm은 50ms마다 = 2회)
+  //----------------------------------------------------------------------------
+  {
+    BenchCase click;
+    click.name = "indicator/playClick";
+    click.op = [](uint32_t) { playClickBuzzer(); };
+    cases.push_back(click);
+
+    static IndicatorStats before;
+
+    BenchCase alarm;
+    alarm.name = "indicator/alarmWarning100ms";
+    alarm.maxIters = 30;
+    alarm.setup = [] {
+      indicatorPlay(IND_PATTERN_ALARM_WARNING);
+      getIndicatorStats(before);
+    };
+    alarm.op = [](uint32_t) { delay(100); };
+    alarm.teardown = [] { indicatorStop(IND_PATTERN_ALARM_WARNING); };
+    alarm.extraLabel = "wakeups/op";
+    alarm.extraTotal = [] {
+      IndicatorStats now;
+      getIndicatorStats(now);
+      double r = now.timerFires - before.timerFires;
+      before = now;
+      return r;
+    };
+    cases.push_back(alarm);
+  }
+
+  //----------------------------------------------------------------------------
+  // 서버 명령 한 줄 파싱
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "uart/parseServerLine";
+    c.prepare = [](uint32_t) { xQueueReset(g_serverCmdQueue); };
+    c.op = [](uint32_t i) {
+      static const String lines[2] = {String("CMD,1,1,1"), String("CMD,2,1,75")};
+      parseServerLine(lines[i & 1]);
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 서버 명령 프레임 수신 (바이트 디코딩 + 큐 투입 + ACK 송신)
+  //----------------------------------------------------------------------------
+  {
+    static uint8_t wire[FRAME_MAX_ENCODED];
+    static size_t wireLen = 0;
+    static FrameDecoder dec;
+    BenchCase c;
+    c.name = "uart/handleServerFrame";
+    c.setup = [] {
+      const uint8_t record[COMMAND_RECORD_LEN] = {MODULE_TANK, TANK_CMD_SET_PUMP, 1, 0, 0, 0};
+      wireLen = buildFrame(FRAME_COMMAND, 7, record, sizeof(record), wire, sizeof(wire));
+      frameDecoderInit(dec);
+    };
+    c.prepare = [](uint32_t) { xQueueReset(g_serverCmdQueue); };
+    c.op = [](uint32_t) {
+      Frame frame;
+      for (size_t i = 0; i < wireLen; ++i) {
+        if (frameDecoderPush(dec, wire[i], frame) == 1) handleServerFrame(frame);
+      }
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 화면 그리기 (화면별)
+  //----------------------------------------------------------------------------
+  static const char *kScreenNames[SCREEN_COUNT] = {
+    "dashboard", "tank", "trendTemp", "trendPh", "trendDo", "grow", "nutrient", "feeder", "log",
+    "settings", "diag"
+  };
+  for (int s = 0; s < SCREEN_COUNT; ++s) {
+    BenchCase c;
+    c.name = std::string("ui/drawCurrentScreen/") + kScreenNames[s];
+    c.setup = [s] {
+      g_currentScreen = (ScreenId)s;
+      tft.hostResetSpiStats();
+    };
+    c.op = [](uint32_t) { drawCurrentScreen(); };
+    c.extraLabel = "spiB/op";
+    c.extraTotal = [] {
+      double b = (double)tft.hostSpiBytes();
+      tft.hostResetSpiStats();
+      return b;
+    };
+    cases.push_back(c);
+
+    // 화면 전환 직후처럼 전체를 다시 그리는 비용
+    BenchCase full = c;
+    full.name = std::string("ui/screenChange/") + kScreenNames[s];
+    full.prepare = [](uint32_t) { uiInvalidate(); };
+    cases.push_back(full);
+  }
+
+  // 수조 화면을 보고 있는 동안 수온 프레임이 들어와 한 칸만 바뀐 경우
+  {
+    BenchCase c;
+    c.name = "ui/refresh/tankTempChanged";
+    c.setup = [] {
+      g_currentScreen = SCREEN_TANK;
+      drawCurrentScreen();
+      tft.hostResetSpiStats();
+    };
+    c.prepare = [](uint32_t i) {
+      uint8_t tank[8] = {24, 80, 68, 45, 3, 72, 0, 0};
+      tank[0] = (uint8_t)(20 + (i & 7));
+      handleCanFrame(makeFrame(0x010, tank, 8));
+    };
+    c.op = [](uint32_t) { drawCurrentScreen(); };
+    c.extraLabel = "spiB/op";
+    c.extraTotal = [] {
+      double b = (double)tft.hostSpiBytes();
+      tft.hostResetSpiStats();
+      return b;
+    };
+    cases.push_back(c);
+  }
+
+  // pH 추이 그래프를 보고 있는 동안 1초 샘플이 하나 들어온 경우 (한 열 스크롤)
+  {
+    static SystemState st;
+    static uint32_t    t;
+
+    BenchCase c;
+    c.name = "ui/trend/newSample";
+    c.setup = [] {
+      historyInit();
+      snapshotState(st);
+      st.tank.status = MODULE_OK;
+      for (t = 1; t <= 400; ++t) {
+        st.tank.pH = 7.0f + 0.15f * sinf((float)t * 0.05f);
+        historySample(t, st);
+      }
+      g_currentScreen = SCREEN_TREND_PH;
+      uiInvalidate();
+      drawCurrentScreen();
+      tft.hostResetSpiStats();
+    };
+    c.prepare = [](uint32_t) {
+      ++t;
+      st.tank.pH = 7.0f + 0.15f * sinf((float)t * 0.05f);
+      historySample(t, st);
+    };
+    c.op = [](uint32_t) { uiRefresh(STATE_CHG_HISTORY, 0); };
+    c.extraLabel = "spiB/op";
+    c.extraTotal = [] {
+      double b = (double)tft.hostSpiBytes();
+      tft.hostResetSpiStats();
+      return b;
+    };
+    cases.push_back(c);
+
+    // 비교: 같은 그래프를 매번 처음부터 다시 그리는 경우
+    BenchCase full = c;
+    full.name = "ui/trend/fullRedraw";
+    full.prepare = [](uint32_t) { uiInvalidate(); };
+    full.op = [](uint32_t) { drawCurrentScreen(); };
+    cases.push_back(full);
+  }
+
+  //----------------------------------------------------------------------------
+  // taskCan 실행 중 종단 간 측정 (500 kbit/s 가상 버스, TX 큐 5)
+  //  - cmdLatency : enqueueCanCommand() → 프레임이 버스에 나감 (프레임 시간 약 0.24 ms 포함)
+  //  - rxLatency  : 드라이버가 프레임 수신 → snapshotState()에 보임
+  //  - txBurst12  : 급여 명령 12개(합쳐지지 않는 일반 명령 최대치)를 한꺼번에 넣고
+  //                 모두 나갈 때까지 (frames/s)
+  //----------------------------------------------------------------------------
+  {
+    static auto startCanTasks = [] {
+      static bool started = false;
+      if (started) return;
+      started = true;
+      hostCanSetTxHook(moduleSimAck);
+      xTaskCreatePinnedToCore(taskCanAlert, "CAN_Alert", 2048, nullptr, 4, &g_taskCanAlertHandle, 0);
+      xTaskCreatePinnedToCore(taskCan,      "CAN_Task",   4096, nullptr, 3, &g_taskCanHandle,      0);
+      delay(20);
+    };
+    static auto drainTxLog = [] {
+      while (hostCanTakeTx(nullptr, nullptr)) {
+      }
+    };
+
+    BenchCase lat;
+    lat.name = "can/task/cmdLatency";
+    lat.maxIters = 300;
+    lat.setup = [] { startCanTasks(); drainTxLog(); };
+    lat.prepare = [](uint32_t) { delay(1); };
+    lat.op = [](uint32_t i) {
+      uint32_t n0 = hostCanTxCount();
+      enqueueCanCommand(MODULE_TANK, TANK_CMD_SET_PUMP, (int32_t)(i & 1));
+      while (hostCanTxCount() == n0) std::this_thread::yield();
+    };
+    cases.push_back(lat);
+
+    BenchCase rx;
+    rx.name = "can/task/rxLatency";
+    rx.maxIters = 300;
+    rx.setup = [] { startCanTasks(); };
+    rx.prepare = [](uint32_t) { delay(1); };
+    rx.op = [](uint32_t i) {
+      uint8_t data[8] = {0, 80, 68, 45, 3, 72, 0, 0};
+      data[0] = (uint8_t)(10 + (i % 20));
+      twai_message_t msg = makeFrame(0x010, data, 8);
+      hostCanInjectRx(&msg);
+      SystemState st;
+      do {
+        std::this_thread::yield();
+        snapshotState(st);
+      } while (st.tank.tempC != data[0]);
+    };
+    cases.push_back(rx);
+
+    // 이전 케이스가 남긴 송신이 모두 버스에 나갈 때까지 기다리고 TX 로그를 비웁니다.
+    static auto waitTxIdle = [] {
+      uint32_t last = hostCanTxCount();
+      for (;;) {
+        delay(3);
+        uint32_t n = hostCanTxCount();
+        if (n == last) break;
+        last = n;
+      }
+      drainTxLog();
+    };
+
+    // 엔코더를 빠르게 돌려 LED 밝기 설정이 20번 연달아 들어온 경우 버스에 나간 프레임 수
+    static uint32_t spinFrames = 0;
+    BenchCase spin;
+    spin.name = "can/task/ledSpin20";
+    spin.maxIters = 100;
+    spin.setup = [] { startCanTasks(); waitTxIdle(); spinFrames = 0; };
+    spin.prepare = [](uint32_t) { waitTxIdle(); };
+    spin.op = [](uint32_t i) {
+      uint32_t n0 = hostCanTxCount();
+      for (int k = 0; k < 20; ++k) {
+        enqueueCanCommand(MODULE_GROW, GROW_CMD_SET_LED_BRIGHTNESS, (int32_t)((i * 20 + k) % 101));
+      }
+      waitTxIdle();
+      spinFrames += hostCanTxCount() - n0;
+    };
+    spin.extraLabel = "frames/op";
+    spin.extraTotal = [] { double f = spinFrames; spinFrames = 0; return f; };
+    cases.push_back(spin);
+
+    // 급여 명령 12개가 밀려 있는 상태에서 펌프 OFF가 버스에 나가기까지의 시간
+    BenchCase safety;
+    safety.name = "can/task/pumpOffBehind12";
+    safety.maxIters = 100;
+    safety.setup = [] { startCanTasks(); waitTxIdle(); };
+    safety.prepare = [](uint32_t) { waitTxIdle(); };
+    safety.op = [](uint32_t) {
+      for (int k = 0; k < 12; ++k) enqueueCanCommand(MODULE_FEEDER, FEEDER_CMD_FEED_ONCE, 10);
+      enqueueCanCommand(MODULE_TANK, TANK_CMD_SET_PUMP, 0);
+      twai_message_t msg;
+      for (;;) {
+        if (hostCanTakeTx(&msg, nullptr)) {
+          if (msg.identifier == (0x100u | MODULE_TANK) && msg.data[0] == TANK_CMD_SET_PUMP) break;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    };
+    cases.push_back(safety);
+
+    // 응답 없는 급여기로 간 명령이 ACK 대기 표를 채운 상태에서 펌프 OFF가 버스에 나가기까지
+    // (남겨 둔 자리가 없으면 재전송이 모두 끝날 때까지 약 200ms를 기다림)
+    BenchCase silent;
+    silent.name = "can/task/pumpOffInFlightFull";
+    silent.maxIters = 20;
+    silent.setup = [] { startCanTasks(); waitTxIdle(); s_silentModule = MODULE_FEEDER; };
+    silent.prepare = [](uint32_t) {
+      delay(CAN_CMD_ACK_TIMEOUT_MS * (CAN_CMD_MAX_RETRIES + 2));  // 이전 반복의 명령이 시간 초과로 빠질 때까지
+      waitTxIdle();
+      for (size_t k = 0; k < CAN_CMD_INFLIGHT; ++k) enqueueCanCommand(MODULE_FEEDER, FEEDER_CMD_FEED_ONCE, 10);
+      delay(5);
+      drainTxLog();
+    };
+    silent.op = [](uint32_t) {
+      enqueueCanCommand(MODULE_TANK, TANK_CMD_SET_PUMP, 0);
+      twai_message_t msg;
+      for (;;) {
+        if (hostCanTakeTx(&msg, nullptr)) {
+          if (msg.identifier == (0x100u | MODULE_TANK) && msg.data[0] == TANK_CMD_SET_PUMP) break;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    };
+    silent.teardown = [] {
+      s_silentModule = 0;
+      delay(CAN_CMD_ACK_TIMEOUT_MS * (CAN_CMD_MAX_RETRIES + 2));
+      waitTxIdle();
+    };
+    cases.push_back(silent);
+
+    static double burstFrames = 0, burstUs = 0;
+    static uint32_t burstOps = 0;
+    BenchCase burst;
+    burst.name = "can/task/txBurst12";
+    burst.maxIters = 100;
+    burst.setup = [] { startCanTasks(); waitTxIdle(); };
+    burst.prepare = [](uint32_t) { waitTxIdle(); };
+    burst.op = [](uint32_t i) {
+      uint32_t t0 = micros();
+      uint32_t n0 = hostCanTxCount();
+      for (int k = 0; k < 12; ++k) enqueueCanCommand(MODULE_FEEDER, FEEDER_CMD_FEED_ONCE, (int32_t)((i + k) % 101));
+      while (hostCanTxCount() - n0 < 12) std::this_thread::yield();
+      burstFrames += 12;
+      burstUs += micros() - t0;
+      burstOps++;
+    };
+    burst.extraLabel = "frames/s";
+    burst.extraTotal = [] {
+      // benchRun이 반복 수로 나누므로 평균 처리량에 반복 수를 곱해 돌려줍니다.
+      double total = burstUs > 0 ? burstFrames / (burstUs / 1e6) * burstOps : 0;
+      burstFrames = burstUs = 0;
+      burstOps = 0;
+      return total;
+    };
+    cases.push_back(burst);
+
+    // 펌프 토글 요청부터 모듈 ACK로 g_state.tank.pumpOn이 바뀌기까지 (UI에 보이는 시점)
+    static uint32_t ackRetx0 = 0;
+    static auto cmdRetransmits = [] {
+      CanCmdStats s;
+      getCanCmdTotals(s);
+      return s.retransmits;
+    };
+    static auto pumpToggleUntilAcked = [](uint32_t i) {
+      bool on = (i & 1) != 0;
+      enqueueCanCommand(MODULE_TANK, TANK_CMD_SET_PUMP, on ? 1 : 0);
+      SystemState st;
+      do {
+        std::this_thread::yield();
+        snapshotState(st);
+      } while (st.tank.pumpOn != on);
+    };
+
+    BenchCase ack;
+    ack.name = "can/task/cmdAckRtt";
+    ack.maxIters = 300;
+    ack.setup = [] { startCanTasks(); waitTxIdle(); ackRetx0 = cmdRetransmits(); };
+    ack.prepare = [](uint32_t) { drainTxLog(); };
+    ack.op = pumpToggleUntilAcked;
+    ack.extraLabel = "retx/op";
+    ack.extraTotal = [] { return (double)(cmdRetransmits() - ackRetx0); };
+    cases.push_back(ack);
+
+    // ACK 두 개 중 하나가 사라지는 링크: 재전송(CAN_CMD_ACK_TIMEOUT_MS)으로 회복하는 시간
+    BenchCase lossy;
+    lossy.name = "can/task/cmdAckLoss50";
+    lossy.maxIters = 60;
+    lossy.setup = [] {
+      startCanTasks();
+      waitTxIdle();
+      s_ackDropEvery = 2;
+      ackRetx0 = cmdRetransmits();
+    };
+    lossy.prepare = [](uint32_t) { drainTxLog(); };
+    lossy.op = pumpToggleUntilAcked;
+    lossy.teardown = [] { s_ackDropEvery = 0; };
+    lossy.extraLabel = "retx/op";
+    lossy.extraTotal = [] { return (double)(cmdRetransmits() - ackRetx0); };
+    cases.push_back(lossy);
+
+    // 서버 "CMD,1,1,x" 한 줄 → taskUart 디스패치 → 모듈 ACK까지 (추적 레코드의 ACK 단계로 판단)
+    //  taskUart의 10ms 주기 대기는 빼고, 줄을 읽은 직후 디스패치하는 경우
+    static uint32_t lineOps = 0;
+    BenchCase line;
+    line.name = "trace/pumpLineToAck";
+    line.maxIters = 300;
+    line.setup = [] { startCanTasks(); waitTxIdle(); };
+    line.prepare = [](uint32_t) { drainTxLog(); xQueueReset(g_serverCmdQueue); };
+    line.op = [](uint32_t i) {
+      static const String lines[2] = {String("CMD,1,1,0"), String("CMD,1,1,1")};
+      lineOps++;
+      parseServerLine(lines[i & 1]);
+      ServerCommand cmd;
+      if (xQueueReceive(g_serverCmdQueue, &cmd, 0) != pdTRUE) return;
+      traceStamp(cmd.traceId, TRACE_STAGE_DISPATCH);
+      handleServerCommand(cmd);
+      TraceRecord r;
+      while (traceRead(cmd.traceId, r) && !(r.reached & (1u << TRACE_STAGE_ACK))) {
+        std::this_thread::yield();
+      }
+    };
+    line.extraLabel = "ackP99us";
+    line.extraTotal = [] {
+      // 링에 남은 최근 명령의 p99. benchRun이 반복 수로 나누므로 반복 수를 곱해 돌려줍니다.
+      TraceStageStats st;
+      traceStageStats(TRACE_STAGE_ACK, st);
+      double total = (double)st.cumP99Us * lineOps;
+      lineOps = 0;
+      return total;
+    };
+    cases.push_back(line);
+  }
+
+  //----------------------------------------------------------------------------
+  // 로터리 엔코더 (GPIO ISR + 이벤트 링)
+  //  - isr/detent : 디텐트 한 칸(A/B 에지 4개 → ISR 4회)과 updateRotary() 소비까지
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "input/isr/detent";
+    c.op = [](uint32_t i) {
+      spinDetents(1, (i & 1) ? -1 : +1, 0);
+      updateRotary();
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 렌더 태스크 + DMA (SPI 40MHz로 전송 시간을 재현)
+  //  - screenChange  : 화면 전환 때 uiRefresh() 한 번이 taskUi를 잡고 있는 시간.
+  //                    조각 버퍼가 모두 전송 중이면 나머지는 남기고 돌아옴 (다음 준비에서 마저 그림)
+  //                    cpu%는 그동안 렌더 태스크의 CPU 점유율
+  //----------------------------------------------------------------------------
+  static uint32_t savedSpiHz = 0;
+  static RenderStats render0;
+  static auto renderSetup = [] {
+    savedSpiHz = tft.hostSpiClockHz();
+    tft.hostSetSpiClockHz(40000000);
+    startRenderTask();
+    getRenderStats(render0);
+  };
+  static auto renderCpuShare = [] {
+    RenderStats r;
+    getRenderStats(r);
+    double runUs = (double)(r.runUs - render0.runUs);
+    return runUs > 0 ? 100.0 * (double)(r.busyUs - render0.busyUs) / runUs : 0;
+  };
+  {
+    static uint32_t framesSubmitted = 0;
+    BenchCase c;
+    c.name = "ui/render/screenChange";
+    c.maxIters = 200;
+    c.setup = [] {
+      renderSetup();
+      g_currentScreen = SCREEN_TANK;
+      framesSubmitted = render0.frames;
+    };
+    c.prepare = [](uint32_t) {
+      while (uiFlush()) std::this_thread::yield();
+      waitRenderIdle(framesSubmitted);
+      uiInvalidate();
+    };
+    c.op = [](uint32_t) {
+      uiRefresh(STATE_CHG_ALL, 0);
+      framesSubmitted++;
+    };
+    c.teardown = [] {
+      while (uiFlush()) std::this_thread::yield();
+      waitRenderIdle(framesSubmitted);
+      tft.hostSetSpiClockHz(savedSpiHz);
+    };
+    c.extraLabel = "cpu%";
+    c.extraTotal = [] { return renderCpuShare() * 200; };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // taskUi 실행 중 종단 간 측정
+  //  - valueToPanel : 수온 프레임 반영(handleCanFrame) → 해당 칸이 패널에 다시 그려짐
+  //                   (직전 프레임과 UI_MIN_FRAME_MS 이상 떨어진 경우)
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "ui/task/valueToPanel";
+    c.maxIters = 200;
+    c.setup = [] { startUiTask(SCREEN_TANK); };
+    c.prepare = [](uint32_t) { delay(UI_MIN_FRAME_MS + 5); };
+    c.op = [](uint32_t) {
+      static uint8_t temp = 10;
+      UiRenderStats before, now;
+      getUiRenderStats(before);
+      uint8_t tank[8] = {24, 80, 68, 45, 3, 72, 0, 0};
+      temp = (uint8_t)(temp >= 29 ? 10 : temp + 1);  // 매번 다른 값
+      tank[0] = temp;
+      handleCanFrame(makeFrame(0x010, tank, 8));
+      do {
+        std::this_thread::yield();
+        getUiRenderStats(now);
+      } while (now.cellsRepainted == before.cellsRepainted);
+    };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // taskUi가 화면을 그리는 동안 빠르게 돌리기
+  //  - spinWhileDrawing : 24칸을 칸당 1ms(1000 스텝/s)로 돌림. 스텝마다 화면이 바뀌어
+  //                       전체 다시 그리기가 이어지는 동안 ISR이 에지를 받아 둡니다.
+  //                       taskUi가 24스텝을 모두 반영할 때까지의 시간, lost/op는 잃은 스텝 수
+  //----------------------------------------------------------------------------
+  {
+    static uint32_t lostSteps = 0;
+    BenchCase c;
+    c.name = "ui/task/spinWhileDrawing";
+    c.maxIters = 100;
+    c.setup = [] { startUiTask(SCREEN_DASHBOARD); };
+    c.prepare = [](uint32_t) { delay(UI_MIN_FRAME_MS + 5); };
+    c.op = [](uint32_t i) {
+      const uint32_t kDetents = 24;
+      InputStats before, now;
+      getInputStats(before);
+      spinDetents(kDetents, (i & 1) ? -1 : +1, 250);
+      uint32_t t0 = millis();
+      do {
+        std::this_thread::yield();
+        getInputStats(now);
+      } while (now.steps - before.steps < kDetents && millis() - t0 < 500);
+      lostSteps += kDetents - (now.steps - before.steps);
+    };
+    c.extraLabel = "lost/op";
+    c.extraTotal = [] {
+      double total = lostSteps;
+      lostSteps = 0;
+      return total;
+    };
+    cases.push_back(c);
+  }
+
+
+
+  //----------------------------------------------------------------------------
+  // 입력→패널 지연: 엔코더 한 칸(ISR) → 화면 전환이 패널에 다 나갈 때까지 (SPI 40MHz)
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "ui/task/inputToPhoton";
+    c.maxIters = 100;
+    c.setup = [] { renderSetup(); startUiTask(SCREEN_TANK); };
+    c.prepare = [](uint32_t) { delay(UI_MIN_FRAME_MS + 5); };
+    c.op = [](uint32_t i) {
+      RenderStats before, now;
+      getRenderStats(before);
+      spinDetents(1, (i & 1) ? -1 : +1, 0);
+      do {
+        std::this_thread::yield();
+        getRenderStats(now);
+      } while (now.photonCount == before.photonCount);
+    };
+    c.teardown = [] { tft.hostSetSpiClockHz(savedSpiHz); };
+    c.extraLabel = "cpu%";
+    c.extraTotal = [] { return renderCpuShare() * 100; };
+    cases.push_back(c);
+  }
+
+  //----------------------------------------------------------------------------
+  // 자동 규칙을 실제 경로로: 탱크 CAN 프레임(handleCanFrame)으로 용존산소가 5.00을 넘나들면
+  // taskLogic이 다음 주기(100ms)에 규칙 동작을 보낼 때까지. 판정 태스크는 계속 돌기 때문에 맨 뒤에 둡니다.
+  //----------------------------------------------------------------------------
+  {
+    BenchCase c;
+    c.name = "rules/task/canFrameToAction";
+    c.maxIters = 40;
+    c.setup = [] {
+      rulesHandleCommand(SYS_CMD_RULE_CLEAR, 0);
+      uint32_t thr = 5u * historyScale(HIST_TANK_DO);
+      rulesHandleCommand(SYS_CMD_RULE_CONDITION,
+                         (HIST_TANK_DO << RULE_CHANNEL_SHIFT) | (RULE_CMP_BELOW << RULE_CMP_SHIFT) | thr);
+      rulesHandleCommand(SYS_CMD_RULE_ACTION,
+                         (MODULE_TANK << RULE_MODULE_SHIFT) | (TANK_CMD_SET_PUMP << RULE_COMMAND_SHIFT) |
+                         (1 << 8) | 0);
+      fillTypicalState();  // 용존산소 7.2
+      startLogicTask();
+      delay(250);          // 부팅 때처럼 첫 평가를 마치게 둠
+    };
+    c.op = [](uint32_t) {
+      static bool low = false;  // 워밍업 뒤에도 번갈아 넘나들도록 반복 번호 대신 직전 값 기준
+      low = !low;
+      uint8_t tank[8] = {24, 80, 68, 45, 3, 72, 0, 0};
+      tank[5] = low ? 40 : 60;  // 4.0 (충족) / 6.0 (해제)
+      RulesStats before, now;
+      getRulesStats(before);
+      handleCanFrame(makeFrame(0x010, tank, 8));
+      uint32_t t0 = millis();
+      do {
+        std::this_thread::yield();
+        getRulesStats(now);
+      } while (now.fired == before.fired && millis() - t0 < 1000);
+    };
+    c.teardown = [] { rulesHandleCommand(SYS_CMD_RULE_CLEAR, 0); };
+    cases.push_back(c);
+  }
+  return cases;
+}
+
+void usage(const char *argv0) {
+  fprintf(stderr, "usage: %s [--iters N] [--filter SUBSTR] [--csv] [--spi-hz HZ] [--list]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  BenchOptions opt;
+  bool listOnly = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--iters") && i + 1 < argc) {
+      opt.iters = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+      opt.filter = argv[++i];
+    } else if (!strcmp(argv[i], "--spi-hz") && i + 1 < argc) {
+      opt.spiHz = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--csv")) {
+      opt.csv = true;
+    } else if (!strcmp(argv[i], "--list")) {
+      listOnly = true;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (opt.iters == 0) opt.iters = 1;
+
+  benchInitFirmware();
+  fillTypicalState();
+  tft.hostSetSpiClockHz(opt.spiHz);
+
+  std::vector<BenchCase> cases = buildCases();
+  if (listOnly) {
+    for (const BenchCase &c : cases) printf("%s\n", c.name.c_str());
+    return 0;
+  }
+
+  benchPrintHeader(opt);
+  for (const BenchCase &c : cases) {
+    if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+    benchPrintResult(benchRun(c, opt), opt);
+  }
+
+  // 태스크 스레드가 남아 있을 수 있으므로 전역 소멸자를 거치지 않고 종료합니다.
+  fflush(stdout);
+  _Exit(0);
+}
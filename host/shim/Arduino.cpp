@@ -0,0 +1,92 @@
+#include "Arduino.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file Arduino.cpp
+ * @brief 시간/GPIO API의 호스트 구현입니다.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Clock::time_point kBootTime = Clock::now();
+
+const int kPinCount = 64;
+std::atomic<int> s_pinLevel[kPinCount];
+std::atomic<uint8_t> s_pinMode[kPinCount];
+
+// GPIO 인터럽트: s_isrLock으로 ISR 실행을 직렬화합니다. (단일 GPIO ISR 디스패처 흉내)
+std::recursive_mutex s_isrLock;
+void (*s_isr[kPinCount])(void);
+int s_isrMode[kPinCount];
+
+} // namespace
+
+uint32_t millis() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      Clock::now() - kBootTime).count();
+}
+
+uint32_t micros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      Clock::now() - kBootTime).count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= kPinCount) return;
+  s_pinMode[pin] = mode;
+  // 풀업 입력은 아무것도 연결되지 않았을 때 HIGH로 읽힙니다.
+  if (mode == INPUT_PULLUP) s_pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= kPinCount) return;
+  s_pinLevel[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= kPinCount) return LOW;
+  return s_pinLevel[pin];
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+  if (pin >= kPinCount) return;
+  std::lock_guard<std::recursive_mutex> guard(s_isrLock);
+  s_isr[pin] = isr;
+  s_isrMode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin >= kPinCount) return;
+  std::lock_guard<std::recursive_mutex> guard(s_isrLock);
+  s_isr[pin] = nullptr;
+}
+
+void hostSetPinLevel(uint8_t pin, int level) {
+  if (pin >= kPinCount) return;
+  std::lock_guard<std::recursive_mutex> guard(s_isrLock);
+  int next = level ? HIGH : LOW;
+  int prev = s_pinLevel[pin].exchange(next);
+  if (prev == next || !s_isr[pin]) return;
+
+  int edge = next == HIGH ? RISING : FALLING;
+  if (s_isrMode[pin] & edge) s_isr[pin]();
+}
+
+int hostGetPinLevel(uint8_t pin) {
+  if (pin >= kPinCount) return LOW;
+  return s_pinLevel[pin];
+}
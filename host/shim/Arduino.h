@@ -0,0 +1,83 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief 호스트(Linux) 빌드용 Arduino 코어 대체 헤더입니다.
+ *
+ * 펌웨어 소스를 수정 없이 PC에서 컴파일하기 위해, 펌웨어가 사용하는
+ * Arduino API(millis, GPIO, Serial, String)만 최소한으로 흉내 냅니다.
+ * ESP32 Arduino 코어와 마찬가지로 FreeRTOS 헤더도 함께 포함합니다.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <math.h>
+
+#include "WString.h"
+#include "Print.h"
+#include "HardwareSerial.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+//==============================================================================
+// GPIO 상수
+//==============================================================================
+#define LOW           0x0
+#define HIGH          0x1
+
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+
+#define RISING        0x01
+#define FALLING       0x02
+#define CHANGE        0x03
+
+#define digitalPinToInterrupt(p) (p)
+
+//==============================================================================
+// 시간 / GPIO API
+//==============================================================================
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+
+/**
+ * @brief 핀 레벨 변화 시 호출할 ISR을 등록합니다.
+ *
+ * 호스트에서는 hostSetPinLevel()이 레벨을 바꾸는 스레드에서 ISR을 바로 호출합니다.
+ * ESP32의 GPIO ISR 디스패처처럼 ISR끼리는 동시에 실행되지 않습니다.
+ */
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+//==============================================================================
+// 호스트 전용 훅 (벤치마크/시뮬레이션에서 사용)
+//==============================================================================
+
+/**
+ * @brief 입력 핀의 논리 레벨을 외부에서 지정합니다. (엔코더/버튼 시뮬레이션)
+ *
+ * 레벨이 바뀌고 그 에지에 ISR이 등록되어 있으면 ISR을 호출합니다.
+ */
+void hostSetPinLevel(uint8_t pin, int level);
+
+/**
+ * @brief 출력 핀에 마지막으로 쓰인 레벨을 돌려줍니다.
+ */
+int hostGetPinLevel(uint8_t pin);
+
+#endif // HOST_ARDUINO_H
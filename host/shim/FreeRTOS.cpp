@@ -0,0 +1,346 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file FreeRTOS.cpp
+ * @brief FreeRTOS 태스크/큐/세마포어 API의 호스트 구현입니다.
+ */
+
+//==============================================================================
+// 공통 유틸
+//==============================================================================
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Clock::time_point kSchedulerStart = Clock::now();
+
+/**
+ * @brief 틱 단위 대기 시간을 조건 변수 대기로 변환합니다.
+ * @return pred가 만족되면 true, 시간 초과면 false
+ */
+template <typename Lock, typename Pred>
+bool waitTicks(std::condition_variable &cv, Lock &lock, TickType_t ticks, Pred pred) {
+  if (ticks == portMAX_DELAY) {
+    cv.wait(lock, pred);
+    return true;
+  }
+  return cv.wait_for(lock, std::chrono::milliseconds(ticks), pred);
+}
+
+} // namespace
+
+
+//==============================================================================
+// 태스크
+//==============================================================================
+
+struct tskTaskControlBlock {
+  std::string name;
+  uint32_t stackDepth = 0;
+  std::mutex lock;
+  std::condition_variable cv;
+  uint32_t notifyValue = 0;
+  bool notifyPending = false;
+};
+
+namespace {
+
+thread_local tskTaskControlBlock *t_currentTask = nullptr;
+
+struct TaskStart {
+  TaskFunction_t fn;
+  void *param;
+  tskTaskControlBlock *tcb;
+};
+
+} // namespace
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char *pcName,
+                                   uint32_t usStackDepth, void *pvParameters,
+                                   UBaseType_t, TaskHandle_t *pvCreatedTask, BaseType_t) {
+  tskTaskControlBlock *tcb = new tskTaskControlBlock();
+  tcb->name = pcName ? pcName : "";
+  tcb->stackDepth = usStackDepth;
+  if (pvCreatedTask) *pvCreatedTask = tcb;
+
+  TaskStart start{pvTaskCode, pvParameters, tcb};
+  std::thread([start]() {
+    t_currentTask = start.tcb;
+    start.fn(start.param);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char *pcName,
+                       uint32_t usStackDepth, void *pvParameters,
+                       UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask) {
+  return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters,
+                                 uxPriority, pvCreatedTask, tskNO_AFFINITY);
+}
+
+void vTaskDelay(TickType_t xTicksToDelay) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(xTicksToDelay));
+}
+
+void vPortYield() {
+  std::this_thread::yield();
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      Clock::now() - kSchedulerStart).count();
+}
+
+TickType_t xTaskGetTickCountFromISR() {
+  return xTaskGetTickCount();
+}
+
+void vTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement) {
+  TickType_t wake = *pxPreviousWakeTime + xTimeIncrement;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(wake - now) > 0) vTaskDelay(wake - now);
+  *pxPreviousWakeTime = wake;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  // 벤치마크의 메인 스레드처럼 xTaskCreate로 만들지 않은 스레드도
+  // 알림을 받을 수 있도록 처음 호출 시 제어 블록을 만들어 둡니다.
+  if (!t_currentTask) {
+    t_currentTask = new tskTaskControlBlock();
+    t_currentTask->name = "host";
+  }
+  return t_currentTask;
+}
+
+const char *pcTaskGetName(TaskHandle_t xTask) {
+  if (!xTask) xTask = xTaskGetCurrentTaskHandle();
+  return xTask->name.c_str();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask) {
+  // 호스트 스레드 스택은 측정할 수 없으므로 할당 크기를 그대로 돌려줍니다.
+  if (!xTask) xTask = xTaskGetCurrentTaskHandle();
+  return xTask->stackDepth;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction) {
+  if (!xTaskToNotify) return pdFAIL;
+  BaseType_t result = pdPASS;
+  {
+    std::lock_guard<std::mutex> guard(xTaskToNotify->lock);
+    switch (eAction) {
+      case eSetBits:                  xTaskToNotify->notifyValue |= ulValue; break;
+      case eIncrement:                xTaskToNotify->notifyValue++; break;
+      case eSetValueWithOverwrite:    xTaskToNotify->notifyValue = ulValue; break;
+      case eSetValueWithoutOverwrite:
+        if (xTaskToNotify->notifyPending) result = pdFAIL;
+        else xTaskToNotify->notifyValue = ulValue;
+        break;
+      case eNoAction:
+      default:
+        break;
+    }
+    xTaskToNotify->notifyPending = true;
+  }
+  xTaskToNotify->cv.notify_all();
+  return result;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t xTaskToNotify, uint32_t ulValue,
+                              eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken) {
+  if (pxHigherPriorityTaskWoken) *pxHigherPriorityTaskWoken = pdFALSE;
+  return xTaskNotify(xTaskToNotify, ulValue, eAction);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify) {
+  return xTaskNotify(xTaskToNotify, 0, eIncrement);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken) {
+  if (pxHigherPriorityTaskWoken) *pxHigherPriorityTaskWoken = pdFALSE;
+  xTaskNotify(xTaskToNotify, 0, eIncrement);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait) {
+  tskTaskControlBlock *self = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(self->lock);
+  waitTicks(self->cv, lock, xTicksToWait, [self] { return self->notifyValue != 0; });
+  uint32_t value = self->notifyValue;
+  if (value != 0) {
+    self->notifyValue = xClearCountOnExit ? 0 : value - 1;
+  }
+  self->notifyPending = false;
+  return value;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                           uint32_t *pulNotificationValue, TickType_t xTicksToWait) {
+  tskTaskControlBlock *self = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(self->lock);
+  if (!self->notifyPending) self->notifyValue &= ~ulBitsToClearOnEntry;
+  bool got = waitTicks(self->cv, lock, xTicksToWait, [self] { return self->notifyPending; });
+  if (pulNotificationValue) *pulNotificationValue = self->notifyValue;
+  if (!got) return pdFALSE;
+  self->notifyValue &= ~ulBitsToClearOnExit;
+  self->notifyPending = false;
+  return pdTRUE;
+}
+
+
+//==============================================================================
+// 큐 / 세마포어
+//==============================================================================
+
+struct QueueDefinition {
+  std::mutex lock;
+  std::condition_variable cv;
+  UBaseType_t length = 0;
+  UBaseType_t itemSize = 0;
+  std::vector<uint8_t> storage;
+  UBaseType_t head = 0;
+  UBaseType_t count = 0;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize) {
+  QueueDefinition *q = new QueueDefinition();
+  q->length = uxQueueLength;
+  q->itemSize = uxItemSize;
+  q->storage.resize((size_t)uxQueueLength * uxItemSize);
+  return q;
+}
+
+void vQueueDelete(QueueHandle_t xQueue) {
+  delete xQueue;
+}
+
+namespace {
+
+BaseType_t queueSend(QueueHandle_t q, const void *item, TickType_t ticks, bool front) {
+  if (!q) return errQUEUE_FULL;
+  {
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!waitTicks(q->cv, lock, ticks, [q] { return q->count < q->length; })) {
+      return errQUEUE_FULL;
+    }
+    UBaseType_t slot;
+    if (front) {
+      q->head = (q->head + q->length - 1) % q->length;
+      slot = q->head;
+    } else {
+      slot = (q->head + q->count) % q->length;
+    }
+    if (q->itemSize) memcpy(&q->storage[(size_t)slot * q->itemSize], item, q->itemSize);
+    q->count++;
+  }
+  q->cv.notify_all();
+  return pdPASS;
+}
+
+BaseType_t queueReceive(QueueHandle_t q, void *buffer, TickType_t ticks, bool peek) {
+  if (!q) return pdFALSE;
+  {
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!waitTicks(q->cv, lock, ticks, [q] { return q->count > 0; })) {
+      return pdFALSE;
+    }
+    if (q->itemSize && buffer) {
+      memcpy(buffer, &q->storage[(size_t)q->head * q->itemSize], q->itemSize);
+    }
+    if (!peek) {
+      q->head = (q->head + 1) % q->length;
+      q->count--;
+    }
+  }
+  q->cv.notify_all();
+  return pdTRUE;
+}
+
+} // namespace
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait) {
+  return queueSend(xQueue, pvItemToQueue, xTicksToWait, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait) {
+  return queueSend(xQueue, pvItemToQueue, xTicksToWait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait) {
+  return queueSend(xQueue, pvItemToQueue, xTicksToWait, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue,
+                             BaseType_t *pxHigherPriorityTaskWoken) {
+  if (pxHigherPriorityTaskWoken) *pxHigherPriorityTaskWoken = pdFALSE;
+  return queueSend(xQueue, pvItemToQueue, 0, false);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait) {
+  return queueReceive(xQueue, pvBuffer, xTicksToWait, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait) {
+  return queueReceive(xQueue, pvBuffer, xTicksToWait, true);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue) {
+  std::lock_guard<std::mutex> guard(xQueue->lock);
+  return xQueue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t xQueue) {
+  std::lock_guard<std::mutex> guard(xQueue->lock);
+  return xQueue->length - xQueue->count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue) {
+  {
+    std::lock_guard<std::mutex> guard(xQueue->lock);
+    xQueue->head = 0;
+    xQueue->count = 0;
+  }
+  xQueue->cv.notify_all();
+  return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  // 뮤텍스는 '주어진(given)' 상태로 생성됩니다.
+  SemaphoreHandle_t s = xQueueCreate(1, 0);
+  s->count = 1;
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount) {
+  SemaphoreHandle_t s = xQueueCreate(uxMaxCount, 0);
+  s->count = uxInitialCount;
+  return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime) {
+  return queueReceive(xSemaphore, nullptr, xBlockTime, false);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore) {
+  return queueSend(xSemaphore, nullptr, 0, false);
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken) {
+  if (pxHigherPriorityTaskWoken) *pxHigherPriorityTaskWoken = pdFALSE;
+  return queueSend(xSemaphore, nullptr, 0, false);
+}
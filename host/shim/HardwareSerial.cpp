@@ -0,0 +1,67 @@
+#include "HardwareSerial.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @file HardwareSerial.cpp
+ * @brief ESP32 HardwareSerial 호스트 구현입니다.
+ */
+
+HardwareSerial Serial(0);
+HardwareSerial Serial2(2);
+
+void HardwareSerial::begin(unsigned long, uint32_t, int8_t, int8_t) {
+  // 디버그 콘솔만 환경 변수에 따라 stderr로 내보냅니다.
+  echo_ = (uartNum_ == 0) && getenv("HOST_SERIAL_ECHO") != nullptr;
+}
+
+int HardwareSerial::available() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return (int)rx_.size();
+}
+
+int HardwareSerial::read() {
+  std::lock_guard<std::mutex> guard(lock_);
+  if (rx_.empty()) return -1;
+  int c = rx_.front();
+  rx_.pop_front();
+  return c;
+}
+
+int HardwareSerial::peek() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return rx_.empty() ? -1 : rx_.front();
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t size) {
+  txBytes_ += size;
+  if (capture_) {
+    std::lock_guard<std::mutex> guard(lock_);
+    captured_.append((const char *)buf, size);
+  }
+  if (echo_) fwrite(buf, 1, size, stderr);
+  return size;
+}
+
+void HardwareSerial::hostInjectRx(const char *data, size_t len) {
+  std::lock_guard<std::mutex> guard(lock_);
+  for (size_t i = 0; i < len; ++i) rx_.push_back((uint8_t)data[i]);
+}
+
+void HardwareSerial::hostSetCapture(bool enable) {
+  std::lock_guard<std::mutex> guard(lock_);
+  capture_ = enable;
+  if (!enable) captured_.clear();
+}
+
+std::string HardwareSerial::hostTakeCaptured() {
+  std::lock_guard<std::mutex> guard(lock_);
+  std::string out;
+  out.swap(captured_);
+  return out;
+}
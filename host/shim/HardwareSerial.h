@@ -0,0 +1,62 @@
+#ifndef HOST_HARDWARE_SERIAL_H
+#define HOST_HARDWARE_SERIAL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include "Print.h"
+
+#define SERIAL_8N1 0x800001c
+
+/**
+ * @file HardwareSerial.h
+ * @brief ESP32 HardwareSerial의 호스트 구현입니다.
+ *
+ * TX는 바이트 수만 집계하고(필요하면 캡처), RX는 hostInjectRx()로 주입한
+ * 바이트를 돌려줍니다. Serial(디버그 콘솔)은 환경 변수 HOST_SERIAL_ECHO가
+ * 설정된 경우에만 stderr로 출력합니다.
+ */
+class HardwareSerial : public Print {
+public:
+  explicit HardwareSerial(int uartNum) : uartNum_(uartNum) {}
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1,
+             int8_t rxPin = -1, int8_t txPin = -1);
+  void end() {}
+
+  int available();
+  int read();
+  int peek();
+  void flush() {}
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t size) override;
+  using Print::write;
+
+  operator bool() const { return true; }
+
+  //============================================================================
+  // 호스트 전용 훅
+  //============================================================================
+  void hostInjectRx(const char *data, size_t len);
+  void hostSetCapture(bool enable);
+  std::string hostTakeCaptured();
+  uint64_t hostTxBytes() const { return txBytes_; }
+  void hostResetTxBytes() { txBytes_ = 0; }
+
+private:
+  int uartNum_;
+  bool echo_ = false;
+  bool capture_ = false;
+  uint64_t txBytes_ = 0;
+  std::string captured_;
+  std::deque<uint8_t> rx_;
+  std::mutex lock_;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+#endif // HOST_HARDWARE_SERIAL_H
@@ -0,0 +1,109 @@
+#include "Preferences.h"
+
+#include <cstring>
+#include <mutex>
+
+/**
+ * @file Preferences.cpp
+ * @brief Preferences(NVS) 호스트 구현입니다.
+ */
+
+namespace {
+
+std::mutex s_lock;
+std::map<std::string, std::vector<uint8_t>> s_store; // "<namespace>/<key>" → 값
+
+std::string fullKey(const std::string &ns, const char *key) {
+  return ns + "/" + (key ? key : "");
+}
+
+} // namespace
+
+bool Preferences::begin(const char *name, bool, const char *) {
+  ns_ = name ? name : "";
+  return true;
+}
+
+void Preferences::end() {}
+
+bool Preferences::clear() {
+  std::lock_guard<std::mutex> guard(s_lock);
+  std::string prefix = ns_ + "/";
+  for (auto it = s_store.begin(); it != s_store.end();) {
+    if (it->first.compare(0, prefix.size(), prefix) == 0) it = s_store.erase(it);
+    else ++it;
+  }
+  return true;
+}
+
+bool Preferences::remove(const char *key) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  return s_store.erase(fullKey(ns_, key)) > 0;
+}
+
+bool Preferences::isKey(const char *key) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  return s_store.count(fullKey(ns_, key)) > 0;
+}
+
+size_t Preferences::put(const char *key, const void *value, size_t len) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  std::vector<uint8_t> &slot = s_store[fullKey(ns_, key)];
+  slot.assign((const uint8_t *)value, (const uint8_t *)value + len);
+  writeCount_++;
+  writeBytes_ += (uint32_t)len;
+  return len;
+}
+
+bool Preferences::get(const char *key, void *out, size_t len) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  auto it = s_store.find(fullKey(ns_, key));
+  if (it == s_store.end() || it->second.size() != len) return false;
+  memcpy(out, it->second.data(), len);
+  return true;
+}
+
+size_t Preferences::putUChar(const char *key, uint8_t value)   { return put(key, &value, sizeof(value)); }
+size_t Preferences::putBool(const char *key, bool value)       { uint8_t v = value ? 1 : 0; return put(key, &v, 1); }
+size_t Preferences::putUShort(const char *key, uint16_t value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putUInt(const char *key, uint32_t value)   { return put(key, &value, sizeof(value)); }
+size_t Preferences::putULong(const char *key, uint32_t value)  { return put(key, &value, sizeof(value)); }
+size_t Preferences::putBytes(const char *key, const void *value, size_t len) { return put(key, value, len); }
+
+uint8_t Preferences::getUChar(const char *key, uint8_t defaultValue) {
+  uint8_t v;
+  return get(key, &v, sizeof(v)) ? v : defaultValue;
+}
+
+bool Preferences::getBool(const char *key, bool defaultValue) {
+  uint8_t v;
+  return get(key, &v, 1) ? (v != 0) : defaultValue;
+}
+
+uint16_t Preferences::getUShort(const char *key, uint16_t defaultValue) {
+  uint16_t v;
+  return get(key, &v, sizeof(v)) ? v : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char *key, uint32_t defaultValue) {
+  uint32_t v;
+  return get(key, &v, sizeof(v)) ? v : defaultValue;
+}
+
+uint32_t Preferences::getULong(const char *key, uint32_t defaultValue) {
+  return getUInt(key, defaultValue);
+}
+
+size_t Preferences::getBytesLength(const char *key) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  auto it = s_store.find(fullKey(ns_, key));
+  return it == s_store.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  auto it = s_store.find(fullKey(ns_, key));
+  if (it == s_store.end() || it->second.size() > maxLen) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
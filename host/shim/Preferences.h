@@ -0,0 +1,56 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file Preferences.h
+ * @brief ESP32 Preferences(NVS) 라이브러리의 호스트 구현입니다.
+ *
+ * 값은 프로세스 메모리에만 보관되며, 쓰기 횟수/바이트를 집계해
+ * 플래시 마모와 쓰기 비용을 벤치마크에서 비교할 수 있게 합니다.
+ */
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false, const char *partition = nullptr);
+  void end();
+  bool clear();
+  bool remove(const char *key);
+  bool isKey(const char *key);
+
+  size_t putUChar(const char *key, uint8_t value);
+  size_t putBool(const char *key, bool value);
+  size_t putUShort(const char *key, uint16_t value);
+  size_t putUInt(const char *key, uint32_t value);
+  size_t putULong(const char *key, uint32_t value);
+  size_t putBytes(const char *key, const void *value, size_t len);
+
+  uint8_t  getUChar(const char *key, uint8_t defaultValue = 0);
+  bool     getBool(const char *key, bool defaultValue = false);
+  uint16_t getUShort(const char *key, uint16_t defaultValue = 0);
+  uint32_t getUInt(const char *key, uint32_t defaultValue = 0);
+  uint32_t getULong(const char *key, uint32_t defaultValue = 0);
+  size_t   getBytesLength(const char *key);
+  size_t   getBytes(const char *key, void *buf, size_t maxLen);
+
+  //============================================================================
+  // 호스트 전용 훅
+  //============================================================================
+  uint32_t hostWriteCount() const { return writeCount_; }
+  uint32_t hostWriteBytes() const { return writeBytes_; }
+  void hostResetStats() { writeCount_ = 0; writeBytes_ = 0; }
+
+private:
+  size_t put(const char *key, const void *value, size_t len);
+  bool get(const char *key, void *out, size_t len);
+
+  std::string ns_;
+  uint32_t writeCount_ = 0;
+  uint32_t writeBytes_ = 0;
+};
+
+#endif // HOST_PREFERENCES_H
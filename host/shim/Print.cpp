@@ -0,0 +1,71 @@
+#include "Print.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @file Print.cpp
+ * @brief Arduino Print 호스트 구현입니다.
+ */
+
+size_t Print::write(const uint8_t *buf, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buf++);
+  return n;
+}
+
+size_t Print::write(const char *str) {
+  if (!str) return 0;
+  return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::print(const char *s)                { return write(s); }
+size_t Print::print(const String &s)              { return write(s.c_str()); }
+size_t Print::print(char c)                       { return write((uint8_t)c); }
+size_t Print::print(unsigned char n, int base)    { return print(String(n, (unsigned char)base)); }
+size_t Print::print(int n, int base)              { return print(String(n, (unsigned char)base)); }
+size_t Print::print(unsigned int n, int base)     { return print(String(n, (unsigned char)base)); }
+size_t Print::print(long n, int base)             { return print(String(n, (unsigned char)base)); }
+size_t Print::print(unsigned long n, int base)    { return print(String(n, (unsigned char)base)); }
+size_t Print::print(double n, int digits)         { return print(String(n, (unsigned int)digits)); }
+
+size_t Print::println()                           { return write("\r\n"); }
+size_t Print::println(const char *s)              { size_t n = print(s); return n + println(); }
+size_t Print::println(const String &s)            { size_t n = print(s); return n + println(); }
+size_t Print::println(char c)                     { size_t n = print(c); return n + println(); }
+size_t Print::println(unsigned char v, int base)  { size_t n = print(v, base); return n + println(); }
+size_t Print::println(int v, int base)            { size_t n = print(v, base); return n + println(); }
+size_t Print::println(unsigned int v, int base)   { size_t n = print(v, base); return n + println(); }
+size_t Print::println(long v, int base)           { size_t n = print(v, base); return n + println(); }
+size_t Print::println(unsigned long v, int base)  { size_t n = print(v, base); return n + println(); }
+size_t Print::println(double v, int digits)       { size_t n = print(v, digits); return n + println(); }
+
+size_t Print::printf(const char *format, ...) {
+  // ESP32 코어와 같이 64바이트 스택 버퍼를 먼저 쓰고, 넘치면 힙을 사용합니다.
+  char loc[64];
+  char *temp = loc;
+  va_list arg;
+  va_start(arg, format);
+  va_list copy;
+  va_copy(copy, arg);
+  int len = vsnprintf(temp, sizeof(loc), format, copy);
+  va_end(copy);
+  if (len < 0) {
+    va_end(arg);
+    return 0;
+  }
+  if (len >= (int)sizeof(loc)) {
+    temp = (char *)malloc(len + 1);
+    if (!temp) {
+      va_end(arg);
+      return 0;
+    }
+    vsnprintf(temp, len + 1, format, arg);
+  }
+  va_end(arg);
+  size_t n = write((const uint8_t *)temp, len);
+  if (temp != loc) free(temp);
+  return n;
+}
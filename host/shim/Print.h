@@ -0,0 +1,48 @@
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <cstdint>
+#include <cstddef>
+#include "WString.h"
+
+/**
+ * @file Print.h
+ * @brief Arduino Print 클래스의 호스트 구현입니다.
+ *
+ * Serial과 TFT_eSPI가 공통으로 상속하며, 모든 출력은 write(uint8_t) 한 글자
+ * 단위로 내려갑니다. (ESP32 코어의 Print와 동일한 구조)
+ */
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size);
+  size_t write(const char *str);
+  size_t write(const char *buf, size_t size) { return write((const uint8_t *)buf, size); }
+
+  size_t print(const char *s);
+  size_t print(const String &s);
+  size_t print(char c);
+  size_t print(unsigned char n, int base = 10);
+  size_t print(int n, int base = 10);
+  size_t print(unsigned int n, int base = 10);
+  size_t print(long n, int base = 10);
+  size_t print(unsigned long n, int base = 10);
+  size_t print(double n, int digits = 2);
+
+  size_t println();
+  size_t println(const char *s);
+  size_t println(const String &s);
+  size_t println(char c);
+  size_t println(unsigned char n, int base = 10);
+  size_t println(int n, int base = 10);
+  size_t println(unsigned int n, int base = 10);
+  size_t println(long n, int base = 10);
+  size_t println(unsigned long n, int base = 10);
+  size_t println(double n, int digits = 2);
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+#endif // HOST_PRINT_H
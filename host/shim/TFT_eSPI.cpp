@@ -0,0 +1,242 @@
+#include "TFT_eSPI.h"
+
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+
+/**
+ * @file TFT_eSPI.cpp
+ * @brief TFT_eSPI 호스트 구현 (SPI 전송량 모델)
+ *
+ * 비용 모델 (ILI9341, 16bit 색):
+ *  - 주소창 설정: CASET(1+4) + RASET(1+4) + RAMWR(1) = 11바이트
+ *  - 픽셀 데이터: 픽셀당 2바이트
+ *  - 배경색이 있는 글자: 6s x 8s 블록 한 번에 전송
+ *  - 배경색이 없는(투명) 글자: 켜진 픽셀(평균 15개)마다 s x s 사각형 전송
+ *  - pushImageDMA: 같은 전송량이지만 CPU를 점유하지 않고 dmaWait()에서만 기다림
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const uint32_t kWindowOverhead = 11;
+const uint32_t kGlyphLitPixels = 15;
+
+int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+    : width_(w), height_(h), baseWidth_(w), baseHeight_(h) {}
+
+void TFT_eSPI::init() {
+  setRotation(0);
+  spiBytes_ = 0;
+  spiTransactions_ = 0;
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+  rotation_ = r & 3;
+  if (rotation_ & 1) {
+    width_ = baseHeight_;
+    height_ = baseWidth_;
+  } else {
+    width_ = baseWidth_;
+    height_ = baseHeight_;
+  }
+}
+
+void TFT_eSPI::chargeWindow(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t pixels,
+                            uint16_t) {
+  // 화면 밖으로 완전히 벗어난 영역은 라이브러리가 전송하지 않습니다.
+  if (w <= 0 || h <= 0 || x >= width_ || y >= height_ || x + w <= 0 || y + h <= 0) return;
+  uint32_t bytes = kWindowOverhead + pixels * 2;
+  spiBytes_ += bytes;
+  spiTransactions_++;
+
+  if (spiClockHz_) {
+    // 동기식 전송은 진행 중인 DMA 뒤에 이어서 나갑니다.
+    if (dmaReady_) dmaWait();
+    auto ns = std::chrono::nanoseconds((uint64_t)bytes * 8ULL * 1000000000ULL / spiClockHz_);
+    auto until = Clock::now() + ns;
+    while (Clock::now() < until) {
+      // SPI 전송이 끝날 때까지 CPU를 점유하는 동기식 전송을 흉내 냅니다.
+    }
+  }
+}
+
+void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data,
+                            uint16_t *) {
+  if (!dmaReady_ || !data) return;
+  if (w <= 0 || h <= 0 || x >= width_ || y >= height_ || x + w <= 0 || y + h <= 0) return;
+  dmaWait();  // 라이브러리와 같이 이전 DMA 전송이 끝난 뒤 시작
+
+  uint32_t bytes = kWindowOverhead + (uint32_t)(w * h) * 2;
+  spiBytes_ += bytes;
+  spiTransactions_++;
+  if (spiClockHz_) {
+    dmaDoneNs_ = nowNs() + (int64_t)((uint64_t)bytes * 8ULL * 1000000000ULL / spiClockHz_);
+  }
+}
+
+bool TFT_eSPI::dmaBusy() const {
+  return dmaDoneNs_ > nowNs();
+}
+
+void TFT_eSPI::dmaWait() {
+  int64_t left = dmaDoneNs_ - nowNs();
+  if (left > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(left));
+}
+
+void TFT_eSPI::fillScreen(uint32_t color) {
+  fillRect(0, 0, width_, height_, color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width_) w = width_ - x;
+  if (y + h > height_) h = height_ - y;
+  if (w <= 0 || h <= 0) return;
+  chargeWindow(x, y, w, h, (uint32_t)(w * h), (uint16_t)color);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color) {
+  chargeWindow(x, y, 1, 1, 1, (uint16_t)color);
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+  if (y0 == y1) {
+    drawFastHLine(x0 < x1 ? x0 : x1, y0, abs(x1 - x0) + 1, color);
+  } else if (x0 == x1) {
+    drawFastVLine(x0, y0 < y1 ? y0 : y1, abs(y1 - y0) + 1, color);
+  } else {
+    int32_t steps = abs(x1 - x0) > abs(y1 - y0) ? abs(x1 - x0) : abs(y1 - y0);
+    for (int32_t i = 0; i <= steps; ++i) {
+      drawPixel(x0 + (x1 - x0) * i / steps, y0 + (y1 - y0) * i / steps, color);
+    }
+  }
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *) {
+  chargeWindow(x, y, w, h, (uint32_t)(w * h), TFT_BLACK);
+}
+
+int16_t TFT_eSPI::textWidth(const char *string) const {
+  return string ? (int16_t)(strlen(string) * 6 * textSize_) : 0;
+}
+
+void TFT_eSPI::drawChar(int32_t x, int32_t y, char) {
+  int32_t cw = 6 * textSize_;
+  int32_t ch = 8 * textSize_;
+  if (textBg_ != textColor_) {
+    chargeWindow(x, y, cw, ch, (uint32_t)(cw * ch), textBg_);
+  } else {
+    for (uint32_t i = 0; i < kGlyphLitPixels; ++i) {
+      chargeWindow(x, y, textSize_, textSize_, (uint32_t)(textSize_ * textSize_), textColor_);
+    }
+  }
+}
+
+int16_t TFT_eSPI::drawString(const char *string, int32_t x, int32_t y) {
+  if (!string) return 0;
+  int16_t w = textWidth(string);
+  int16_t h = fontHeight();
+  switch (datum_) {
+    case TC_DATUM: x -= w / 2; break;
+    case TR_DATUM: x -= w; break;
+    case ML_DATUM: y -= h / 2; break;
+    case MC_DATUM: x -= w / 2; y -= h / 2; break;
+    case MR_DATUM: x -= w; y -= h / 2; break;
+    default: break;
+  }
+  for (const char *p = string; *p; ++p) {
+    drawChar(x, y, *p);
+    x += 6 * textSize_;
+  }
+  if (padding_ > w && textBg_ != textColor_) {
+    fillRect(x, y, padding_ - w, h, textBg_);
+  }
+  return w;
+}
+
+size_t TFT_eSPI::write(uint8_t c) {
+  if (c == '\r') return 1;
+  if (c == '\n') {
+    cursorX_ = 0;
+    cursorY_ += 8 * textSize_;
+    return 1;
+  }
+  if (wrapX_ && cursorX_ + 6 * textSize_ > width_) {
+    cursorX_ = 0;
+    cursorY_ += 8 * textSize_;
+  }
+  drawChar(cursorX_, cursorY_, (char)c);
+  cursorX_ += 6 * textSize_;
+  return 1;
+}
+
+
+//==============================================================================
+// TFT_eSprite
+//==============================================================================
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI *tft) : TFT_eSPI(0, 0), tft_(tft) {}
+
+TFT_eSprite::~TFT_eSprite() {
+  deleteSprite();
+}
+
+void *TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t) {
+  if (buf_) return buf_;
+  if (w <= 0 || h <= 0) return nullptr;
+  buf_ = (uint16_t *)calloc((size_t)w * h, sizeof(uint16_t));
+  if (!buf_) return nullptr;
+  width_ = baseWidth_ = w;
+  height_ = baseHeight_ = h;
+  return buf_;
+}
+
+void TFT_eSprite::deleteSprite() {
+  free(buf_);
+  buf_ = nullptr;
+  width_ = height_ = baseWidth_ = baseHeight_ = 0;
+}
+
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) const {
+  if (!buf_ || x < 0 || y < 0 || x >= width_ || y >= height_) return 0;
+  return buf_[y * width_ + x];
+}
+
+void TFT_eSprite::chargeWindow(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t,
+                               uint16_t color) {
+  if (!buf_) return;
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width_) w = width_ - x;
+  if (y + h > height_) h = height_ - y;
+  for (int32_t row = 0; row < h; ++row) {
+    uint16_t *p = buf_ + (y + row) * width_ + x;
+    for (int32_t col = 0; col < w; ++col) p[col] = color;
+  }
+}
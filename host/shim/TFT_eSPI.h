@@ -0,0 +1,167 @@
+#ifndef HOST_TFT_ESPI_H
+#define HOST_TFT_ESPI_H
+
+#include <cstdint>
+#include <cstddef>
+#include "Print.h"
+
+/**
+ * @file TFT_eSPI.h
+ * @brief TFT_eSPI 라이브러리의 호스트 구현입니다.
+ *
+ * 픽셀을 실제로 그리지는 않고, 각 그리기 호출이 ILI9341에 보냈을 SPI
+ * 바이트 수(주소창 설정 명령 + 16bit 픽셀 데이터)를 집계합니다. 글꼴은
+ * 기본 GLCD(6x8) 글꼴만 지원합니다.
+ *
+ * TFT_eSprite는 같은 그리기 호출을 메모리 버퍼에 대한 사각형 채우기로 수행합니다.
+ * (글자는 글리프 모양 대신 글자 칸 전체를 배경색으로 채움)
+ */
+
+// 기본 색상 (RGB565)
+#define TFT_BLACK       0x0000
+#define TFT_NAVY        0x000F
+#define TFT_DARKGREEN   0x03E0
+#define TFT_MAROON      0x7800
+#define TFT_DARKGREY    0x7BEF
+#define TFT_LIGHTGREY   0xD69A
+#define TFT_BLUE        0x001F
+#define TFT_GREEN       0x07E0
+#define TFT_CYAN        0x07FF
+#define TFT_RED         0xF800
+#define TFT_MAGENTA     0xF81F
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+#define TFT_ORANGE      0xFDA0
+
+// 텍스트 기준점
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH  240
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 320
+#endif
+
+class TFT_eSPI : public Print {
+public:
+  TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+
+  void init();
+  void begin() { init(); }
+  void setRotation(uint8_t r);
+  uint8_t getRotation() const { return rotation_; }
+  int16_t width() const { return width_; }
+  int16_t height() const { return height_; }
+
+  void fillScreen(uint32_t color);
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void drawPixel(int32_t x, int32_t y, uint32_t color);
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+  void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data);
+
+  void setCursor(int16_t x, int16_t y) { cursorX_ = x; cursorY_ = y; }
+  int16_t getCursorX() const { return cursorX_; }
+  int16_t getCursorY() const { return cursorY_; }
+  void setTextColor(uint16_t color) { textColor_ = color; textBg_ = color; }
+  void setTextColor(uint16_t fg, uint16_t bg) { textColor_ = fg; textBg_ = bg; }
+  void setTextSize(uint8_t size) { textSize_ = size ? size : 1; }
+  uint8_t getTextSize() const { return textSize_; }
+  void setTextWrap(bool wrapX, bool wrapY = false) { wrapX_ = wrapX; (void)wrapY; }
+  void setTextDatum(uint8_t datum) { datum_ = datum; }
+  void setTextPadding(uint16_t padding) { padding_ = padding; }
+
+  int16_t textWidth(const char *string) const;
+  int16_t fontHeight() const { return (int16_t)(8 * textSize_); }
+  int16_t drawString(const char *string, int32_t x, int32_t y);
+  int16_t drawString(const String &string, int32_t x, int32_t y) { return drawString(string.c_str(), x, y); }
+
+  void startWrite() {}
+  void endWrite() {}
+
+  // DMA 전송: 호출은 바로 돌아오고 전송은 백그라운드에서 진행됩니다.
+  // data는 전송이 끝날 때까지(dmaWait) 유지되어야 합니다.
+  bool initDMA(bool ctrl_cs = false) { (void)ctrl_cs; dmaReady_ = true; return true; }
+  void deInitDMA() { dmaWait(); dmaReady_ = false; }
+  void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data,
+                    uint16_t *buffer = nullptr);
+  bool dmaBusy() const;
+  void dmaWait();
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  //============================================================================
+  // 호스트 전용 훅
+  //============================================================================
+  uint64_t hostSpiBytes() const { return spiBytes_; }
+  uint32_t hostSpiTransactions() const { return spiTransactions_; }
+  void hostResetSpiStats() { spiBytes_ = 0; spiTransactions_ = 0; }
+
+  /**
+   * @brief 0이 아니면 SPI 전송 시간을 해당 클럭 기준으로 실제로 소모합니다.
+   * (렌더링이 다른 작업을 얼마나 막는지 재현할 때 사용)
+   */
+  void hostSetSpiClockHz(uint32_t hz) { spiClockHz_ = hz; }
+  uint32_t hostSpiClockHz() const { return spiClockHz_; }
+
+protected:
+  virtual void chargeWindow(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t pixels,
+                            uint16_t color);
+  void drawChar(int32_t x, int32_t y, char c);
+
+  int16_t width_;
+  int16_t height_;
+  int16_t baseWidth_;
+  int16_t baseHeight_;
+  uint8_t rotation_ = 0;
+
+  int16_t cursorX_ = 0;
+  int16_t cursorY_ = 0;
+  uint16_t textColor_ = TFT_WHITE;
+  uint16_t textBg_ = TFT_WHITE;
+  uint8_t textSize_ = 1;
+  bool wrapX_ = true;
+  uint8_t datum_ = TL_DATUM;
+  uint16_t padding_ = 0;
+
+  uint64_t spiBytes_ = 0;
+  uint32_t spiTransactions_ = 0;
+  uint32_t spiClockHz_ = 0;
+  bool dmaReady_ = false;
+  int64_t dmaDoneNs_ = 0;  // 진행 중인 DMA 전송이 끝나는 시각 (steady_clock)
+};
+
+/**
+ * @brief 메모리 버퍼에 그리는 스프라이트 (16bit 색만 지원)
+ */
+class TFT_eSprite : public TFT_eSPI {
+public:
+  explicit TFT_eSprite(TFT_eSPI *tft);
+  ~TFT_eSprite();
+
+  void *createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+  void deleteSprite();
+  bool created() const { return buf_ != nullptr; }
+  void setColorDepth(int8_t bpp) { (void)bpp; }
+  void fillSprite(uint32_t color) { fillRect(0, 0, width_, height_, color); }
+  void *getPointer() { return buf_; }
+  uint16_t readPixel(int32_t x, int32_t y) const;
+
+protected:
+  void chargeWindow(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t pixels,
+                    uint16_t color) override;
+
+  TFT_eSPI *tft_;
+  uint16_t *buf_ = nullptr;
+};
+
+#endif // HOST_TFT_ESPI_H
@@ -0,0 +1,133 @@
+#include "WString.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @file WString.cpp
+ * @brief Arduino String 호스트 구현의 변환/검색 함수입니다.
+ */
+
+namespace {
+
+std::string formatInteger(unsigned long value, bool negative, unsigned char base) {
+  if (base < 2 || base > 36) base = 10;
+  char tmp[72];
+  int pos = (int)sizeof(tmp) - 1;
+  tmp[pos] = '\0';
+  do {
+    int digit = (int)(value % base);
+    tmp[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    value /= base;
+  } while (value > 0 && pos > 1);
+  if (negative) tmp[--pos] = '-';
+  return std::string(&tmp[pos]);
+}
+
+std::string formatSigned(long value, unsigned char base) {
+  if (base == 10 && value < 0) {
+    return formatInteger((unsigned long)(-(value + 1)) + 1UL, true, base);
+  }
+  return formatInteger((unsigned long)value, false, base);
+}
+
+std::string formatFloat(double value, unsigned int decimals) {
+  char tmp[64];
+  snprintf(tmp, sizeof(tmp), "%.*f", (int)decimals, value);
+  return std::string(tmp);
+}
+
+} // namespace
+
+String::String(unsigned char value, unsigned char base)
+    : buf_(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base)
+    : buf_(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base)
+    : buf_(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base)
+    : buf_(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base)
+    : buf_(formatInteger(value, false, base)) {}
+String::String(float value, unsigned int decimalPlaces)
+    : buf_(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces)
+    : buf_(formatFloat(value, decimalPlaces)) {}
+
+String operator+(const String &lhs, const String &rhs) {
+  String s(lhs);
+  s += rhs;
+  return s;
+}
+
+String operator+(const String &lhs, const char *rhs) {
+  String s(lhs);
+  s += rhs;
+  return s;
+}
+
+String operator+(const char *lhs, const String &rhs) {
+  String s(lhs);
+  s += rhs;
+  return s;
+}
+
+String operator+(const String &lhs, char rhs) {
+  String s(lhs);
+  s += rhs;
+  return s;
+}
+
+bool String::startsWith(const String &prefix) const {
+  return buf_.compare(0, prefix.buf_.size(), prefix.buf_) == 0;
+}
+
+bool String::endsWith(const String &suffix) const {
+  if (suffix.buf_.size() > buf_.size()) return false;
+  return buf_.compare(buf_.size() - suffix.buf_.size(), suffix.buf_.size(), suffix.buf_) == 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  size_t pos = buf_.find(ch, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const {
+  size_t pos = buf_.find(str.buf_, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const {
+  return substring(beginIndex, length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) {
+    unsigned int t = beginIndex;
+    beginIndex = endIndex;
+    endIndex = t;
+  }
+  if (beginIndex >= buf_.size()) return String();
+  if (endIndex > buf_.size()) endIndex = (unsigned int)buf_.size();
+  String out;
+  out.buf_ = buf_.substr(beginIndex, endIndex - beginIndex);
+  return out;
+}
+
+long String::toInt() const {
+  return strtol(buf_.c_str(), nullptr, 10);
+}
+
+float String::toFloat() const {
+  return strtof(buf_.c_str(), nullptr);
+}
+
+void String::trim() {
+  size_t begin = buf_.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    buf_.clear();
+    return;
+  }
+  size_t end = buf_.find_last_not_of(" \t\r\n");
+  buf_ = buf_.substr(begin, end - begin + 1);
+}
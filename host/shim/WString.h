@@ -0,0 +1,70 @@
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * @file WString.h
+ * @brief Arduino String 클래스의 호스트 구현입니다.
+ *
+ * 펌웨어가 사용하는 생성자/연결/검색 API만 제공합니다. 내부 저장소는
+ * 실제 Arduino String과 마찬가지로 힙에 할당되므로, 벤치마크에서 측정되는
+ * 할당 횟수는 실제 장치의 경향과 같습니다.
+ */
+class String {
+public:
+  String() {}
+  String(const char *cstr) : buf_(cstr ? cstr : "") {}
+  String(const String &other) = default;
+  String(String &&other) = default;
+  explicit String(char c) : buf_(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+
+  String &operator=(const String &rhs) = default;
+  String &operator=(String &&rhs) = default;
+  String &operator=(const char *cstr) { buf_ = cstr ? cstr : ""; return *this; }
+
+  String &operator+=(const String &rhs) { buf_ += rhs.buf_; return *this; }
+  String &operator+=(const char *cstr) { if (cstr) buf_ += cstr; return *this; }
+  String &operator+=(char c) { buf_ += c; return *this; }
+
+  friend String operator+(const String &lhs, const String &rhs);
+  friend String operator+(const String &lhs, const char *rhs);
+  friend String operator+(const char *lhs, const String &rhs);
+  friend String operator+(const String &lhs, char rhs);
+
+  bool operator==(const String &rhs) const { return buf_ == rhs.buf_; }
+  bool operator==(const char *cstr) const { return buf_ == (cstr ? cstr : ""); }
+  bool operator!=(const String &rhs) const { return !(*this == rhs); }
+  bool operator!=(const char *cstr) const { return !(*this == cstr); }
+
+  char operator[](unsigned int index) const { return index < buf_.size() ? buf_[index] : 0; }
+  char charAt(unsigned int index) const { return (*this)[index]; }
+
+  unsigned int length() const { return (unsigned int)buf_.size(); }
+  const char *c_str() const { return buf_.c_str(); }
+  void reserve(unsigned int size) { buf_.reserve(size); }
+
+  bool startsWith(const String &prefix) const;
+  bool endsWith(const String &suffix) const;
+  int indexOf(char ch, unsigned int fromIndex = 0) const;
+  int indexOf(const String &str, unsigned int fromIndex = 0) const;
+  String substring(unsigned int beginIndex) const;
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+  long toInt() const;
+  float toFloat() const;
+  void trim();
+
+private:
+  std::string buf_;
+};
+
+#endif // HOST_WSTRING_H
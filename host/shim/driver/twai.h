@@ -0,0 +1,130 @@
+#ifndef HOST_DRIVER_TWAI_H
+#define HOST_DRIVER_TWAI_H
+
+/**
+ * @file twai.h
+ * @brief ESP-IDF TWAI(CAN) 드라이버 API의 호스트 구현입니다.
+ *
+ * 수신 프레임은 hostCanInjectRx()로 주입하고, 송신 프레임은 드라이버 TX 큐를
+ * 거쳐 비트레이트에 맞춘 간격으로 버스에 나간 뒤 내부 로그에 쌓여
+ * hostCanTakeTx()로 꺼낼 수 있습니다. 송신 완료/수신은 경고(alert)로 알립니다. 펌웨어 쪽 포함 방식
+ * (extern "C" { #include "driver/twai.h" })과 호환되도록 C 선언만 둡니다.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#define TWAI_FRAME_MAX_DLC     8
+
+// 경고(alert) 비트 (ESP-IDF와 동일한 값)
+#define TWAI_ALERT_TX_IDLE          0x00000001
+#define TWAI_ALERT_TX_SUCCESS       0x00000002
+#define TWAI_ALERT_RX_DATA          0x00000004
+#define TWAI_ALERT_TX_FAILED        0x00000400
+#define TWAI_ALERT_RX_QUEUE_FULL    0x00000800
+#define TWAI_ALERT_BUS_OFF          0x00002000
+#define TWAI_ALERT_RX_FIFO_OVERRUN  0x00004000
+#define TWAI_ALERT_ALL              0x0001FFFF
+#define TWAI_ALERT_NONE             0x00000000
+
+typedef enum {
+  GPIO_NUM_NC = -1,
+} gpio_num_t;
+
+/**
+ * @brief TWAI 메시지 구조체 (ESP-IDF와 동일한 레이아웃)
+ */
+typedef struct {
+  union {
+    struct {
+      uint32_t extd: 1;
+      uint32_t rtr: 1;
+      uint32_t ss: 1;
+      uint32_t self: 1;
+      uint32_t dlc_non_comp: 1;
+      uint32_t reserved: 27;
+    };
+    uint32_t flags;
+  };
+  uint32_t identifier;
+  uint8_t data_length_code;
+  uint8_t data[TWAI_FRAME_MAX_DLC];
+} twai_message_t;
+
+/**
+ * @brief TWAI 드라이버 상태 (ESP-IDF와 동일한 필드)
+ */
+typedef enum {
+  TWAI_STATE_STOPPED,
+  TWAI_STATE_RUNNING,
+  TWAI_STATE_BUS_OFF,
+  TWAI_STATE_RECOVERING,
+} twai_state_t;
+
+typedef struct {
+  twai_state_t state;
+  uint32_t msgs_to_tx;
+  uint32_t msgs_to_rx;
+  uint32_t tx_error_counter;
+  uint32_t rx_error_counter;
+  uint32_t tx_failed_count;
+  uint32_t rx_missed_count;
+  uint32_t rx_overrun_count;
+  uint32_t arb_lost_count;
+  uint32_t bus_error_count;
+} twai_status_info_t;
+
+esp_err_t twai_transmit(const twai_message_t *message, TickType_t ticks_to_wait);
+esp_err_t twai_receive(twai_message_t *message, TickType_t ticks_to_wait);
+esp_err_t twai_get_status_info(twai_status_info_t *status_info);
+esp_err_t twai_read_alerts(uint32_t *alerts, TickType_t ticks_to_wait);
+esp_err_t twai_reconfigure_alerts(uint32_t alerts_enabled, uint32_t *current_alerts);
+
+//==============================================================================
+// 호스트 전용 훅
+//==============================================================================
+
+/**
+ * @brief 버스에서 프레임을 받은 것처럼 수신 큐에 넣습니다.
+ * 드라이버 RX 큐가 가득 차 있으면 실제 드라이버처럼 버리고 rx_missed_count를 올립니다.
+ */
+void hostCanInjectRx(const twai_message_t *message);
+
+/**
+ * @brief 드라이버 RX 큐 길이를 지정합니다. (twai_general_config_t::rx_queue_len, 기본 32)
+ */
+void hostCanSetRxQueueLen(uint32_t len);
+
+/**
+ * @brief 드라이버 TX 큐 길이를 지정합니다. (twai_general_config_t::tx_queue_len, 기본 5)
+ */
+void hostCanSetTxQueueLen(uint32_t len);
+
+/**
+ * @brief 버스 비트레이트를 지정합니다. (기본 500 kbit/s, 0이면 송신 즉시 완료)
+ */
+void hostCanSetBitrate(uint32_t bitsPerSec);
+
+/**
+ * @brief 버스에 나간 프레임 중 가장 오래된 것을 꺼냅니다.
+ * @param txMicros 버스 전송이 끝난 시각 (micros())
+ * @return 꺼낼 프레임이 있으면 1, 없으면 0
+ */
+int hostCanTakeTx(twai_message_t *message, uint32_t *txMicros);
+
+/**
+ * @brief 누적 송신 프레임 수
+ */
+uint32_t hostCanTxCount(void);
+
+/**
+ * @brief 프레임이 버스에 나갈 때마다 버스 스레드에서 불리는 콜백 (모듈 시뮬레이터용)
+ *
+ * 드라이버 잠금 밖에서 불리므로 콜백 안에서 hostCanInjectRx()로 응답을 넣을 수 있습니다.
+ */
+typedef void (*HostCanTxHook)(const twai_message_t *message);
+void hostCanSetTxHook(HostCanTxHook hook);
+
+#endif // HOST_DRIVER_TWAI_H
@@ -0,0 +1,146 @@
+#include "esp_partition.h"
+#include "esp_system.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "Arduino.h"
+
+/**
+ * @file esp_partition.cpp
+ * @brief 파티션 API와 리셋 원인의 호스트 구현 (메모리 상의 NOR 플래시)
+ */
+
+namespace {
+
+struct HostPartition {
+  esp_partition_t info;
+  std::vector<uint8_t>  data;
+  std::vector<uint32_t> sectorErases;
+};
+
+// partitions.csv의 데이터 파티션 중 펌웨어가 직접 쓰는 것
+HostPartition s_parts[] = {
+  { { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x290000, 0x10000,
+      SPI_FLASH_SEC_SIZE, "evlog", false }, {}, {} },
+};
+
+std::mutex     s_lock;
+HostFlashStats s_stats = {};
+uint32_t       s_eraseUs = 25000;
+uint32_t       s_writeUsPerPage = 500;
+esp_reset_reason_t s_resetReason = ESP_RST_POWERON;
+
+HostPartition *lookup(const esp_partition_t *p) {
+  for (HostPartition &hp : s_parts) {
+    if (&hp.info == p) {
+      if (hp.data.empty()) {
+        hp.data.assign(hp.info.size, 0xFF);
+        hp.sectorErases.assign(hp.info.size / SPI_FLASH_SEC_SIZE, 0);
+      }
+      return &hp;
+    }
+  }
+  return nullptr;
+}
+
+// 칩이 바쁜 시간: 호출한 태스크는 그동안 멈춥니다. (잠금 밖에서 호출)
+void busyWait(uint32_t us) {
+  if (us) delayMicroseconds(us);
+}
+
+} // namespace
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label) {
+  for (HostPartition &hp : s_parts) {
+    if (hp.info.type != type) continue;
+    if (subtype != ESP_PARTITION_SUBTYPE_ANY && hp.info.subtype != subtype) continue;
+    if (label && strcmp(label, hp.info.label) != 0) continue;
+    return &hp.info;
+  }
+  return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset,
+                             void *dst, size_t size) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  HostPartition *hp = lookup(partition);
+  if (!hp || !dst) return ESP_ERR_INVALID_ARG;
+  if (src_offset + size > hp->info.size) return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, hp->data.data() + src_offset, size);
+  s_stats.reads++;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset,
+                              const void *src, size_t size) {
+  uint32_t us;
+  {
+    std::lock_guard<std::mutex> guard(s_lock);
+    HostPartition *hp = lookup(partition);
+    if (!hp || !src) return ESP_ERR_INVALID_ARG;
+    if (dst_offset + size > hp->info.size) return ESP_ERR_INVALID_SIZE;
+    const uint8_t *in = (const uint8_t *)src;
+    for (size_t i = 0; i < size; ++i) hp->data[dst_offset + i] &= in[i];  // 1 → 0만 가능
+    us = (uint32_t)(((uint64_t)size * s_writeUsPerPage + 255) / 256);
+    s_stats.writes++;
+    s_stats.bytesWritten += (uint32_t)size;
+    s_stats.busyUs += us;
+  }
+  busyWait(us);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset,
+                                    size_t size) {
+  uint32_t us;
+  {
+    std::lock_guard<std::mutex> guard(s_lock);
+    HostPartition *hp = lookup(partition);
+    if (!hp) return ESP_ERR_INVALID_ARG;
+    if (offset % SPI_FLASH_SEC_SIZE || size % SPI_FLASH_SEC_SIZE) return ESP_ERR_INVALID_SIZE;
+    if (offset + size > hp->info.size) return ESP_ERR_INVALID_SIZE;
+    std::fill(hp->data.begin() + offset, hp->data.begin() + offset + size, 0xFF);
+    for (size_t s = offset / SPI_FLASH_SEC_SIZE; s < (offset + size) / SPI_FLASH_SEC_SIZE; ++s) {
+      uint32_t n = ++hp->sectorErases[s];
+      if (n > s_stats.maxSectorErases) s_stats.maxSectorErases = n;
+      s_stats.erases++;
+    }
+    us = (uint32_t)(size / SPI_FLASH_SEC_SIZE) * s_eraseUs;
+    s_stats.busyUs += us;
+  }
+  busyWait(us);
+  return ESP_OK;
+}
+
+void hostFlashGetStats(HostFlashStats *out) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  *out = s_stats;
+}
+
+void hostFlashSetTiming(uint32_t eraseUsPerSector, uint32_t writeUsPerPage) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_eraseUs = eraseUsPerSector;
+  s_writeUsPerPage = writeUsPerPage;
+}
+
+void hostFlashWipe(void) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  for (HostPartition &hp : s_parts) {
+    hp.data.assign(hp.info.size, 0xFF);
+    hp.sectorErases.assign(hp.info.size / SPI_FLASH_SEC_SIZE, 0);
+  }
+  s_stats = {};
+}
+
+esp_reset_reason_t esp_reset_reason(void) {
+  return s_resetReason;
+}
+
+void hostSetResetReason(esp_reset_reason_t reason) {
+  s_resetReason = reason;
+}
@@ -0,0 +1,81 @@
+#ifndef HOST_ESP_PARTITION_H
+#define HOST_ESP_PARTITION_H
+
+/**
+ * @file esp_partition.h
+ * @brief ESP-IDF 파티션 API(esp_partition_*)의 호스트 구현입니다.
+ *
+ * partitions.csv의 데이터 파티션을 메모리 상의 NOR 플래시로 흉내 냅니다.
+ * 지우기는 섹터(4 KB) 단위로 0xFF를 채우고, 쓰기는 실제 플래시처럼 1 → 0 비트만 바꿉니다(AND).
+ * 지우기/쓰기에는 실제 칩과 비슷한 시간이 걸리며, 파티션 내용은 프로세스가 끝날 때까지
+ * 남으므로 재부팅(다시 마운트)을 흉내 낼 수 있습니다.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP  = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+/**
+ * @brief 파티션 정보 (ESP-IDF와 같은 이름의 필드)
+ */
+typedef struct {
+  esp_partition_type_t    type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  uint32_t erase_size;
+  char     label[17];
+  bool     encrypted;
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset,
+                             void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset,
+                              const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset,
+                                    size_t size);
+
+//==============================================================================
+// 호스트 전용 훅
+//==============================================================================
+
+/**
+ * @brief 플래시 파티션 접근 통계 (누적값)
+ */
+typedef struct {
+  uint32_t reads;
+  uint32_t writes;
+  uint32_t bytesWritten;
+  uint32_t erases;          // 지운 섹터 수
+  uint32_t maxSectorErases; // 가장 많이 지운 섹터의 지우기 횟수 (마모 편중 확인용)
+  uint64_t busyUs;          // 지우기/쓰기에 걸린 시간 (그동안 호출한 태스크가 멈춤)
+} HostFlashStats;
+
+void hostFlashGetStats(HostFlashStats *out);
+
+/**
+ * @brief 지우기/쓰기 시간을 지정합니다. (기본: 섹터 지우기 25 ms, 256바이트 쓰기 500 us)
+ */
+void hostFlashSetTiming(uint32_t eraseUsPerSector, uint32_t writeUsPerPage);
+
+/**
+ * @brief 모든 파티션을 공장 출하 상태(전부 0xFF)로 되돌리고 통계를 지웁니다.
+ */
+void hostFlashWipe(void);
+
+#endif // HOST_ESP_PARTITION_H
@@ -0,0 +1,34 @@
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+/**
+ * @file esp_system.h
+ * @brief ESP-IDF esp_reset_reason()의 호스트 구현입니다.
+ */
+
+typedef enum {
+  ESP_RST_UNKNOWN   = 0,
+  ESP_RST_POWERON   = 1,
+  ESP_RST_EXT       = 2,
+  ESP_RST_SW        = 3,
+  ESP_RST_PANIC     = 4,
+  ESP_RST_INT_WDT   = 5,
+  ESP_RST_TASK_WDT  = 6,
+  ESP_RST_WDT       = 7,
+  ESP_RST_DEEPSLEEP = 8,
+  ESP_RST_BROWNOUT  = 9,
+  ESP_RST_SDIO      = 10,
+} esp_reset_reason_t;
+
+esp_reset_reason_t esp_reset_reason(void);
+
+//==============================================================================
+// 호스트 전용 훅
+//==============================================================================
+
+/**
+ * @brief 다음 esp_reset_reason()이 돌려줄 값을 지정합니다. (기본 ESP_RST_POWERON)
+ */
+void hostSetResetReason(esp_reset_reason_t reason);
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,112 @@
+#include "esp_timer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file esp_timer.cpp
+ * @brief esp_timer의 호스트 구현 (디스패치 스레드 하나 + 만료 시각 목록)
+ */
+
+struct HostEspTimer {
+  esp_timer_cb_t cb;
+  void          *arg;
+  bool           armed;
+  int64_t        dueUs;
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 디스패치 스레드는 프로세스가 끝날 때까지 기다리고 있으므로 정적 소멸자가 없도록 힙에 둠
+std::mutex                 &s_lock = *new std::mutex;
+std::condition_variable    &s_cv   = *new std::condition_variable;
+std::vector<HostEspTimer *> s_timers;
+std::atomic<uint32_t>       s_fires{0};
+bool                        s_started = false;
+
+// 가장 이른 만료를 기다렸다가 잠금 밖에서 콜백을 부릅니다.
+void dispatchLoop() {
+  std::unique_lock<std::mutex> lock(s_lock);
+  for (;;) {
+    HostEspTimer *next = nullptr;
+    for (HostEspTimer *t : s_timers) {
+      if (t->armed && (!next || t->dueUs < next->dueUs)) next = t;
+    }
+    if (!next) {
+      s_cv.wait(lock);
+      continue;
+    }
+    int64_t now = esp_timer_get_time();
+    if (now < next->dueUs) {
+      s_cv.wait_for(lock, std::chrono::microseconds(next->dueUs - now));
+      continue;
+    }
+    next->armed = false;
+    esp_timer_cb_t cb = next->cb;
+    void *arg = next->arg;
+    lock.unlock();
+    cb(arg);
+    s_fires.fetch_add(1, std::memory_order_relaxed);
+    lock.lock();
+  }
+}
+
+} // namespace
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle) {
+  if (!create_args || !create_args->callback || !out_handle) return ESP_ERR_INVALID_ARG;
+  HostEspTimer *t = new HostEspTimer{ create_args->callback, create_args->arg, false, 0 };
+  std::lock_guard<std::mutex> lock(s_lock);
+  s_timers.push_back(t);
+  if (!s_started) {
+    s_started = true;
+    std::thread(dispatchLoop).detach();
+  }
+  *out_handle = t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  std::lock_guard<std::mutex> lock(s_lock);
+  if (timer->armed) return ESP_ERR_INVALID_STATE;
+  timer->armed = true;
+  timer->dueUs = esp_timer_get_time() + (int64_t)timeout_us;
+  s_cv.notify_all();
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  std::lock_guard<std::mutex> lock(s_lock);
+  if (!timer->armed) return ESP_ERR_INVALID_STATE;
+  timer->armed = false;
+  s_cv.notify_all();
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  std::lock_guard<std::mutex> lock(s_lock);
+  if (timer->armed) return ESP_ERR_INVALID_STATE;
+  for (size_t i = 0; i < s_timers.size(); ++i) {
+    if (s_timers[i] == timer) {
+      s_timers.erase(s_timers.begin() + i);
+      break;
+    }
+  }
+  delete timer;
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+  static const Clock::time_point kBoot = Clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - kBoot).count();
+}
+
+uint32_t hostEspTimerFireCount() {
+  return s_fires.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,44 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+/**
+ * @file esp_timer.h
+ * @brief ESP-IDF 고해상도 타이머 API(esp_timer_*)의 호스트 구현입니다.
+ *
+ * ESP-IDF처럼 콜백은 모두 하나의 디스패치 스레드("esp_timer" 태스크)에서 차례로 실행됩니다.
+ * esp_timer_get_time()은 처음 부른 때부터 잰 µs입니다. (실기기는 부팅 후)
+ */
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct HostEspTimer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum {
+  ESP_TIMER_TASK = 0,
+} esp_timer_dispatch_t;
+
+/**
+ * @brief 타이머 생성 인자 (ESP-IDF와 같은 이름의 필드)
+ */
+typedef struct {
+  esp_timer_cb_t       callback;
+  void                *arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char          *name;
+  bool                 skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+int64_t   esp_timer_get_time();
+
+/**
+ * @brief 지금까지 실행한 타이머 콜백 수 (벤치: 깨어난 횟수)
+ */
+uint32_t hostEspTimerFireCount();
+
+#endif // HOST_ESP_TIMER_H
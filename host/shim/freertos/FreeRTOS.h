@@ -0,0 +1,56 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+/**
+ * @file FreeRTOS.h
+ * @brief ESP-IDF FreeRTOS API의 호스트 구현(기본 타입/매크로)입니다.
+ *
+ * 틱 주기는 실제 설정과 같은 1kHz(1 tick = 1ms)로 가정합니다.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define pdFALSE          ((BaseType_t)0)
+#define pdTRUE           ((BaseType_t)1)
+#define pdPASS           (pdTRUE)
+#define pdFAIL           (pdFALSE)
+#define errQUEUE_EMPTY   ((BaseType_t)0)
+#define errQUEUE_FULL    ((BaseType_t)0)
+
+#define configTICK_RATE_HZ   1000
+#define portTICK_PERIOD_MS   ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY        ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(xTimeInMs) \
+  ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+#define tskNO_AFFINITY   ((BaseType_t)0x7FFFFFFF)
+
+/**
+ * @brief ESP-IDF의 portMUX_TYPE(스핀락)을 호스트 뮤텍스로 대체합니다.
+ * (driver/twai.h처럼 extern "C" 안에서 포함되어도 되도록 C++ 링크로 고정)
+ */
+extern "C++" {
+#include <mutex>
+struct portMUX_TYPE {
+  std::recursive_mutex m;
+};
+}
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+#define portENTER_CRITICAL(mux)      ((mux)->m.lock())
+#define portEXIT_CRITICAL(mux)       ((mux)->m.unlock())
+#define portENTER_CRITICAL_ISR(mux)  ((mux)->m.lock())
+#define portEXIT_CRITICAL_ISR(mux)   ((mux)->m.unlock())
+#define taskENTER_CRITICAL(mux)      portENTER_CRITICAL(mux)
+#define taskEXIT_CRITICAL(mux)       portEXIT_CRITICAL(mux)
+
+#define portYIELD_FROM_ISR(...)      ((void)0)
+#define IRAM_ATTR
+
+#endif // HOST_FREERTOS_H
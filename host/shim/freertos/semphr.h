@@ -0,0 +1,23 @@
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+/**
+ * @file semphr.h
+ * @brief FreeRTOS 세마포어/뮤텍스 API의 호스트 구현입니다.
+ *
+ * 실제 FreeRTOS와 마찬가지로 세마포어는 항목 크기 0인 큐로 구현됩니다.
+ */
+
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken);
+#define vSemaphoreDelete(xSemaphore) vQueueDelete(xSemaphore)
+
+#endif // HOST_FREERTOS_SEMPHR_H
@@ -0,0 +1,223 @@
+extern "C" {
+  #include "driver/twai.h"
+}
+
+#include <chrono>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Arduino.h"
+
+/**
+ * @file twai.cpp
+ * @brief TWAI 드라이버 호스트 구현 (메모리 상의 가상 버스)
+ *
+ * 송신은 실제 컨트롤러처럼 길이 tx_queue_len의 드라이버 큐에 들어가고,
+ * 버스 스레드가 비트레이트로 계산한 프레임 시간마다 하나씩 내보냅니다.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct TxRecord {
+  twai_message_t msg;
+  uint32_t us;
+};
+
+std::mutex s_lock;
+std::condition_variable s_rxCv;     // 수신 큐에 프레임이 들어옴
+std::condition_variable s_txCv;     // TX 큐에 자리가 생김 / 프레임이 들어옴
+std::condition_variable s_alertCv;  // 경고 발생
+std::deque<twai_message_t> s_rx;
+std::deque<twai_message_t> s_txQueue;
+std::deque<TxRecord> s_tx;
+uint32_t s_txCount = 0;
+uint32_t s_rxQueueLen = 32;
+uint32_t s_txQueueLen = 5;
+uint32_t s_bitrate = 500000;
+uint32_t s_rxMissed = 0;
+uint32_t s_alertsEnabled = TWAI_ALERT_NONE;
+uint32_t s_alertsPending = 0;
+bool s_busStarted = false;
+HostCanTxHook s_txHook = nullptr;
+
+const size_t kTxLogLimit = 4096; // 아무도 꺼내가지 않을 때 무한히 쌓이지 않도록 제한
+
+// s_lock을 잡은 상태에서 호출
+void raiseAlerts(uint32_t alerts) {
+  alerts &= s_alertsEnabled;
+  if (!alerts) return;
+  s_alertsPending |= alerts;
+  s_alertCv.notify_all();
+}
+
+// 표준 프레임 한 개의 버스 점유 시간 (비트 스터핑은 평균 10%로 근사)
+std::chrono::microseconds frameTime(const twai_message_t &msg) {
+  if (s_bitrate == 0) return std::chrono::microseconds(0);
+  uint32_t bits = 47 + 8u * msg.data_length_code;
+  bits += bits / 10;
+  return std::chrono::microseconds((uint64_t)bits * 1000000u / s_bitrate);
+}
+
+// s_lock을 잡은 상태에서 호출
+void logTx(const twai_message_t &msg) {
+  if (s_tx.size() >= kTxLogLimit) s_tx.pop_front();
+  s_tx.push_back(TxRecord{msg, micros()});
+  s_txCount++;
+}
+
+void busThread() {
+  std::unique_lock<std::mutex> lock(s_lock);
+  for (;;) {
+    s_txCv.wait(lock, [] { return !s_txQueue.empty(); });
+    twai_message_t msg = s_txQueue.front();
+    Clock::time_point done = Clock::now() + frameTime(msg);
+
+    lock.unlock();
+    while (Clock::now() < done) {
+      std::this_thread::sleep_until(done);
+    }
+    lock.lock();
+
+    s_txQueue.pop_front();
+    logTx(msg);
+    raiseAlerts(TWAI_ALERT_TX_SUCCESS | (s_txQueue.empty() ? TWAI_ALERT_TX_IDLE : 0));
+    s_txCv.notify_all();
+
+    HostCanTxHook hook = s_txHook;
+    if (hook) {
+      lock.unlock();
+      hook(&msg);
+      lock.lock();
+    }
+  }
+}
+
+} // namespace
+
+esp_err_t twai_transmit(const twai_message_t *message, TickType_t ticks_to_wait) {
+  if (!message) return ESP_ERR_INVALID_ARG;
+  std::unique_lock<std::mutex> lock(s_lock);
+
+  if (s_bitrate == 0) {
+    logTx(*message);
+    raiseAlerts(TWAI_ALERT_TX_SUCCESS | TWAI_ALERT_TX_IDLE);
+    HostCanTxHook hook = s_txHook;
+    lock.unlock();
+    if (hook) hook(message);
+    return ESP_OK;
+  }
+
+  if (!s_busStarted) {
+    s_busStarted = true;
+    std::thread(busThread).detach();
+  }
+
+  auto space = [] { return s_txQueue.size() < s_txQueueLen; };
+  if (ticks_to_wait == portMAX_DELAY) {
+    s_txCv.wait(lock, space);
+  } else if (!s_txCv.wait_for(lock, std::chrono::milliseconds(ticks_to_wait), space)) {
+    return ESP_ERR_TIMEOUT;
+  }
+  s_txQueue.push_back(*message);
+  s_txCv.notify_all();
+  return ESP_OK;
+}
+
+esp_err_t twai_receive(twai_message_t *message, TickType_t ticks_to_wait) {
+  if (!message) return ESP_ERR_INVALID_ARG;
+  std::unique_lock<std::mutex> lock(s_lock);
+  auto ready = [] { return !s_rx.empty(); };
+  if (ticks_to_wait == portMAX_DELAY) {
+    s_rxCv.wait(lock, ready);
+  } else if (!s_rxCv.wait_for(lock, std::chrono::milliseconds(ticks_to_wait), ready)) {
+    return ESP_ERR_TIMEOUT;
+  }
+  *message = s_rx.front();
+  s_rx.pop_front();
+  return ESP_OK;
+}
+
+esp_err_t twai_get_status_info(twai_status_info_t *status_info) {
+  if (!status_info) return ESP_ERR_INVALID_ARG;
+  std::lock_guard<std::mutex> guard(s_lock);
+  memset(status_info, 0, sizeof(*status_info));
+  status_info->state = TWAI_STATE_RUNNING;
+  status_info->msgs_to_tx = (uint32_t)s_txQueue.size();
+  status_info->msgs_to_rx = (uint32_t)s_rx.size();
+  status_info->rx_missed_count = s_rxMissed;
+  return ESP_OK;
+}
+
+esp_err_t twai_read_alerts(uint32_t *alerts, TickType_t ticks_to_wait) {
+  if (!alerts) return ESP_ERR_INVALID_ARG;
+  std::unique_lock<std::mutex> lock(s_lock);
+  auto ready = [] { return s_alertsPending != 0; };
+  if (ticks_to_wait == portMAX_DELAY) {
+    s_alertCv.wait(lock, ready);
+  } else if (!s_alertCv.wait_for(lock, std::chrono::milliseconds(ticks_to_wait), ready)) {
+    *alerts = 0;
+    return ESP_ERR_TIMEOUT;
+  }
+  *alerts = s_alertsPending;
+  s_alertsPending = 0;
+  return ESP_OK;
+}
+
+esp_err_t twai_reconfigure_alerts(uint32_t alerts_enabled, uint32_t *current_alerts) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_alertsEnabled = alerts_enabled;
+  if (current_alerts) *current_alerts = s_alertsPending;
+  s_alertsPending = 0;
+  return ESP_OK;
+}
+
+void hostCanInjectRx(const twai_message_t *message) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  if (s_rx.size() >= s_rxQueueLen) {
+    s_rxMissed++;
+    raiseAlerts(TWAI_ALERT_RX_QUEUE_FULL);
+    return;
+  }
+  s_rx.push_back(*message);
+  raiseAlerts(TWAI_ALERT_RX_DATA);
+  s_rxCv.notify_all();
+}
+
+void hostCanSetRxQueueLen(uint32_t len) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_rxQueueLen = len ? len : 1;
+}
+
+void hostCanSetTxQueueLen(uint32_t len) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_txQueueLen = len ? len : 1;
+}
+
+void hostCanSetBitrate(uint32_t bitsPerSec) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_bitrate = bitsPerSec;
+}
+
+int hostCanTakeTx(twai_message_t *message, uint32_t *txMicros) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  if (s_tx.empty()) return 0;
+  if (message) *message = s_tx.front().msg;
+  if (txMicros) *txMicros = s_tx.front().us;
+  s_tx.pop_front();
+  return 1;
+}
+
+void hostCanSetTxHook(HostCanTxHook hook) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_txHook = hook;
+}
+
+uint32_t hostCanTxCount(void) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  return s_txCount;
+}